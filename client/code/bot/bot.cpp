@@ -0,0 +1,507 @@
+#include "../global/globaluse.hpp"
+
+#include "../multiplayer/messagebuffer.hpp"
+#include "../multiplayer/client.hpp"
+#include "../player/inputhistory.hpp"
+#include "../multiplayer/playerdatacollector.hpp"
+#include "../multiplayer/weaponpickercollector.hpp"
+#include "../multiplayer/weapondroppercollector.hpp"
+#include "../multiplayer/weaponfirecollector.hpp"
+#include "../multiplayer/snapshotreader.hpp"
+#include "../multiplayer/netclock.hpp"
+
+#include "bot.hpp"
+
+Bot::Bot(bool binary)
+{
+    client = new Client();
+    playerDataCollector = new PlayerDataCollector();
+    weaponPickerCollector = new WeaponPickerCollector();
+    weaponDropperCollector = new WeaponDropperCollector();
+    weaponFireCollector = new WeaponFireCollector();
+    snapshotReader = new SnapshotReader();
+    netClock = new NetClock();
+
+    this->binary = binary;
+    datagramToken = 0;
+
+    playerID = -1;
+    serverTick = 0;
+
+    spawned = false;
+    origin = position = vec3(0.0);
+    forward = vec3(0.0, 0.0, 1.0);
+    angle = 0.0;
+    frameTime = 0.0;
+    inputSeq = 0;
+
+    shots = 0;
+
+    lastSend = lastPing = lastPick = lastDrop = chrono::steady_clock::now();
+
+    tickTime = 0;
+}
+
+unsigned long long Bot::getNow() const
+{
+    return chrono::duration_cast < chrono::microseconds >(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Bot::connect(string ip, int port)
+{
+    client->connectToServer(ip, port);
+
+    /* connection info */
+    client->recvMSG(100);
+    string msg = client->getMessage();
+
+    if (msg == "")
+    {
+        throw(runtime_error("ERROR::Bot::connect() server is down"));
+    }
+
+    XMLDocument newConnectionDoc;
+    newConnectionDoc.Parse(msg.data());
+
+    XMLElement* joinElem = newConnectionDoc.FirstChildElement("join");
+
+    if (!joinElem)
+    {
+        throw(runtime_error("ERROR::Bot::connect() no free slots"));
+    }
+
+    joinElem->QueryIntText(&playerID);
+
+    /* binary snapshots offered, without a <Proto> answer the server keeps the bot on XML over the stream */
+    XMLElement* snapElem = newConnectionDoc.FirstChildElement("snap");
+    int snapVersion = 0;
+
+    if (snapElem)
+    {
+        snapElem->QueryIntText(&snapVersion);
+    }
+
+    binary = binary && snapVersion == SNAPSHOT_VERSION;
+
+    if (binary)
+    {
+        client->sendMSG(snapshotReader->getProtoData(playerID), MESSAGE_PROTO);
+
+        XMLElement* udpElem = newConnectionDoc.FirstChildElement("udp");
+
+        if (udpElem)
+        {
+            udpElem->QueryUnsignedText(&datagramToken);
+        }
+    }
+
+    /* gameObjects, weapons and players info, a bot has no scene to fill */
+    for (int i = 0; i < 3; i++)
+    {
+        client->recvMSG(10000);
+
+        if (client->getMessage() == "")
+        {
+            throw(runtime_error("ERROR::Bot::connect() no level data"));
+        }
+    }
+
+    playerDataCollector->setPlayerID(playerID);
+    weaponPickerCollector->setPlayerID(playerID);
+    weaponDropperCollector->setPlayerID(playerID);
+    weaponFireCollector->setPlayerID(playerID);
+}
+
+void Bot::handle(const string& msg)
+{
+    if (snapshotReader->isSnapshot(msg))
+    {
+        handleSnapshot(msg);
+        return;
+    }
+
+    XMLDocument doc;
+
+    doc.Parse(msg.c_str());
+
+    /* the root element names the message, the same name inside a payload doesn't */
+    for (XMLElement* root = doc.FirstChildElement(); root; root = root->NextSiblingElement())
+    {
+        string name = root->Name();
+
+        if (name == "Pong")
+        {
+            handlePong(root);
+        }
+        else if (name == "Soldiers")
+        {
+            handleSoldiers(doc, root);
+        }
+        else if (name == "Pick")
+        {
+            handleWeapons(root, true);
+        }
+        else if (name == "Drop")
+        {
+            handleWeapons(root, false);
+        }
+    }
+}
+
+void Bot::handleSnapshot(const string& msg)
+{
+    if (snapshotReader->collect(msg))
+    {
+        addState(snapshotReader->getTick(), snapshotReader->getTimeStamp());
+
+        vec3 reported;
+
+        if (snapshotReader->getKind() == 'S' && snapshotReader->getPosition(playerID, reported))
+        {
+            serverTick = snapshotReader->getTick();
+            setPosition(reported);
+        }
+    }
+
+    snapshotReader->clear();
+}
+
+void Bot::handlePong(XMLElement* root)
+{
+    XMLElement* timeElem = root->FirstChildElement("t");
+
+    if (!timeElem || !timeElem->GetText())
+    {
+        return;
+    }
+
+    unsigned long long sent = strtoull(timeElem->GetText(), nullptr, 10);
+
+    unsigned int tt = 0;
+    XMLElement* tickTimeElem = root->FirstChildElement("tt");
+
+    if (tickTimeElem)
+    {
+        tickTimeElem->QueryUnsignedText(&tt);
+    }
+
+    unique_lock < mutex > lk(mtx);
+
+    roundTrips.push_back((getNow() - sent) / 1000.0);
+    tickTime = tt;
+}
+
+void Bot::handleSoldiers(XMLDocument& soldiersDoc, XMLElement* root)
+{
+    XMLElement* timeElem = soldiersDoc.FirstChildElement("time");
+
+    if (timeElem)
+    {
+        unsigned int timeStamp = 0;
+
+        timeElem->QueryUnsignedAttribute("time", &timeStamp);
+        timeElem->QueryUnsignedAttribute("tick", &serverTick);
+
+        addState(serverTick, timeStamp);
+    }
+
+    for (XMLElement* soldierElem = root->FirstChildElement("soldier"); soldierElem; soldierElem = soldierElem->NextSiblingElement("soldier"))
+    {
+        int id = -1;
+        soldierElem->QueryIntAttribute("id", &id);
+
+        if (id != playerID)
+        {
+            continue;
+        }
+
+        XMLElement* objElem = soldierElem->FirstChildElement("obj");
+        XMLElement* modelElem = objElem ? objElem->FirstChildElement("mdl") : nullptr;
+
+        if (!modelElem)
+        {
+            return;
+        }
+
+        /* translation column of the model */
+        vec3 reported;
+
+        modelElem->QueryFloatAttribute("m", &reported.x);
+        modelElem->QueryFloatAttribute("n", &reported.y);
+        modelElem->QueryFloatAttribute("o", &reported.z);
+
+        setPosition(reported);
+
+        return;
+    }
+}
+
+/* how late the state of the tick came, on the server timeline the states themselves set up */
+void Bot::addState(unsigned int tick, unsigned int timeStamp)
+{
+    netClock->addSample(tick, timeStamp);
+
+    unique_lock < mutex > lk(mtx);
+
+    latencies.push_back(netClock->getAge(tick));
+}
+
+void Bot::setPosition(vec3 reported)
+{
+    /* first state or a respawn, the walk starts over from there */
+    if (!spawned || glm::distance(reported, position) > BOT_WALK_RADIUS * 2.0)
+    {
+        origin = reported - vec3(BOT_WALK_RADIUS, 0.0, 0.0);
+        angle = 0.0;
+
+        spawned = true;
+    }
+
+    position = reported;
+}
+
+void Bot::handleWeapons(XMLElement* root, bool picked)
+{
+    int id = -1;
+    XMLElement* playerIDElem = root->FirstChildElement("id");
+
+    if (playerIDElem)
+    {
+        playerIDElem->QueryIntText(&id);
+    }
+
+    XMLElement* weaponsElem = root->FirstChildElement("wpns");
+
+    if (id != playerID || !weaponsElem)
+    {
+        return;
+    }
+
+    for (XMLElement* weaponElem = weaponsElem->FirstChildElement("wpn"); weaponElem; weaponElem = weaponElem->NextSiblingElement())
+    {
+        int netID = -1;
+        weaponElem->QueryIntText(&netID);
+
+        auto it = find(weapons.begin(), weapons.end(), netID);
+
+        if (picked && it == weapons.end())
+        {
+            weapons.push_back(netID);
+        }
+        else if (!picked && it != weapons.end())
+        {
+            weapons.erase(it);
+        }
+    }
+}
+
+void Bot::move(float dt)
+{
+    angle += BOT_WALK_SPEED * dt;
+    frameTime = dt;
+
+    /* heads for the point of the circle, the server decides how far it gets */
+    vec3 target = origin + vec3(cos(angle), 0.0, sin(angle)) * float(BOT_WALK_RADIUS);
+    vec3 toTarget = vec3(target.x - position.x, 0.0, target.z - position.z);
+
+    forward = length(toTarget) > 0.1 ? normalize(toTarget) : normalize(vec3(-sin(angle), 0.0, cos(angle)));
+}
+
+void Bot::act()
+{
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+
+    /* walk, one command for the whole send period */
+    InputCommand input;
+
+    input.seq = ++inputSeq;
+    input.moveDirection = forward;
+    input.jump = false;
+    input.time = frameTime;
+    input.rotation = angleAxis(-angle, vec3(0.0, 1.0, 0.0));
+    input.position = position;
+
+    playerDataCollector->collect({input});
+    client->sendMSG(playerDataCollector->getData(), MESSAGE_PLAYER);
+    playerDataCollector->clear();
+
+    /* round trip */
+    if (now - lastPing >= chrono::milliseconds(BOT_PING_PERIOD))
+    {
+        client->sendMSG(getPingData(), MESSAGE_PING, true);
+        lastPing = now;
+    }
+
+    vec3 eye = position + vec3(0.0, BOT_EYE_HEIGHT, 0.0);
+
+    /* pick whatever lies ahead on the floor */
+    if (now - lastPick >= chrono::milliseconds(BOT_PICK_PERIOD))
+    {
+        weaponPickerCollector->collect({eye, position + forward * 3.0f - vec3(0.0, 1.0, 0.0)});
+        client->sendMSG(weaponPickerCollector->getData(), MESSAGE_PICK, true);
+        weaponPickerCollector->clear();
+
+        lastPick = now;
+    }
+
+    if (weapons.empty())
+    {
+        lastDrop = now;
+
+        return;
+    }
+
+    /* drop the active one now and then */
+    if (now - lastDrop >= chrono::milliseconds(BOT_DROP_PERIOD))
+    {
+        weaponDropperCollector->collect(true, translate(mat4(1.0), eye + forward));
+        client->sendMSG(weaponDropperCollector->getData(), MESSAGE_DROP, true);
+        weaponDropperCollector->clear();
+
+        lastDrop = now;
+    }
+
+    /* one shot per send, a reload every clip */
+    map < int, vector < pair < vec3, vec3 > > > fireInfo;
+    map < int, bool > reloadInfo;
+
+    fireInfo[weapons[0]].push_back({eye, eye + forward * float(BOT_FIRE_DISTANCE)});
+
+    if (++shots % BOT_CLIP_SIZE == 0)
+    {
+        reloadInfo[weapons[0]] = true;
+    }
+
+    weaponFireCollector->setTick(serverTick);
+    weaponFireCollector->collect(fireInfo, reloadInfo);
+    client->sendMSG(weaponFireCollector->getData(), MESSAGE_FIRE, true);
+    weaponFireCollector->clear();
+
+    /* snapshot ack, the binary ones are deltas against it */
+    if (binary)
+    {
+        client->sendMSG(snapshotReader->getAckData(playerID), MESSAGE_ACK);
+    }
+
+    /* repeated until the server answers */
+    if (datagramToken)
+    {
+        client->bindDatagrams(playerID, datagramToken);
+    }
+}
+
+string Bot::getPingData() const
+{
+    XMLDocument pingDoc;
+
+    /* root */
+    XMLNode* root = pingDoc.NewElement("Ping");
+
+    pingDoc.InsertFirstChild(root);
+
+    /* playerID */
+    XMLElement* playerIDElem = pingDoc.NewElement("id");
+    playerIDElem->SetText(playerID);
+
+    root->InsertEndChild(playerIDElem);
+
+    /* local send time, echoed back by the server */
+    XMLElement* timeElem = pingDoc.NewElement("t");
+    timeElem->SetText(to_string(getNow()).data());
+
+    root->InsertEndChild(timeElem);
+
+    /* printer */
+    XMLPrinter pingPrinter;
+    pingDoc.Print(&pingPrinter);
+
+    string res(pingPrinter.CStr());
+
+    return res;
+}
+
+void Bot::run(const atomic < bool >& running)
+{
+    lastSend = lastPing = lastPick = lastDrop = chrono::steady_clock::now();
+
+    while (running)
+    {
+        /* never blocks, everything queued is handled */
+        client->recvMSG(2048, 0);
+
+        for (string msg = client->getMessage(); msg != ""; msg = client->getMessage())
+        {
+            handle(msg);
+        }
+
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+
+        /* nothing to say until the server tells where the bot is */
+        if (!spawned)
+        {
+            lastSend = now;
+        }
+        else if (now - lastSend >= chrono::milliseconds(BOT_SEND_PERIOD))
+        {
+            move(chrono::duration < float >(now - lastSend).count());
+            act();
+
+            lastSend = now;
+        }
+
+        this_thread::sleep_for(chrono::milliseconds(5));
+    }
+}
+
+int Bot::getPlayerID() const
+{
+    return playerID;
+}
+
+unsigned int Bot::getTickTime() const
+{
+    unique_lock < mutex > lk(mtx);
+
+    return tickTime;
+}
+
+unsigned long long Bot::getSentBytes() const
+{
+    return client->getSentBytes();
+}
+
+unsigned long long Bot::getReceivedBytes() const
+{
+    return client->getReceivedBytes();
+}
+
+vector < float > Bot::takeLatencies()
+{
+    unique_lock < mutex > lk(mtx);
+
+    vector < float > res;
+    res.swap(latencies);
+
+    return res;
+}
+
+vector < float > Bot::takeRoundTrips()
+{
+    unique_lock < mutex > lk(mtx);
+
+    vector < float > res;
+    res.swap(roundTrips);
+
+    return res;
+}
+
+Bot::~Bot()
+{
+    delete client;
+    delete playerDataCollector;
+    delete weaponPickerCollector;
+    delete weaponDropperCollector;
+    delete weaponFireCollector;
+    delete snapshotReader;
+    delete netClock;
+}
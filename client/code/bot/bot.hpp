@@ -0,0 +1,109 @@
+#pragma once
+
+#include <stdexcept>
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <tinyxml2/tinyxml2.h>
+
+#define BOT_SEND_PERIOD 50 /* ms, the same as the real client broadcast */
+#define BOT_PING_PERIOD 250 /* ms */
+#define BOT_PICK_PERIOD 1000 /* ms */
+#define BOT_DROP_PERIOD 7000 /* ms */
+#define BOT_CLIP_SIZE 30 /* shots before a reload */
+
+#define BOT_WALK_RADIUS 6.0
+#define BOT_WALK_SPEED 0.5 /* rad/s around the spawn point */
+#define BOT_EYE_HEIGHT 1.5
+#define BOT_FIRE_DISTANCE 100.0
+
+using namespace std;
+using namespace tinyxml2;
+
+/*
+ * headless player driven by a script instead of a window.
+ * walks a circle around its spawn point by input commands, picks, drops and fires through the same
+ * collectors as the real client. takes the binary snapshots over UDP like the real client unless
+ * told to stay on XML, measures how late every state arrives against the server tick timeline
+ * and pings the server for the round trip
+ */
+class Bot
+{
+    private:
+        Client* client;
+        PlayerDataCollector* playerDataCollector;
+        WeaponPickerCollector* weaponPickerCollector;
+        WeaponDropperCollector* weaponDropperCollector;
+        WeaponFireCollector* weaponFireCollector;
+        SnapshotReader* snapshotReader;
+        NetClock* netClock;
+
+        bool binary;
+        unsigned int datagramToken;
+
+        int playerID;
+        unsigned int serverTick;
+
+        bool spawned;
+        vec3 origin; /* first own position the server reported */
+        vec3 position; /* the latest one, the server moves the bot */
+        vec3 forward;
+        float angle;
+        float frameTime; /* seconds since the last input command */
+        unsigned int inputSeq;
+
+        vector < int > weapons; /* net ids of the picked ones */
+        int shots;
+
+        chrono::steady_clock::time_point lastSend;
+        chrono::steady_clock::time_point lastPing;
+        chrono::steady_clock::time_point lastPick;
+        chrono::steady_clock::time_point lastDrop;
+
+        mutable mutex mtx;
+        vector < float > latencies; /* ms a state is late on the server timeline, drained by the swarm */
+        vector < float > roundTrips; /* ms, drained by the swarm */
+        unsigned int tickTime; /* us, reported by the server */
+
+        unsigned long long getNow() const;
+
+        void handle(const string& msg);
+
+        void handleSnapshot(const string& msg);
+        void handlePong(XMLElement* root);
+        void handleSoldiers(XMLDocument& soldiersDoc, XMLElement* root);
+        void handleWeapons(XMLElement* root, bool picked);
+
+        void addState(unsigned int tick, unsigned int timeStamp);
+        void setPosition(vec3 reported);
+
+        void move(float dt);
+        void act();
+
+        string getPingData() const;
+
+    public:
+        Bot(bool binary = true);
+
+        void connect(string ip, int port);
+
+        void run(const atomic < bool >& running);
+
+        int getPlayerID() const;
+        unsigned int getTickTime() const;
+
+        unsigned long long getSentBytes() const;
+        unsigned long long getReceivedBytes() const;
+
+        vector < float > takeLatencies();
+        vector < float > takeRoundTrips();
+
+        ~Bot();
+};
@@ -0,0 +1,176 @@
+#include "../global/globaluse.hpp"
+
+#include "../multiplayer/messagebuffer.hpp"
+#include "../multiplayer/client.hpp"
+#include "../player/inputhistory.hpp"
+#include "../multiplayer/playerdatacollector.hpp"
+#include "../multiplayer/weaponpickercollector.hpp"
+#include "../multiplayer/weapondroppercollector.hpp"
+#include "../multiplayer/weaponfirecollector.hpp"
+#include "../multiplayer/snapshotreader.hpp"
+#include "../multiplayer/netclock.hpp"
+
+#include "bot.hpp"
+#include "botswarm.hpp"
+
+BotSwarm::BotSwarm(int count, bool binary)
+{
+    for (int i = 0; i < count; i++)
+    {
+        bots.push_back(new Bot(binary));
+    }
+
+    running = false;
+}
+
+float BotSwarm::getPercentile(vector < float >& values, float percent) const
+{
+    if (values.empty())
+    {
+        return 0.0;
+    }
+
+    size_t index = std::min(values.size() - 1, size_t(percent / 100.0 * values.size()));
+
+    nth_element(values.begin(), values.begin() + index, values.end());
+
+    return values[index];
+}
+
+void BotSwarm::printPercentiles(string name, vector < float >& values) const
+{
+    cout << " | " << name << " p50 " << getPercentile(values, 50) << " p90 " << getPercentile(values, 90) << " p99 " << getPercentile(values, 99);
+    cout << " max " << (values.empty() ? 0.0 : *max_element(values.begin(), values.end())) << " ms (" << values.size() << ")";
+}
+
+void BotSwarm::report(string title, float seconds, vector < float >& latencies, vector < float >& roundTrips, unsigned long long sent, unsigned long long received, unsigned int tickTime) const
+{
+    float clients = std::max(size_t(1), bots.size());
+    seconds = std::max(seconds, 0.001f);
+
+    cout << fixed << setprecision(2);
+
+    cout << title << " bots " << bots.size();
+    cout << " | tick " << tickTime / 1000.0 << " ms";
+    cout << " | per client in " << received / clients / seconds / 1024.0 << " KB/s out " << sent / clients / seconds / 1024.0 << " KB/s";
+
+    /* a state against its tick on the server, then the ping answered off the tick */
+    printPercentiles("update", latencies);
+    printPercentiles("rtt", roundTrips);
+
+    cout << endl;
+}
+
+void BotSwarm::connect(string ip, int port)
+{
+    for (size_t i = 0; i < bots.size(); i++)
+    {
+        try
+        {
+            bots[i]->connect(ip, port);
+        }
+        catch(exception& ex)
+        {
+            /* the server is full, the rest won't get in either */
+            cerr << ex.what() << endl;
+
+            for (size_t j = i; j < bots.size(); j++)
+            {
+                delete bots[j];
+            }
+
+            bots.resize(i);
+
+            break;
+        }
+
+        this_thread::sleep_for(chrono::milliseconds(BOT_SWARM_JOIN_DELAY));
+    }
+
+    cout << bots.size() << " bots joined" << endl;
+}
+
+void BotSwarm::run(int seconds, int reportPeriod)
+{
+    running = true;
+
+    for (size_t i = 0; i < bots.size(); i++)
+    {
+        threads.push_back(thread(&Bot::run, bots[i], cref(running)));
+    }
+
+    vector < float > total;
+    vector < float > totalRoundTrips;
+    unsigned int maxTickTime = 0;
+
+    unsigned long long sent = 0;
+    unsigned long long received = 0;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    chrono::steady_clock::time_point previous = start;
+
+    for (int elapsed = 0; elapsed < seconds; elapsed += reportPeriod)
+    {
+        this_thread::sleep_for(chrono::seconds(reportPeriod));
+
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
+
+        vector < float > latencies;
+        vector < float > roundTrips;
+        unsigned int tickTime = 0;
+
+        unsigned long long nowSent = 0;
+        unsigned long long nowReceived = 0;
+
+        for (size_t i = 0; i < bots.size(); i++)
+        {
+            vector < float > botLatencies = bots[i]->takeLatencies();
+            latencies.insert(latencies.end(), botLatencies.begin(), botLatencies.end());
+
+            vector < float > botRoundTrips = bots[i]->takeRoundTrips();
+            roundTrips.insert(roundTrips.end(), botRoundTrips.begin(), botRoundTrips.end());
+
+            tickTime = std::max(tickTime, bots[i]->getTickTime());
+
+            nowSent += bots[i]->getSentBytes();
+            nowReceived += bots[i]->getReceivedBytes();
+        }
+
+        total.insert(total.end(), latencies.begin(), latencies.end());
+        totalRoundTrips.insert(totalRoundTrips.end(), roundTrips.begin(), roundTrips.end());
+        maxTickTime = std::max(maxTickTime, tickTime);
+
+        report("[" + to_string(elapsed + reportPeriod) + "s]", chrono::duration < float >(now - previous).count(), latencies, roundTrips, nowSent - sent, nowReceived - received, tickTime);
+
+        sent = nowSent;
+        received = nowReceived;
+        previous = now;
+    }
+
+    running = false;
+
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        threads[i].join();
+    }
+
+    threads.clear();
+
+    /* the whole run, the tick is the worst one seen */
+    report("[total]", chrono::duration < float >(previous - start).count(), total, totalRoundTrips, sent, received, maxTickTime);
+}
+
+BotSwarm::~BotSwarm()
+{
+    running = false;
+
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        threads[i].join();
+    }
+
+    for (size_t i = 0; i < bots.size(); i++)
+    {
+        delete bots[i];
+    }
+}
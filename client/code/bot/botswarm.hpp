@@ -0,0 +1,44 @@
+#pragma once
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <functional>
+
+#define BOT_SWARM_JOIN_DELAY 50 /* ms between the joins, the server accepts them one by one */
+
+using namespace std;
+
+/*
+ * a crowd of bots in one process, a thread per bot.
+ * every period prints the server tick time, the bytes per client each way,
+ * the percentiles of how late the states come and of the ping round trip,
+ * the whole run is summed up at the end
+ */
+class BotSwarm
+{
+    private:
+        vector < Bot* > bots;
+        vector < thread > threads;
+
+        atomic < bool > running;
+
+        float getPercentile(vector < float >& values, float percent) const;
+
+        void printPercentiles(string name, vector < float >& values) const;
+        void report(string title, float seconds, vector < float >& latencies, vector < float >& roundTrips, unsigned long long sent, unsigned long long received, unsigned int tickTime) const;
+
+    public:
+        BotSwarm(int count, bool binary = true);
+
+        void connect(string ip, int port);
+
+        void run(int seconds, int reportPeriod = 1);
+
+        ~BotSwarm();
+};
@@ -0,0 +1,40 @@
+#include "global/globaluse.hpp"
+
+#include "multiplayer/messagebuffer.hpp"
+#include "multiplayer/client.hpp"
+#include "player/inputhistory.hpp"
+#include "multiplayer/playerdatacollector.hpp"
+#include "multiplayer/weaponpickercollector.hpp"
+#include "multiplayer/weapondroppercollector.hpp"
+#include "multiplayer/weaponfirecollector.hpp"
+#include "multiplayer/snapshotreader.hpp"
+#include "multiplayer/netclock.hpp"
+
+#include "bot/bot.hpp"
+#include "bot/botswarm.hpp"
+
+/* Hide_and_Seek_Bots [bots] [seconds] [ip] [port] [binary|xml] */
+int main(int argc, char** argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : 8;
+    int seconds = argc > 2 ? atoi(argv[2]) : 60;
+    string ip = argc > 3 ? argv[3] : "127.0.0.1";
+    int port = argc > 4 ? atoi(argv[4]) : 5040;
+    bool binary = argc > 5 ? string(argv[5]) != "xml" : true;
+
+    BotSwarm* BS = new BotSwarm(count, binary);
+
+    try
+    {
+        BS->connect(ip, port);
+        BS->run(seconds);
+    }
+    catch(exception& ex)
+    {
+        cerr << ex.what() << endl;
+    }
+
+    delete BS;
+
+    return 0;
+}
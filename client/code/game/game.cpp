@@ -1,6 +1,7 @@
 #include "../global/globaluse.hpp"
 
 #include "../shader/shader.hpp"
+#include "../shader/uniformbuffer.hpp"
 
 #include "../framebuffer/framebuffer.hpp"
 #include "../framebuffer/colorbuffer.hpp"
@@ -29,24 +30,30 @@
 #include "../game_object/sphere.hpp"
 #include "../game_object/openglmotionstate.hpp"
 #include "../game_object/animation.hpp"
+#include "../game_object/glstatecache.hpp"
 #include "../game_object/mesh.hpp"
 #include "../game_object/bone.hpp"
+#include "../game_object/animationclip.hpp"
 #include "../game_object/skeleton.hpp"
 #include "../game_object/viewfrustum.hpp"
 #include "../game_object/boundsphere.hpp"
 #include "../game_object/modelloader.hpp"
 #include "../game_object/physicsobject.hpp"
+#include "../game_object/transformbuffer.hpp"
+#include "../game_object/renderqueue.hpp"
 #include "../game_object/gameobject.hpp"
 #include "../game_object/instancedgameobject.hpp"
 #include "../game_object/weapon.hpp"
 #include "../game_object/rifle.hpp"
 
+#include "../player/inputhistory.hpp"
 #include "../player/player.hpp"
 #include "../player/soldier.hpp"
 
 #include "../level/bloom.hpp"
 #include "../level/lensflare.hpp"
 #include "../level/dirlightsoftshadow.hpp"
+#include "../level/dirlightcascade.hpp"
 #include "../level/dirlight.hpp"
 #include "../level/ssao.hpp"
 #include "../level/atmosphere.hpp"
@@ -54,6 +61,7 @@
 #include "../level/levelloader.hpp"
 #include "../level/level.hpp"
 
+#include "../multiplayer/messagebuffer.hpp"
 #include "../multiplayer/client.hpp"
 #include "../multiplayer/physicsobjectdataparser.hpp"
 #include "../multiplayer/playerdatacollector.hpp"
@@ -68,6 +76,9 @@
 #include "../multiplayer/weaponfirecollector.hpp"
 #include "../multiplayer/playerconnectionupdater.hpp"
 #include "../multiplayer/playerdisconnectionupdater.hpp"
+#include "../multiplayer/snapshotreader.hpp"
+#include "../multiplayer/snapshotdecoder.hpp"
+#include "../multiplayer/netclock.hpp"
 #include "../multiplayer/multiplayer.hpp"
 
 #include "game.hpp"
@@ -193,8 +204,12 @@ void Game::gameLoop()
             physicsWorld->updateSimulation(step, 1000);
         }
 
+        /* every remote entity is placed on the same server tick once a frame */
+        level->interpolate(multiplayer->getRenderTick());
+
         level->updateSunPos();
         level->updatePlayers(mode);
+        level->animate(Global::fpsCounter->getActualFrameTime());
         level->render();
 
         /***********************************
@@ -8,6 +8,7 @@ Animation::Animation(string name)
     framesRange = vec2(0); // default is from start to the end
 
     curFrame = 0.0;
+    step = 0.0;
 
     speed = 0.0; // default is 24 frames per second
     loop = false;
@@ -21,6 +22,7 @@ Animation::Animation(string name, int animId, vec2 framesRange, float speed, boo
     this->framesRange = framesRange;
 
     curFrame = framesRange.x;
+    step = 0.0;
 
     this->speed = speed;
 
@@ -100,7 +102,8 @@ void Animation::fromFrame(float frame)
     }
 }
 
-bool Animation::nextFrame()
+/* the frames move with the time, not with the calls */
+bool Animation::advance(float deltaTime)
 { 
     if (curFrame < framesRange.x)
     {
@@ -118,7 +121,8 @@ bool Animation::nextFrame()
         }
     }
     
-    curFrame += speed;
+    step = speed * ANIMATION_RATE * std::min(deltaTime, float(ANIMATION_MAX_STEP));
+    curFrame += step;
 
     return true;
 }
@@ -128,4 +132,9 @@ float Animation::getCurFrame() const
     return curFrame;
 }
 
+float Animation::getStep() const
+{
+    return step;
+}
+
 Animation::~Animation(){}
@@ -4,6 +4,9 @@
 
 #include <glm/glm.hpp>
 
+#define ANIMATION_RATE 120.0 /* updates per second the speeds are given in, a speed is frames per update */
+#define ANIMATION_MAX_STEP 0.1 /* seconds, a hitch doesn't skip through a clip */
+
 using namespace std;
 using namespace glm;
 
@@ -16,6 +19,7 @@ class Animation
         vec2 framesRange;
         
         float curFrame;
+        float step; /* frames of the last advance */
 
         float speed;
         bool loop; 
@@ -40,8 +44,9 @@ class Animation
 
         void fromStart();
         void fromFrame(float frame);
-        bool nextFrame();
+        bool advance(float deltaTime);
         float getCurFrame() const;
+        float getStep() const;
 
         ~Animation();
 };
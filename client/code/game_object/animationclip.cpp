@@ -0,0 +1,92 @@
+#include "animation.hpp"
+#include "bone.hpp"
+#include "animationclip.hpp"
+
+AnimationClip::AnimationClip(const vector < Bone* > &bones, int id)
+{
+    duration = 0.0;
+    speed = 0.0;
+
+    bonesAmount = bones.size();
+    animated.assign(bonesAmount, 0);
+
+    for (int i = 0; i < bonesAmount; i++)
+    {
+        AnimationData* data = bones[i]->getAnimation(id);
+
+        if (data && data->nodeAnim)
+        {
+            duration = data->duration;
+            speed = data->speed;
+            animated[i] = 1;
+        }
+    }
+
+    /* the speed is ticks per second / ANIMATION_RATE */
+    float ticks = speed > 0.0 ? speed * ANIMATION_RATE : ANIMATION_CLIP_TICKS;
+
+    if (speed <= 0.0)
+    {
+        speed = ticks / ANIMATION_RATE;
+    }
+
+    step = ticks / ANIMATION_CLIP_SAMPLE_RATE;
+    keys = int(duration / step) + 2;
+
+    positions.assign(keys * bonesAmount, vec3(0.0));
+    rotations.assign(keys * bonesAmount, quat(1.0, 0.0, 0.0, 0.0));
+
+    for (int k = 0; k < keys; k++)
+    {
+        float time = std::min(k * step, duration);
+
+        for (int i = 0; i < bonesAmount; i++)
+        {
+            if (animated[i])
+            {
+                bones[i]->getKeyframe(id, time, positions[k * bonesAmount + i], rotations[k * bonesAmount + i]);
+            }
+        }
+    }
+}
+
+float AnimationClip::getDuration() const
+{
+    return duration;
+}
+
+float AnimationClip::getSpeed() const
+{
+    return speed;
+}
+
+bool AnimationClip::isAnimated(int bone) const
+{
+    return animated[bone];
+}
+
+void AnimationClip::sample(float time, vector < vec3 > &positions, vector < quat > &rotations) const
+{
+    float row = std::max(time, 0.0f) / step;
+
+    int first = std::min(int(row), keys - 1);
+    int second = std::min(first + 1, keys - 1);
+
+    float factor = std::min(row - first, 1.0f);
+
+    const vec3* firstPositions = &this->positions[first * bonesAmount];
+    const vec3* secondPositions = &this->positions[second * bonesAmount];
+    const quat* firstRotations = &this->rotations[first * bonesAmount];
+    const quat* secondRotations = &this->rotations[second * bonesAmount];
+
+    positions.resize(bonesAmount);
+    rotations.resize(bonesAmount);
+
+    for (int i = 0; i < bonesAmount; i++)
+    {
+        positions[i] = mix(firstPositions[i], secondPositions[i], factor);
+        rotations[i] = slerp(firstRotations[i], secondRotations[i], factor);
+    }
+}
+
+AnimationClip::~AnimationClip() {}
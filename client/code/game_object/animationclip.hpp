@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#define ANIMATION_CLIP_SAMPLE_RATE 60.0 /* keys per second a clip is resampled to at the load */
+#define ANIMATION_CLIP_TICKS 25.0 /* ticks per second of a clip that doesn't say */
+
+using namespace std;
+using namespace glm;
+
+/*
+ * one animation of a skeleton resampled at a fixed rate, a row of all the bones
+ * per key, so a pose is two rows and a lerp away instead of a key search per bone
+ */
+class AnimationClip
+{
+    private:
+        float duration; /* ticks, the frames of Animation */
+        float speed; /* default frames per update */
+        float step; /* ticks between two rows */
+
+        int keys;
+        int bonesAmount;
+
+        vector < vec3 > positions; 
+        vector < quat > rotations; 
+        vector < char > animated; /* per bone, the others keep their pose */
+
+    public:
+        AnimationClip(const vector < Bone* > &bones, int id);
+
+        float getDuration() const;
+        float getSpeed() const;
+
+        bool isAnimated(int bone) const;
+
+        void sample(float time, vector < vec3 > &positions, vector < quat > &rotations) const;
+
+        ~AnimationClip();
+};
@@ -3,6 +3,7 @@
 #include "../shader/shader.hpp"
 
 #include "animation.hpp"
+#include "glstatecache.hpp"
 #include "mesh.hpp"
 #include "bone.hpp"
 
@@ -12,30 +13,6 @@ using namespace Assimp;
 
 Bone::Bone(){}
 
-mat4 Bone::getFullTransform() const
-{
-    const Bone* b = this; 
-
-    vector < mat4 > matrices; 
-
-    while (b) 
-    {
-        mat4 tmp = global.aiMatrix4x4ToGlm(b->node->mTransformation); 
-        matrices.push_back(tmp); 
-
-        b = b->parentBone; 
-    }
-
-    mat4 res; 
-
-    for (int i = matrices.size() - 1; i >= 0; i--) 
-    {
-        res *= matrices[i]; 
-    }
-    
-    return res;
-}
-
 vec3 Bone::calcInterpolatedPosition(int id, float time)
 {
     vec3 out; 
@@ -52,6 +29,14 @@ vec3 Bone::calcInterpolatedPosition(int id, float time)
     int positionIndex = findPosition(id, time); 
     int nextPositionIndex = positionIndex + 1; 
 
+    /* at or past the last key */
+    if (nextPositionIndex >= int(animation.at(id)->nodeAnim->mNumPositionKeys))
+    {
+        aiVector3D help = animation.at(id)->nodeAnim->mPositionKeys[positionIndex].mValue; 
+
+        return vec3(help.x, help.y, help.z);
+    }
+
     float deltaTime = (float)(animation.at(id)->nodeAnim->mPositionKeys[nextPositionIndex].mTime - animation.at(id)->nodeAnim->mPositionKeys[positionIndex].mTime); 
     float factor = (time - (float)animation.at(id)->nodeAnim->mPositionKeys[positionIndex].mTime) / deltaTime; 
 
@@ -81,6 +66,14 @@ quat Bone::calcInterpolatedRotation(int id, float time)
     int rotationIndex = findRotation(id, time); 
     int nextRotationIndex = rotationIndex + 1; 
 
+    /* at or past the last key */
+    if (nextRotationIndex >= int(animation.at(id)->nodeAnim->mNumRotationKeys))
+    {
+        aiQuaternion help = animation.at(id)->nodeAnim->mRotationKeys[rotationIndex].mValue; 
+
+        return quat(help.w, help.x, help.y, help.z);
+    }
+
     float deltaTime = (float)(animation.at(id)->nodeAnim->mRotationKeys[nextRotationIndex].mTime - animation.at(id)->nodeAnim->mRotationKeys[rotationIndex].mTime); 
     float factor = (time - (float)animation.at(id)->nodeAnim->mRotationKeys[rotationIndex].mTime) / deltaTime;  
 
@@ -151,24 +144,18 @@ int Bone::findRotation(int id, float time)
     return l;
 }
 
-void Bone::updateKeyframeTransform(int id, float time)
+/* false if the bone doesn't move in this animation, the keys are searched, only for the load */
+bool Bone::getKeyframe(int id, float time, vec3& position, quat& rotation)
 {
-    if (!animation.at(id)->nodeAnim) 
+    if (!animation.at(id) || !animation.at(id)->nodeAnim) 
     {
-        return;
+        return false;
     }
     
-    vec3 scal = vec3(1.0); 
-    vec3 pos = calcInterpolatedPosition(id, time); 
-    quat rot = calcInterpolatedRotation(id, time); 
-
-    mat4 res(1.0);
-    
-    res *= scale(scal);
-    res *= translate(pos);
-    res *= mat4_cast(rot);
+    position = calcInterpolatedPosition(id, time); 
+    rotation = calcInterpolatedRotation(id, time); 
 
-    node->mTransformation = global.glmToAiMatrix4x4(res); 
+    return true;
 }
 
 void Bone::setName(string &name)
@@ -221,6 +208,11 @@ AnimationData* Bone::getAnimation(int id) const
     return animation.at(id);
 }
 
+int Bone::getAnimationsAmount() const
+{
+    return animation.size();
+}
+
 Bone* Bone::getParent() const
 {
     return parentBone;
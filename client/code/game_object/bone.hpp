@@ -44,8 +44,7 @@ class Bone
     public:
         Bone();
         
-        mat4 getFullTransform() const; 
-        void updateKeyframeTransform(int id, float time); 
+        bool getKeyframe(int id, float time, vec3& position, quat& rotation); 
         
         void setName(string &name);
         void setId(int id);
@@ -58,6 +57,7 @@ class Bone
         int getId() const;
         aiNode* getNode() const;
         AnimationData* getAnimation(int id) const;
+        int getAnimationsAmount() const;
         Bone* getParent() const;
         mat4 getOffset() const;
 
@@ -1,6 +1,7 @@
 #include "../shader/shader.hpp"
 
 #include "animation.hpp"
+#include "glstatecache.hpp"
 #include "mesh.hpp"
 #include "bone.hpp"
 #include "boundsphere.hpp"
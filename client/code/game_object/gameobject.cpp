@@ -1,6 +1,7 @@
 #include "../global/globaluse.hpp"
 
 #include "../shader/shader.hpp"
+#include "../shader/uniformbuffer.hpp"
 
 #include "../window/renderquad.hpp"
 #include "../window/glfwevents.hpp"
@@ -18,13 +19,17 @@
 #include "sphere.hpp"
 #include "openglmotionstate.hpp"
 #include "animation.hpp"
+#include "glstatecache.hpp"
 #include "mesh.hpp"
 #include "bone.hpp"
+#include "animationclip.hpp"
 #include "skeleton.hpp"
 #include "viewfrustum.hpp"
 #include "boundsphere.hpp"
 #include "modelloader.hpp"
 #include "physicsobject.hpp"
+#include "transformbuffer.hpp"
+#include "renderqueue.hpp"
 #include "gameobject.hpp"
 
 set < string > GameObject::globalNames;
@@ -56,9 +61,10 @@ GameObject::GameObject(Window* window, string name)
     sphere = nullptr;
 
     interpolation = false;
-    interpolationCoeff = 1.0;
-    localTransform = nextTransform = prevTransform = mat4(1.0);
+    transformBuffer = new TransformBuffer();
+    localTransform = mat4(1.0);
     ready = true;
+    netID = -1;
 
     userPointer = nullptr;
 }
@@ -169,6 +175,11 @@ void GameObject::setUserPointer(void* userPointer)
 {
     this->userPointer = userPointer;
 }
+
+void GameObject::setNetID(int netID)
+{
+    this->netID = netID;
+}
         
 void GameObject::createBoundSphere()
 {
@@ -277,11 +288,10 @@ void GameObject::clearPhysicsObjectTransform()
     physicsObject->clearTransform();
     
     this->interpolation = false;
-    prevTransform = nextTransform = mat4(1.0);
-    interpolationCoeff = 1.0;
+    transformBuffer->clear();
 }
         
-void GameObject::setPhysicsObjectTransform(mat4 model, bool interpolation, unsigned int timeStamp)
+void GameObject::setPhysicsObjectTransform(mat4 model, bool interpolation, unsigned int tick)
 {
     if (!physicsObject)
     {
@@ -295,18 +305,29 @@ void GameObject::setPhysicsObjectTransform(mat4 model, bool interpolation, unsig
         unique_ptr < btScalar > transform(global.glmMat42BtScalar(model));
         physicsObject->setTransform(transform.get());
 
-        interpolationCoeff = 1.0;
-        interpolationDelta = 0.0;
-        prevTransform = nextTransform = model;
+        transformBuffer->clear();
     }
     else
     {
-        unsigned int diffMill = ((global.getTime() + 1000000) - timeStamp + 50) % 1000000;
+        /* shown later, by interpolate() */
+        transformBuffer->push(tick, model);
+    }
+}
 
-        interpolationCoeff = 0.0;
-        interpolationDelta = 1.0 / (diffMill / (Global::fpsCounter->getFramesTime() * 1000.0));
-        prevTransform = nextTransform;
-        nextTransform = model;
+void GameObject::interpolate(double tick)
+{
+    if (!interpolation || !physicsObject)
+    {
+        return;
+    }
+
+    mat4 model;
+
+    if (transformBuffer->sample(tick, model))
+    {
+        unique_ptr < btScalar > scalarModel(global.glmMat42BtScalar(model));
+
+        physicsObject->setTransform(scalarModel.get());
     }
 }
 
@@ -330,11 +351,11 @@ void GameObject::removeAnimation(string name)
     }
 }
 
-void GameObject::playAnimation(string name, bool reset)
+void GameObject::playAnimation(string name, bool reset, float fade)
 {
     if (animations.find(name) != animations.end())
     {
-        skeleton->playAnimation(animations.find(name)->second, reset);
+        skeleton->playAnimation(animations.find(name)->second, reset, fade);
     }
 }
 
@@ -427,6 +448,11 @@ void* GameObject::getUserPointer() const
 {
     return userPointer;
 }
+
+int GameObject::getNetID() const
+{
+    return netID;
+}
         
 Animation* GameObject::getActiveAnimation() const
 {
@@ -443,71 +469,64 @@ Animation* GameObject::getAnimation(string name) const
     return nullptr;
 }
 
-void GameObject::render(Shader* shader, bool viewCull)
+/* no bound sphere, no culling */
+bool GameObject::isInFrustum(const ViewFrustum* frustum)
 {
-    if (interpolation && interpolationCoeff < 1.0)
+    if (!boundSphere)
     {
-        mat4 model = float(1.0 - interpolationCoeff) * prevTransform + interpolationCoeff * nextTransform;
-
-        unique_ptr < btScalar > scalarModel(global.glmMat42BtScalar(model));
-
-        physicsObject->setTransform(scalarModel.get());
-
-        interpolationCoeff += interpolationDelta;
+        return true;
     }
-    
-    if (visible && viewCull && viewFrustum && boundSphere)
-    {
-        unique_lock < mutex > lk(mtx);
-        ready = false;
 
-        mat4 transform = getPhysicsObjectTransform() * localTransform;
+    unique_lock < mutex > lk(mtx);
+    ready = false;
 
-        lk.unlock();
-        ready = true;
-        cv.notify_all();
+    mat4 transform = getPhysicsObjectTransform() * localTransform;
 
-        boundSphere->applyTransform(transform);
+    lk.unlock();
+    ready = true;
+    cv.notify_all();
 
-        if (!viewFrustum->isSphereInFrustum(boundSphere->getTransformedCenter(), boundSphere->getTransformedRadius()))
-        {
-            return;
-        }
-    }
+    boundSphere->applyTransform(transform);
+
+    return frustum->isSphereInFrustum(boundSphere->getTransformedCenter(), boundSphere->getTransformedRadius());
+}
 
-    if (skeleton)
+void GameObject::collect(RenderQueue* renderQueue, Shader* shader, bool viewCull)
+{
+    if (visible && viewCull && viewFrustum && !isInFrustum(viewFrustum))
     {
-        skeleton->update(shader);
+        return;
     }
 
     if (visible)
     {
-        if (!cull)
-        {
-            glDisable(GL_CULL_FACE);
-        }
+        RenderItem item;
+
+        item.shader = shader;
+        item.skeleton = skeleton && skeleton->isMeshWithBones() ? skeleton : nullptr;
+        item.owner = this;
 
         unique_lock < mutex > lk(mtx);
         ready = false;
 
-        shader->setMat4("localTransform", localTransform);
-        shader->setMat4("model", getPhysicsObjectTransform());
-        
+        item.localTransform = localTransform;
+        item.model = getPhysicsObjectTransform();
+
         ready = true;
         lk.unlock();
         cv.notify_all();
 
-        /* minimal diffuse value */
-        shader->setFloat("minNormalCosAngle", minNormalCosAngle);
-        /* isStatic */
-        shader->setInt("isStatic", viewStatic);
+        item.minNormalCosAngle = minNormalCosAngle;
+        item.viewStatic = viewStatic;
+        item.cull = cull;
+        item.instanced = false;
 
         for (size_t i = 0; i < meshes.size(); i++)
         {
-            meshes[i]->render(shader);
+            item.mesh = meshes[i];
+
+            renderQueue->add(item);
         }
-    
-        glEnable(GL_CULL_FACE);
     }
 }
 
@@ -548,6 +567,7 @@ GameObject::~GameObject()
     removePhysicsObject();
 
     delete modelLoader;
+    delete transformBuffer;
 
     delete sphere;
 
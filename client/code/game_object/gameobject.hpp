@@ -51,16 +51,14 @@ class GameObject
 
         mat4 localTransform;
 
-        /* interpolation */
+        /* interpolation, the server states by tick */
         bool interpolation;
-        float interpolationCoeff;
-        float interpolationDelta;
-        mat4 prevTransform;
-        mat4 nextTransform;
+        TransformBuffer* transformBuffer;
 
         void* userPointer;
 
         /* multiplayer */
+        int netID;
         bool ready;
         mutex mtx;
         condition_variable cv;
@@ -92,13 +90,15 @@ class GameObject
         void clearLocalTransform();
         void clearPhysicsObjectTransform();
 
-        void setPhysicsObjectTransform(mat4 model, bool interpolation = false, unsigned int timeStamp = 0);
+        void setPhysicsObjectTransform(mat4 model, bool interpolation = false, unsigned int tick = 0);
+        void interpolate(double tick);
 
         void setUserPointer(void* userPointer);
+        void setNetID(int netID);
         
         void addAnimation(Animation* anim);
         void removeAnimation(string name);
-        void playAnimation(string name, bool reset = true);
+        void playAnimation(string name, bool reset = true, float fade = 0.0);
         void stopAnimation();
 
         PhysicsObject* getPhysicsObject() const;
@@ -116,11 +116,14 @@ class GameObject
         mat4 getPhysicsObjectTransform() const;
 
         void* getUserPointer() const;
+        int getNetID() const;
 
         Animation* getActiveAnimation() const;
         Animation* getAnimation(string name) const;
 
-        virtual void render(Shader* shader, bool viewCull = true);
+        bool isInFrustum(const ViewFrustum* frustum);
+
+        virtual void collect(RenderQueue* renderQueue, Shader* shader, bool viewCull = true);
         
         /*** DEBUG ***/
         void createDebugSphere(int depth);
@@ -0,0 +1,127 @@
+#include "../shader/shader.hpp"
+
+#include "glstatecache.hpp"
+
+GLStateCache::GLStateCache()
+{
+    reset();
+}
+
+void GLStateCache::reset()
+{
+    program = 0;
+    vertexArray = 0;
+
+    /* a unit that doesn't exist, the first bind always goes through */
+    activeUnit = ~0u;
+    textures.clear();
+
+    cullFace = -1;
+
+    ints.clear();
+    floats.clear();
+}
+
+void GLStateCache::useProgram(Shader* shader)
+{
+    if (program == shader->getID())
+    {
+        return;
+    }
+
+    shader->use();
+    program = shader->getID();
+
+    /* uniforms belong to the program */
+    ints.clear();
+    floats.clear();
+}
+
+void GLStateCache::bindVertexArray(GLuint VAO)
+{
+    if (vertexArray == VAO)
+    {
+        return;
+    }
+
+    glBindVertexArray(VAO);
+    vertexArray = VAO;
+}
+
+void GLStateCache::bindTexture(unsigned int unit, GLuint texture)
+{
+    if (unit < textures.size() && textures[unit] == texture)
+    {
+        return;
+    }
+
+    if (unit >= textures.size())
+    {
+        /* never bound by us, 0 would be a guess */
+        textures.resize(unit + 1, ~0u);
+    }
+
+    if (activeUnit != unit)
+    {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        activeUnit = unit;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    textures[unit] = texture;
+}
+
+void GLStateCache::unbindTextures()
+{
+    for (size_t i = 0; i < textures.size(); i++)
+    {
+        bindTexture(i, 0);
+    }
+}
+
+void GLStateCache::setCullFace(bool enabled)
+{
+    if (cullFace == int(enabled))
+    {
+        return;
+    }
+
+    if (enabled)
+    {
+        glEnable(GL_CULL_FACE);
+    }
+    else
+    {
+        glDisable(GL_CULL_FACE);
+    }
+
+    cullFace = enabled;
+}
+
+void GLStateCache::setInt(Shader* shader, const string& key, int value)
+{
+    auto it = ints.find(key);
+
+    if (it != ints.end() && it->second == value)
+    {
+        return;
+    }
+
+    shader->setInt(key, value);
+    ints[key] = value;
+}
+
+void GLStateCache::setFloat(Shader* shader, const string& key, float value)
+{
+    auto it = floats.find(key);
+
+    if (it != floats.end() && it->second == value)
+    {
+        return;
+    }
+
+    shader->setFloat(key, value);
+    floats[key] = value;
+}
+
+GLStateCache::~GLStateCache() {}
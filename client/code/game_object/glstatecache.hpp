@@ -0,0 +1,44 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include <string>
+
+using namespace std;
+
+/*
+ * shadow copy of the gl state the render queue touches. it only trusts what went
+ * through it since reset(), the rest of the renderer still binds on its own
+ */
+class GLStateCache
+{
+    private:
+        GLuint program;
+        GLuint vertexArray;
+
+        unsigned int activeUnit;
+        vector < GLuint > textures; /* bound texture of each unit */
+
+        int cullFace; /* -1 unknown */
+
+        /* uniform values of the current program */
+        map < string, int > ints;
+        map < string, float > floats;
+
+    public:
+        GLStateCache();
+
+        void reset();
+
+        void useProgram(Shader* shader);
+        void bindVertexArray(GLuint VAO);
+        void bindTexture(unsigned int unit, GLuint texture);
+        void unbindTextures();
+
+        void setCullFace(bool enabled);
+
+        void setInt(Shader* shader, const string& key, int value);
+        void setFloat(Shader* shader, const string& key, float value);
+
+        ~GLStateCache();
+};
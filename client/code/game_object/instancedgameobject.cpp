@@ -2,6 +2,7 @@
 #include "../global/poissondisk.hpp"
 
 #include "../shader/shader.hpp"
+#include "../shader/uniformbuffer.hpp"
 
 #include "../window/renderquad.hpp"
 #include "../window/glfwevents.hpp"
@@ -19,13 +20,17 @@
 #include "sphere.hpp"
 #include "openglmotionstate.hpp"
 #include "animation.hpp"
+#include "glstatecache.hpp"
 #include "mesh.hpp"
 #include "bone.hpp"
+#include "animationclip.hpp"
 #include "skeleton.hpp"
 #include "viewfrustum.hpp"
 #include "boundsphere.hpp"
 #include "modelloader.hpp"
 #include "physicsobject.hpp"
+#include "transformbuffer.hpp"
+#include "renderqueue.hpp"
 #include "gameobject.hpp"
 #include "instancedgameobject.hpp"
 
@@ -146,60 +151,42 @@ void InstancedGameObject::genInstances()
     }
 }
 
-void InstancedGameObject::render(Shader* shader, bool viewCull)
+void InstancedGameObject::collect(RenderQueue* renderQueue, Shader* shader, bool viewCull)
 {
-    if (visible && viewCull && viewFrustum && boundSphere)
+    if (visible && viewCull && viewFrustum && !isInFrustum(viewFrustum))
     {
-        unique_lock < mutex > lk(mtx);
-        ready = false;
-
-        mat4 transform = getPhysicsObjectTransform() * localTransform;
-
-        lk.unlock();
-        ready = true;
-        cv.notify_all();
-
-        boundSphere->applyTransform(transform);
-
-        if (!viewFrustum->isSphereInFrustum(boundSphere->getTransformedCenter(), boundSphere->getTransformedRadius()))
-        {
-            return;
-        }
-    }
-
-    if (skeleton)
-    {
-        skeleton->update(shader);
+        return;
     }
 
     if (visible)
     {
-        if (!cull)
-        {
-            glDisable(GL_CULL_FACE);
-        }
+        RenderItem item;
+
+        item.shader = shader;
+        item.skeleton = skeleton && skeleton->isMeshWithBones() ? skeleton : nullptr;
+        item.owner = this;
 
         unique_lock < mutex > lk(mtx);
         ready = false;
 
-        shader->setMat4("localTransform", localTransform);        
-        shader->setMat4("model", getPhysicsObjectTransform());
+        item.localTransform = localTransform;
+        item.model = getPhysicsObjectTransform();
 
         ready = true;
         lk.unlock();
         cv.notify_all();
-        
-        /* minimal diffuse value */
-        shader->setFloat("minNormalCosAngle", minNormalCosAngle);
-        /* is static */
-        shader->setInt("isStatic", viewStatic);
+
+        item.minNormalCosAngle = minNormalCosAngle;
+        item.viewStatic = viewStatic;
+        item.cull = cull;
+        item.instanced = true;
 
         for (size_t i = 0; i < meshes.size(); i++)
         {
-            meshes[i]->render(shader, true);
+            item.mesh = meshes[i];
+
+            renderQueue->add(item);
         }
-        
-        glEnable(GL_CULL_FACE);
     }
 }
 
@@ -37,7 +37,7 @@ class InstancedGameObject : public GameObject
 
         void genInstances();
 
-        void render(Shader* shader, bool viewCull = true) override;
+        void collect(RenderQueue* renderQueue, Shader* shader, bool viewCull = true) override;
 
         ~InstancedGameObject();        
 };
@@ -1,10 +1,13 @@
 #include "../shader/shader.hpp"
 
+#include "glstatecache.hpp"
 #include "mesh.hpp"
 
 using namespace std;
 using namespace glm;
 
+map < vector < GLuint >, unsigned int > Mesh::materials;
+
 Mesh::Mesh(vector < Vertex > &v, vector < unsigned int > &i, vector < Texture > &t)
 {
     vertices = v; 
@@ -14,6 +17,7 @@ Mesh::Mesh(vector < Vertex > &v, vector < unsigned int > &i, vector < Texture >
     instanceAmount = 0;
 
     setupMesh(); 
+    setupMaterial();
 }
 
 void Mesh::setupMesh()
@@ -78,18 +82,18 @@ void Mesh::setupInstancedMesh(vector < mat4 > &transformations)
     glBindVertexArray(0); 
 }
 
-void Mesh::render(Shader *shader, bool instanced) const
+void Mesh::setupMaterial()
 {
     unsigned int normalNR = 1;
     unsigned int diffuseNR = 1;
     unsigned int metallicNR = 1;
     unsigned int roughnessNR = 1;
     unsigned int aoNR = 1; 
+
+    vector < GLuint > textureIDs;
         
     for (size_t i = 0; i < textures.size(); i++)
     {
-        glActiveTexture(GL_TEXTURE0 + i);
-
         string number;
         
         if (textures[i].type == "texture_normal")
@@ -113,42 +117,55 @@ void Mesh::render(Shader *shader, bool instanced) const
             number = to_string(aoNR++);
         }
 
-        //cout << "material." + textures[i].type + number << endl;
-        //cout << textures[i].id << endl;
-
-        shader->setInt("material." + textures[i].type + number, i);
-        glBindTexture(GL_TEXTURE_2D, textures[i].id);
+        textureNames.push_back("material." + textures[i].type + number);
+        textureIDs.push_back(textures[i].id);
     }
 
-    if (normalNR == 1)
+    normalMapped = normalNR != 1;
+
+    auto it = materials.find(textureIDs);
+
+    if (it == materials.end())
     {
-        shader->setInt("meshNormalMapped", 0);
+        it = materials.insert({textureIDs, materials.size()}).first;
     }
-    else
+
+    materialID = it->second;
+}
+
+void Mesh::render(Shader *shader, GLStateCache* state, bool instanced) const
+{
+    /* same material as the last draw, nothing gets rebound */
+    for (size_t i = 0; i < textures.size(); i++)
     {
-        shader->setInt("meshNormalMapped", 1); 
+        state->setInt(shader, textureNames[i], i);
+        state->bindTexture(i, textures[i].id);
     }
 
-    glBindVertexArray(VAO); // bind VAO
+    state->setInt(shader, "meshNormalMapped", normalMapped);
+
+    state->bindVertexArray(VAO);
 
     if (!instanced)
     {
-        shader->setInt("meshInstanced", 0);
+        state->setInt(shader, "meshInstanced", 0);
         glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0); // draw mesh from indices 
     }
     else
     {
-        shader->setInt("meshInstanced", 1);
+        state->setInt(shader, "meshInstanced", 1);
         glDrawElementsInstanced(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0, instanceAmount);
     }
+}
 
-    glBindVertexArray(0); // unbind VAO
-    
-    for (size_t i = 0; i < textures.size(); i++)
-    {
-        glActiveTexture(GL_TEXTURE0 + i);
-        glBindTexture(GL_TEXTURE_2D, 0);
-    }
+unsigned int Mesh::getMaterialID() const
+{
+    return materialID;
+}
+
+GLuint Mesh::getVAO() const
+{
+    return VAO;
 }
 
 vector < Mesh::Vertex > Mesh::getVertices() const
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <map>
+#include <vector>
+#include <string>
+
 #include <glm/glm.hpp>
 
 using namespace std;
@@ -39,14 +43,26 @@ class Mesh
         vector < GLuint > indices; 
         vector < Texture > textures; 
 
+        /* sampler uniform of each texture, "material." + type + number */
+        vector < string > textureNames;
+        bool normalMapped;
+
+        /* meshes with the same textures share the material, the render queue sorts by it */
+        unsigned int materialID;
+        static map < vector < GLuint >, unsigned int > materials;
+
         void setupMesh(); 
+        void setupMaterial();
 
     public:
         Mesh (vector < Vertex > &v, vector < unsigned int > &i, vector < Texture > &t);
 
         void setupInstancedMesh(vector < mat4 > &transformations);
 
-        void render(Shader *shader, bool instanced = false) const; 
+        void render(Shader *shader, GLStateCache* state, bool instanced = false) const; 
+
+        unsigned int getMaterialID() const;
+        GLuint getVAO() const;
 
         vector < Vertex > getVertices() const;
 
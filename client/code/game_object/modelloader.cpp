@@ -1,14 +1,17 @@
 #include "../global/globaluse.hpp"
 
 #include "../shader/shader.hpp"
+#include "../shader/uniformbuffer.hpp"
 
 #include "../window/renderquad.hpp"
 #include "../window/glfwevents.hpp"
 #include "../window/window.hpp"
 
 #include "animation.hpp"
+#include "glstatecache.hpp"
 #include "mesh.hpp"
 #include "bone.hpp"
+#include "animationclip.hpp"
 #include "skeleton.hpp"
 #include "modelloader.hpp"
 
@@ -472,10 +475,8 @@ vector < AnimationData* > ModelLoader::findAiNodeAnims(string name) const
         map < string, AnimationData* >::const_iterator it;
         it = animations[i].find(name);
 
-        if (it != animations[i].end()) 
-        {
-            animation.push_back(it->second); 
-        }
+        /* indexed by the animation, a bone without keys in one gets a hole */
+        animation.push_back(it != animations[i].end() ? it->second : nullptr); 
     }
 
     return animation;
@@ -0,0 +1,117 @@
+#include "../shader/shader.hpp"
+#include "../shader/uniformbuffer.hpp"
+
+#include "animation.hpp"
+#include "glstatecache.hpp"
+#include "mesh.hpp"
+#include "bone.hpp"
+#include "animationclip.hpp"
+#include "skeleton.hpp"
+#include "renderqueue.hpp"
+
+RenderQueue::RenderQueue()
+{
+    state = new GLStateCache();
+
+    clear();
+}
+
+void RenderQueue::add(RenderItem& item)
+{
+    /* every object with bones gets its own group, after all the others */
+    if (item.skeleton && item.owner != lastSkinned)
+    {
+        skinned++;
+        lastSkinned = item.owner;
+    }
+
+    unsigned long long program = item.shader->getID() & 0xFF;
+    unsigned long long group = item.skeleton ? skinned & 0xFFFF : 0;
+    unsigned long long material = item.mesh->getMaterialID() & 0xFFFFF;
+    unsigned long long vertexArray = item.mesh->getVAO() & 0xFFFFF;
+
+    item.key = (program << 56) | (group << 40) | (material << 20) | vertexArray;
+
+    order.push_back({item.key, items.size()});
+    items.push_back(item);
+}
+
+void RenderQueue::render()
+{
+    /* equal keys keep the order they came in */
+    sort(order.begin(), order.end());
+
+    state->reset();
+
+    Shader* shader = nullptr;
+    const void* owner = nullptr;
+    bool instanced = false;
+
+    Uniform < mat4 > localTransform, model;
+
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        const RenderItem& item = items[order[i].second];
+
+        if (item.shader != shader)
+        {
+            shader = item.shader;
+            owner = nullptr;
+
+            state->useProgram(shader);
+
+            localTransform = Uniform < mat4 >(shader, "localTransform");
+            model = Uniform < mat4 >(shader, "model");
+        }
+
+        /* the object uniforms only change with the object */
+        if (item.owner != owner || item.instanced != instanced)
+        {
+            owner = item.owner;
+            instanced = item.instanced;
+
+            if (item.skeleton)
+            {
+                item.skeleton->bindPalette();
+                state->setInt(shader, "meshWithBones", 1);
+            }
+            else
+            {
+                state->setInt(shader, "meshWithBones", 0);
+            }
+
+            localTransform.set(item.localTransform);
+            model.set(item.model);
+
+            /* minimal diffuse value */
+            state->setFloat(shader, "minNormalCosAngle", item.minNormalCosAngle);
+            /* isStatic */
+            state->setInt(shader, "isStatic", item.viewStatic);
+        }
+
+        state->setCullFace(item.cull);
+
+        item.mesh->render(shader, state, item.instanced);
+    }
+
+    /* what the rest of the renderer expects */
+    state->setCullFace(true);
+    state->bindVertexArray(0);
+    state->unbindTextures();
+
+    clear();
+}
+
+void RenderQueue::clear()
+{
+    items.clear();
+    order.clear();
+
+    skinned = 0;
+    lastSkinned = nullptr;
+}
+
+RenderQueue::~RenderQueue()
+{
+    delete state;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+using namespace std;
+using namespace glm;
+
+/* one mesh of one object in one pass */
+struct RenderItem
+{
+    unsigned long long key;
+
+    Shader* shader;
+    const Mesh* mesh;
+    Skeleton* skeleton; /* only with bones, its palette is bound before its draws */
+
+    const void* owner; /* the items of one object share it */
+
+    mat4 model;
+    mat4 localTransform;
+
+    float minNormalCosAngle;
+    bool viewStatic;
+    bool cull;
+    bool instanced;
+};
+
+/*
+ * the draws of a pass, sorted by shader -> object with bones -> material -> VAO
+ * and sent through the state cache, so the textures and the VAO are only bound
+ * when they change. the objects with bones stay in one piece, they bind a bone
+ * palette of their own
+ */
+class RenderQueue
+{
+    private:
+        GLStateCache* state;
+
+        vector < RenderItem > items;
+        vector < pair < unsigned long long, unsigned int > > order;
+
+        unsigned int skinned; /* objects with bones in the queue */
+        const void* lastSkinned;
+
+    public:
+        RenderQueue();
+
+        void add(RenderItem& item);
+
+        void render();
+        void clear();
+
+        ~RenderQueue();
+};
@@ -1,6 +1,7 @@
 #include "../global/globaluse.hpp"
 
 #include "../shader/shader.hpp"
+#include "../shader/uniformbuffer.hpp"
 
 #include "../window/glfwevents.hpp"
 #include "../window/renderquad.hpp"
@@ -18,13 +19,17 @@
 #include "sphere.hpp"
 #include "openglmotionstate.hpp"
 #include "animation.hpp"
+#include "glstatecache.hpp"
 #include "mesh.hpp"
 #include "bone.hpp"
+#include "animationclip.hpp"
 #include "skeleton.hpp"
 #include "viewfrustum.hpp"
 #include "boundsphere.hpp"
 #include "modelloader.hpp"
 #include "physicsobject.hpp"
+#include "transformbuffer.hpp"
+#include "renderqueue.hpp"
 #include "gameobject.hpp"
 #include "weapon.hpp"
 #include "rifle.hpp"
@@ -1,10 +1,13 @@
 #include "../global/globaluse.hpp"
 
 #include "../shader/shader.hpp"
+#include "../shader/uniformbuffer.hpp"
 
+#include "glstatecache.hpp"
 #include "mesh.hpp"
 #include "animation.hpp"
 #include "bone.hpp"
+#include "animationclip.hpp"
 #include "skeleton.hpp"
 
 using namespace std;
@@ -16,43 +19,144 @@ Skeleton::Skeleton(map < string, Bone* > &bones)
     this->bones = bones; 
     meshWithBones = !bones.empty();
 
+    map < Bone*, int > indices;
+
+    for (auto& it : bones)
+    {
+        addBone(it.second, indices);
+    }
+
+    globals.resize(order.size());
+    palette.assign(MAX_BONES_AMOUNT, mat4(1.0));
+
+    paletteBuffer = nullptr;
+    poseDirty = true;
+
+    /* the keys are searched here and never again */
+    int clipsAmount = order.empty() ? 0 : order[0]->getAnimationsAmount();
+
+    for (int i = 0; i < clipsAmount; i++)
+    {
+        clips.push_back(new AnimationClip(order, i));
+    }
+
+    sampleAnimation = -1;
+    sampleFrame = 0.0;
+
+    fadeSampleAnimation = -1;
+    fadeSampleFrame = 0.0;
+    fadeWeight = 1.0;
+
     activeAnimation = nullptr;
+
+    fadeAnimation = nullptr;
+    fadeTime = fadeElapsed = 0.0;
 }
 
-void Skeleton::renderBonesMatrices(Shader* shader)
+int Skeleton::addBone(Bone* bone, map < Bone*, int > &indices)
 {
-    shader->setInt("meshWithBones", meshWithBones); 
+    auto it = indices.find(bone);
 
-    if (!bones.empty()) 
+    if (it != indices.end())
     {
-        bonesMatrices.clear(); 
+        return it->second;
+    }
 
-        int index = 0;
-        map < string, Bone* >::iterator it = bones.begin();
+    int parent = bone->getParent() ? addBone(bone->getParent(), indices) : -1;
+
+    order.push_back(bone);
+    parents.push_back(parent);
+    ids.push_back(bone->getId());
+    offsets.push_back(bone->getOffset());
+    /* the bind pose, the bones without keys in an animation keep it */
+    locals.push_back(global.aiMatrix4x4ToGlm(bone->getNode()->mTransformation));
+
+    indices.insert({bone, order.size() - 1});
+
+    return order.size() - 1;
+}
 
-        for (int i = 0; i < MAX_BONES_AMOUNT; i++, it++) 
+void Skeleton::buildPose()
+{
+    if (sampleAnimation >= 0)
+    {
+        const AnimationClip* clip = clips[sampleAnimation];
+        const AnimationClip* fadeClip = fadeSampleAnimation >= 0 ? clips[fadeSampleAnimation] : nullptr;
+
+        clip->sample(sampleFrame, positions, rotations);
+
+        if (fadeClip)
         {
-            if (i >= int(bones.size())) 
+            fadeClip->sample(fadeSampleFrame, fadePositions, fadeRotations);
+        }
+
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            bool current = clip->isAnimated(i);
+            bool faded = fadeClip && fadeClip->isAnimated(i);
+
+            if (current && faded)
+            {
+                locals[i] = translate(mix(fadePositions[i], positions[i], fadeWeight)) * mat4_cast(slerp(fadeRotations[i], rotations[i], fadeWeight));
+            }
+            else if (current)
             {
-                bonesMatrices.push_back(mat4(1.0)); 
-                index = i;
+                locals[i] = translate(positions[i]) * mat4_cast(rotations[i]);
             }
-            else
+            else if (faded)
             {
-                mat4 res = it->second->getFullTransform() * it->second->getOffset(); 
+                locals[i] = translate(fadePositions[i]) * mat4_cast(fadeRotations[i]);
+            }
+        }
 
-                bonesMatrices.push_back(res); 
+        sampleAnimation = -1;
+        fadeSampleAnimation = -1;
+    }
 
-                index = it->second->getId();
-            }
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        globals[i] = parents[i] < 0 ? locals[i] : globals[parents[i]] * locals[i];
 
-            shader->setMat4("bones[" + to_string(index) + "]", bonesMatrices[i]); 
+        if (ids[i] < MAX_BONES_AMOUNT)
+        {
+            palette[ids[i]] = globals[i] * offsets[i];
         }
     }
+
+    if (!paletteBuffer)
+    {
+        paletteBuffer = new UniformBuffer(BONES_BLOCK_BINDING, sizeof(mat4) * MAX_BONES_AMOUNT);
+    }
+
+    paletteBuffer->update(palette.data());
+
+    poseDirty = false;
+}
+
+void Skeleton::bindPalette()
+{
+    if (poseDirty)
+    {
+        buildPose();
+    }
+
+    paletteBuffer->bind();
 }
 
-void Skeleton::playAnimation(Animation* anim, bool reset)
+void Skeleton::playAnimation(Animation* anim, bool reset, float fade)
 {
+    /* the old one keeps playing under the new one for a while */
+    if (fade > 0.0 && activeAnimation && activeAnimation != anim)
+    {
+        fadeAnimation = activeAnimation;
+        fadeTime = fade;
+        fadeElapsed = 0.0;
+    }
+    else
+    {
+        fadeAnimation = nullptr;
+    }
+
     activeAnimation = anim;
     
     if (reset)
@@ -68,67 +172,77 @@ void Skeleton::stopAnimation()
         return;
     }
 
-    for (auto& it : bones) 
+    if (activeAnimation->getAnimId() >= 0 && activeAnimation->getAnimId() < int(clips.size()))
     {
-        it.second->updateKeyframeTransform(activeAnimation->getAnimId(), 0); 
+        sampleAnimation = activeAnimation->getAnimId();
+        sampleFrame = 0;
+        poseDirty = true;
     }
     
     activeAnimation = nullptr;
+    fadeAnimation = nullptr;
 }
         
 Animation* Skeleton::getAnimation() const
 {
     return activeAnimation;
 }
-        
-void Skeleton::setBonesMatrices(vector < mat4 > &bonesMatrices)
-{
-    this->bonesMatrices = bonesMatrices;
-    meshWithBones = !bonesMatrices.empty();
-}
-
-vector < mat4 > Skeleton::getBonesMatrices() const
-{
-    return bonesMatrices;
-}
 
 bool Skeleton::isMeshWithBones() const
 {
     return meshWithBones;
 }
 
-void Skeleton::update(Shader *shader)
+/* once a frame with the frame time, the culled ones only step their clocks */
+void Skeleton::update(float deltaTime)
 { 
-    renderBonesMatrices(shader); 
-    
-    if (!activeAnimation) 
+    if (!activeAnimation || activeAnimation->getAnimId() < 0 || activeAnimation->getAnimId() >= int(clips.size())) 
     {
         return; 
     }
 
+    const AnimationClip* clip = clips[activeAnimation->getAnimId()];
+
     /* default speed */
     if (!activeAnimation->getSpeed())
     {
-        map < string, Bone* >::iterator it = bones.begin();
-        activeAnimation->setSpeed(it->second->getAnimation(activeAnimation->getAnimId())->speed);
+        activeAnimation->setSpeed(clip->getSpeed());
     }
         
     /* default frames range */
     if (activeAnimation->getFramesRange().y == 0.0)
     {
-        map < string, Bone* >::iterator it = bones.begin();
-
-        activeAnimation->setFramesRange(vec2(activeAnimation->getFramesRange().x, it->second->getAnimation(activeAnimation->getAnimId())->duration));
+        activeAnimation->setFramesRange(vec2(activeAnimation->getFramesRange().x, clip->getDuration()));
         activeAnimation->fromStart();
     }
-    
-    for (auto& it : bones) 
+
+    sampleAnimation = activeAnimation->getAnimId();
+    sampleFrame = activeAnimation->getCurFrame();
+    poseDirty = true;
+
+    fadeSampleAnimation = -1;
+
+    if (fadeAnimation)
     {
-        it.second->updateKeyframeTransform(activeAnimation->getAnimId(), activeAnimation->getCurFrame()); 
+        fadeElapsed += std::min(deltaTime, float(ANIMATION_MAX_STEP));
+
+        if (fadeElapsed >= fadeTime || fadeAnimation->getAnimId() < 0 || fadeAnimation->getAnimId() >= int(clips.size()))
+        {
+            fadeAnimation = nullptr;
+        }
+        else
+        {
+            fadeSampleAnimation = fadeAnimation->getAnimId();
+            fadeSampleFrame = fadeAnimation->getCurFrame();
+            fadeWeight = fadeElapsed / fadeTime;
+
+            /* a finished one holds its last frame */
+            fadeAnimation->advance(deltaTime);
+        }
     }
     
     /* next frame */
-    if (!activeAnimation->nextFrame())
+    if (!activeAnimation->advance(deltaTime))
     {
         stopAnimation();
     }
@@ -140,4 +254,11 @@ Skeleton::~Skeleton()
     {
         delete it.second;
     } 
+
+    for (size_t i = 0; i < clips.size(); i++)
+    {
+        delete clips[i];
+    }
+
+    delete paletteBuffer;
 }
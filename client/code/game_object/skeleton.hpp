@@ -13,31 +13,64 @@ using namespace glm;
 
 #define MAX_BONES_AMOUNT 50
 
+/*
+ * the bones are kept parents first with the index of their parent, so the global
+ * transforms are one pass over the arrays. the pose is built once a frame on the
+ * first draw and stays in a uniform buffer for every pass after it
+ */
 class Skeleton
 {
     private:
         bool meshWithBones;
 
         map < string, Bone* > bones; 
-        vector < mat4 > bonesMatrices; 
+
+        vector < Bone* > order; 
+        vector < int > parents; /* -1 for a root */
+        vector < int > ids; 
+        vector < mat4 > offsets; 
+        vector < mat4 > locals; 
+        vector < mat4 > globals; 
+        vector < mat4 > palette; /* by bone id, as the shaders read it */
+
+        UniformBuffer* paletteBuffer;
+        bool poseDirty;
+
+        /* by the animation id */
+        vector < AnimationClip* > clips; 
+
+        /* the last frames asked for, sampled when the pose is built */
+        int sampleAnimation;
+        float sampleFrame;
+
+        int fadeSampleAnimation;
+        float fadeSampleFrame;
+        float fadeWeight;
+
+        vector < vec3 > positions, fadePositions; 
+        vector < quat > rotations, fadeRotations; 
 
         Animation* activeAnimation; 
 
-        void renderBonesMatrices(Shader* shader); 
+        /* the animation faded out of, seconds */
+        Animation* fadeAnimation; 
+        float fadeTime;
+        float fadeElapsed;
+
+        int addBone(Bone* bone, map < Bone*, int > &indices);
+        void buildPose();
         
     public:
         Skeleton(map < string, Bone* > &bones);
 
-        void playAnimation(Animation* anim, bool reset = true); 
+        void playAnimation(Animation* anim, bool reset = true, float fade = 0.0); 
         void stopAnimation(); 
         Animation* getAnimation() const;
 
-        void setBonesMatrices(vector < mat4 > &bonesMatrices);
-
-        vector < mat4 > getBonesMatrices() const;
         bool isMeshWithBones() const;
 
-        void update(Shader* shader); 
+        void update(float deltaTime); 
+        void bindPalette();
 
         ~Skeleton();
 };
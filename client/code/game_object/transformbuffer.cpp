@@ -0,0 +1,112 @@
+#include "transformbuffer.hpp"
+
+TransformBuffer::TransformBuffer() {}
+
+mat4 TransformBuffer::compose(const vec3& position, const quat& rotation) const
+{
+    mat4 transform = mat4_cast(rotation);
+    transform[3] = vec4(position, 1.0);
+
+    return transform;
+}
+
+void TransformBuffer::push(unsigned int tick, const mat4& transform)
+{
+    State state;
+
+    state.tick = tick;
+    state.position = vec3(transform[3]);
+    state.rotation = normalize(quat_cast(mat3(transform)));
+
+    unique_lock < mutex > lk(mtx);
+
+    /* a new server timeline, the old states are useless */
+    if (!states.empty() && state.tick + TRANSFORM_BUFFER_RESET < states.back().tick)
+    {
+        states.clear();
+    }
+
+    /* keep it sorted, a late datagram still fills its gap */
+    auto it = states.end();
+
+    while (it != states.begin() && (it - 1)->tick >= state.tick)
+    {
+        it--;
+    }
+
+    if (it != states.end() && it->tick == state.tick)
+    {
+        *it = state;
+        return;
+    }
+
+    if (it == states.begin() && states.size() >= TRANSFORM_BUFFER_SIZE)
+    {
+        return;
+    }
+
+    states.insert(it, state);
+
+    while (states.size() > TRANSFORM_BUFFER_SIZE)
+    {
+        states.pop_front();
+    }
+}
+
+bool TransformBuffer::sample(double tick, mat4& transform) const
+{
+    unique_lock < mutex > lk(mtx);
+
+    if (states.empty())
+    {
+        return false;
+    }
+
+    /* before the oldest one, hold it */
+    if (tick <= states.front().tick || states.size() == 1)
+    {
+        transform = compose(states.front().position, states.front().rotation);
+        return true;
+    }
+
+    const State& last = states.back();
+
+    /* late, keep the last velocity for a while, then stop */
+    if (tick >= last.tick)
+    {
+        const State& prev = states[states.size() - 2];
+
+        double interval = last.tick - prev.tick;
+        double ahead = std::min(tick - last.tick, interval * TRANSFORM_BUFFER_EXTRAPOLATION);
+
+        vec3 velocity = (last.position - prev.position) / float(interval);
+
+        transform = compose(last.position + velocity * float(ahead), last.rotation);
+        return true;
+    }
+
+    size_t i = 1;
+
+    while (states[i].tick < tick)
+    {
+        i++;
+    }
+
+    const State& a = states[i - 1];
+    const State& b = states[i];
+
+    float t = (tick - a.tick) / (b.tick - a.tick);
+
+    transform = compose(mix(a.position, b.position, t), slerp(a.rotation, b.rotation, t));
+
+    return true;
+}
+
+void TransformBuffer::clear()
+{
+    unique_lock < mutex > lk(mtx);
+
+    states.clear();
+}
+
+TransformBuffer::~TransformBuffer() {}
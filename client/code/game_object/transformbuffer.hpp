@@ -0,0 +1,47 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#define TRANSFORM_BUFFER_SIZE 16 /* server states kept per entity */
+#define TRANSFORM_BUFFER_EXTRAPOLATION 1.0 /* how far past the newest state, in the intervals between the last two */
+#define TRANSFORM_BUFFER_RESET 600 /* ticks back in time, the server started over */
+
+using namespace std;
+using namespace glm;
+
+/*
+ * jitter buffer of one remote entity. the states are keyed by the server tick,
+ * so it doesn't matter when or how often they arrive, sample() places the entity
+ * anywhere on that timeline: position lerp, rotation slerp, short extrapolation
+ */
+class TransformBuffer
+{
+    private:
+        struct State
+        {
+            double tick;
+            vec3 position;
+            quat rotation;
+        };
+
+        deque < State > states;
+
+        mutable mutex mtx;
+
+        mat4 compose(const vec3& position, const quat& rotation) const;
+
+    public:
+        TransformBuffer();
+
+        void push(unsigned int tick, const mat4& transform);
+        bool sample(double tick, mat4& transform) const;
+
+        void clear();
+
+        ~TransformBuffer();
+};
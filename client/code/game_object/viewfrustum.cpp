@@ -32,8 +32,8 @@ void ViewFrustum::updateFrustum(mat4 view, mat4 projection)
 
     mat4 clip = projection * view;
 
-    //near plane
-    frustum[0].setData(clip[0][2], clip[1][2], clip[2][2], clip[3][2]);
+    //near plane, -w <= z, an ortho box of a light starts at the middle otherwise
+    frustum[0].setData(clip[0][3] + clip[0][2], clip[1][3] + clip[1][2], clip[2][3] + clip[2][2], clip[3][3] + clip[3][2]);
                                               
     //far plane                               
     frustum[1].setData(clip[0][3] - clip[0][2], clip[1][3] - clip[1][2], clip[2][3] - clip[2][2], clip[3][3] - clip[3][2]);
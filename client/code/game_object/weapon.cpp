@@ -1,6 +1,7 @@
 #include "../global/globaluse.hpp"
 
 #include "../shader/shader.hpp"
+#include "../shader/uniformbuffer.hpp"
 
 #include "../window/glfwevents.hpp"
 #include "../window/renderquad.hpp"
@@ -18,13 +19,17 @@
 #include "sphere.hpp"
 #include "openglmotionstate.hpp"
 #include "animation.hpp"
+#include "glstatecache.hpp"
 #include "mesh.hpp"
 #include "bone.hpp"
+#include "animationclip.hpp"
 #include "skeleton.hpp"
 #include "viewfrustum.hpp"
 #include "boundsphere.hpp"
 #include "modelloader.hpp"
 #include "physicsobject.hpp"
+#include "transformbuffer.hpp"
+#include "renderqueue.hpp"
 #include "gameobject.hpp"
 #include "weapon.hpp"
         
@@ -105,6 +110,7 @@ void Weapon::drop(vec3 where, bool active)
     
     setVisible(true);
     physicsObject->setCollidable(true);
+    physicsObject->setStatic(false);
 
     if (active)
     {
@@ -234,7 +240,7 @@ void Weapon::updateStatus()
     {
         if (anim->getName() == "reload1" || anim->getName() == "reload2")
         {
-            if (anim->getEndFrame() > 0.0 && anim->getCurFrame() + anim->getSpeed() > anim->getEndFrame())
+            if (anim->getEndFrame() > 0.0 && anim->getCurFrame() + anim->getStep() > anim->getEndFrame())
             {
                 int toMove = std::min(storageBullets, magazineSize - magazineBullets);
 
@@ -138,8 +138,6 @@ void Atmosphere::renderAtmosphere(Shader* shader)
     shader->setInt("jSteps", jBeauty);
 
     shader->setVec3("rayOrigin", rayOrigin);
-    shader->setVec3("sunPos", sunPos);
-    shader->setFloat("sunIntensity", sunIntensity);
     shader->setFloat("planetRadius", planetRadius);
     shader->setFloat("atmoRadius", atmoRadius);
     shader->setVec3("rayleighCoeff", rayleighCoeff);
@@ -185,6 +183,11 @@ vec3 Atmosphere::getSunPos() const
     return sunPos;
 }
 
+float Atmosphere::getSunIntensity() const
+{
+    return sunIntensity;
+}
+
 vec3 Atmosphere::getSunAxis() const
 {
     return axis;
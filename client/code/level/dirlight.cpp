@@ -11,22 +11,27 @@
 #include "../global/gaussianblur.hpp"
 #include "../global/gaussianblur.cpp"
 
+#include "../debug/debugdrawer.hpp"
+
 #include "../game_object/sphere.hpp"
+#include "../game_object/viewfrustum.hpp"
 
 #include "dirlightsoftshadow.hpp"
+#include "dirlightcascade.hpp"
 #include "dirlight.hpp"
 
 DirLight::DirLight()
 {
     direction = color = vec3(0.0);
     coeff = 1.0;
-    shadowViewOffset = 0.0;
-
-    shadowView = shadowProjection = mat4(1.0);
 
     sphere = new Sphere();
 
-    shadow = new DirLightSoftShadow();
+    shadowDistance = 100.0;
+    splitLambda = 0.5;
+    shadowDepth = 50.0;
+    cacheMargin = 0.2;
+    cacheAngle = 0.5;
     
     scatterBuffer = new ColorBuffer();
     radialBlur = new RadialBlur();
@@ -37,13 +42,14 @@ DirLight::DirLight(vec3 direction, vec3 color)
     this->direction = direction;
     this->color = color;
     coeff = 1.0;
-    shadowViewOffset = 0.0;
-
-    shadowView = shadowProjection = mat4(1.0);
 
     sphere = new Sphere();
 
-    shadow = new DirLightSoftShadow();
+    shadowDistance = 100.0;
+    splitLambda = 0.5;
+    shadowDepth = 50.0;
+    cacheMargin = 0.2;
+    cacheAngle = 0.5;
     
     scatterBuffer = new ColorBuffer();
     radialBlur = new RadialBlur();
@@ -51,7 +57,10 @@ DirLight::DirLight(vec3 direction, vec3 color)
 
 void DirLight::genShadowBuffer(int width, int height)
 {
-    shadow->genBuffer(width, height);
+    for (size_t i = 0; i < cascades.size(); i++)
+    {
+        cascades[i]->genBuffer(width, height);
+    }
 }
 
 void DirLight::genShadowBuffer(vec2 size)
@@ -117,22 +126,57 @@ void DirLight::setRadialWeight(float weight)
 
 void DirLight::setShadowIntensity(float intensity)
 {
-    shadow->setIntensity(intensity);
+    for (size_t i = 0; i < cascades.size(); i++)
+    {
+        cascades[i]->setIntensity(intensity);
+    }
 }
 
 void DirLight::setShadowBias(float bias)
 {
-    shadow->setBias(bias);
+    for (size_t i = 0; i < cascades.size(); i++)
+    {
+        cascades[i]->setBias(bias);
+    }
 }
 
 void DirLight::setShadowSoftness(float softness)
 {
-    shadow->setSoftness(softness);
+    for (size_t i = 0; i < cascades.size(); i++)
+    {
+        cascades[i]->setSoftness(softness);
+    }
 }
-        
-void DirLight::setShadowViewOffset(float offset)
+
+void DirLight::setShadowCascades(int count, float distance, float lambda)
+{
+    for (size_t i = 0; i < cascades.size(); i++)
+    {
+        delete cascades[i];
+    }
+
+    cascades.clear();
+
+    count = std::max(1, std::min(count, DIR_LIGHT_MAX_CASCADES));
+
+    for (int i = 0; i < count; i++)
+    {
+        cascades.push_back(new DirLightCascade());
+    }
+
+    shadowDistance = distance;
+    splitLambda = lambda;
+}
+
+void DirLight::setShadowDepth(float depth)
 {
-    this->shadowViewOffset = offset;
+    shadowDepth = depth;
+}
+
+void DirLight::setShadowCache(float margin, float angle)
+{
+    cacheMargin = margin;
+    cacheAngle = angle;
 }
 
 vec3 DirLight::getDirection() const
@@ -140,14 +184,22 @@ vec3 DirLight::getDirection() const
     return direction;
 }
 
-void DirLight::setShadowProjection(mat4 projection)
+bool DirLight::isShadow() const
+{
+    return !cascades.empty();
+}
+
+const vector < DirLightCascade* >& DirLight::getShadowCascades() const
 {
-    this->shadowProjection = projection;
+    return cascades;
 }
 
 void DirLight::blurShadow(int intensity, float radius)
 {
-    shadow->blurShadow(intensity, radius);
+    for (size_t i = 0; i < cascades.size(); i++)
+    {
+        cascades[i]->blurShadow(intensity, radius);
+    }
 }
 
 void DirLight::blurScatter(vec2 center)
@@ -167,16 +219,15 @@ void DirLight::renderShadow(Shader* shader, GLuint index)
     shader->setVec3("dirLights[" + to_string(index) + "].color", color);
     shader->setFloat("dirLights[" + to_string(index) + "].coeff", coeff);
 
-    GLuint shadowTexture = getShadowTexture();
-
-    if (shadowTexture)
+    if (isShadow())
     {
         shader->setInt("dirLights[" + to_string(index) + "].isShadow", 1);
+        shader->setInt("dirLights[" + to_string(index) + "].cascades", cascades.size());
 
-        shadow->render(shader, index);
-
-        shader->setMat4("dirLights[" + to_string(index) + "].shadowView", getShadowView());
-        shader->setMat4("dirLights[" + to_string(index) + "].shadowProjection", getShadowProjection());
+        for (size_t i = 0; i < cascades.size(); i++)
+        {
+            cascades[i]->render(shader, index, i);
+        }
     }
     else
     {
@@ -200,11 +251,6 @@ void DirLight::renderLight(Shader* shader)
     glBindTexture(GL_TEXTURE_2D, getScatterTexture());
 }
 
-GLuint DirLight::getShadowTexture() const
-{
-    return shadow->getTexture();
-}
-
 GLuint DirLight::getScatterTexture() const
 {
     if (radialBlur->getBuffer() && radialBlur->getTexture())
@@ -219,42 +265,79 @@ GLuint DirLight::getScatterTexture() const
     return 0;
 }
 
-ShadowBuffer* DirLight::getShadowBuffer() const
-{
-    return shadow->getBuffer();
-}
-
 ColorBuffer* DirLight::getScatterBuffer() const
 {
     return scatterBuffer;
 }
 
-void DirLight::updateShadowView(vec3 playerPosition, vec3 playerForward)
+/* splits the view of the camera and fits a cascade to every slice */
+void DirLight::updateShadowCascades(mat4 view, mat4 projection)
 {
-    playerForward = normalize(playerForward);
-    vec3 offset = playerForward * shadowViewOffset;
+    /* out of the perspective projection */
+    float near = projection[3][2] / (projection[2][2] - 1.0);
+    float far = projection[3][2] / (projection[2][2] + 1.0);
 
-    shadowView = lookAt(offset + playerPosition, offset + playerPosition + normalize(direction), vec3(0, 1, 0));
-}
+    float distance = std::min(far, shadowDistance);
 
-Sphere* DirLight::getSphere() const
-{
-    return sphere;
+    mat4 invViewProjection = inverse(projection * view);
+
+    /* the rays through the corners of the view, a slice is cut out of them by depth */
+    vec3 nearCorners[4];
+    vec3 farCorners[4];
+
+    for (int i = 0; i < 4; i++)
+    {
+        vec2 ndc = vec2(i & 1 ? 1.0 : -1.0, i & 2 ? 1.0 : -1.0);
+
+        vec4 nearCorner = invViewProjection * vec4(ndc, -1.0, 1.0);
+        vec4 farCorner = invViewProjection * vec4(ndc, 1.0, 1.0);
+
+        nearCorners[i] = vec3(nearCorner) / nearCorner.w;
+        farCorners[i] = vec3(farCorner) / farCorner.w;
+    }
+
+    vector < vec3 > corners(8);
+
+    float sliceNear = near;
+
+    for (size_t i = 0; i < cascades.size(); i++)
+    {
+        /* lambda blends the even split and the logarithmic one */
+        float k = float(i + 1) / cascades.size();
+        float sliceFar = mix(near + (distance - near) * k, near * pow(distance / near, k), splitLambda);
+
+        for (int j = 0; j < 4; j++)
+        {
+            corners[j] = mix(nearCorners[j], farCorners[j], (sliceNear - near) / (far - near));
+            corners[j + 4] = mix(nearCorners[j], farCorners[j], (sliceFar - near) / (far - near));
+        }
+
+        cascades[i]->fit(corners, direction, shadowDepth, cacheMargin, cacheAngle);
+
+        sliceNear = sliceFar;
+    }
 }
 
-mat4 DirLight::getShadowView() const
+/* a static caster came or went, every cascade draws them again */
+void DirLight::clearShadowCache()
 {
-    return shadowView;
+    for (size_t i = 0; i < cascades.size(); i++)
+    {
+        cascades[i]->setStaticDirty(true);
+    }
 }
 
-mat4 DirLight::getShadowProjection() const
+Sphere* DirLight::getSphere() const
 {
-    return shadowProjection;
+    return sphere;
 }
 
 DirLight::~DirLight()
 {
-    delete shadow;
+    for (size_t i = 0; i < cascades.size(); i++)
+    {
+        delete cascades[i];
+    }
 
     delete scatterBuffer;
     delete radialBlur;
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <vector>
+
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#define DIR_LIGHT_MAX_CASCADES 3 /* as SHADOW_CASCADES of objectShader.frag */
+
 using namespace std;
 using namespace glm;
 
@@ -13,13 +17,17 @@ class DirLight
         vec3 direction;
         vec3 color;
         float coeff;
-        float shadowViewOffset;
-
-        mat4 shadowView, shadowProjection;
 
         Sphere* sphere;
 
-        DirLightSoftShadow* shadow;
+        /* the view split up to shadowDistance, nearest first */
+        vector < DirLightCascade* > cascades;
+
+        float shadowDistance;
+        float splitLambda;
+        float shadowDepth;
+        float cacheMargin;
+        float cacheAngle;
 
         ColorBuffer* scatterBuffer;
         RadialBlur* radialBlur;
@@ -48,12 +56,14 @@ class DirLight
         void setShadowIntensity(float intensity);
         void setShadowBias(float bias);
         void setShadowSoftness(float softness);
-        void setShadowViewOffset(float offset);
 
-        void setShadowProjection(mat4 projection);
+        void setShadowCascades(int count, float distance, float lambda);
+        void setShadowDepth(float depth);
+        void setShadowCache(float margin, float angle);
 
         vec3 getDirection() const;
-        ShadowBuffer* getShadowBuffer() const;
+        bool isShadow() const;
+        const vector < DirLightCascade* >& getShadowCascades() const;
         ColorBuffer* getScatterBuffer() const;
        
         void blurShadow(int intensity, float radius);
@@ -62,15 +72,12 @@ class DirLight
         void renderShadow(Shader* shader, GLuint index);
         void renderSphere(Shader* shader);
         void renderLight(Shader* shader);
-        void updateShadowView(vec3 playerPosition, vec3 playerForward);
+        void updateShadowCascades(mat4 view, mat4 projection);
+        void clearShadowCache();
 
         Sphere* getSphere() const;
 
-        GLuint getShadowTexture() const;
         GLuint getScatterTexture() const;
 
-        mat4 getShadowView() const;
-        mat4 getShadowProjection() const;
-
         ~DirLight();
 };
@@ -0,0 +1,190 @@
+#include "../global/globaluse.hpp"
+
+#include "../shader/shader.hpp"
+
+#include "../framebuffer/framebuffer.hpp"
+#include "../framebuffer/colorbuffer.hpp"
+#include "../framebuffer/depthbuffer.hpp"
+#include "../framebuffer/shadowbuffer.hpp"
+
+#include "../window/renderquad.hpp"
+
+#include "../global/gaussianblur.hpp"
+
+#include "../debug/debugdrawer.hpp"
+
+#include "../game_object/viewfrustum.hpp"
+
+#include "dirlightsoftshadow.hpp"
+#include "dirlightcascade.hpp"
+
+DirLightCascade::DirLightCascade()
+{
+    shadow = new DirLightSoftShadow();
+    staticBuffer = new ShadowBuffer();
+
+    frustum = new ViewFrustum();
+
+    view = projection = mat4(1.0);
+
+    center = direction = vec3(0.0);
+    radius = 0.0;
+
+    fitted = false;
+    staticDirty = true;
+
+    width = 1;
+}
+
+void DirLightCascade::genBuffer(int width, int height)
+{
+    this->width = width;
+
+    shadow->genBuffer(width, height);
+
+    staticBuffer->genBuffer(width, height,
+            {
+                {GL_R32F, GL_RED, GL_FLOAT}
+            });
+
+    staticDirty = true;
+}
+
+void DirLightCascade::setIntensity(float intensity)
+{
+    shadow->setIntensity(intensity);
+}
+
+void DirLightCascade::setBias(float bias)
+{
+    shadow->setBias(bias);
+}
+
+void DirLightCascade::setSoftness(float softness)
+{
+    shadow->setSoftness(softness);
+}
+
+void DirLightCascade::fit(const vector < vec3 >& corners, vec3 direction, float depth, float margin, float angle)
+{
+    direction = normalize(direction);
+
+    /* the sphere doesn't change with the view rotation, only its center moves */
+    vec3 sliceCenter = vec3(0.0);
+
+    for (size_t i = 0; i < corners.size(); i++)
+    {
+        sliceCenter += corners[i];
+    }
+
+    sliceCenter /= float(corners.size());
+
+    float sliceRadius = 0.0;
+
+    for (size_t i = 0; i < corners.size(); i++)
+    {
+        sliceRadius = std::max(sliceRadius, length(corners[i] - sliceCenter));
+    }
+
+    float boxRadius = sliceRadius * (1.0 + margin);
+
+    /* the box still holds the slice, the sun is where it was and the view kept its projection */
+    if (fitted &&
+        dot(direction, this->direction) >= cos(radians(angle)) &&
+        abs(boxRadius - radius) <= boxRadius * 0.01 &&
+        length(sliceCenter - center) + sliceRadius <= radius)
+    {
+        return;
+    }
+
+    vec3 up = abs(direction.y) > 0.99 ? vec3(0, 0, 1) : vec3(0, 1, 0);
+
+    /* whole texels in the light plane, a refit doesn't make the edges crawl */
+    mat4 lightRotation = lookAt(vec3(0.0), direction, up);
+
+    float texel = 2.0 * boxRadius / width;
+
+    vec3 lightCenter = vec3(lightRotation * vec4(sliceCenter, 1.0));
+
+    lightCenter.x = floor(lightCenter.x / texel) * texel;
+    lightCenter.y = floor(lightCenter.y / texel) * texel;
+
+    center = vec3(inverse(lightRotation) * vec4(lightCenter, 1.0));
+
+    /* the casters up to depth toward the sun still land in the box */
+    view = lookAt(center - direction * (boxRadius + depth), center, up);
+    projection = ortho(-boxRadius, boxRadius, -boxRadius, boxRadius, 0.0f, 2.0f * boxRadius + depth);
+
+    frustum->updateFrustum(view, projection);
+
+    this->direction = direction;
+    radius = boxRadius;
+
+    fitted = true;
+    staticDirty = true;
+}
+
+void DirLightCascade::restoreStatic()
+{
+    shadow->getBuffer()->copyColorBuffer(0, staticBuffer, 0);
+    shadow->getBuffer()->copyDepthBuffer(staticBuffer);
+}
+
+void DirLightCascade::setStaticDirty(bool dirty)
+{
+    staticDirty = dirty;
+}
+
+bool DirLightCascade::isStaticDirty() const
+{
+    return staticDirty;
+}
+
+void DirLightCascade::blurShadow(int intensity, float radius)
+{
+    shadow->blurShadow(intensity, radius);
+}
+
+void DirLightCascade::render(Shader* shader, int index, int cascade)
+{
+    shadow->render(shader, index, cascade);
+
+    shader->setMat4("dirLights[" + to_string(index) + "].shadowViewProjection[" + to_string(cascade) + "]", projection * view);
+}
+
+ShadowBuffer* DirLightCascade::getBuffer() const
+{
+    return shadow->getBuffer();
+}
+
+ShadowBuffer* DirLightCascade::getStaticBuffer() const
+{
+    return staticBuffer;
+}
+
+ViewFrustum* DirLightCascade::getFrustum() const
+{
+    return frustum;
+}
+
+GLuint DirLightCascade::getTexture() const
+{
+    return shadow->getTexture();
+}
+
+mat4 DirLightCascade::getView() const
+{
+    return view;
+}
+
+mat4 DirLightCascade::getProjection() const
+{
+    return projection;
+}
+
+DirLightCascade::~DirLightCascade()
+{
+    delete shadow;
+    delete staticBuffer;
+    delete frustum;
+}
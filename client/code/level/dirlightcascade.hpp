@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+using namespace std;
+using namespace glm;
+
+/*
+ * one slice of the view in the dir light shadow. the light box is fitted to the bounding
+ * sphere of the slice plus a margin and stays put until the slice leaves the margin or the
+ * sun turns, so the static casters are drawn once into their own buffer and only copied
+ * under the moving ones every frame
+ */
+class DirLightCascade
+{
+    private:
+        DirLightSoftShadow* shadow;
+        ShadowBuffer* staticBuffer;
+
+        ViewFrustum* frustum;
+
+        mat4 view, projection;
+
+        vec3 center;
+        vec3 direction;
+        float radius;
+
+        bool fitted;
+        bool staticDirty;
+
+        int width;
+
+    public:
+        DirLightCascade();
+
+        void genBuffer(int width, int height);
+
+        void setIntensity(float intensity);
+        void setBias(float bias);
+        void setSoftness(float softness);
+
+        void fit(const vector < vec3 >& corners, vec3 direction, float depth, float margin, float angle);
+
+        void restoreStatic();
+        void setStaticDirty(bool dirty);
+        bool isStaticDirty() const;
+
+        void blurShadow(int intensity, float radius);
+
+        void render(Shader* shader, int index, int cascade);
+
+        ShadowBuffer* getBuffer() const;
+        ShadowBuffer* getStaticBuffer() const;
+        ViewFrustum* getFrustum() const;
+
+        GLuint getTexture() const;
+
+        mat4 getView() const;
+        mat4 getProjection() const;
+
+        ~DirLightCascade();
+};
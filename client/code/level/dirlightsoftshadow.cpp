@@ -65,10 +65,10 @@ void DirLightSoftShadow::blurShadow(int intensity, float radius)
     }
 }
 
-void DirLightSoftShadow::render(Shader* shader, int index)
+void DirLightSoftShadow::render(Shader* shader, int index, int cascade)
 {
-    glActiveTexture(GL_TEXTURE0 + 5);
-    shader->setInt("dirLights[" + to_string(index) + "].texture_shadow1", 5);
+    glActiveTexture(GL_TEXTURE0 + DIR_LIGHT_SHADOW_UNIT + cascade);
+    shader->setInt("dirLights[" + to_string(index) + "].texture_shadow[" + to_string(cascade) + "]", DIR_LIGHT_SHADOW_UNIT + cascade);
     glBindTexture(GL_TEXTURE_2D, getTexture());
 
     shader->setFloat("dirLights[" + to_string(index) + "].esmFactor", intensity);
@@ -4,6 +4,8 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#define DIR_LIGHT_SHADOW_UNIT 7 /* the first texture unit of the cascades, one each */
+
 using namespace std;
 using namespace glm;
 
@@ -31,7 +33,7 @@ class DirLightSoftShadow
 
         void blurShadow(int intensity, float radius);
 
-        void render(Shader* shader, int index);
+        void render(Shader* shader, int index, int cascade);
 
         ShadowBuffer* getBuffer() const;
         GLuint getTexture() const;
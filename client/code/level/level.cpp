@@ -1,6 +1,7 @@
 #include "../global/globaluse.hpp"
 
 #include "../shader/shader.hpp"
+#include "../shader/uniformbuffer.hpp"
 
 #include "../framebuffer/framebuffer.hpp"
 #include "../framebuffer/colorbuffer.hpp"
@@ -28,21 +29,28 @@
 #include "../game_object/sphere.hpp"
 #include "../game_object/openglmotionstate.hpp"
 #include "../game_object/animation.hpp"
+#include "../game_object/glstatecache.hpp"
 #include "../game_object/mesh.hpp"
 #include "../game_object/bone.hpp"
+#include "../game_object/animationclip.hpp"
 #include "../game_object/skeleton.hpp"
 #include "../game_object/viewfrustum.hpp"
 #include "../game_object/boundsphere.hpp"
 #include "../game_object/modelloader.hpp"
 #include "../game_object/physicsobject.hpp"
+#include "../game_object/transformbuffer.hpp"
+#include "../game_object/renderqueue.hpp"
 #include "../game_object/gameobject.hpp"
 #include "../game_object/instancedgameobject.hpp"
 #include "../game_object/weapon.hpp"
 #include "../game_object/rifle.hpp"
 
+#include "../player/inputhistory.hpp"
 #include "../player/player.hpp"
+#include "../player/soldier.hpp"
 
 #include "dirlightsoftshadow.hpp"
+#include "dirlightcascade.hpp"
 #include "dirlight.hpp"
 #include "ssao.hpp"
 #include "atmosphere.hpp"
@@ -84,6 +92,8 @@ Level::Level(Window* window, World* physicsWorld)
     viewFrustum = nullptr;
 
     quad = new RenderQuad();
+    renderQueue = new RenderQueue();
+    frameUniforms = new UniformBuffer(FRAME_BLOCK_BINDING, sizeof(FrameData));
 
     /* DEBUG */
     drawDebug = 0;
@@ -162,6 +172,8 @@ void Level::addGameObject(GameObject* gameObject)
     if (gameObjects.find(gameObject->getName()) == gameObjects.end())
     {
         gameObjects.insert({gameObject->getName(), gameObject}); 
+
+        clearShadowCache(gameObject);
     }
 }
 
@@ -180,19 +192,87 @@ map < string, GameObject* > Level::getGameObjects() const
     return gameObjects;
 }
 
+void Level::setNetID(int netID, GameObject* gameObject)
+{
+    if (netID < 0 || !gameObject)
+    {
+        return;
+    }
+
+    if (netID >= (int)netObjects.size())
+    {
+        netObjects.resize(netID + 1, nullptr);
+    }
+
+    netObjects[netID] = gameObject;
+    gameObject->setNetID(netID);
+}
+
+GameObject* Level::getGameObject(int netID) const
+{
+    if (netID < 0 || netID >= (int)netObjects.size())
+    {
+        return nullptr;
+    }
+
+    return netObjects[netID];
+}
+
+vector < GameObject* > Level::getNetObjects() const
+{
+    return netObjects;
+}
+
 void Level::removeGameObject(GameObject* gameObject)
 {
     if (gameObjects.find(gameObject->getName()) != gameObjects.end())
     {
         gameObjects.erase(gameObjects.find(gameObject->getName()));
+
+        clearShadowCache(gameObject);
     }
+
+    replace(netObjects.begin(), netObjects.end(), gameObject, (GameObject*)nullptr);
 }
         
 void Level::removeGameObject(string name)
 {
     if (gameObjects.find(name) != gameObjects.end())
     {
-        gameObjects.erase(gameObjects.find(name));
+        removeGameObject(gameObjects.find(name)->second);
+    }
+}
+
+bool Level::isStaticCaster(GameObject* gameObject) const
+{
+    /* every model has a skeleton, only the ones with bones move on their own */
+    Skeleton* skeleton = gameObject->getSkeleton();
+
+    return gameObject->isShadow() && gameObject->isStatic() && !(skeleton && skeleton->isMeshWithBones());
+}
+
+void Level::clearShadowCache(GameObject* gameObject)
+{
+    if (!isStaticCaster(gameObject))
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < dirLights.size(); i++)
+    {
+        dirLights[i]->clearShadowCache();
+    }
+}
+
+/* the animations step once a frame, a pose is built when it's first drawn */
+void Level::animate(float deltaTime)
+{
+    for (auto& i : gameObjects)
+    {
+        if (i.second->getSkeleton())
+        {
+            i.second->getSkeleton()->update(deltaTime);
+        }
     }
 }
 
@@ -208,6 +288,20 @@ void Level::render()
     mat4 staticView = mat4(mat3(view));
     
     viewFrustum->updateFrustum(view, projection);
+
+    /* everything the passes share about the camera and the sun, set once */
+    FrameData frame;
+
+    frame.projection = projection;
+    frame.view = view;
+    frame.staticView = staticView;
+    frame.viewPos = getConnectedPlayer(true)->getPosition();
+    frame.sunIntensity = atmosphere->getSunIntensity();
+    frame.sunPos = atmosphere->getSunPos();
+    frame.sunGradient = atmosphere->getRelativeSunGradient();
+
+    frameUniforms->update(&frame);
+    frameUniforms->bind();
     
     /************************************
      * DIR SHADOWS
@@ -217,28 +311,56 @@ void Level::render()
     
     for (size_t i = 0; i < dirLights.size(); i++)
     {
-        if (dirLights[i]->getShadowBuffer())
+        if (!dirLights[i]->isShadow())
         {
-            /*** shadow buffer ***/
-            dirLights[i]->getShadowBuffer()->use();
-            /* crucial */
-            dirLights[i]->getShadowBuffer()->clearColor(vec4(1.0, 0.0, 0.0, 1.0));
-            dirLights[i]->getShadowBuffer()->clearDepth();
+            continue;
+        }
+
+        dirLights[i]->updateShadowCascades(view, projection);
 
-            dirLights[i]->updateShadowView(getConnectedPlayer(true)->getPosition(), getConnectedPlayer(true)->getForward());
+        const vector < DirLightCascade* >& cascades = dirLights[i]->getShadowCascades();
 
+        for (DirLightCascade* cascade : cascades)
+        {
             dirShadowShader->use();
 
-            dirShadowShader->setMat4("view", dirLights[i]->getShadowView());
-            dirShadowShader->setMat4("projection", dirLights[i]->getShadowProjection());
+            dirShadowShader->setMat4("view", cascade->getView());
+            dirShadowShader->setMat4("projection", cascade->getProjection());
+
+            /*** static casters, only after the cascade moved ***/
+            if (cascade->isStaticDirty())
+            {
+                cascade->getStaticBuffer()->use();
+                /* crucial */
+                cascade->getStaticBuffer()->clearColor(vec4(1.0, 0.0, 0.0, 1.0));
+                cascade->getStaticBuffer()->clearDepth();
+
+                for (auto& j : gameObjects)
+                {
+                    if (isStaticCaster(j.second) && j.second->isInFrustum(cascade->getFrustum()))
+                    {
+                        j.second->collect(renderQueue, dirShadowShader, false); 
+                    }
+                }
+
+                renderQueue->render();
+
+                cascade->setStaticDirty(false);
+            }
+
+            /*** shadow buffer, the static ones under the moving ones ***/
+            cascade->restoreStatic();
+            cascade->getBuffer()->use();
 
-            for (auto& i : gameObjects)
+            for (auto& j : gameObjects)
             {
-                if (i.second->isShadow())
+                if (j.second->isShadow() && !isStaticCaster(j.second) && j.second->isInFrustum(cascade->getFrustum()))
                 {
-                    i.second->render(dirShadowShader); 
+                    j.second->collect(renderQueue, dirShadowShader, false); 
                 }
             }
+
+            renderQueue->render();
         }
     }
 
@@ -253,32 +375,30 @@ void Level::render()
     gBuffer->clear();
 
     gBufferShader->use();
-    
-    gBufferShader->setMat4("projection", projection);
-
-    gBufferShader->setMat4("view", staticView);
    
-    /* render view static */
+    /* render view static, isStatic picks the static view */
     for (auto& i : gameObjects)
     {
         if (i.second->isViewStatic())
         {
-            i.second->render(gBufferShader); 
+            i.second->collect(renderQueue, gBufferShader); 
         }
     }
+
+    renderQueue->render();
     
     gBuffer->clearDepth();
-    
-    gBufferShader->setMat4("view", view);
 
     /* render normal */
     for (auto& i : gameObjects)
     {
         if (!i.second->isViewStatic())
         {
-            i.second->render(gBufferShader);
+            i.second->collect(renderQueue, gBufferShader);
         }
     }
+
+    renderQueue->render();
     
     /************************************
      * ATMOSPHERE
@@ -294,9 +414,6 @@ void Level::render()
     atmosphere->getBuffer()->use();
     atmosphereShader->use();
 
-    atmosphereShader->setMat4("view", staticView);
-    atmosphereShader->setMat4("projection", projection);
-
     gBuffer->renderStaticDepth(atmosphereShader);
 
     atmosphere->renderAtmosphere(atmosphereShader);
@@ -313,7 +430,6 @@ void Level::render()
     sSAOShader->use();
     
     sSAOShader->setMat4("invProjection", transpose(inverse(projection)));
-    sSAOShader->setMat4("projection", projection);
 
     gBuffer->renderSsao(sSAOShader);
     sSAO->renderInfo(sSAOShader);
@@ -334,8 +450,6 @@ void Level::render()
 
     gameObjectShader->use();
 
-    gameObjectShader->setVec3("viewPos", getConnectedPlayer(true)->getPosition());
-
     for (size_t i = 0; i < dirLights.size(); i++)
     {
         dirLights[i]->blurShadow(1, 1.0);
@@ -378,9 +492,6 @@ void Level::render()
 
             dirSphereShader->use();
 
-            dirSphereShader->setMat4("view", staticView);
-            dirSphereShader->setMat4("projection", projection);
-
             gBuffer->renderStaticDepth(dirSphereShader);
             dirLights[i]->renderSphere(dirSphereShader);
 
@@ -418,10 +529,6 @@ void Level::render()
 
     skyBoxShader->use();
 
-    skyBoxShader->setFloat("alpha", atmosphere->getRelativeSunGradient());
-    skyBoxShader->setMat4("view", staticView);
-    skyBoxShader->setMat4("projection", projection);
-
     gBuffer->renderStaticDepth(skyBoxShader);
     skyBox->render(skyBoxShader);
     
@@ -489,6 +596,23 @@ void Level::updatePlayers(int mode)
     }
 }
 
+void Level::interpolate(double tick)
+{
+    for (auto& i: gameObjects)
+    {
+        i.second->interpolate(tick);
+    }
+
+    /* the net objects the level doesn't know by name */
+    for (size_t i = 0; i < netObjects.size(); i++)
+    {
+        if (netObjects[i] && getGameObject(netObjects[i]->getName()) != netObjects[i])
+        {
+            netObjects[i]->interpolate(tick);
+        }
+    }
+}
+
 void Level::updateSunPos()
 {
     atmosphere->updateSunPos();
@@ -539,6 +663,28 @@ Player* Level::getIDPlayer(int id) const
     return nullptr;
 }
 
+/* a slot without a soldier in the level file gets a copy of the first one */
+Player* Level::addPlayer(int id)
+{
+    Player* player = getIDPlayer(id);
+
+    if (player)
+    {
+        return player;
+    }
+
+    Soldier* soldier = levelLoader->loadSoldier(id);
+
+    if (soldier->getGameObject())
+    {
+        addGameObject(soldier->getGameObject());
+    }
+
+    players.push_back(soldier);
+
+    return soldier;
+}
+
 vector < Player* > Level::getPlayers() const
 {
     return players;
@@ -613,4 +759,6 @@ Level::~Level()
 
     delete viewFrustum;
     delete quad;
+    delete renderQueue;
+    delete frameUniforms;
 }
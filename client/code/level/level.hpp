@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iostream>
+#include <algorithm>
 
 #include <map>
 #include <vector>
@@ -14,6 +15,18 @@
 using namespace std;
 using namespace glm;
 
+/* the std140 Frame block of the shaders, vec3 + float fill a row */
+struct FrameData
+{
+    mat4 projection;
+    mat4 view;
+    mat4 staticView;
+    vec3 viewPos;
+    float sunIntensity;
+    vec3 sunPos;
+    float sunGradient;
+};
+
 class Level
 {
     private:
@@ -42,6 +55,7 @@ class Level
 
         /* all objects in the level */
         map < string, GameObject* > gameObjects;
+        vector < GameObject* > netObjects; /* indexed by the server net id */
         vector < DirLight* > dirLights;
 
         SSAO* sSAO; 
@@ -53,6 +67,8 @@ class Level
 
         ViewFrustum* viewFrustum;
         RenderQuad* quad;
+        RenderQueue* renderQueue;
+        UniformBuffer* frameUniforms;
         
         mat4 projection;
 
@@ -61,6 +77,9 @@ class Level
         Player* virtualPlayer;
         int activeVirtualPlayer;
 
+        bool isStaticCaster(GameObject* gameObject) const;
+        void clearShadowCache(GameObject* gameObject);
+
     public:
         Level(Window* window, World* physicsWorld);
         
@@ -72,16 +91,23 @@ class Level
         GameObject* getGameObject(string name) const;
         map < string, GameObject* > getGameObjects() const;
 
+        void setNetID(int netID, GameObject* gameObject);
+        GameObject* getGameObject(int netID) const;
+        vector < GameObject* > getNetObjects() const;
+
         void removeGameObject(GameObject* gameObject);
         void removeGameObject(string name);
         
+        void animate(float deltaTime);
         void render();
         void updatePlayers(int mode);
+        void interpolate(double tick);
         void updateSunPos();
 
         GLuint getRenderTexture(unsigned int num = 0) const;
         Player* getConnectedPlayer(bool andVirtual = false) const;
         Player* getIDPlayer(int id) const;
+        Player* addPlayer(int id);
         vector < Player* > getPlayers() const;
         vec3 getSunPosition() const;
 
@@ -1,6 +1,7 @@
 #include "../global/globaluse.hpp"
 
 #include "../shader/shader.hpp"
+#include "../shader/uniformbuffer.hpp"
 
 #include "../framebuffer/framebuffer.hpp"
 #include "../framebuffer/colorbuffer.hpp"
@@ -27,24 +28,30 @@
 #include "../game_object/sphere.hpp"
 #include "../game_object/openglmotionstate.hpp"
 #include "../game_object/animation.hpp"
+#include "../game_object/glstatecache.hpp"
 #include "../game_object/mesh.hpp"
 #include "../game_object/bone.hpp"
+#include "../game_object/animationclip.hpp"
 #include "../game_object/skeleton.hpp"
 #include "../game_object/viewfrustum.hpp"
 #include "../game_object/boundsphere.hpp"
 #include "../game_object/modelloader.hpp"
 #include "../game_object/physicsobject.hpp"
+#include "../game_object/transformbuffer.hpp"
+#include "../game_object/renderqueue.hpp"
 #include "../game_object/gameobject.hpp"
 #include "../game_object/instancedgameobject.hpp"
 #include "../game_object/weapon.hpp"
 #include "../game_object/rifle.hpp"
 
+#include "../player/inputhistory.hpp"
 #include "../player/player.hpp"
 #include "../player/soldier.hpp"
 
 #include "ssao.hpp"
 #include "atmosphere.hpp"
 #include "dirlightsoftshadow.hpp"
+#include "dirlightcascade.hpp"
 #include "dirlight.hpp"
 #include "skybox.hpp"
 #include "levelloader.hpp"
@@ -305,10 +312,16 @@ void LevelLoader::loadDebugObject(XMLElement* debugObjectElem, GameObject*& GO)
     }
 }
 
-void LevelLoader::loadGameObject(XMLElement* gameObjectElem, GameObject*& GO)
+void LevelLoader::loadGameObject(XMLElement* gameObjectElem, GameObject*& GO, string name)
 {
-    const char* name = nullptr;
-    gameObjectElem->QueryStringAttribute("name", &name);
+    /* the name of the XML unless the caller has its own */
+    if (name.empty())
+    {
+        const char* tmp = nullptr;
+        gameObjectElem->QueryStringAttribute("name", &tmp);
+
+        name = tmp;
+    }
 
     GO = new GameObject(window, name);
 
@@ -637,16 +650,6 @@ void LevelLoader::loadDirLight()
             DL->setColor(vec3(r, g, b));
         }
         
-        XMLElement* offsetElem = dirLightElem->FirstChildElement("shadowviewoffset");
-
-        if (offsetElem)
-        {
-            float offset = 0.0;
-            offsetElem->QueryFloatAttribute("offset", &offset);
-
-            DL->setShadowViewOffset(offset);
-        }
-
         /* scatter */
         XMLElement* scatterElem = dirLightElem->FirstChildElement("scatter");
 
@@ -762,6 +765,20 @@ void LevelLoader::loadDirLight()
 
         if (shadowElem)
         {
+            XMLElement* cascadesElem = shadowElem->FirstChildElement("cascades");
+
+            int count = 1;
+            float distance = 100.0, lambda = 0.5;
+
+            if (cascadesElem)
+            {
+                cascadesElem->QueryIntAttribute("count", &count);
+                cascadesElem->QueryFloatAttribute("distance", &distance);
+                cascadesElem->QueryFloatAttribute("lambda", &lambda);
+            }
+
+            DL->setShadowCascades(count, distance, lambda);
+
             XMLElement* shadowBufferElem = shadowElem->FirstChildElement("shadowbuffer");
 
             float x = 500, y = 500;
@@ -807,12 +824,28 @@ void LevelLoader::loadDirLight()
 
             DL->setShadowSoftness(scale);
 
-            XMLElement* projElem = shadowElem->FirstChildElement("projection");
+            XMLElement* depthElem = shadowElem->FirstChildElement("depth");
 
-            mat4 shadowProj = mat4(1.0);
-            loadProjection(projElem, shadowProj);
+            float depth = 50.0;
 
-            DL->setShadowProjection(shadowProj);
+            if (depthElem)
+            {
+                depthElem->QueryFloatAttribute("depth", &depth);
+            }
+
+            DL->setShadowDepth(depth);
+
+            XMLElement* cacheElem = shadowElem->FirstChildElement("cache");
+
+            float margin = 0.2, angle = 0.5;
+
+            if (cacheElem)
+            {
+                cacheElem->QueryFloatAttribute("margin", &margin);
+                cacheElem->QueryFloatAttribute("angle", &angle);
+            }
+
+            DL->setShadowCache(margin, angle);
         }
 
         if (find(dirLights.begin(), dirLights.end(), DL) == dirLights.end())
@@ -1302,143 +1335,199 @@ void LevelLoader::loadVirtualPlayer()
     }
 }
 
-void LevelLoader::loadSoldiers()
+Soldier* LevelLoader::loadSoldier(XMLElement* soldierElem, int playerID, bool copy)
 {
-    XMLDocument soldierDoc;
+    /* position */
+    XMLElement* positionElem = soldierElem->FirstChildElement("position");
+    vec3 position(0.0);
 
-    soldierDoc.LoadFile((levelName + "/soldier.xml").c_str());
+    if (positionElem)
+    {
+        float x = 0, y = 0, z = 0;
+        positionElem->QueryFloatAttribute("x", &x);
+        positionElem->QueryFloatAttribute("y", &y);
+        positionElem->QueryFloatAttribute("z", &z);
 
-    XMLNode* root = soldierDoc.FirstChildElement("SoldierFile");
+        position = vec3(x, y, z);
+    }
 
-    if (!root)
+    /* forward */
+    XMLElement* forwardElem = soldierElem->FirstChildElement("forward");
+    vec3 forward(0.0);
+
+    if (forwardElem)
     {
-        throw runtime_error("ERROR::loadSoldiers() failed to load XML");
+        float x = 0, y = 0, z = 0;
+        forwardElem->QueryFloatAttribute("x", &x);
+        forwardElem->QueryFloatAttribute("y", &y);
+        forwardElem->QueryFloatAttribute("z", &z);
+
+        forward = vec3(x, y, z);
     }
 
-    XMLNode* soldierNode = root->FirstChildElement("soldiers"); 
-    XMLElement* soldierElem = soldierNode->FirstChildElement("soldier");
+    /* speed */
+    XMLElement* speedElem = soldierElem->FirstChildElement("speed");
+    float speed = 1.0;
 
-    while (soldierElem)
+    if (speedElem)
     {
-        /* playerID */
-        int playerID;
+        speedElem->QueryFloatAttribute("speed", &speed);
+    }
 
-        soldierElem->QueryIntAttribute("id", &playerID);
+    Soldier* soldier = new Soldier(playerID, window, position, forward, speed);
 
-        /* position */
-        XMLElement* positionElem = soldierElem->FirstChildElement("position");
-        vec3 position(0.0);
+    /* game object */
+    XMLElement* gameObjectElem = soldierElem->FirstChildElement("gameobject");
 
-        if (positionElem)
-        {
-            float x = 0, y = 0, z = 0;
-            positionElem->QueryFloatAttribute("x", &x);
-            positionElem->QueryFloatAttribute("y", &y);
-            positionElem->QueryFloatAttribute("z", &z);
+    if (gameObjectElem)
+    {
+        GameObject* GO = nullptr;
 
-            position = vec3(x, y, z);
-        }
+        /* the template's object keeps its name, a copy gets one of its own */
+        loadGameObject(gameObjectElem, GO, copy ? "soldier" + to_string(playerID) : "");
 
-        /* forward */
-        XMLElement* forwardElem = soldierElem->FirstChildElement("forward");
-        vec3 forward(0.0);
+        gameObjects.insert({GO->getName(), GO});
 
-        if (forwardElem)
-        {
-            float x = 0, y = 0, z = 0;
-            forwardElem->QueryFloatAttribute("x", &x);
-            forwardElem->QueryFloatAttribute("y", &y);
-            forwardElem->QueryFloatAttribute("z", &z);
+        soldier->setGameObject(GO);
+    }
 
-            forward = vec3(x, y, z);
-        }
+    /* visible */
+    XMLElement* activeElem = soldierElem->FirstChildElement("active");
 
-        /* speed */
-        XMLElement* speedElem = soldierElem->FirstChildElement("speed");
-        float speed = 1.0;
+    if (activeElem && !copy)
+    {
+        bool active = false;
 
-        if (speedElem)
+        activeElem->QueryBoolAttribute("active", &active);
+
+        soldier->setActive(active);
+    }
+
+    /* raytracer */
+    XMLElement* rayTracerElem = soldierElem->FirstChildElement("raytracer");
+
+    if (rayTracerElem)
+    {
+        bool apply = false;
+
+        rayTracerElem->QueryBoolAttribute("apply", &apply);
+
+        if (apply)
         {
-            speedElem->QueryFloatAttribute("speed", &speed);
+            RayTracer* rayTracer = new RayTracer(physicsWorld->getWorld(), nullptr, projection);     
+
+            soldier->setRayTracer(rayTracer);
+            rayTracer->setCamera(soldier);
         }
+    }
 
-        Soldier* soldier = new Soldier(playerID, window, position, forward, speed);
+    /* camera offset */
+    XMLElement* cameraOffsetElem = soldierElem->FirstChildElement("cameraoffset");
 
-        /* game object */
-        XMLElement* gameObjectElem = soldierElem->FirstChildElement("gameobject");
+    if (cameraOffsetElem)
+    {
+        float x = 0, y = 0, z = 0;
 
-        if (gameObjectElem)
-        {
-            GameObject* GO = nullptr;
-            loadGameObject(gameObjectElem, GO);
+        cameraOffsetElem->QueryFloatAttribute("x", &x);
+        cameraOffsetElem->QueryFloatAttribute("y", &y);
+        cameraOffsetElem->QueryFloatAttribute("z", &z);
 
-            gameObjects.insert({GO->getName(), GO});
+        soldier->setCameraOffset(vec3(x, y, z));
+    }
 
-            soldier->setGameObject(GO);
-        }
+    /* model offset */
+    XMLElement* modelOffsetElem = soldierElem->FirstChildElement("modeloffset");
 
-        /* visible */
-        XMLElement* activeElem = soldierElem->FirstChildElement("active");
+    if (modelOffsetElem)
+    {
+        float x = 0, y = 0, z = 0;
 
-        if (activeElem)
-        {
-            bool active = false;
+        modelOffsetElem->QueryFloatAttribute("x", &x);
+        modelOffsetElem->QueryFloatAttribute("y", &y);
+        modelOffsetElem->QueryFloatAttribute("z", &z);
 
-            activeElem->QueryBoolAttribute("active", &active);
+        soldier->setModelOffset(vec3(x, y, z));
+    }
 
-            soldier->setActive(active);
-        }
+    return soldier;
+}
 
-        /* raytracer */
-        XMLElement* rayTracerElem = soldierElem->FirstChildElement("raytracer");
+void LevelLoader::loadSoldiers()
+{
+    XMLDocument soldierDoc;
 
-        if (rayTracerElem)
-        {
-            bool apply = false;
+    soldierDoc.LoadFile((levelName + "/soldier.xml").c_str());
 
-            rayTracerElem->QueryBoolAttribute("apply", &apply);
+    XMLNode* root = soldierDoc.FirstChildElement("SoldierFile");
 
-            if (apply)
-            {
-                RayTracer* rayTracer = new RayTracer(physicsWorld->getWorld(), nullptr, projection);     
+    if (!root)
+    {
+        throw runtime_error("ERROR::loadSoldiers() failed to load XML");
+    }
 
-                soldier->setRayTracer(rayTracer);
-                rayTracer->setCamera(soldier);
-            }
-        }
+    XMLNode* soldierNode = root->FirstChildElement("soldiers"); 
+    XMLElement* soldierElem = soldierNode->FirstChildElement("soldier");
 
-        /* camera offset */
-        XMLElement* cameraOffsetElem = soldierElem->FirstChildElement("cameraoffset");
+    while (soldierElem)
+    {
+        /* playerID */
+        int playerID;
 
-        if (cameraOffsetElem)
-        {
-            float x = 0, y = 0, z = 0;
+        soldierElem->QueryIntAttribute("id", &playerID);
 
-            cameraOffsetElem->QueryFloatAttribute("x", &x);
-            cameraOffsetElem->QueryFloatAttribute("y", &y);
-            cameraOffsetElem->QueryFloatAttribute("z", &z);
+        players.push_back(loadSoldier(soldierElem, playerID, false));
 
-            soldier->setCameraOffset(vec3(x, y, z));
-        }
+        soldierElem = soldierElem->NextSiblingElement();
+    }
+}
 
-        /* model offset */
-        XMLElement* modelOffsetElem = soldierElem->FirstChildElement("modeloffset");
+Soldier* LevelLoader::loadSoldier(int id)
+{
+    XMLDocument soldierDoc;
 
-        if (modelOffsetElem)
-        {
-            float x = 0, y = 0, z = 0;
+    soldierDoc.LoadFile((levelName + "/soldier.xml").c_str());
 
-            modelOffsetElem->QueryFloatAttribute("x", &x);
-            modelOffsetElem->QueryFloatAttribute("y", &y);
-            modelOffsetElem->QueryFloatAttribute("z", &z);
+    XMLNode* root = soldierDoc.FirstChildElement("SoldierFile");
+
+    if (!root || !root->FirstChildElement("soldiers"))
+    {
+        throw runtime_error("ERROR::loadSoldier() failed to load XML");
+    }
+
+    /* the soldier with this id or the first one as a template, like the server does */
+    XMLElement* soldierElem = root->FirstChildElement("soldiers")->FirstChildElement("soldier");
+    XMLElement* templateElem = soldierElem;
+
+    while (soldierElem)
+    {
+        int soldierID = -1;
+        soldierElem->QueryIntAttribute("id", &soldierID);
 
-            soldier->setModelOffset(vec3(x, y, z));
+        if (soldierID == id)
+        {
+            break;
         }
 
-        players.push_back(soldier);
+        soldierElem = soldierElem->NextSiblingElement("soldier");
+    }
 
-        soldierElem = soldierElem->NextSiblingElement();
+    bool found = soldierElem;
+
+    if (!found)
+    {
+        soldierElem = templateElem;
     }
+
+    if (!soldierElem)
+    {
+        throw runtime_error("ERROR::loadSoldier() no soldier to load");
+    }
+
+    Soldier* soldier = loadSoldier(soldierElem, id, !found);
+
+    players.push_back(soldier);
+
+    return soldier;
 }
 
 void LevelLoader::loadLevel(string name)
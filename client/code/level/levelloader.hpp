@@ -44,7 +44,7 @@ class LevelLoader
         void loadGraphicsObject(XMLElement* graphicsObjectElem, GameObject*& GO);
         void loadDebugObject(XMLElement* debugObjectElem, GameObject*& GO);
 
-        void loadGameObject(XMLElement* gameObjectElem, GameObject*& GO);
+        void loadGameObject(XMLElement* gameObjectElem, GameObject*& GO, string name = "");
         void loadInstancedGameObject(XMLElement* instancedGameObjectElem, InstancedGameObject*& IGO);
         void loadRifle(XMLElement* rifleElem, Rifle*& rifle);
 
@@ -61,6 +61,7 @@ class LevelLoader
         void loadProjection();
 
         void loadVirtualPlayer();
+        Soldier* loadSoldier(XMLElement* soldierElem, int playerID, bool copy);
         void loadSoldiers();
 
     public:
@@ -68,6 +69,8 @@ class LevelLoader
 
         void loadLevel(string name);
 
+        Soldier* loadSoldier(int id);
+
         void getGameObjectsData(map < string, GameObject* > &gameObjects) const;
         void getDirLightData(vector < DirLight* > &dirLights) const;
         void getSkyBoxData(SkyBox*& skyBox) const;
@@ -137,10 +137,7 @@ void SSAO::renderInfo(Shader* shader)
     shader->setInt("texture_noise", 1);
     glBindTexture(GL_TEXTURE_2D, texture_noise);
 
-    for (size_t i = 0; i < kernel.size(); i++)
-    {
-        shader->setVec3("sphereSamples[" + to_string(i) + "]", kernel[i]);    
-    }
+    Uniform < vec3 >(shader, "sphereSamples").set(kernel.data(), kernel.size());
 
     shader->setVec2("renderSize", renderSize);
 }
@@ -1,10 +1,20 @@
+#include "messagebuffer.hpp"
 #include "client.hpp"
 
 Client::Client()
 {
+    messageBuffer = new MessageBuffer();
+
     sock = 0;
+    udp_sock = -1;
     ready = true;
     lastMsg = "";
+
+    datagramBound = false;
+    memset(datagramSeqs, 0, sizeof(datagramSeqs));
+
+    sentBytes = 0;
+    receivedBytes = 0;
 }
         
 void Client::connectToServer(string ip, int port, int timeoutSec)
@@ -68,9 +78,21 @@ void Client::connectToServer(string ip, int port, int timeoutSec)
     arg = fcntl(sock, F_GETFL, NULL);
     arg &= ~O_NONBLOCK;
     fcntl(sock, F_SETFL, arg);
+
+    /* snapshots, only the server may talk to it */
+    udp_sock = socket(AF_INET, SOCK_DGRAM, 0);
+
+    if (udp_sock < 0 || connect(udp_sock, (struct sockaddr*) &addr, sizeof(addr)) < 0)
+    {
+        throw(runtime_error("ERROR::Client::connectToServer() udp socket"));
+    }
+
+    arg = fcntl(udp_sock, F_GETFL, NULL);
+    arg |= O_NONBLOCK;
+    fcntl(udp_sock, F_SETFL, arg);
 }
 
-void Client::sendMSG(string data, bool force)
+void Client::sendMSG(string data, unsigned char type, bool force)
 {
     if (data.empty() || data == "" || (data == lastMsg && !force))
     {
@@ -78,100 +100,181 @@ void Client::sendMSG(string data, bool force)
     }
 
     lastMsg = data;
-    send(sock, data.data(), data.size(), 0);
+
+    /* typed length header + payload without gluing them together */
+    char header[FRAME_HEADER_SIZE];
+    MessageBuffer::writeHeader(header, data.size(), type);
+
+    struct iovec iov[2];
+    iov[0].iov_base = header;
+    iov[0].iov_len = FRAME_HEADER_SIZE;
+    iov[1].iov_base = (void*)data.data();
+    iov[1].iov_len = data.size();
+
+    size_t total = FRAME_HEADER_SIZE + data.size();
+    size_t sent = 0;
+
+    while (sent < total)
+    {
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+
+        /* skip what is already out */
+        int first = sent < FRAME_HEADER_SIZE ? 0 : 1;
+        size_t offset = first ? sent - FRAME_HEADER_SIZE : sent;
+
+        struct iovec part[2] = {iov[0], iov[1]};
+        part[first].iov_base = (char*)part[first].iov_base + offset;
+        part[first].iov_len -= offset;
+
+        msg.msg_iov = part + first;
+        msg.msg_iovlen = 2 - first;
+
+        int bytes_sent = sendmsg(sock, &msg, MSG_NOSIGNAL);
+
+        if (bytes_sent < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            cerr << "ERROR::Client::sendMSG(); code " << errno << " = " << strerror(errno) << endl;
+            return;
+        }
+
+        sent += bytes_sent;
+    }
+
+    sentBytes += total;
 }
 
-void Client::constructFineMessage(char* buffer, int size, int curMsg, int begOffset)
-{ 
-    /* BEG */
-    if (!buffer || size <= 0)
+void Client::bindDatagrams(int id, unsigned int token)
+{
+    if (isDatagramBound() || udp_sock < 0)
     {
-        messages.clear();
         return;
     }
 
-    if (begOffset >= size)
+    char hello[CLIENT_DATAGRAM_HEADER_SIZE + 8];
+    memset(hello, 0, sizeof(hello));
+
+    hello[0] = char(CLIENT_DATAGRAM_HELLO);
+
+    for (int i = 0; i < 4; i++)
     {
-        return;
+        hello[CLIENT_DATAGRAM_HEADER_SIZE + i] = char(((unsigned int)id >> (i * 8)) & 0xFF);
+        hello[CLIENT_DATAGRAM_HEADER_SIZE + 4 + i] = char((token >> (i * 8)) & 0xFF);
+    }
+
+    /* lost ones are repeated by the caller until the server answers */
+    if (send(udp_sock, hello, sizeof(hello), MSG_DONTWAIT | MSG_NOSIGNAL) > 0)
+    {
+        sentBytes += sizeof(hello);
     }
+}
 
-    string tmp(buffer, size);
+void Client::checkDatagrams()
+{
+    char buffer[CLIENT_DATAGRAM_SIZE];
 
-    if ((int)messages.size() <= curMsg)
+    while (true)
     {
-        messages.push_back({"", false});
+        int bytes_read = recv(udp_sock, buffer, sizeof(buffer), MSG_DONTWAIT);
 
-        size_t beg = tmp.find("BEG", begOffset);
-        if (beg != string::npos)
+        if (bytes_read < 0)
         {
-            size_t end = tmp.find("END", beg + 3);
-            if (end != string::npos)
+            if (errno == EINTR)
             {
-                messages[curMsg].first = tmp.substr(beg + 3, end - beg - 3);
-                messages[curMsg].second = true;
-
-                constructFineMessage(buffer, size, curMsg + 1, end + 3);
-                return;
+                continue;
             }
-            else
-            {
-                messages[curMsg].first = tmp.substr(beg + 3);
-                messages[curMsg].second = false;
 
-                return;
-            }
+            return;
         }
-    }
-    else
-    {
-        size_t end = tmp.find("END", begOffset);
-        if (end != string::npos)
+
+        receivedBytes += bytes_read;
+
+        if (bytes_read < CLIENT_DATAGRAM_HEADER_SIZE)
         {
-            messages[curMsg].first += tmp.substr(begOffset, end);
-            messages[curMsg].second = true;
+            continue;
+        }
 
-            constructFineMessage(buffer, size, curMsg + 1, end + 3);
-            return;
+        unsigned char channel = buffer[0];
+
+        /* the server answered the hello */
+        if (channel == CLIENT_DATAGRAM_HELLO)
+        {
+            datagramBound = true;
+            continue;
         }
-        else
+
+        if (channel >= CLIENT_DATAGRAM_CHANNELS)
         {
-            messages[curMsg].first += tmp;
-            messages[curMsg].second = false;
+            continue;
+        }
 
-            return;
+        unsigned int seq = 0;
+
+        for (int i = 0; i < 4; i++)
+        {
+            seq |= (unsigned int)(unsigned char)buffer[1 + i] << (i * 8);
         }
-    }
 
-    return;
-    /* END */
+        /* duplicated or overtaken by a newer one */
+        if (seq <= datagramSeqs[channel])
+        {
+            continue;
+        }
+
+        datagramSeqs[channel] = seq;
+
+        messages.emplace_back(buffer + CLIENT_DATAGRAM_HEADER_SIZE, bytes_read - CLIENT_DATAGRAM_HEADER_SIZE);
+    }
 }
 
 void Client::recvMSG(int size, int timeoutSec)
 {
-    FD_ZERO(&fds);
-    FD_SET(sock, &fds);
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(timeoutSec);
 
-    timeout.tv_sec = timeoutSec;
-    timeout.tv_usec = 0;
-
-    if (select(sock + 1, &fds, NULL, NULL, &timeout))
+    while (true)
     {
-        char* buffer = new char[size + 1];
+        bool queued = false;
+
+        {
+            unique_lock < mutex > lk(mtx);
+            queued = !messages.empty();
+        }
+
+        /* only wait while there is nothing to hand out */
+        long long left = queued ? 0 : chrono::duration_cast < chrono::microseconds >(deadline - chrono::steady_clock::now()).count();
+
+        FD_ZERO(&fds);
+        FD_SET(sock, &fds);
+
+        if (udp_sock >= 0)
+        {
+            FD_SET(udp_sock, &fds);
+        }
+
+        timeout.tv_sec = max(0LL, left) / 1000000;
+        timeout.tv_usec = max(0LL, left) % 1000000;
+
+        if (select(max(sock, udp_sock) + 1, &fds, NULL, NULL, &timeout) <= 0)
+        {
+            return;
+        }
 
         unique_lock < mutex > lk(mtx);
         ready = false;
-        
-        int last = 0;
-        while (last < int(messages.size()) && messages[last].second)
+
+        if (udp_sock >= 0 && FD_ISSET(udp_sock, &fds))
         {
-            last++;
+            checkDatagrams();
         }
 
-        while (messages.empty() || (!messages.empty() && !messages[last].second))
+        while (FD_ISSET(sock, &fds))
         {
-            memset(buffer, 0, size + 1);
-
-            int bytes_read = recv(sock, buffer, size, MSG_DONTWAIT);
+            int bytes_read = recv(sock, messageBuffer->getWritable(size), size, MSG_DONTWAIT);
 
             if (bytes_read == 0)
             {
@@ -182,39 +285,44 @@ void Client::recvMSG(int size, int timeoutSec)
             else if (bytes_read < 0)
             {
                 /* temporary unavailable */
-                if (errno != 11)
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
                 {
                     cerr << "ERROR::Client::recvMSG(); code " << errno << " = " << strerror(errno) << endl;
-                    break;
                 }
+
+                break;
             }
-            else
-            {
-                constructFineMessage(buffer, bytes_read, last, 0);
-            }
+
+            messageBuffer->commit(bytes_read);
+            receivedBytes += bytes_read;
         }
-        
-        for (size_t i = last; i < messages.size(); i++)
+
+        /* complete frames */
+        const char* frame = nullptr;
+        size_t frameSize = 0;
+
+        try
         {
-            if (messages[i].second)
+            while (messageBuffer->nextFrame(frame, frameSize))
             {
-                /* END fix */
-                if (!messages[i].first.empty())
-                {
-                    int s = messages[i].first.size() - 1;
-                    while (s >= 0 && messages[i].first[s] != '>')
-                    {
-                        messages[i].first[s] = ' ';
-                        s--;
-                    }
-                }
+                messages.emplace_back(frame, frameSize);
             }
         }
+        catch(exception& ex)
+        {
+            cerr << ex.what() << endl;
+            exit(0);
+        }
+
+        bool done = !messages.empty();
 
         ready = true;
         cv.notify_all();
 
-        delete[] buffer;
+        if (done)
+        {
+            return;
+        }
     }
 }
 
@@ -227,9 +335,9 @@ string Client::getMessage() const
         cv.wait(lk);
     }
 
-    if (!messages.empty() && messages[0].second)
+    if (!messages.empty())
     {
-        string msg = messages[0].first;
+        string msg = move(messages.front());
         
         messages.pop_front();
 
@@ -239,7 +347,31 @@ string Client::getMessage() const
     return "";
 }
 
+bool Client::isDatagramBound() const
+{
+    unique_lock < mutex > lk(mtx);
+
+    return datagramBound;
+}
+
+unsigned long long Client::getSentBytes() const
+{
+    return sentBytes;
+}
+
+unsigned long long Client::getReceivedBytes() const
+{
+    return receivedBytes;
+}
+
 Client::~Client()
 {
     close(sock);
+
+    if (udp_sock >= 0)
+    {
+        close(udp_sock);
+    }
+
+    delete messageBuffer;
 }
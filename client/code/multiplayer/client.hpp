@@ -3,11 +3,14 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <cstring>
+#include <cerrno>
+#include <chrono>
 
 #include <iostream>
 #include <string>
@@ -16,8 +19,16 @@
 #include <deque>
 #include <thread>
 #include <mutex>
+#include <atomic>
 #include <condition_variable>
 
+/* u8 channel + u32 sequence (little endian) before every datagram payload */
+#define CLIENT_DATAGRAM_HEADER_SIZE 5
+#define CLIENT_DATAGRAM_SIZE 1500
+#define CLIENT_DATAGRAM_CHANNELS 4
+/* channel byte of the handshake, u32 slot + u32 token follow the header */
+#define CLIENT_DATAGRAM_HELLO 0xFF
+
 using namespace std;
 
 class Client
@@ -26,6 +37,7 @@ class Client
         fd_set fds;
 
         int sock;
+        int udp_sock;
         struct sockaddr_in addr;
         struct timeval timeout;
 
@@ -33,21 +45,36 @@ class Client
         mutable mutex mtx;
         mutable condition_variable cv;
 
-        mutable deque < pair < string, bool > > messages;
+        MessageBuffer* messageBuffer;
+        mutable deque < string > messages;
 
         string lastMsg;
 
+        bool datagramBound;
+        unsigned int datagramSeqs[CLIENT_DATAGRAM_CHANNELS];
+
+        /* wire bytes, headers included */
+        atomic < unsigned long long > sentBytes;
+        atomic < unsigned long long > receivedBytes;
+
+        void checkDatagrams();
+
     public:
         Client();
 
         void connectToServer(string ip, int port, int timeoutSec = 5);
 
-        void sendMSG(string data, bool force = false);
+        void sendMSG(string data, unsigned char type, bool force = false);
+        void bindDatagrams(int id, unsigned int token);
         
-        void constructFineMessage(char* buffer, int size, int curMsg, int begOffset);
         void recvMSG(int size = 2048, int timeoutSec = 1);
 
         string getMessage() const;
 
+        bool isDatagramBound() const;
+
+        unsigned long long getSentBytes() const;
+        unsigned long long getReceivedBytes() const;
+
         ~Client();
 };
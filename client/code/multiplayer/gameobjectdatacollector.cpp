@@ -1,4 +1,5 @@
 #include "../shader/shader.hpp"
+#include "../shader/uniformbuffer.hpp"
 
 #include "../global/globaluse.hpp"
 
@@ -21,13 +22,17 @@
 #include "../game_object/sphere.hpp"
 #include "../game_object/openglmotionstate.hpp"
 #include "../game_object/animation.hpp"
+#include "../game_object/glstatecache.hpp"
 #include "../game_object/mesh.hpp"
 #include "../game_object/bone.hpp"
+#include "../game_object/animationclip.hpp"
 #include "../game_object/skeleton.hpp"
 #include "../game_object/viewfrustum.hpp"
 #include "../game_object/boundsphere.hpp"
 #include "../game_object/modelloader.hpp"
 #include "../game_object/physicsobject.hpp"
+#include "../game_object/transformbuffer.hpp"
+#include "../game_object/renderqueue.hpp"
 #include "../game_object/gameobject.hpp"
 #include "../game_object/weapon.hpp"
 #include "../game_object/rifle.hpp"
@@ -36,7 +41,7 @@
         
 GameObjectDataCollector::GameObjectDataCollector()
 {
-    name = "";
+    netID = -1;
     senderID = -1;
     model = mat4(1.0);
 }
@@ -46,12 +51,12 @@ void GameObjectDataCollector::setSenderID(int senderID)
     this->senderID = senderID;
 }
 
-void GameObjectDataCollector::collect(GameObject* gameObject)
+void GameObjectDataCollector::collect(GameObject* gameObject, int netID)
 {
     if (gameObject)
     {
         model = gameObject->getPhysicsObjectTransform();
-        name = gameObject->getName();
+        this->netID = netID;
     }
 }
 
@@ -64,11 +69,11 @@ string GameObjectDataCollector::getData() const
 
     gameObjectDataCollectorDoc.InsertFirstChild(root);
 
-    /* name */
-    XMLElement* nameElem = gameObjectDataCollectorDoc.NewElement("name");
-    nameElem->SetText(name.data());
+    /* netID */
+    XMLElement* netIDElem = gameObjectDataCollectorDoc.NewElement("obj");
+    netIDElem->SetText(netID);
 
-    root->InsertEndChild(nameElem);
+    root->InsertEndChild(netIDElem);
     
     /* senderID */
     XMLElement* senderIDElem = gameObjectDataCollectorDoc.NewElement("id");
@@ -96,16 +101,14 @@ string GameObjectDataCollector::getData() const
     XMLPrinter gameObjectDataCollectorPrinter;
     gameObjectDataCollectorDoc.Print(&gameObjectDataCollectorPrinter);
 
-    string res("BEG\n");
-    res += gameObjectDataCollectorPrinter.CStr();
-    res += "END";
+    string res(gameObjectDataCollectorPrinter.CStr());
 
     return res;
 }
 
 void GameObjectDataCollector::clear()
 {
-    name = "";
+    netID = -1;
     model = mat4(1.0);
 }
 
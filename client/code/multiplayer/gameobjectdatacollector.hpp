@@ -12,7 +12,7 @@ using namespace tinyxml2;
 class GameObjectDataCollector
 {
     private:
-        string name;
+        int netID;
         int senderID;
 
         mat4 model;        
@@ -22,7 +22,7 @@ class GameObjectDataCollector
 
         void setSenderID(int senderID);
 
-        void collect(GameObject* gameObject);
+        void collect(GameObject* gameObject, int netID);
 
         string getData() const;
 
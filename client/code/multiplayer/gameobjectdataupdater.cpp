@@ -1,4 +1,5 @@
 #include "../shader/shader.hpp"
+#include "../shader/uniformbuffer.hpp"
 
 #include "../global/globaluse.hpp"
 
@@ -21,13 +22,17 @@
 #include "../game_object/sphere.hpp"
 #include "../game_object/openglmotionstate.hpp"
 #include "../game_object/animation.hpp"
+#include "../game_object/glstatecache.hpp"
 #include "../game_object/mesh.hpp"
 #include "../game_object/bone.hpp"
+#include "../game_object/animationclip.hpp"
 #include "../game_object/skeleton.hpp"
 #include "../game_object/viewfrustum.hpp"
 #include "../game_object/boundsphere.hpp"
 #include "../game_object/modelloader.hpp"
 #include "../game_object/physicsobject.hpp"
+#include "../game_object/transformbuffer.hpp"
+#include "../game_object/renderqueue.hpp"
 #include "../game_object/gameobject.hpp"
 #include "../game_object/weapon.hpp"
 #include "../game_object/rifle.hpp"
@@ -39,6 +44,7 @@ GameObjectDataUpdater::GameObjectDataUpdater()
 {
     objParser = new PhysicsObjectDataParser();
     timeStamp = 0;
+    tick = 0;
 }
 
 void GameObjectDataUpdater::collect(string info)
@@ -49,6 +55,7 @@ void GameObjectDataUpdater::collect(string info)
     
     XMLElement* timeElem = gameObjectDataUpdaterDoc.FirstChildElement("time");
     timeElem->QueryUnsignedAttribute("time", &timeStamp);
+    timeElem->QueryUnsignedAttribute("tick", &tick);
 
     /* root */
     XMLNode* root = gameObjectDataUpdaterDoc.FirstChildElement("Objs");
@@ -70,6 +77,7 @@ void GameObjectDataUpdater::collect(string info)
     }
 
     names = objParser->getNames();
+    netIDs = objParser->getNetIDs();
 }
 
 void GameObjectDataUpdater::updateData(GameObject* gameObject, bool interpolation)
@@ -79,7 +87,7 @@ void GameObjectDataUpdater::updateData(GameObject* gameObject, bool interpolatio
         return;
     }
 
-    objParser->updatePhysicsObject(gameObject, interpolation, timeStamp);
+    objParser->updatePhysicsObject(gameObject, interpolation, tick);
 }
 
 void GameObjectDataUpdater::updateData(map < string, GameObject* > gameObjects, bool interpolation)
@@ -90,7 +98,20 @@ void GameObjectDataUpdater::updateData(map < string, GameObject* > gameObjects,
 
         if (it != gameObjects.end())
         {
-            objParser->updatePhysicsObject(it->second, interpolation, timeStamp);
+            objParser->updatePhysicsObject(it->second, interpolation, tick);
+        }
+    }
+}
+
+void GameObjectDataUpdater::updateData(vector < GameObject* > netObjects, bool interpolation)
+{
+    for (size_t i = 0; i < netIDs.size(); i++)
+    {
+        size_t netID = netIDs[i];
+
+        if (netID < netObjects.size() && netObjects[netID])
+        {
+            objParser->updateInstance(i, netObjects[netID], interpolation, tick);
         }
     }
 }
@@ -105,12 +126,29 @@ vector < string > GameObjectDataUpdater::getNames() const
     return names;
 }
 
+vector < int > GameObjectDataUpdater::getNetIDs() const
+{
+    return netIDs;
+}
+
+unsigned int GameObjectDataUpdater::getTick() const
+{
+    return tick;
+}
+
+unsigned int GameObjectDataUpdater::getTimeStamp() const
+{
+    return timeStamp;
+}
+
 void GameObjectDataUpdater::clear()
 {
     objParser->clear();
     names.clear();
+    netIDs.clear();
 
     timeStamp = 0;
+    tick = 0;
 }
 
 GameObjectDataUpdater::~GameObjectDataUpdater() 
@@ -16,8 +16,10 @@ class GameObjectDataUpdater
     private:
         PhysicsObjectDataParser* objParser;
         vector < string > names;
+        vector < int > netIDs;
 
         unsigned int timeStamp;
+        unsigned int tick;
 
     public:
         GameObjectDataUpdater();
@@ -26,9 +28,13 @@ class GameObjectDataUpdater
 
         void updateData(GameObject* gameObject, bool interpolation = false);
         void updateData(map < string, GameObject* > gameObjects, bool interpolation = false);
+        void updateData(vector < GameObject* > netObjects, bool interpolation = false);
 
         string getName(int index = 0) const;
         vector < string > getNames() const;
+        vector < int > getNetIDs() const;
+        unsigned int getTick() const;
+        unsigned int getTimeStamp() const;
 
         void clear();
 
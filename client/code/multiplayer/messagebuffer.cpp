@@ -0,0 +1,106 @@
+#include "messagebuffer.hpp"
+
+MessageBuffer::MessageBuffer(size_t capacity)
+{
+    data.resize(capacity);
+
+    head = 0;
+    tail = 0;
+}
+
+void MessageBuffer::writeHeader(char* header, size_t size, unsigned char type)
+{
+    if (size >= FRAME_MAX_SIZE)
+    {
+        throw(runtime_error("ERROR::MessageBuffer::writeHeader() frame is too big"));
+    }
+
+    uint32_t word = (uint32_t)size | ((uint32_t)type << FRAME_TYPE_SHIFT);
+
+    for (int i = 0; i < FRAME_HEADER_SIZE; i++)
+    {
+        header[i] = (word >> (i * 8)) & 0xFF;
+    }
+}
+
+char* MessageBuffer::getWritable(size_t size)
+{
+    if (data.size() - tail < size)
+    {
+        /* move the unread part to the front */
+        if (head)
+        {
+            memmove(data.data(), data.data() + head, tail - head);
+
+            tail -= head;
+            head = 0;
+        }
+
+        if (data.size() - tail < size)
+        {
+            data.resize(max(data.size() * 2, tail + size));
+        }
+    }
+
+    return data.data() + tail;
+}
+
+void MessageBuffer::commit(size_t size)
+{
+    tail = min(tail + size, data.size());
+}
+
+bool MessageBuffer::nextFrame(const char*& frame, size_t& size)
+{
+    unsigned char type;
+
+    return nextFrame(frame, size, type);
+}
+
+bool MessageBuffer::nextFrame(const char*& frame, size_t& size, unsigned char& type)
+{
+    if (tail - head < FRAME_HEADER_SIZE)
+    {
+        return false;
+    }
+
+    uint32_t word = 0;
+
+    for (int i = 0; i < FRAME_HEADER_SIZE; i++)
+    {
+        word |= (uint32_t)(unsigned char)data[head + i] << (i * 8);
+    }
+
+    size = word & (FRAME_MAX_SIZE - 1);
+    type = word >> FRAME_TYPE_SHIFT;
+
+    if (type >= MESSAGE_TYPES)
+    {
+        throw(runtime_error("ERROR::MessageBuffer::nextFrame() unknown message type"));
+    }
+
+    if (tail - head < FRAME_HEADER_SIZE + size)
+    {
+        return false;
+    }
+
+    frame = data.data() + head + FRAME_HEADER_SIZE;
+    head += FRAME_HEADER_SIZE + size;
+
+    /* everything is read, start over */
+    if (head == tail)
+    {
+        head = 0;
+        tail = 0;
+    }
+
+    return true;
+}
+
+void MessageBuffer::clear()
+{
+    head = 0;
+    tail = 0;
+}
+
+MessageBuffer::~MessageBuffer() {}
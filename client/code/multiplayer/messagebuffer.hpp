@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+
+/* u32 little endian before every message, u24 payload size + u8 message type on top */
+#define FRAME_HEADER_SIZE 4
+#define FRAME_MAX_SIZE (1 << 24)
+#define FRAME_TYPE_SHIFT 24
+
+using namespace std;
+
+/* what a client frame carries, the receiver dispatches on it without looking into the payload */
+enum MessageType
+{
+    MESSAGE_NONE = 0, /* server to client frames, untyped */
+    MESSAGE_PLAYER,
+    MESSAGE_OBJ,
+    MESSAGE_PICK,
+    MESSAGE_DROP,
+    MESSAGE_FIRE,
+    MESSAGE_ACK,
+    MESSAGE_PROTO,
+    MESSAGE_PING,
+    MESSAGE_TYPES
+};
+
+/*
+ * reusable receive buffer of one connection. the unread bytes are kept
+ * contiguous (compacted on demand), so a complete frame is always handed
+ * out as a view into the buffer, valid until the next getWritable()
+ */
+class MessageBuffer
+{
+    private:
+        vector < char > data;
+
+        size_t head;
+        size_t tail;
+
+    public:
+        MessageBuffer(size_t capacity = 4096);
+
+        static void writeHeader(char* header, size_t size, unsigned char type = MESSAGE_NONE);
+
+        char* getWritable(size_t size);
+        void commit(size_t size);
+
+        bool nextFrame(const char*& frame, size_t& size);
+        bool nextFrame(const char*& frame, size_t& size, unsigned char& type);
+
+        void clear();
+
+        ~MessageBuffer();
+};
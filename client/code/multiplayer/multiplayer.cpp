@@ -1,6 +1,7 @@
 #include "../global/globaluse.hpp"
 
 #include "../shader/shader.hpp"
+#include "../shader/uniformbuffer.hpp"
 
 #include "../framebuffer/framebuffer.hpp"
 #include "../framebuffer/colorbuffer.hpp"
@@ -28,21 +29,28 @@
 #include "../game_object/sphere.hpp"
 #include "../game_object/openglmotionstate.hpp"
 #include "../game_object/animation.hpp"
+#include "../game_object/glstatecache.hpp"
 #include "../game_object/mesh.hpp"
 #include "../game_object/bone.hpp"
+#include "../game_object/animationclip.hpp"
 #include "../game_object/skeleton.hpp"
 #include "../game_object/viewfrustum.hpp"
 #include "../game_object/boundsphere.hpp"
 #include "../game_object/modelloader.hpp"
 #include "../game_object/physicsobject.hpp"
+#include "../game_object/transformbuffer.hpp"
+#include "../game_object/renderqueue.hpp"
 #include "../game_object/gameobject.hpp"
 #include "../game_object/instancedgameobject.hpp"
 #include "../game_object/weapon.hpp"
 #include "../game_object/rifle.hpp"
 
+#include "../player/inputhistory.hpp"
 #include "../player/player.hpp"
+#include "../player/soldier.hpp"
 
 #include "../level/dirlightsoftshadow.hpp"
+#include "../level/dirlightcascade.hpp"
 #include "../level/dirlight.hpp"
 #include "../level/ssao.hpp"
 #include "../level/atmosphere.hpp"
@@ -50,6 +58,7 @@
 #include "../level/levelloader.hpp"
 #include "../level/level.hpp"
 
+#include "messagebuffer.hpp"
 #include "client.hpp"
 #include "physicsobjectdataparser.hpp"
 #include "playerdatacollector.hpp"
@@ -64,6 +73,9 @@
 #include "weaponfirecollector.hpp"
 #include "playerconnectionupdater.hpp"
 #include "playerdisconnectionupdater.hpp"
+#include "snapshotreader.hpp"
+#include "snapshotdecoder.hpp"
+#include "netclock.hpp"
 #include "multiplayer.hpp"
 
 Multiplayer::Multiplayer(Window* window, Level* level, World* world)
@@ -81,12 +93,17 @@ Multiplayer::Multiplayer(Window* window, Level* level, World* world)
     weaponFireCollector = new WeaponFireCollector();
     playerConnectionUpdater = new PlayerConnectionUpdater();
     playerDisconnectionUpdater = new PlayerDisconnectionUpdater();
+    snapshotDecoder = new SnapshotDecoder();
+    netClock = new NetClock();
 
     this->window = window;
     this->level = level;
     this->world = world;
 
     playerID = 0;
+    binarySnapshots = true; /* false keeps the XML snapshots for debugging */
+    datagramToken = 0;
+    serverTick = 0;
 }
 
 void Multiplayer::connect()
@@ -112,6 +129,42 @@ void Multiplayer::connect()
         {
             joinElem->QueryIntText(&playerID);
         }
+
+        /* every slot needs a soldier before the players info, the models load on this thread */
+        XMLElement* slotsElem = newConnectionDoc.FirstChildElement("slots");
+        int slots = 0;
+
+        if (slotsElem)
+        {
+            slotsElem->QueryIntText(&slots);
+        }
+
+        for (int i = 0; i < std::max(slots, playerID + 1); i++)
+        {
+            level->addPlayer(i);
+        }
+
+        /* binary snapshots offered */
+        XMLElement* snapElem = newConnectionDoc.FirstChildElement("snap");
+        int snapVersion = 0;
+
+        if (snapElem)
+        {
+            snapElem->QueryIntText(&snapVersion);
+        }
+
+        if (binarySnapshots && snapVersion == SNAPSHOT_VERSION)
+        {
+            client->sendMSG(snapshotDecoder->getProtoData(playerID), MESSAGE_PROTO);
+
+            /* the binary snapshots come over UDP once the server knows our address */
+            XMLElement* udpElem = newConnectionDoc.FirstChildElement("udp");
+
+            if (udpElem)
+            {
+                udpElem->QueryUnsignedText(&datagramToken);
+            }
+        }
     }
     else
     {
@@ -126,11 +179,21 @@ void Multiplayer::connect()
     {
         gameObjectDataUpdater->collect(msg);
         gameObjectDataUpdater->updateData(level->getGameObjects(), false);
+
+        /* the only time the names are sent, everything after refers to the ids */
+        vector < string > names = gameObjectDataUpdater->getNames();
+        vector < int > netIDs = gameObjectDataUpdater->getNetIDs();
+
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            level->setNetID(netIDs[i], level->getGameObject(names[i]));
+        }
+
         gameObjectDataUpdater->clear();
     }
     else
     {
-        throw(runtime_error("ERROR::Multiplayer::connect() not enough buffer (gameObject)"));
+        throw(runtime_error("ERROR::Multiplayer::connect() no data (gameObject)"));
     }
     
     /* weapons info */
@@ -141,11 +204,20 @@ void Multiplayer::connect()
     {
         weaponDataUpdater->collect(msg);
         weaponDataUpdater->updateData(level->getGameObjects(), false);
+
+        vector < string > names = weaponDataUpdater->getNames();
+        vector < int > netIDs = weaponDataUpdater->getNetIDs();
+
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            level->setNetID(netIDs[i], level->getGameObject(names[i]));
+        }
+
         weaponDataUpdater->clear();
     }
     else
     {
-        throw(runtime_error("ERROR::Multiplayer::connect() not enough buffer (weapon)"));
+        throw(runtime_error("ERROR::Multiplayer::connect() no data (weapon)"));
     }
     
     /* players info */
@@ -154,16 +226,14 @@ void Multiplayer::connect()
 
     if (msg != "")
     {
-        map < string, GameObject* > gameObjects = level->getGameObjects();
-       
         playerDataUpdater->collect(msg);
 
-        playerDataUpdater->updateData(level->getPlayers(), false, gameObjects);
+        playerDataUpdater->updateData(level->getPlayers(), false, level->getNetObjects());
         playerDataUpdater->clear();
     }
     else
     {
-        throw(runtime_error("ERROR::Multiplayer::connect() not enough buffer (player)"));
+        throw(runtime_error("ERROR::Multiplayer::connect() no data (player)"));
     }
    
     level->setPlayerID(playerID);
@@ -173,6 +243,11 @@ void Multiplayer::connect()
     weaponDropperCollector->setPlayerID(playerID);
     weaponFireCollector->setPlayerID(playerID);
 
+    if (!level->getConnectedPlayer())
+    {
+        throw(runtime_error("ERROR::Multiplayer::connect() no soldier for the slot"));
+    }
+
     level->getConnectedPlayer()->setConnected(true);
     level->getConnectedPlayer()->setActive(true);
 
@@ -185,38 +260,36 @@ void Multiplayer::broadcast()
     {
         this_thread::sleep_for(chrono::milliseconds(50));
 
-        /* player */
-        if (level->getConnectedPlayer()->getGameObject()->getPhysicsObject()->getRigidBody()->getLinearVelocity().length() > 0.01)
+        Soldier* soldier = dynamic_cast < Soldier* >(level->getConnectedPlayer());
+
+        if (!soldier)
         {
-            playerDataCollector->collect(level->getConnectedPlayer());
-            client->sendMSG(playerDataCollector->getData());
-            playerDataCollector->clear();
+            throw(runtime_error("ERROR::Multiplayer::broadcast() player is not a soldier"));
         }
 
-        map < string, GameObject* > gameObjects = level->getGameObjects();
-        vector < Player* > players = level->getPlayers();
+        /* player, the input of the frames since the last time */
+        playerDataCollector->collect(soldier->getInputHistory()->takeUnsent());
+        client->sendMSG(playerDataCollector->getData(), MESSAGE_PLAYER);
+        playerDataCollector->clear();
 
-        // erase players
-        for (size_t i = 0; i < players.size(); i++)
-        {
-            gameObjects.erase(players[i]->getGameObject()->getName());
-        }
+        /* players are not in the net table */
+        vector < GameObject* > netObjects = level->getNetObjects();
 
         // game objects
-        for (auto& i: gameObjects)
+        for (size_t i = 0; i < netObjects.size(); i++)
         {
-            if (i.second->getPhysicsObject())
+            if (netObjects[i] && netObjects[i]->getPhysicsObject())
             {
-                PhysicsObject* PO = i.second->getPhysicsObject();
+                PhysicsObject* PO = netObjects[i]->getPhysicsObject();
 
                 if (PO->getRigidBody())
                 {
                     btRigidBody* RB = PO->getRigidBody();
 
-                    if (i.second->isCollidable() && RB->isActive() && !RB->isStaticOrKinematicObject())
+                    if (netObjects[i]->isCollidable() && RB->isActive() && !RB->isStaticOrKinematicObject())
                     {
-                        gameObjectDataCollector->collect(i.second); 
-                        client->sendMSG(gameObjectDataCollector->getData());
+                        gameObjectDataCollector->collect(netObjects[i], i); 
+                        client->sendMSG(gameObjectDataCollector->getData(), MESSAGE_OBJ);
                         gameObjectDataCollector->clear();
                     }
                 }
@@ -224,19 +297,42 @@ void Multiplayer::broadcast()
         }
 
         /* pick */
-        weaponPickerCollector->collect(level->getConnectedPlayer());
-        client->sendMSG(weaponPickerCollector->getData());
+        weaponPickerCollector->collect(soldier->getPickRay());
+        client->sendMSG(weaponPickerCollector->getData(), MESSAGE_PICK);
         weaponPickerCollector->clear();
         
         /* drop */
-        weaponDropperCollector->collect(level->getConnectedPlayer());
-        client->sendMSG(weaponDropperCollector->getData());
+        bool dropTo = soldier->isDrop();
+        mat4 dropModel(1.0);
+
+        if (dropTo)
+        {
+            deque < Weapon* > weapons = soldier->getWeapons();
+
+            if (!weapons.empty() && weapons[0])
+            {
+                dropModel = weapons[0]->getPhysicsObjectTransform();
+            }
+        }
+
+        weaponDropperCollector->collect(dropTo, dropModel);
+        client->sendMSG(weaponDropperCollector->getData(), MESSAGE_DROP);
         weaponDropperCollector->clear();
         
         /* fire */
-        weaponFireCollector->collect(level->getConnectedPlayer());
-        client->sendMSG(weaponFireCollector->getData(), true);
+        weaponFireCollector->setTick(serverTick);
+        weaponFireCollector->collect(soldier->getFire(), soldier->getReload());
+        client->sendMSG(weaponFireCollector->getData(), MESSAGE_FIRE, true);
         weaponFireCollector->clear();
+
+        /* snapshot ack */
+        client->sendMSG(snapshotDecoder->getAckData(playerID), MESSAGE_ACK);
+
+        /* repeated until the server answers */
+        if (datagramToken)
+        {
+            client->bindDatagrams(playerID, datagramToken);
+        }
     }
 }
 
@@ -259,7 +355,26 @@ void Multiplayer::update()
             this_thread::sleep_for(chrono::milliseconds(10));
         }
 
-        if (msg.find("Con") != string::npos)
+        if (snapshotDecoder->isSnapshot(msg))
+        {
+            if (snapshotDecoder->collect(msg))
+            {
+                netClock->addSample(snapshotDecoder->getTick(), snapshotDecoder->getTimeStamp());
+
+                if (snapshotDecoder->getKind() == 'S')
+                {
+                    snapshotDecoder->updateData(level->getPlayers(), true);
+                    serverTick = snapshotDecoder->getTick();
+                }
+                else
+                {
+                    snapshotDecoder->updateData(level->getNetObjects(), true);
+                }
+            }
+
+            snapshotDecoder->clear();
+        }
+        else if (msg.find("Con") != string::npos)
         {
             playerConnectionUpdater->collect(msg);
 
@@ -275,24 +390,27 @@ void Multiplayer::update()
         else if (msg.find("Soldiers") != string::npos)
         { 
             playerDataUpdater->collect(msg);
+            netClock->addSample(playerDataUpdater->getTick(), playerDataUpdater->getTimeStamp());
             playerDataUpdater->updateData(level->getIDPlayer(playerDataUpdater->getPlayerID()), true);
+            serverTick = playerDataUpdater->getTick();
             playerDataUpdater->clear();
         }
         else if (msg.find("Objs") != string::npos)
         {
             gameObjectDataUpdater->collect(msg);
-            gameObjectDataUpdater->updateData(level->getGameObjects(), true);
+            netClock->addSample(gameObjectDataUpdater->getTick(), gameObjectDataUpdater->getTimeStamp());
+            gameObjectDataUpdater->updateData(level->getNetObjects(), true);
             gameObjectDataUpdater->clear();
         }
         else if (msg.find("Pick") != string::npos)
         {
             weaponPickerUpdater->collect(msg);
             Player* player = level->getIDPlayer(weaponPickerUpdater->getPlayerID());
-            vector < string > names = weaponPickerUpdater->getNames();
+            vector < int > netIDs = weaponPickerUpdater->getNetIDs();
 
-            for (size_t i = 0; i < names.size(); i++)
+            for (size_t i = 0; i < netIDs.size(); i++)
             {
-                GameObject* gameObject = level->getGameObject(names[i]);
+                GameObject* gameObject = level->getGameObject(netIDs[i]);
 
                 weaponPickerUpdater->updateData(player, gameObject);
             }
@@ -303,11 +421,11 @@ void Multiplayer::update()
         {
             weaponDropperUpdater->collect(msg);
             Player* player = level->getIDPlayer(weaponDropperUpdater->getPlayerID());
-            vector < string > names = weaponDropperUpdater->getNames();
+            vector < int > netIDs = weaponDropperUpdater->getNetIDs();
 
-            for (size_t i = 0; i < names.size(); i++)
+            for (size_t i = 0; i < netIDs.size(); i++)
             {
-                GameObject* gameObject = level->getGameObject(names[i]);
+                GameObject* gameObject = level->getGameObject(netIDs[i]);
 
                 weaponDropperUpdater->updateData(player, gameObject);
             }
@@ -330,6 +448,11 @@ void Multiplayer::update()
     }
 }
 
+double Multiplayer::getRenderTick() const
+{
+    return netClock->getRenderTick();
+}
+
 Multiplayer::~Multiplayer()
 {
     delete client;
@@ -345,4 +468,6 @@ Multiplayer::~Multiplayer()
     delete weaponFireCollector;
     delete playerConnectionUpdater;
     delete playerDisconnectionUpdater;
+    delete snapshotDecoder;
+    delete netClock;
 }
@@ -4,6 +4,7 @@
 
 #include <iostream>
 #include <string>
+#include <atomic>
 #include <tinyxml2/tinyxml2.h>
 
 using namespace tinyxml2;
@@ -25,12 +26,17 @@ class Multiplayer
         WeaponFireCollector* weaponFireCollector;
         PlayerConnectionUpdater* playerConnectionUpdater;
         PlayerDisconnectionUpdater* playerDisconnectionUpdater;
+        SnapshotDecoder* snapshotDecoder;
+        NetClock* netClock;
 
         Window* window;
         Level* level;
         World* world;
 
         int playerID;
+        bool binarySnapshots;
+        unsigned int datagramToken;
+        atomic < unsigned int > serverTick; /* of the latest soldiers state, written by the receiver */
 
     public:
         Multiplayer(Window* window, Level* level, World* world);
@@ -40,5 +46,7 @@ class Multiplayer
         void broadcast();
         void update();
 
+        double getRenderTick() const;
+
         ~Multiplayer();
 };
@@ -0,0 +1,130 @@
+#include "netclock.hpp"
+
+NetClock::NetClock()
+{
+    clear();
+}
+
+double NetClock::localTime() const
+{
+    return chrono::duration < double, milli >(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void NetClock::addSample(unsigned int tick, unsigned int serverTime)
+{
+    unique_lock < mutex > lk(mtx);
+
+    double local = localTime();
+
+    if (synced && tick + NETCLOCK_RESET < lastTick)
+    {
+        synced = false;
+    }
+
+    if (!synced)
+    {
+        synced = true;
+
+        lastTick = tick;
+        lastTime = serverTime;
+        wrap = 0.0;
+
+        refTick = tick;
+        refTime = serverTime;
+        offset = local - serverTime;
+
+        msPerTick = NETCLOCK_MS_PER_TICK;
+        interval = 1.0;
+
+        return;
+    }
+
+    /* the server time wraps around, a late state may still be from before that */
+    double time = wrap + serverTime;
+
+    if (serverTime + NETCLOCK_TIME_WRAP / 2 < lastTime)
+    {
+        wrap += NETCLOCK_TIME_WRAP;
+        time += NETCLOCK_TIME_WRAP;
+    }
+    else if (lastTime + NETCLOCK_TIME_WRAP / 2 < serverTime)
+    {
+        time -= NETCLOCK_TIME_WRAP;
+    }
+
+    double sampleOffset = local - time;
+    offset += (sampleOffset - offset) * (sampleOffset < offset ? NETCLOCK_OFFSET_DROP : NETCLOCK_SMOOTHING);
+
+    /* only the newer states move the timeline */
+    if (tick <= lastTick)
+    {
+        return;
+    }
+
+    double ticks = tick - lastTick;
+    double ms = time - refTime;
+
+    if (ms > 0.0)
+    {
+        msPerTick += (ms / ticks - msPerTick) * NETCLOCK_SMOOTHING;
+    }
+
+    interval += (ticks - interval) * NETCLOCK_SMOOTHING;
+
+    lastTick = tick;
+    lastTime = serverTime;
+
+    refTick = tick;
+    refTime = time;
+}
+
+double NetClock::getRenderTick() const
+{
+    unique_lock < mutex > lk(mtx);
+
+    if (!synced)
+    {
+        return 0.0;
+    }
+
+    double serverNow = localTime() - offset;
+    double tick = refTick + (serverNow - refTime) / msPerTick;
+
+    return max(0.0, tick - interval * NETCLOCK_DELAY_INTERVALS);
+}
+
+/*
+ * milliseconds between the tick on the server and now on the server timeline. the offset follows
+ * the quickest samples, so it's the delay over the best path seen, not an absolute one way time
+ */
+double NetClock::getAge(unsigned int tick) const
+{
+    unique_lock < mutex > lk(mtx);
+
+    if (!synced)
+    {
+        return 0.0;
+    }
+
+    double serverNow = localTime() - offset;
+
+    return max(0.0, serverNow - refTime + (refTick - tick) * msPerTick);
+}
+
+void NetClock::clear()
+{
+    unique_lock < mutex > lk(mtx);
+
+    synced = false;
+
+    lastTick = lastTime = 0;
+    wrap = 0.0;
+
+    refTick = refTime = 0.0;
+
+    msPerTick = NETCLOCK_MS_PER_TICK;
+    interval = 1.0;
+    offset = 0.0;
+}
+
+NetClock::~NetClock() {}
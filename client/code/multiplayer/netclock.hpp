@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <algorithm>
+
+#define NETCLOCK_TIME_WRAP 1000000 /* the server sends its milliseconds modulo this */
+#define NETCLOCK_DELAY_INTERVALS 2.0 /* how many snapshot intervals the remote entities are shown behind */
+#define NETCLOCK_MS_PER_TICK (1000.0 / 60.0) /* until the server says otherwise */
+#define NETCLOCK_RESET 600 /* ticks back in time, the server started over */
+#define NETCLOCK_SMOOTHING 0.1
+#define NETCLOCK_OFFSET_DROP 0.5 /* a sample that came quicker is trusted more */
+
+using namespace std;
+
+/*
+ * maps the local clock onto the server tick timeline. fed by the receiver with the
+ * tick and the time of every state, read by the render loop once per frame
+ */
+class NetClock
+{
+    private:
+        bool synced;
+
+        unsigned int lastTick;
+        unsigned int lastTime;
+        double wrap;
+
+        double refTick;
+        double refTime;
+
+        double msPerTick;
+        double interval; /* ticks between the states */
+        double offset; /* local - server, milliseconds */
+
+        mutable mutex mtx;
+
+        double localTime() const;
+
+    public:
+        NetClock();
+
+        void addSample(unsigned int tick, unsigned int serverTime);
+
+        double getRenderTick() const;
+        double getAge(unsigned int tick) const;
+
+        void clear();
+
+        ~NetClock();
+};
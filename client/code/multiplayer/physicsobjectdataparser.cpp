@@ -1,4 +1,5 @@
 #include "../shader/shader.hpp"
+#include "../shader/uniformbuffer.hpp"
 
 #include "../global/globaluse.hpp"
 
@@ -21,13 +22,17 @@
 #include "../game_object/sphere.hpp"
 #include "../game_object/openglmotionstate.hpp"
 #include "../game_object/animation.hpp"
+#include "../game_object/glstatecache.hpp"
 #include "../game_object/mesh.hpp"
 #include "../game_object/bone.hpp"
+#include "../game_object/animationclip.hpp"
 #include "../game_object/skeleton.hpp"
 #include "../game_object/viewfrustum.hpp"
 #include "../game_object/boundsphere.hpp"
 #include "../game_object/modelloader.hpp"
 #include "../game_object/physicsobject.hpp"
+#include "../game_object/transformbuffer.hpp"
+#include "../game_object/renderqueue.hpp"
 #include "../game_object/gameobject.hpp"
 #include "../game_object/weapon.hpp"
 #include "../game_object/rifle.hpp"
@@ -44,16 +49,43 @@ void PhysicsObjectDataParser::parse(XMLElement* objElem)
     int quantity = 1;
     objElem->QueryIntAttribute("quantity", &quantity);
 
+    /* net ids, a list per instance at join and a single id in the steady messages */
+    vector < int > ids;
+
+    const char* idList = nullptr;
+
+    if (objElem->QueryStringAttribute("ids", &idList) == XML_SUCCESS)
+    {
+        istringstream idStream(idList);
+        int id;
+
+        while (idStream >> id)
+        {
+            ids.push_back(id);
+        }
+    }
+
+    int netID = -1;
+
+    if (objElem->QueryIntAttribute("id", &netID) == XML_SUCCESS)
+    {
+        ids.push_back(netID);
+    }
+
     for (int inst = 0; inst < quantity; inst++)
     {
-        string name = baseName;
+        int instID = inst < (int)ids.size() ? ids[inst] : -1;
+
+        /* nameless objects are keyed by their id */
+        string name = baseName ? baseName : "#" + to_string(instID);
 
-        if (quantity > 1)
+        if (baseName && quantity > 1)
         {
             name += to_string(inst);
         }
 
         names.push_back(name);
+        netIDs.push_back(instID);
 
         /* shape */
         XMLElement* shapeElem = objElem->FirstChildElement("shape");
@@ -291,19 +323,14 @@ void PhysicsObjectDataParser::parse(XMLElement* objElem)
     }
 }
 
-void PhysicsObjectDataParser::updatePhysicsObject(GameObject* gameObject, bool interpolation, unsigned int timeStamp)
+void PhysicsObjectDataParser::updatePhysicsObject(const string& key, GameObject* gameObject, bool interpolation, unsigned int tick)
 {
-    if (names.empty())
-    {
-        return;
-    }
-
-    auto collIt = collShapes.find(gameObject->getName());
-    auto compIt = compShapes.find(gameObject->getName());
-    auto convIt = convShapes.find(gameObject->getName());
-    auto massIt = masses.find(gameObject->getName());
-    auto modelIt = models.find(gameObject->getName());
-    auto aFactorIt = aFactors.find(gameObject->getName());
+    auto collIt = collShapes.find(key);
+    auto compIt = compShapes.find(key);
+    auto convIt = convShapes.find(key);
+    auto massIt = masses.find(key);
+    auto modelIt = models.find(key);
+    auto aFactorIt = aFactors.find(key);
 
     if (collIt != collShapes.end())
     {
@@ -325,7 +352,7 @@ void PhysicsObjectDataParser::updatePhysicsObject(GameObject* gameObject, bool i
 
     if (modelIt != models.end())
     {
-        gameObject->setPhysicsObjectTransform(modelIt->second, interpolation, timeStamp); 
+        gameObject->setPhysicsObjectTransform(modelIt->second, interpolation, tick); 
     }
 
     if (aFactorIt != aFactors.end())
@@ -334,14 +361,54 @@ void PhysicsObjectDataParser::updatePhysicsObject(GameObject* gameObject, bool i
     }
 }
 
+void PhysicsObjectDataParser::updatePhysicsObject(GameObject* gameObject, bool interpolation, unsigned int tick)
+{
+    if (names.empty())
+    {
+        return;
+    }
+
+    updatePhysicsObject(gameObject->getName(), gameObject, interpolation, tick);
+}
+
+void PhysicsObjectDataParser::updateInstance(size_t index, GameObject* gameObject, bool interpolation, unsigned int tick)
+{
+    if (index >= names.size())
+    {
+        return;
+    }
+
+    updatePhysicsObject(names[index], gameObject, interpolation, tick);
+}
+
+bool PhysicsObjectDataParser::getModel(const string& name, mat4& model) const
+{
+    auto it = models.find(name);
+
+    if (it == models.end())
+    {
+        return false;
+    }
+
+    model = it->second;
+
+    return true;
+}
+
 vector < string > PhysicsObjectDataParser::getNames() const
 {
     return names;
 }
 
+vector < int > PhysicsObjectDataParser::getNetIDs() const
+{
+    return netIDs;
+}
+
 void PhysicsObjectDataParser::clear()
 {
     names.clear();
+    netIDs.clear();
     collShapes.clear();
     compShapes.clear();
     masses.clear();
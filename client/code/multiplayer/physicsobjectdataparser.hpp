@@ -4,6 +4,7 @@
 
 #include <stdexcept>
 #include <vector>
+#include <sstream>
 #include <string>
 
 #include <tinyxml2/tinyxml2.h>
@@ -15,6 +16,7 @@ class PhysicsObjectDataParser
 {
     private:
         vector < string > names;
+        vector < int > netIDs;
         map < string, btCollisionShape* > collShapes; 
         map < string, ConvexHullShape* > convShapes;
         map < string, CompoundShape* > compShapes;
@@ -22,14 +24,19 @@ class PhysicsObjectDataParser
         map < string, mat4 > models;
         map < string, vec3 > aFactors; 
 
+        void updatePhysicsObject(const string& key, GameObject* gameObject, bool interpolation, unsigned int tick);
+
     public:
         PhysicsObjectDataParser();
 
         void parse(XMLElement* objElem);
         
-        void updatePhysicsObject(GameObject* gameObject, bool interpolation = false, unsigned int timeStamp = 0);
+        void updatePhysicsObject(GameObject* gameObject, bool interpolation = false, unsigned int tick = 0);
+        void updateInstance(size_t index, GameObject* gameObject, bool interpolation = false, unsigned int tick = 0);
 
+        bool getModel(const string& name, mat4& model) const;
         vector < string > getNames() const;
+        vector < int > getNetIDs() const;
 
         void clear();
 
@@ -1,48 +1,12 @@
-#include "../shader/shader.hpp"
-
 #include "../global/globaluse.hpp"
 
-#include "../framebuffer/framebuffer.hpp"
-#include "../framebuffer/colorbuffer.hpp"
-
-#include "../window/renderquad.hpp"
-#include "../window/glfwevents.hpp"
-#include "../window/window.hpp"
-
-#include "../player/camera.hpp"
-
-#include "../debug/debugdrawer.hpp"
-
-#include "../world/raytracer.hpp"
-#include "../world/constrainthandler.hpp"
-#include "../world/bulletevents.hpp"
-#include "../world/world.hpp"
-
-#include "../game_object/sphere.hpp"
-#include "../game_object/openglmotionstate.hpp"
-#include "../game_object/animation.hpp"
-#include "../game_object/mesh.hpp"
-#include "../game_object/bone.hpp"
-#include "../game_object/skeleton.hpp"
-#include "../game_object/viewfrustum.hpp"
-#include "../game_object/boundsphere.hpp"
-#include "../game_object/modelloader.hpp"
-#include "../game_object/physicsobject.hpp"
-#include "../game_object/gameobject.hpp"
-#include "../game_object/weapon.hpp"
-#include "../game_object/rifle.hpp"
-
-#include "../player/player.hpp"
-#include "../player/soldier.hpp"
+#include "../player/inputhistory.hpp"
 
 #include "playerdatacollector.hpp"
         
 PlayerDataCollector::PlayerDataCollector()
 {
     playerID = 0;
-
-    model = mat4(1.0);
-    moveDirection = vec3(0.0);
 }
 
 void PlayerDataCollector::setPlayerID(int playerID)
@@ -50,17 +14,18 @@ void PlayerDataCollector::setPlayerID(int playerID)
     this->playerID = playerID;
 }
 
-void PlayerDataCollector::collect(Player* player)
+void PlayerDataCollector::collect(const vector < InputCommand >& inputs)
 {
-    if (player->getGameObject())
-    {
-        model = player->getGameObject()->getPhysicsObjectTransform();
-        moveDirection = player->getMoveDirection();
-    }
+    this->inputs.insert(this->inputs.end(), inputs.begin(), inputs.end());
 }
 
 string PlayerDataCollector::getData() const
 {
+    if (inputs.empty())
+    {
+        return "";
+    }
+
     XMLDocument playerDataCollectorDoc;
 
     /* root */
@@ -74,45 +39,43 @@ string PlayerDataCollector::getData() const
 
     root->InsertEndChild(playerIDElem);
     
-    /* model */
-    XMLElement* modelElem = playerDataCollectorDoc.NewElement("mdl");
-
-    for (int i = 0; i < 4; i++)
+    /* input commands, the server moves the soldier by them */
+    for (size_t i = 0; i < inputs.size(); i++)
     {
-        for (int j = 0; j < 4; j++)
-        {
-            string str;
-            str = char('a' + (i * 4 + j));
+        const InputCommand& input = inputs[i];
 
-            modelElem->SetAttribute(str.data(), global.cutFloat(model[i][j], 4));
-        }
-    }
+        XMLElement* inputElem = playerDataCollectorDoc.NewElement("in");
 
-    root->InsertEndChild(modelElem);
+        inputElem->SetAttribute("s", input.seq);
+        inputElem->SetAttribute("x", global.cutFloat(input.moveDirection.x, 4));
+        inputElem->SetAttribute("z", global.cutFloat(input.moveDirection.z, 4));
+        inputElem->SetAttribute("t", global.cutFloat(input.time, 4));
 
-    /* moveDirection */
-    XMLElement* moveDirectionElem = playerDataCollectorDoc.NewElement("dir");
-    moveDirectionElem->SetAttribute("x", global.cutFloat(moveDirection.x, 4));
-    moveDirectionElem->SetAttribute("y", global.cutFloat(moveDirection.y, 4));
-    moveDirectionElem->SetAttribute("z", global.cutFloat(moveDirection.z, 4));
+        if (input.jump)
+        {
+            inputElem->SetAttribute("j", true);
+        }
 
-    root->InsertEndChild(moveDirectionElem);
+        inputElem->SetAttribute("qx", global.cutFloat(input.rotation.x, 4));
+        inputElem->SetAttribute("qy", global.cutFloat(input.rotation.y, 4));
+        inputElem->SetAttribute("qz", global.cutFloat(input.rotation.z, 4));
+        inputElem->SetAttribute("qw", global.cutFloat(input.rotation.w, 4));
+
+        root->InsertEndChild(inputElem);
+    }
 
     /* printer */
     XMLPrinter playerDataCollectorPrinter;
     playerDataCollectorDoc.Print(&playerDataCollectorPrinter);
 
-    string res("BEG\n");
-    res += playerDataCollectorPrinter.CStr();
-    res += "END\n";
+    string res(playerDataCollectorPrinter.CStr());
 
     return res;
 }
 
 void PlayerDataCollector::clear()
 {
-    model = mat4(1.0);
-    moveDirection = vec3(0.0);
+    inputs.clear();
 }
 
 PlayerDataCollector::~PlayerDataCollector() {}
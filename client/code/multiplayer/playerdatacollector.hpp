@@ -14,15 +14,14 @@ class PlayerDataCollector
     private:
         int playerID;
 
-        mat4 model;
-        vec3 moveDirection;
+        vector < InputCommand > inputs;
 
     public:
         PlayerDataCollector();
 
         void setPlayerID(int playerID);
         
-        void collect(Player* player);
+        void collect(const vector < InputCommand >& inputs);
 
         string getData() const;
 
@@ -1,4 +1,5 @@
 #include "../shader/shader.hpp"
+#include "../shader/uniformbuffer.hpp"
 
 #include "../global/globaluse.hpp"
 
@@ -21,17 +22,22 @@
 #include "../game_object/sphere.hpp"
 #include "../game_object/openglmotionstate.hpp"
 #include "../game_object/animation.hpp"
+#include "../game_object/glstatecache.hpp"
 #include "../game_object/mesh.hpp"
 #include "../game_object/bone.hpp"
+#include "../game_object/animationclip.hpp"
 #include "../game_object/skeleton.hpp"
 #include "../game_object/viewfrustum.hpp"
 #include "../game_object/boundsphere.hpp"
 #include "../game_object/modelloader.hpp"
 #include "../game_object/physicsobject.hpp"
+#include "../game_object/transformbuffer.hpp"
+#include "../game_object/renderqueue.hpp"
 #include "../game_object/gameobject.hpp"
 #include "../game_object/weapon.hpp"
 #include "../game_object/rifle.hpp"
 
+#include "../player/inputhistory.hpp"
 #include "../player/player.hpp"
 #include "../player/soldier.hpp"
 
@@ -42,6 +48,7 @@ PlayerDataUpdater::PlayerDataUpdater()
 {
     objParser = new PhysicsObjectDataParser();
     timeStamp = 0;
+    tick = 0;
 }
 
 void PlayerDataUpdater::collect(string info)
@@ -52,6 +59,7 @@ void PlayerDataUpdater::collect(string info)
 
     XMLElement* timeElem = playerDataUpdaterDoc.FirstChildElement("time");
     timeElem->QueryUnsignedAttribute("time", &timeStamp);
+    timeElem->QueryUnsignedAttribute("tick", &tick);
 
     /* root */
     XMLNode* root = playerDataUpdaterDoc.FirstChildElement("Soldiers");
@@ -73,6 +81,13 @@ void PlayerDataUpdater::collect(string info)
         soldierElem->QueryIntAttribute("id", &playerID);
 
         playerIDs.push_back(playerID);
+
+        unsigned int inputSeq = 0;
+
+        if (soldierElem->QueryUnsignedAttribute("inp", &inputSeq) == XML_SUCCESS)
+        {
+            inputSeqs.insert({playerID, inputSeq});
+        }
         
         /* speed */
         XMLElement* speedElem = soldierElem->FirstChildElement("speed");
@@ -123,15 +138,16 @@ void PlayerDataUpdater::collect(string info)
 
         if (armoryElem)
         {
-            vector < string > picked;
+            vector < int > picked;
 
             XMLElement* weaponElem = armoryElem->FirstChildElement("weapon");
 
             while (weaponElem)
             {
-                string name = weaponElem->GetText();
+                int netID = -1;
+                weaponElem->QueryIntText(&netID);
 
-                picked.push_back(name);
+                picked.push_back(netID);
 
                 weaponElem = weaponElem->NextSiblingElement();
             }
@@ -143,20 +159,36 @@ void PlayerDataUpdater::collect(string info)
     }
 }
 
-void PlayerDataUpdater::updateData(Player* player, bool interpolation, map < string, GameObject* > gameObjects)
+void PlayerDataUpdater::updatePosition(Player* player, bool interpolation)
 {
-    int playerID = player->getID();
+    if (!player->isActive())
+    {
+        objParser->updatePhysicsObject(player->getGameObject(), interpolation, tick);
+        return;
+    }
 
-    interpolation = player->isActive() ? false : interpolation;
+    /* the own soldier is predicted, the server position only corrects it */
+    auto it = inputSeqs.find(player->getID());
+    mat4 model;
 
-    objParser->updatePhysicsObject(player->getGameObject(), interpolation, timeStamp);
+    if (it != inputSeqs.end() && player->getGameObject() && objParser->getModel(player->getGameObject()->getName(), model))
+    {
+        player->reconcile(it->second, vec3(model[3]));
+    }
+}
+
+void PlayerDataUpdater::updateData(Player* player, bool interpolation, vector < GameObject* > netObjects)
+{
+    int playerID = player->getID();
+
+    updatePosition(player, interpolation);
 
     if (speeds.find(playerID) != speeds.end())
     {
         player->setSpeed(speeds[playerID]);
     }
 
-    if (moveDirections.find(playerID) != moveDirections.end())
+    if (!player->isActive() && moveDirections.find(playerID) != moveDirections.end())
     {
         player->updateModel(moveDirections[playerID]);
         player->updateAnimation(moveDirections[playerID]);
@@ -174,14 +206,15 @@ void PlayerDataUpdater::updateData(Player* player, bool interpolation, map < str
         soldier->setHealth(healths[playerID]);
     }
 
-    if (pickedWeapons.empty() || gameObjects.empty())
+    if (pickedWeapons.empty() || netObjects.empty())
     {
         return;
     }
 
     for (int j = int(pickedWeapons[playerID].size()) - 1; j >= 0; j--)
     {
-        GameObject* gameObject = gameObjects.find(pickedWeapons[playerID][j])->second;
+        size_t netID = pickedWeapons[playerID][j];
+        GameObject* gameObject = netID < netObjects.size() ? netObjects[netID] : nullptr;
         Weapon* weapon = dynamic_cast < Weapon* >(gameObject);
 
         if (!weapon)
@@ -193,7 +226,7 @@ void PlayerDataUpdater::updateData(Player* player, bool interpolation, map < str
     }
 }
 
-void PlayerDataUpdater::updateData(vector < Player* > players, bool interpolation, map < string, GameObject* > gameObjects)
+void PlayerDataUpdater::updateData(vector < Player* > players, bool interpolation, vector < GameObject* > netObjects)
 {
     for (size_t i = 0; i < playerIDs.size(); i++)
     {
@@ -209,14 +242,14 @@ void PlayerDataUpdater::updateData(vector < Player* > players, bool interpolatio
             }
         }
         
-        objParser->updatePhysicsObject(player->getGameObject(), interpolation, timeStamp);
+        updatePosition(player, interpolation);
 
         if (speeds.find(playerID) != speeds.end())
         {
             player->setSpeed(speeds[playerID]);
         }
 
-        if (moveDirections.find(playerID) != moveDirections.end())
+        if (!player->isActive() && moveDirections.find(playerID) != moveDirections.end())
         {
             player->updateModel(moveDirections[playerID]);
             player->updateAnimation(moveDirections[playerID]);
@@ -234,14 +267,15 @@ void PlayerDataUpdater::updateData(vector < Player* > players, bool interpolatio
             soldier->setHealth(healths[playerID]);
         }
 
-        if (pickedWeapons.empty() || gameObjects.empty())
+        if (pickedWeapons.empty() || netObjects.empty())
         {
             continue;
         }
 
         for (int j = int(pickedWeapons[playerID].size()) - 1; j >= 0; j--)
         {
-            GameObject* gameObject = gameObjects.find(pickedWeapons[playerID][j])->second;
+            size_t netID = pickedWeapons[playerID][j];
+            GameObject* gameObject = netID < netObjects.size() ? netObjects[netID] : nullptr;
             Weapon* weapon = dynamic_cast < Weapon* >(gameObject);
 
             if (!weapon)
@@ -264,6 +298,16 @@ vector < int > PlayerDataUpdater::getPlayerIDs() const
     return playerIDs;
 }
 
+unsigned int PlayerDataUpdater::getTick() const
+{
+    return tick;
+}
+
+unsigned int PlayerDataUpdater::getTimeStamp() const
+{
+    return timeStamp;
+}
+
 void PlayerDataUpdater::clear()
 {
     playerIDs.clear();
@@ -272,8 +316,10 @@ void PlayerDataUpdater::clear()
     objParser->clear();
     pickedWeapons.clear();
     healths.clear();
+    inputSeqs.clear();
 
     timeStamp = 0;
+    tick = 0;
 }
 
 PlayerDataUpdater::~PlayerDataUpdater() 
@@ -19,22 +19,28 @@ class PlayerDataUpdater
         
         PhysicsObjectDataParser* objParser;
 
-        map < int, vector < string > > pickedWeapons;
+        map < int, vector < int > > pickedWeapons;
 
         map < int, int > healths;
+        map < int, unsigned int > inputSeqs; /* the own soldier reconciles against it */
 
         unsigned int timeStamp;
+        unsigned int tick;
+
+        void updatePosition(Player* player, bool interpolation);
 
     public:
         PlayerDataUpdater();
 
         void collect(string info);
 
-        void updateData(Player* player, bool interpolation = false, map < string, GameObject* > gameObjects = {});
-        void updateData(vector < Player* > players, bool interpolation = false, map < string, GameObject* > gameObjects = {});
+        void updateData(Player* player, bool interpolation = false, vector < GameObject* > netObjects = {});
+        void updateData(vector < Player* > players, bool interpolation = false, vector < GameObject* > netObjects = {});
 
         int getPlayerID(int index = 0) const;
         vector < int > getPlayerIDs() const;
+        unsigned int getTick() const;
+        unsigned int getTimeStamp() const;
         
         void clear();
         
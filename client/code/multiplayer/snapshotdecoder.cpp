@@ -0,0 +1,201 @@
+#include "../shader/shader.hpp"
+#include "../shader/uniformbuffer.hpp"
+
+#include "../global/globaluse.hpp"
+
+#include "../framebuffer/framebuffer.hpp"
+#include "../framebuffer/colorbuffer.hpp"
+
+#include "../window/renderquad.hpp"
+#include "../window/glfwevents.hpp"
+#include "../window/window.hpp"
+
+#include "../player/camera.hpp"
+
+#include "../debug/debugdrawer.hpp"
+
+#include "../world/raytracer.hpp"
+#include "../world/constrainthandler.hpp"
+#include "../world/bulletevents.hpp"
+#include "../world/world.hpp"
+
+#include "../game_object/sphere.hpp"
+#include "../game_object/openglmotionstate.hpp"
+#include "../game_object/animation.hpp"
+#include "../game_object/glstatecache.hpp"
+#include "../game_object/mesh.hpp"
+#include "../game_object/bone.hpp"
+#include "../game_object/animationclip.hpp"
+#include "../game_object/skeleton.hpp"
+#include "../game_object/viewfrustum.hpp"
+#include "../game_object/boundsphere.hpp"
+#include "../game_object/modelloader.hpp"
+#include "../game_object/physicsobject.hpp"
+#include "../game_object/transformbuffer.hpp"
+#include "../game_object/renderqueue.hpp"
+#include "../game_object/gameobject.hpp"
+#include "../game_object/weapon.hpp"
+#include "../game_object/rifle.hpp"
+
+#include "../player/inputhistory.hpp"
+#include "../player/player.hpp"
+#include "../player/soldier.hpp"
+
+#include "snapshotreader.hpp"
+#include "snapshotdecoder.hpp"
+
+SnapshotDecoder::SnapshotDecoder() {}
+
+quat SnapshotDecoder::unpackRotation(unsigned int rotation) const
+{
+    int largest = rotation >> 30;
+
+    float q[4];
+    float sum = 0.0;
+    int shift = 20;
+
+    for (int i = 0; i < 4; i++)
+    {
+        if (i == largest)
+        {
+            continue;
+        }
+
+        q[i] = (((rotation >> shift) & 1023) / 1023.0 * 2.0 - 1.0) / M_SQRT2;
+        sum += q[i] * q[i];
+        shift -= 10;
+    }
+
+    q[largest] = sqrt(std::max(0.0f, 1.0f - sum));
+
+    return quat(q[3], q[0], q[1], q[2]);
+}
+
+mat4 SnapshotDecoder::getModel(const Entity& entity) const
+{
+    vec3 position = vec3(entity.position[0], entity.position[1], entity.position[2]) / float(SNAPSHOT_POSITION_SCALE);
+
+    return translate(mat4(1.0), position) * toMat4(unpackRotation(entity.rotation));
+}
+
+void SnapshotDecoder::updateData(vector < Player* > players, bool interpolation)
+{
+    for (auto& i: changed)
+    {
+        const Entity& entity = entities[i.first];
+        Player* player = nullptr;
+
+        for (size_t j = 0; j < players.size(); j++)
+        {
+            if (players[j]->getID() == entity.id)
+            {
+                player = players[j];
+                break;
+            }
+        }
+
+        if (!player || !player->getGameObject())
+        {
+            continue;
+        }
+
+        if (i.second & REMOVED)
+        {
+            player->setConnected(false);
+            continue;
+        }
+
+        /* out of our interest, not where the last state left it */
+        if (i.second & HIDDEN)
+        {
+            player->getGameObject()->setVisible(false);
+            player->getGameObject()->setCollidable(false);
+            player->getGameObject()->setStatic(true);
+            continue;
+        }
+
+        if (player->isActive())
+        {
+            /* a respawn turns the predicted soldier, where it is comes from the reconciliation */
+            if ((i.second & ROTATION) && (entity.mask & POSITION))
+            {
+                mat4 model = getModel(entity);
+                model[3] = player->getGameObject()->getPhysicsObjectTransform()[3];
+
+                player->getGameObject()->setPhysicsObjectTransform(model);
+            }
+
+            if ((i.second & (POSITION | INPUT)) && (entity.mask & POSITION) && (entity.mask & INPUT))
+            {
+                player->reconcile(entity.input, vec3(entity.position[0], entity.position[1], entity.position[2]) / float(SNAPSHOT_POSITION_SCALE));
+            }
+        }
+        else if ((i.second & (POSITION | ROTATION)) && (entity.mask & POSITION) && (entity.mask & ROTATION))
+        {
+            /* a hidden one comes back where it is, not gliding from where it was hidden */
+            player->getGameObject()->setPhysicsObjectTransform(getModel(entity), interpolation && !(i.second & RESTORED), tick);
+        }
+
+        if ((i.second & (POSITION | DIRECTION)) && (entity.mask & DIRECTION))
+        {
+            vec3 moveDirection = vec3(entity.direction[0], entity.direction[1], entity.direction[2]) / 127.0f;
+
+            player->updateModel(moveDirection);
+            player->updateAnimation(moveDirection);
+        }
+
+        Soldier* soldier = dynamic_cast < Soldier* >(player);
+
+        if (soldier && (i.second & HEALTH))
+        {
+            soldier->setHealth(entity.health);
+        }
+
+        /* a dead one stays hidden, the respawn shows it */
+        if ((i.second & RESTORED) && player->isConnected() && (!soldier || soldier->getHealth() > 0))
+        {
+            player->getGameObject()->setVisible(!player->isActive());
+            player->getGameObject()->setCollidable(true);
+            player->getGameObject()->setStatic(false);
+        }
+    }
+}
+
+void SnapshotDecoder::updateData(vector < GameObject* > netObjects, bool interpolation)
+{
+    for (auto& i: changed)
+    {
+        const Entity& entity = entities[i.first];
+        size_t netID = entity.id;
+
+        /* a weapon in hands belongs to its soldier, the pick and the drop move it */
+        if (netID >= netObjects.size() || !netObjects[netID] || netObjects[netID]->getUserPointer())
+        {
+            continue;
+        }
+
+        if (i.second & (REMOVED | HIDDEN))
+        {
+            netObjects[netID]->setVisible(false);
+            netObjects[netID]->setCollidable(false);
+            netObjects[netID]->setStatic(true);
+            continue;
+        }
+
+        if (i.second & RESTORED)
+        {
+            netObjects[netID]->setStatic(false);
+            netObjects[netID]->setCollidable(true);
+            netObjects[netID]->setVisible(true);
+        }
+
+        if (!(entity.mask & POSITION) || !(entity.mask & ROTATION))
+        {
+            continue;
+        }
+
+        netObjects[netID]->setPhysicsObjectTransform(getModel(entity), interpolation && !(i.second & RESTORED), tick);
+    }
+}
+
+SnapshotDecoder::~SnapshotDecoder() {}
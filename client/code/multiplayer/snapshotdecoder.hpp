@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+using namespace std;
+using namespace glm;
+
+/* puts what the SnapshotReader read onto the players and the net objects of the level */
+class SnapshotDecoder : public SnapshotReader
+{
+    private:
+        quat unpackRotation(unsigned int rotation) const;
+        mat4 getModel(const Entity& entity) const;
+
+    public:
+        SnapshotDecoder();
+
+        void updateData(vector < Player* > players, bool interpolation = true);
+        void updateData(vector < GameObject* > netObjects, bool interpolation = true);
+
+        ~SnapshotDecoder();
+};
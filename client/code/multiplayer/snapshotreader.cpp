@@ -0,0 +1,339 @@
+#include "snapshotreader.hpp"
+
+SnapshotReader::SnapshotReader()
+{
+    soldiersAck = 0;
+    objsAck = 0;
+    lastSoldiersAck = 0;
+    lastObjsAck = 0;
+
+    kind = 0;
+    timeStamp = 0;
+    tick = 0;
+}
+
+bool SnapshotReader::readVarint(const string& data, size_t& pos, unsigned int& value) const
+{
+    value = 0;
+
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        if (pos >= data.size())
+        {
+            return false;
+        }
+
+        unsigned char byte = data[pos++];
+        value |= (unsigned int)(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool SnapshotReader::readSignedVarint(const string& data, size_t& pos, int& value) const
+{
+    unsigned int raw = 0;
+
+    if (!readVarint(data, pos, raw))
+    {
+        return false;
+    }
+
+    value = int(raw >> 1) ^ -int(raw & 1);
+
+    return true;
+}
+
+bool SnapshotReader::isSnapshot(const string& info) const
+{
+    return !info.empty() && info[0] == '#';
+}
+
+bool SnapshotReader::collect(const string& data)
+{
+    if (!isSnapshot(data))
+    {
+        return false;
+    }
+
+    size_t pos = 3;
+
+    /* '#', version, kind */
+    if (data.size() < 3 || data[1] != SNAPSHOT_VERSION || (data[2] != 'S' && data[2] != 'O'))
+    {
+        return false;
+    }
+
+    /* nothing is kept before the whole snapshot is read, a stale or broken one changes nothing */
+    char nextKind = data[2];
+
+    unsigned int seq = 0, baseSeq = 0, nextTimeStamp = 0, nextTick = 0, count = 0;
+
+    if (!readVarint(data, pos, seq) || !readVarint(data, pos, baseSeq) || !readVarint(data, pos, nextTimeStamp) || !readVarint(data, pos, nextTick) || !readVarint(data, pos, count))
+    {
+        return false;
+    }
+
+    deque < State >& states = nextKind == 'S' ? soldierStates : objStates;
+    unsigned int& ack = nextKind == 'S' ? soldiersAck : objsAck;
+
+    if (seq <= ack)
+    {
+        return false;
+    }
+
+    map < string, unsigned char > nextChanged;
+    map < string, Entity > nextEntities;
+
+    State next;
+    next.seq = seq;
+
+    /* baseline */
+    if (baseSeq)
+    {
+        bool found = false;
+
+        for (size_t i = 0; i < states.size(); i++)
+        {
+            if (states[i].seq == baseSeq)
+            {
+                next.entities = states[i].entities;
+                found = true;
+                break;
+            }
+        }
+
+        if (!found)
+        {
+            return false;
+        }
+    }
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        /* player id or level net id */
+        unsigned int id = 0;
+
+        if (!readVarint(data, pos, id))
+        {
+            return false;
+        }
+
+        string key = to_string(id);
+
+        if (pos >= data.size())
+        {
+            return false;
+        }
+
+        unsigned char flags = data[pos++];
+
+        if (flags & (REMOVED | HIDDEN))
+        {
+            Entity removed;
+            memset(&removed, 0, sizeof(Entity));
+            removed.id = id;
+
+            next.entities.erase(key);
+
+            if (nextKind == 'O')
+            {
+                removedObjs.insert(key);
+            }
+            else if (flags & HIDDEN)
+            {
+                hiddenSoldiers.insert(key);
+            }
+
+            nextChanged[key] = flags & (REMOVED | HIDDEN);
+            nextEntities[key] = removed;
+
+            continue;
+        }
+
+        Entity& entity = next.entities[key];
+        entity.id = id;
+
+        if (flags & POSITION)
+        {
+            for (int j = 0; j < 3; j++)
+            {
+                int delta = 0;
+
+                if (!readSignedVarint(data, pos, delta))
+                {
+                    return false;
+                }
+
+                entity.position[j] = ((entity.mask & POSITION) ? entity.position[j] : 0) + delta;
+            }
+        }
+
+        if (flags & ROTATION)
+        {
+            if (pos + 4 > data.size())
+            {
+                return false;
+            }
+
+            entity.rotation = 0;
+
+            for (int j = 0; j < 4; j++)
+            {
+                entity.rotation |= (unsigned int)(unsigned char)data[pos++] << (j * 8);
+            }
+        }
+
+        if (flags & DIRECTION)
+        {
+            if (pos + 3 > data.size())
+            {
+                return false;
+            }
+
+            for (int j = 0; j < 3; j++)
+            {
+                entity.direction[j] = data[pos++];
+            }
+        }
+
+        if (flags & HEALTH)
+        {
+            if (!readSignedVarint(data, pos, entity.health))
+            {
+                return false;
+            }
+        }
+
+        if (flags & INPUT)
+        {
+            if (!readVarint(data, pos, entity.input))
+            {
+                return false;
+            }
+        }
+
+        entity.mask |= flags;
+
+        if ((nextKind == 'O' ? removedObjs : hiddenSoldiers).erase(key))
+        {
+            flags |= RESTORED;
+        }
+
+        nextChanged[key] = flags;
+        nextEntities[key] = entity;
+    }
+
+    kind = nextKind;
+    timeStamp = nextTimeStamp;
+    tick = nextTick;
+
+    for (auto& i: nextChanged)
+    {
+        changed[i.first] = i.second;
+        entities[i.first] = nextEntities[i.first];
+    }
+
+    /* older snapshots will never be used as a baseline again */
+    while (!states.empty() && states.front().seq < baseSeq)
+    {
+        states.pop_front();
+    }
+
+    states.push_back(move(next));
+
+    if (states.size() > SNAPSHOT_HISTORY)
+    {
+        states.pop_front();
+    }
+
+    unique_lock < mutex > lk(mtx);
+    ack = seq;
+
+    return true;
+}
+
+char SnapshotReader::getKind() const
+{
+    return kind;
+}
+
+unsigned int SnapshotReader::getTick() const
+{
+    return tick;
+}
+
+unsigned int SnapshotReader::getTimeStamp() const
+{
+    return timeStamp;
+}
+
+bool SnapshotReader::getPosition(int id, vec3& position) const
+{
+    auto it = entities.find(to_string(id));
+
+    if (it == entities.end() || !(it->second.mask & POSITION))
+    {
+        return false;
+    }
+
+    position = vec3(it->second.position[0], it->second.position[1], it->second.position[2]) / float(SNAPSHOT_POSITION_SCALE);
+
+    return true;
+}
+
+string SnapshotReader::getProtoData(int playerID) const
+{
+    return "<Proto><id>" + to_string(playerID) + "</id><snap>" + to_string(SNAPSHOT_VERSION) + "</snap></Proto>";
+}
+
+string SnapshotReader::getAckData(int playerID) const
+{
+    unique_lock < mutex > lk(mtx);
+
+    if (soldiersAck == lastSoldiersAck && objsAck == lastObjsAck)
+    {
+        return "";
+    }
+
+    lastSoldiersAck = soldiersAck;
+    lastObjsAck = objsAck;
+
+    return "<Ack><id>" + to_string(playerID) + "</id><soldiers>" + to_string(soldiersAck) + "</soldiers><objs>" + to_string(objsAck) + "</objs></Ack>";
+}
+
+void SnapshotReader::clear()
+{
+    kind = 0;
+    timeStamp = 0;
+    tick = 0;
+
+    changed.clear();
+    entities.clear();
+}
+
+void SnapshotReader::clearAll()
+{
+    clear();
+
+    soldierStates.clear();
+    objStates.clear();
+    removedObjs.clear();
+    hiddenSoldiers.clear();
+
+    unique_lock < mutex > lk(mtx);
+
+    soldiersAck = 0;
+    objsAck = 0;
+    lastSoldiersAck = 0;
+    lastObjsAck = 0;
+}
+
+SnapshotReader::~SnapshotReader() {}
+
+
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <mutex>
+
+#include <glm/glm.hpp>
+
+#define SNAPSHOT_VERSION 5
+#define SNAPSHOT_HISTORY 32
+#define SNAPSHOT_POSITION_SCALE 512.0
+
+using namespace std;
+using namespace glm;
+
+/*
+ * reads the binary snapshots produced by the server SnapshotEncoder and keeps the baselines
+ * and the acks, without a scene, so the bots read them the same way as the game
+ */
+class SnapshotReader
+{
+    protected:
+        enum Flags
+        {
+            POSITION = 1,
+            ROTATION = 2,
+            DIRECTION = 4,
+            HEALTH = 8,
+            INPUT = 16,
+            REMOVED = 32, /* alone, the server doesn't have the entity anymore */
+            HIDDEN = 64, /* alone, the entity is out of our interest */
+            RESTORED = 128 /* never on the wire, a removed obj or a hidden entity came back */
+        };
+
+        struct Entity
+        {
+            int id;
+            unsigned char mask;
+
+            int position[3];
+            unsigned int rotation;
+            signed char direction[3];
+            int health;
+            unsigned int input; /* own soldier only, the last input command the server applied */
+        };
+
+        struct State
+        {
+            unsigned int seq;
+            map < string, Entity > entities;
+        };
+
+        deque < State > soldierStates;
+        deque < State > objStates;
+
+        set < string > removedObjs; /* hidden by a REMOVED or a HIDDEN, until their net id comes back */
+        set < string > hiddenSoldiers; /* hidden by a HIDDEN, until their id comes back */
+
+        unsigned int soldiersAck;
+        unsigned int objsAck;
+        mutable unsigned int lastSoldiersAck;
+        mutable unsigned int lastObjsAck;
+        mutable mutex mtx;
+
+        char kind;
+        unsigned int timeStamp;
+        unsigned int tick;
+        map < string, unsigned char > changed;
+        map < string, Entity > entities;
+
+        bool readVarint(const string& data, size_t& pos, unsigned int& value) const;
+        bool readSignedVarint(const string& data, size_t& pos, int& value) const;
+
+    public:
+        SnapshotReader();
+
+        bool isSnapshot(const string& info) const;
+
+        bool collect(const string& data);
+
+        char getKind() const;
+        unsigned int getTick() const;
+        unsigned int getTimeStamp() const;
+        bool getPosition(int id, vec3& position) const; /* of the last collected snapshot */
+
+        string getProtoData(int playerID) const;
+        string getAckData(int playerID) const;
+
+        void clear();
+        void clearAll();
+
+        virtual ~SnapshotReader();
+};
@@ -1,4 +1,5 @@
 #include "../shader/shader.hpp"
+#include "../shader/uniformbuffer.hpp"
 
 #include "../global/globaluse.hpp"
 
@@ -21,13 +22,17 @@
 #include "../game_object/sphere.hpp"
 #include "../game_object/openglmotionstate.hpp"
 #include "../game_object/animation.hpp"
+#include "../game_object/glstatecache.hpp"
 #include "../game_object/mesh.hpp"
 #include "../game_object/bone.hpp"
+#include "../game_object/animationclip.hpp"
 #include "../game_object/skeleton.hpp"
 #include "../game_object/viewfrustum.hpp"
 #include "../game_object/boundsphere.hpp"
 #include "../game_object/modelloader.hpp"
 #include "../game_object/physicsobject.hpp"
+#include "../game_object/transformbuffer.hpp"
+#include "../game_object/renderqueue.hpp"
 #include "../game_object/gameobject.hpp"
 #include "../game_object/weapon.hpp"
 #include "../game_object/rifle.hpp"
@@ -125,6 +130,7 @@ void WeaponDataUpdater::collect(string info)
     }
 
     names = objParser->getNames();
+    netIDs = objParser->getNetIDs();
 }
 
 void WeaponDataUpdater::updateData(map < string, GameObject* > gameObjects, bool interpolation)
@@ -185,10 +191,16 @@ vector < string > WeaponDataUpdater::getNames() const
     return names;
 }
 
+vector < int > WeaponDataUpdater::getNetIDs() const
+{
+    return netIDs;
+}
+
 void WeaponDataUpdater::clear()
 {
     objParser->clear();
     names.clear();
+    netIDs.clear();
 
     storages.clear();
     sizes.clear();
@@ -14,6 +14,7 @@ class WeaponDataUpdater
     private:
         PhysicsObjectDataParser* objParser;
         vector < string > names;
+        vector < int > netIDs;
 
         map < string, int > storages;
         map < string, int > sizes;
@@ -29,6 +30,7 @@ class WeaponDataUpdater
         void updateData(map < string, GameObject* > gameObjects, bool interpolation = false);
 
         vector < string > getNames() const;
+        vector < int > getNetIDs() const;
 
         void clear();
 
@@ -1,40 +1,5 @@
-#include "../shader/shader.hpp"
-
 #include "../global/globaluse.hpp"
 
-#include "../framebuffer/framebuffer.hpp"
-#include "../framebuffer/colorbuffer.hpp"
-
-#include "../window/renderquad.hpp"
-#include "../window/glfwevents.hpp"
-#include "../window/window.hpp"
-
-#include "../player/camera.hpp"
-
-#include "../debug/debugdrawer.hpp"
-
-#include "../world/raytracer.hpp"
-#include "../world/constrainthandler.hpp"
-#include "../world/bulletevents.hpp"
-#include "../world/world.hpp"
-
-#include "../game_object/sphere.hpp"
-#include "../game_object/openglmotionstate.hpp"
-#include "../game_object/animation.hpp"
-#include "../game_object/mesh.hpp"
-#include "../game_object/bone.hpp"
-#include "../game_object/skeleton.hpp"
-#include "../game_object/viewfrustum.hpp"
-#include "../game_object/boundsphere.hpp"
-#include "../game_object/modelloader.hpp"
-#include "../game_object/physicsobject.hpp"
-#include "../game_object/gameobject.hpp"
-#include "../game_object/weapon.hpp"
-#include "../game_object/rifle.hpp"
-
-#include "../player/player.hpp"
-#include "../player/soldier.hpp"
-
 #include "weapondroppercollector.hpp"
 
 WeaponDropperCollector::WeaponDropperCollector() 
@@ -49,27 +14,13 @@ void WeaponDropperCollector::setPlayerID(int playerID)
     this->playerID = playerID;
 }
 
-void WeaponDropperCollector::collect(Player* player)
+void WeaponDropperCollector::collect(bool dropTo, const mat4& model)
 {
-    Soldier* soldier = dynamic_cast < Soldier* >(player);
-
-    if (!soldier)
-    {
-        throw(runtime_error("ERROR::WeaponDropperCollector::collect() player is not a soldier"));
-    }
-
-    dropTo = soldier->isDrop();
-    
-    if (!dropTo)
-    {
-        return;
-    }
-
-    deque < Weapon* > weapons = soldier->getWeapons();
+    this->dropTo = dropTo;
 
-    if (!weapons.empty() && weapons[0])
+    if (dropTo)
     {
-        model = weapons[0]->getPhysicsObjectTransform();
+        this->model = model;
     }
 }
 
@@ -113,9 +64,7 @@ string WeaponDropperCollector::getData() const
     XMLPrinter weaponDropperPrinter;
     weaponDropperDoc.Print(&weaponDropperPrinter);
 
-    string res("BEG\n");
-    res += weaponDropperPrinter.CStr();
-    res += "END\n";
+    string res(weaponDropperPrinter.CStr());
 
     return res;    
 }
@@ -22,7 +22,7 @@ class WeaponDropperCollector
 
         void setPlayerID(int playerID);
 
-        void collect(Player* player);
+        void collect(bool dropTo, const mat4& model);
 
         string getData() const;
 
@@ -1,4 +1,5 @@
 #include "../shader/shader.hpp"
+#include "../shader/uniformbuffer.hpp"
 
 #include "../global/globaluse.hpp"
 
@@ -21,17 +22,22 @@
 #include "../game_object/sphere.hpp"
 #include "../game_object/openglmotionstate.hpp"
 #include "../game_object/animation.hpp"
+#include "../game_object/glstatecache.hpp"
 #include "../game_object/mesh.hpp"
 #include "../game_object/bone.hpp"
+#include "../game_object/animationclip.hpp"
 #include "../game_object/skeleton.hpp"
 #include "../game_object/viewfrustum.hpp"
 #include "../game_object/boundsphere.hpp"
 #include "../game_object/modelloader.hpp"
 #include "../game_object/physicsobject.hpp"
+#include "../game_object/transformbuffer.hpp"
+#include "../game_object/renderqueue.hpp"
 #include "../game_object/gameobject.hpp"
 #include "../game_object/weapon.hpp"
 #include "../game_object/rifle.hpp"
 
+#include "../player/inputhistory.hpp"
 #include "../player/player.hpp"
 #include "../player/soldier.hpp"
 
@@ -68,16 +74,17 @@ void WeaponDropperUpdater::collect(string info)
     
     XMLElement* weaponsElem = root->FirstChildElement("wpns");
 
-    /* name */
-    XMLElement* nameElem = weaponsElem->FirstChildElement("name");
+    /* netIDs */
+    XMLElement* weaponElem = weaponsElem->FirstChildElement("wpn");
 
-    while (nameElem)
+    while (weaponElem)
     {
-        string name = nameElem->GetText();
+        int netID = -1;
+        weaponElem->QueryIntText(&netID);
 
-        names.push_back(name);
+        netIDs.push_back(netID);
 
-        nameElem = nameElem->NextSiblingElement();
+        weaponElem = weaponElem->NextSiblingElement();
     }
 }
 
@@ -105,15 +112,15 @@ int WeaponDropperUpdater::getPlayerID() const
     return playerID;
 }
 
-vector < string > WeaponDropperUpdater::getNames() const
+vector < int > WeaponDropperUpdater::getNetIDs() const
 {
-    return names;
+    return netIDs;
 }
 
 void WeaponDropperUpdater::clear()
 {
     playerID = 0;
-    names.clear();
+    netIDs.clear();
 }
 
 WeaponDropperUpdater::~WeaponDropperUpdater() {}
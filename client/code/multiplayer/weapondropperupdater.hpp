@@ -14,7 +14,7 @@ class WeaponDropperUpdater
     private:
         int playerID;
 
-        vector < string > names;
+        vector < int > netIDs;
         
     public:
         WeaponDropperUpdater();
@@ -24,7 +24,7 @@ class WeaponDropperUpdater
         void updateData(Player* player, GameObject* gameObject);
         
         int getPlayerID() const;
-        vector < string > getNames() const;
+        vector < int > getNetIDs() const;
 
         void clear();
 
@@ -1,45 +1,11 @@
-#include "../shader/shader.hpp"
-
 #include "../global/globaluse.hpp"
 
-#include "../framebuffer/framebuffer.hpp"
-#include "../framebuffer/colorbuffer.hpp"
-
-#include "../window/renderquad.hpp"
-#include "../window/glfwevents.hpp"
-#include "../window/window.hpp"
-
-#include "../player/camera.hpp"
-
-#include "../debug/debugdrawer.hpp"
-
-#include "../world/raytracer.hpp"
-#include "../world/constrainthandler.hpp"
-#include "../world/bulletevents.hpp"
-#include "../world/world.hpp"
-
-#include "../game_object/sphere.hpp"
-#include "../game_object/openglmotionstate.hpp"
-#include "../game_object/animation.hpp"
-#include "../game_object/mesh.hpp"
-#include "../game_object/bone.hpp"
-#include "../game_object/skeleton.hpp"
-#include "../game_object/viewfrustum.hpp"
-#include "../game_object/boundsphere.hpp"
-#include "../game_object/modelloader.hpp"
-#include "../game_object/physicsobject.hpp"
-#include "../game_object/gameobject.hpp"
-#include "../game_object/weapon.hpp"
-#include "../game_object/rifle.hpp"
-
-#include "../player/player.hpp"
-#include "../player/soldier.hpp"
-
 #include "weaponfirecollector.hpp"
 
 WeaponFireCollector::WeaponFireCollector()
 {
     playerID = 0;
+    tick = 0;
 }
 
 void WeaponFireCollector::setPlayerID(int playerID)
@@ -47,17 +13,15 @@ void WeaponFireCollector::setPlayerID(int playerID)
     this->playerID = playerID;
 }
 
-void WeaponFireCollector::collect(Player* player)
+void WeaponFireCollector::setTick(unsigned int tick)
 {
-    Soldier* soldier = dynamic_cast < Soldier* >(player);
-
-    if (!soldier)
-    {
-        throw(runtime_error("ERROR::WeaponFireCollector::collect() player is not a soldier"));
-    }
+    this->tick = tick;
+}
 
-    fireInfo = soldier->getFire();
-    reloadInfo = soldier->getReload();
+void WeaponFireCollector::collect(const map < int, vector < pair < vec3, vec3 > > >& fireInfo, const map < int, bool >& reloadInfo)
+{
+    this->fireInfo = fireInfo;
+    this->reloadInfo = reloadInfo;
 }
 
 string WeaponFireCollector::getData() const
@@ -80,14 +44,20 @@ string WeaponFireCollector::getData() const
 
     root->InsertEndChild(playerIDElem);
 
+    /* server tick on the screen, hits are checked against the poses of that tick */
+    XMLElement* tickElem = weaponFireDoc.NewElement("tick");
+    tickElem->SetText(tick);
+
+    root->InsertEndChild(tickElem);
+
     for (auto& i : fireInfo)
     {     
         XMLElement* weaponElem = weaponFireDoc.NewElement("wpn");
 
-        XMLElement* nameElem = weaponFireDoc.NewElement("name");
-        nameElem->SetText(i.first.data());
+        XMLElement* netIDElem = weaponFireDoc.NewElement("id");
+        netIDElem->SetText(i.first);
         
-        weaponElem->InsertEndChild(nameElem);
+        weaponElem->InsertEndChild(netIDElem);
 
         auto it = reloadInfo.find(i.first);
 
@@ -134,10 +104,10 @@ string WeaponFireCollector::getData() const
     {     
         XMLElement* weaponElem = weaponFireDoc.NewElement("wpn");
 
-        XMLElement* nameElem = weaponFireDoc.NewElement("name");
-        nameElem->SetText(i.first.data());
+        XMLElement* netIDElem = weaponFireDoc.NewElement("id");
+        netIDElem->SetText(i.first);
 
-        weaponElem->InsertEndChild(nameElem);
+        weaponElem->InsertEndChild(netIDElem);
 
         if (i.second)
         {
@@ -154,9 +124,7 @@ string WeaponFireCollector::getData() const
     XMLPrinter weaponFirePrinter;
     weaponFireDoc.Print(&weaponFirePrinter);
 
-    string res("BEG\n");
-    res += weaponFirePrinter.CStr();
-    res += "END\n";
+    string res(weaponFirePrinter.CStr());
 
     return res;    
 }
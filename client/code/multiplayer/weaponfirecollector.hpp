@@ -3,6 +3,8 @@
 #include <stdexcept>
 #include <vector>
 #include <string>
+#include <map>
+#include <utility>
 
 #include <tinyxml2/tinyxml2.h>
 
@@ -13,16 +15,18 @@ class WeaponFireCollector
 {
     private:
         int playerID;
+        unsigned int tick;
 
-        map < string, vector < pair < vec3, vec3 > > > fireInfo;
-        mutable map < string, bool > reloadInfo;
+        map < int, vector < pair < vec3, vec3 > > > fireInfo;
+        mutable map < int, bool > reloadInfo;
 
     public:
         WeaponFireCollector();
 
         void setPlayerID(int playerID);
+        void setTick(unsigned int tick);
 
-        void collect(Player* player);
+        void collect(const map < int, vector < pair < vec3, vec3 > > >& fireInfo, const map < int, bool >& reloadInfo);
 
         string getData() const;
 
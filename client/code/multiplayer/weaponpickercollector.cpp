@@ -1,40 +1,5 @@
-#include "../shader/shader.hpp"
-
 #include "../global/globaluse.hpp"
 
-#include "../framebuffer/framebuffer.hpp"
-#include "../framebuffer/colorbuffer.hpp"
-
-#include "../window/renderquad.hpp"
-#include "../window/glfwevents.hpp"
-#include "../window/window.hpp"
-
-#include "../player/camera.hpp"
-
-#include "../debug/debugdrawer.hpp"
-
-#include "../world/raytracer.hpp"
-#include "../world/constrainthandler.hpp"
-#include "../world/bulletevents.hpp"
-#include "../world/world.hpp"
-
-#include "../game_object/sphere.hpp"
-#include "../game_object/openglmotionstate.hpp"
-#include "../game_object/animation.hpp"
-#include "../game_object/mesh.hpp"
-#include "../game_object/bone.hpp"
-#include "../game_object/skeleton.hpp"
-#include "../game_object/viewfrustum.hpp"
-#include "../game_object/boundsphere.hpp"
-#include "../game_object/modelloader.hpp"
-#include "../game_object/physicsobject.hpp"
-#include "../game_object/gameobject.hpp"
-#include "../game_object/weapon.hpp"
-#include "../game_object/rifle.hpp"
-
-#include "../player/player.hpp"
-#include "../player/soldier.hpp"
-
 #include "weaponpickercollector.hpp"
 
 WeaponPickerCollector::WeaponPickerCollector() 
@@ -48,18 +13,10 @@ void WeaponPickerCollector::setPlayerID(int playerID)
     this->playerID = playerID;
 }
 
-void WeaponPickerCollector::collect(Player* player)
+void WeaponPickerCollector::collect(const pair < vec3, vec3 >& pickRay)
 {
-    Soldier* soldier = dynamic_cast < Soldier* >(player);
-
-    if (!soldier)
-    {
-        throw(runtime_error("ERROR::WeaponPickerCollector::collect() player is not a soldier"));
-    }
-
-    pair < vec3, vec3 > ray = soldier->getPickRay();
-    pickFrom = ray.first;
-    pickTo = ray.second;
+    pickFrom = pickRay.first;
+    pickTo = pickRay.second;
 }
 
 string WeaponPickerCollector::getData() const
@@ -102,9 +59,7 @@ string WeaponPickerCollector::getData() const
     XMLPrinter weaponPickerPrinter;
     weaponPickerDoc.Print(&weaponPickerPrinter);
 
-    string res("BEG\n");
-    res += weaponPickerPrinter.CStr();
-    res += "END\n";
+    string res(weaponPickerPrinter.CStr());
 
     return res;    
 }
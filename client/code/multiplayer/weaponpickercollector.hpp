@@ -3,6 +3,7 @@
 #include <stdexcept>
 #include <vector>
 #include <string>
+#include <utility>
 
 #include <tinyxml2/tinyxml2.h>
 
@@ -22,7 +23,7 @@ class WeaponPickerCollector
 
         void setPlayerID(int playerID);
 
-        void collect(Player* player);
+        void collect(const pair < vec3, vec3 >& pickRay);
 
         string getData() const;
 
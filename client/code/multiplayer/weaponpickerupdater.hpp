@@ -14,7 +14,7 @@ class WeaponPickerUpdater
     private:
         int playerID;
 
-        vector < string > names;
+        vector < int > netIDs;
         
     public:
         WeaponPickerUpdater();
@@ -24,7 +24,7 @@ class WeaponPickerUpdater
         void updateData(Player* player, GameObject* gameObject);
         
         int getPlayerID() const;
-        vector < string > getNames() const;
+        vector < int > getNetIDs() const;
 
         void clear();
 
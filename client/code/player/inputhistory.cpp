@@ -0,0 +1,97 @@
+#include "inputhistory.hpp"
+
+InputHistory::InputHistory()
+{
+    seq = 0;
+    sent = 0;
+    acked = 0;
+}
+
+void InputHistory::record(const vec3& moveDirection, bool jump, float time, const mat4& model)
+{
+    unique_lock < mutex > lk(mtx);
+
+    InputCommand command;
+
+    command.seq = ++seq;
+    command.moveDirection = moveDirection;
+    command.jump = jump;
+    command.time = time;
+    command.rotation = normalize(quat_cast(mat3(model)));
+    command.position = vec3(model[3]);
+
+    commands.push_back(command);
+
+    while (commands.size() > INPUT_HISTORY_SIZE)
+    {
+        commands.pop_front();
+    }
+}
+
+vector < InputCommand > InputHistory::takeUnsent()
+{
+    unique_lock < mutex > lk(mtx);
+
+    vector < InputCommand > res;
+
+    for (size_t i = 0; i < commands.size(); i++)
+    {
+        if (commands[i].seq > sent)
+        {
+            res.push_back(commands[i]);
+        }
+    }
+
+    sent = seq;
+
+    return res;
+}
+
+bool InputHistory::reconcile(unsigned int ack, const vec3& serverPosition, const vec3& position, vec3& correction)
+{
+    unique_lock < mutex > lk(mtx);
+
+    /* an older state, the newer one was already taken */
+    if (ack < acked)
+    {
+        return false;
+    }
+
+    acked = ack;
+
+    while (!commands.empty() && commands.front().seq <= ack)
+    {
+        commands.pop_front();
+    }
+
+    /* the prediction right after the server's last command, the start of the next one */
+    vec3 predicted = commands.empty() ? position : commands.front().position;
+
+    correction = serverPosition - predicted;
+
+    if (length(correction) < INPUT_HISTORY_TOLERANCE)
+    {
+        return false;
+    }
+
+    /* the rest is replayed from the server position */
+    for (size_t i = 0; i < commands.size(); i++)
+    {
+        commands[i].position += correction;
+    }
+
+    return true;
+}
+
+void InputHistory::clear()
+{
+    unique_lock < mutex > lk(mtx);
+
+    commands.clear();
+
+    seq = 0;
+    sent = 0;
+    acked = 0;
+}
+
+InputHistory::~InputHistory() {}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <mutex>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#define INPUT_HISTORY_SIZE 256 /* commands kept until the server applies them, the oldest go first */
+#define INPUT_HISTORY_TOLERANCE 0.05 /* meters of prediction error left alone */
+#define INPUT_HISTORY_TELEPORT 2.0 /* meters, a bigger correction is a respawn, the velocity goes too */
+
+using namespace std;
+using namespace glm;
+
+/* one frame of the local player's input, the server runs the same ones */
+struct InputCommand
+{
+    unsigned int seq;
+    vec3 moveDirection;
+    bool jump;
+    float time; /* seconds the frame lasted */
+    quat rotation; /* facing, the server takes it as is */
+
+    vec3 position; /* predicted, before the command ran */
+};
+
+/*
+ * client side prediction. the local soldier moves right away and every frame is recorded,
+ * the server answers with where the soldier is after the last command it applied.
+ * the difference to what was predicted at that command is the error, the commands the
+ * server hasn't seen yet are replayed on top of the server position by shifting the body
+ */
+class InputHistory
+{
+    private:
+        deque < InputCommand > commands;
+
+        unsigned int seq;
+        unsigned int sent;
+        unsigned int acked;
+
+        mutable mutex mtx;
+
+    public:
+        InputHistory();
+
+        void record(const vec3& moveDirection, bool jump, float time, const mat4& model);
+
+        vector < InputCommand > takeUnsent();
+
+        bool reconcile(unsigned int ack, const vec3& serverPosition, const vec3& position, vec3& correction);
+
+        void clear();
+
+        ~InputHistory();
+};
@@ -1,4 +1,5 @@
 #include "../shader/shader.hpp"
+#include "../shader/uniformbuffer.hpp"
 
 #include "../global/globaluse.hpp"
 
@@ -21,15 +22,20 @@
 #include "../game_object/sphere.hpp"
 #include "../game_object/openglmotionstate.hpp"
 #include "../game_object/animation.hpp"
+#include "../game_object/glstatecache.hpp"
 #include "../game_object/mesh.hpp"
 #include "../game_object/bone.hpp"
+#include "../game_object/animationclip.hpp"
 #include "../game_object/skeleton.hpp"
 #include "../game_object/viewfrustum.hpp"
 #include "../game_object/boundsphere.hpp"
 #include "../game_object/modelloader.hpp"
 #include "../game_object/physicsobject.hpp"
+#include "../game_object/transformbuffer.hpp"
+#include "../game_object/renderqueue.hpp"
 #include "../game_object/gameobject.hpp"
 
+#include "inputhistory.hpp"
 #include "player.hpp"
 
 set < int > Player::globalIDs;
@@ -49,6 +55,9 @@ Player::Player(int id, Window* window, vec3 playerPos, vec3 cameraForward, float
 
     speedLock = false;
 
+    inputHistory = new InputHistory();
+    jumped = false;
+
     cameraOffset = modelOffset = vec3(0);
     modelForward = normalize(cross(Left, Up));
 
@@ -70,6 +79,9 @@ Player::Player(int id, Window* window, vec3 playerPos, vec3 cameraForward, RayTr
     this->player = player;
     
     speedLock = false;
+
+    inputHistory = new InputHistory();
+    jumped = false;
     
     cameraOffset = modelOffset = vec3(0);
     modelForward = normalize(cross(Left, Up));
@@ -130,10 +142,11 @@ bool Player::isGroundStanding()
     btVector3 Min;
     btVector3 Max;
 
-    player->getPhysicsObject()->getRigidBody()->getAabb(Min, Max);
+    btRigidBody* body = player->getPhysicsObject()->getRigidBody();
 
-    btVector3 center = player->getPhysicsObject()->getRigidBody()->getCenterOfMassPosition();
-    btVector3 to = btVector3(0, -1, 0);
+    body->getAabb(Min, Max);
+
+    btVector3 center = body->getCenterOfMassPosition();
 
     float playerBottomDist = center.y() - Min.y();
 
@@ -145,6 +158,11 @@ bool Player::isGroundStanding()
     float rayStep = 0.1;
     float whenFloor = 0.1;
 
+    /* the rays are only as long as the floor can be, a hit means standing */
+    btVector3 down = btVector3(0, -(playerBottomDist + whenFloor), 0);
+
+    groundQueries.clear();
+
     for (float i = Min.x(); i < Max.x(); i += rayStep)
     {
         for (float j = Min.z(); j < Max.z(); j += rayStep)
@@ -159,23 +177,18 @@ bool Player::isGroundStanding()
                 continue;
             }
 
-            unique_ptr < RayResult > result(rayTracer->rayCast(from, to, false));
-
-            if (!result)
-            {
-                continue;
-            }
-
-            float dist = (from - result->hitPoint).length();
-
-            if (dist < playerBottomDist + whenFloor)
-            {
-                return true;
-            }
+            groundQueries.push_back({from, from + down});
         }
     }
 
-    return false;
+    if (groundResults.size() < groundQueries.size())
+    {
+        groundResults.resize(groundQueries.size());
+    }
+
+    groundIgnored.assign(1, body);
+
+    return rayTracer->rayCast(groundQueries, groundResults, groundIgnored, false) > 0;
 }
 
 void Player::jump()
@@ -254,6 +267,7 @@ void Player::moveAction()
         if (window->isKeyPressedOnce(GLFW_KEY_SPACE))
         {
             jump();
+            jumped = true;
         }
     }
 }
@@ -517,11 +531,11 @@ void Player::updateAnimation(vec3 moveDirection)
 
     if (!player->getActiveAnimation() || (player->getActiveAnimation()->getName() != "idle" && (moveDirection == vec3(0) || !isGroundStanding())))
     {
-        player->playAnimation("idle");
+        player->playAnimation("idle", true, PLAYER_ANIMATION_FADE);
     }
     else if (player->getActiveAnimation() && player->getActiveAnimation()->getName() != "run" && moveDirection != vec3(0) && isGroundStanding())
     {
-        player->playAnimation("run");
+        player->playAnimation("run", true, PLAYER_ANIMATION_FADE);
     }
 }
 
@@ -565,6 +579,36 @@ void Player::update(bool events)
     //cout << getPosition().x << ' ' << getPosition().z << endl;
 }
 
+void Player::reconcile(unsigned int ack, const vec3& serverPosition)
+{
+    if (!(player && player->getPhysicsObject()))
+    {
+        return;
+    }
+
+    mat4 model = player->getPhysicsObjectTransform();
+    vec3 correction;
+
+    if (!inputHistory->reconcile(ack, serverPosition, vec3(model[3]), correction))
+    {
+        return;
+    }
+
+    model[3] += vec4(correction, 0.0);
+    player->setPhysicsObjectTransform(model);
+
+    /* a respawn, nothing of the old motion is left */
+    if (length(correction) > INPUT_HISTORY_TELEPORT)
+    {
+        player->getPhysicsObject()->getRigidBody()->setLinearVelocity(btVector3(0, 0, 0));
+    }
+}
+
+InputHistory* Player::getInputHistory() const
+{
+    return inputHistory;
+}
+
 GameObject* Player::getGameObject() const
 {
     return player;
@@ -593,4 +637,5 @@ int Player::getID() const
 Player::~Player()
 {
     delete rayTracer;
+    delete inputHistory;
 }
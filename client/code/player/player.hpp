@@ -11,6 +11,8 @@
 #include <bullet/btBulletCollisionCommon.h>
 #include <bullet/btBulletDynamicsCommon.h>
 
+#define PLAYER_ANIMATION_FADE 0.2 /* seconds the idle and the run blend into each other */
+
 using namespace std;
 
 class Player : public Camera
@@ -25,12 +27,20 @@ class Player : public Camera
         bool speedLock;
 
         RayTracer* rayTracer;
+
+        /* ground test buffers, refilled every frame */
+        vector < RayQuery > groundQueries;
+        vector < RayResult > groundResults;
+        vector < btRigidBody* > groundIgnored;
         
         GameObject* player;
 
         vec3 cameraOffset;
         vec3 modelOffset;
         vec3 modelForward;
+
+        InputHistory* inputHistory; /* of the local player, the prediction */
+        bool jumped;
         
         bool isGroundStanding();
         bool isJumpAllowed();
@@ -64,9 +74,12 @@ class Player : public Camera
         void updateModel(vec3 newForward);
         virtual void updateAnimation(vec3 moveDirection);
 
+        void reconcile(unsigned int ack, const vec3& serverPosition);
+
         virtual void update(bool events = true) override;
 
         GameObject* getGameObject() const;
+        InputHistory* getInputHistory() const;
         vec3 getCameraOffset() const;
         vec3 getModelOffset() const;
         vec3 getModelForward() const;
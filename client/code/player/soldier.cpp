@@ -1,4 +1,5 @@
 #include "../shader/shader.hpp"
+#include "../shader/uniformbuffer.hpp"
 
 #include "../global/globaluse.hpp"
 
@@ -21,17 +22,22 @@
 #include "../game_object/sphere.hpp"
 #include "../game_object/openglmotionstate.hpp"
 #include "../game_object/animation.hpp"
+#include "../game_object/glstatecache.hpp"
 #include "../game_object/mesh.hpp"
 #include "../game_object/bone.hpp"
+#include "../game_object/animationclip.hpp"
 #include "../game_object/skeleton.hpp"
 #include "../game_object/viewfrustum.hpp"
 #include "../game_object/boundsphere.hpp"
 #include "../game_object/modelloader.hpp"
 #include "../game_object/physicsobject.hpp"
+#include "../game_object/transformbuffer.hpp"
+#include "../game_object/renderqueue.hpp"
 #include "../game_object/gameobject.hpp"
 #include "../game_object/weapon.hpp"
 #include "../game_object/rifle.hpp"
 
+#include "inputhistory.hpp"
 #include "player.hpp"
 #include "soldier.hpp"
 
@@ -162,7 +168,7 @@ void Soldier::updateWeapon()
 
         if (weapons[0]->isReloaded())
         {
-            reloadInfo.insert({weapons[0]->getName(), true});
+            reloadInfo.insert({weapons[0]->getNetID(), true});
         }
     }
 }
@@ -215,7 +221,7 @@ void Soldier::fire()
         
     if (weapons[0]->fire())
     { 
-        fireInfo[weapons[0]->getName()].push_back({getPosition(), getForward()});
+        fireInfo[weapons[0]->getNetID()].push_back({getPosition(), getForward()});
     }
 }
 
@@ -276,7 +282,7 @@ bool Soldier::isDrop()
     return res;
 }
         
-map < string, vector < pair < vec3, vec3 > > > Soldier::getFire()
+map < int, vector < pair < vec3, vec3 > > > Soldier::getFire()
 {
     unique_lock < mutex > lk(mtx);
 
@@ -285,13 +291,13 @@ map < string, vector < pair < vec3, vec3 > > > Soldier::getFire()
         cv.wait(lk);
     }
     
-    map < string, vector < pair < vec3, vec3 > > > res = fireInfo;
+    map < int, vector < pair < vec3, vec3 > > > res = fireInfo;
     fireInfo.clear();
 
     return res;
 }
         
-map < string, bool > Soldier::getReload()
+map < int, bool > Soldier::getReload()
 {
     unique_lock < mutex > lk(mtx);
 
@@ -300,7 +306,7 @@ map < string, bool > Soldier::getReload()
         cv.wait(lk);
     }
     
-    map < string, bool > res = reloadInfo;
+    map < int, bool > res = reloadInfo;
     reloadInfo.clear();
 
     return res; 
@@ -317,6 +323,7 @@ void Soldier::update(bool events)
     ready = false;
 
     moveDirection = vec3(0, 0, 0);
+    jumped = false;
 
     if (events && active && health)
     {
@@ -339,6 +346,9 @@ void Soldier::update(bool events)
             updateCamera();
             updateModel(moveDirection);
             updateAnimation(moveDirection);
+
+            /* predicted, the server gets the same command */
+            inputHistory->record(moveDirection, jumped, Global::fpsCounter->getFramesTime(), player->getPhysicsObjectTransform());
         }
 
         updateWeapon();
@@ -20,8 +20,8 @@ class Soldier : public Player
 
         pair < vec3, vec3 > pickRay;
 
-        map < string, bool > reloadInfo;
-        map < string, vector < pair < vec3, vec3 > > > fireInfo;
+        map < int, bool > reloadInfo;
+        map < int, vector < pair < vec3, vec3 > > > fireInfo;
 
         bool dropTo;
         
@@ -53,8 +53,8 @@ class Soldier : public Player
 
         pair < vec3, vec3 > getPickRay();
         bool isDrop();
-        map < string, vector < pair < vec3, vec3 > > > getFire();
-        map < string, bool > getReload();
+        map < int, vector < pair < vec3, vec3 > > > getFire();
+        map < int, bool > getReload();
 
         int getHealth() const;
 
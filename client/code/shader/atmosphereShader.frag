@@ -4,9 +4,18 @@ layout (location = 0) out vec4 fragColor;
 
 in vec3 vPos;
 
+layout (std140) uniform Frame
+{
+    mat4 projection;
+    mat4 view;
+    mat4 staticView;
+    vec3 viewPos;
+    float sunIntensity;
+    vec3 sunPos;
+    float sunGradient;
+};
+
 uniform vec3 rayOrigin;
-uniform vec3 sunPos;
-uniform float sunIntensity;
 uniform float planetRadius;
 uniform float atmoRadius;
 uniform vec3 rayleighCoeff;
@@ -4,12 +4,20 @@ layout (location = 0) in vec3 position;
 
 out vec3 vPos;
 
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform Frame
+{
+    mat4 projection;
+    mat4 view;
+    mat4 staticView;
+    vec3 viewPos;
+    float sunIntensity;
+    vec3 sunPos;
+    float sunGradient;
+};
 
 void main()
 {
-    vec4 pos = projection * view * vec4(position, 1.0);
+    vec4 pos = projection * staticView * vec4(position, 1.0);
 
     gl_Position = pos.xyww;
 
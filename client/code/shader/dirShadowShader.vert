@@ -17,7 +17,11 @@ uniform mat4 projection;
 
 uniform int meshInstanced;
 
-uniform mat4 bones[MAX_BONES_AMOUNT];
+layout (std140) uniform Bones
+{
+    mat4 bones[MAX_BONES_AMOUNT];
+};
+
 uniform int meshWithBones;
 
 out vec4 fragmentPos;
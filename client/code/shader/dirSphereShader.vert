@@ -4,8 +4,16 @@ layout (location = 0) in vec3 position;
 layout (location = 1) in vec3 color;
 
 uniform mat4 localTransform;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform Frame
+{
+    mat4 projection;
+    mat4 view;
+    mat4 staticView;
+    vec3 viewPos;
+    float sunIntensity;
+    vec3 sunPos;
+    float sunGradient;
+};
 
 out vec4 polyColor;
 
@@ -26,7 +34,7 @@ void main()
         polyColor = vec4(0.0, 0.0, 0.0, 1.0);
     }
     
-    pos = projection * view * pos;
+    pos = projection * staticView * pos;
 
     gl_Position = pos.xyww;
 }
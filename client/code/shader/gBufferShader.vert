@@ -13,12 +13,26 @@ layout (location = 10) in mat4 instanceMatrix;
 
 uniform mat4 localTransform;
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform Frame
+{
+    mat4 projection;
+    mat4 view;
+    mat4 staticView;
+    vec3 viewPos;
+    float sunIntensity;
+    vec3 sunPos;
+    float sunGradient;
+};
+
+uniform int isStatic;
 
 uniform int meshInstanced;
 
-uniform mat4 bones[MAX_BONES_AMOUNT];
+layout (std140) uniform Bones
+{
+    mat4 bones[MAX_BONES_AMOUNT];
+};
+
 uniform int meshWithBones;
 uniform int meshNormalMapped;
 
@@ -38,6 +52,9 @@ void main()
     mat4 instanceMat;
     mat4 bonesTransform;
 
+    /* the view static objects don't move with the camera */
+    mat4 cameraView = isStatic == 1 ? staticView : view;
+
     /* animated? */
     if (meshWithBones == 1)
     {
@@ -64,12 +81,12 @@ void main()
         instanceMat = mat4(1.0);
     }
 
-    gl_Position = projection * view * model * localTransform * instanceMat * bonesTransform * vec4(position, 1.0);
+    gl_Position = projection * cameraView * model * localTransform * instanceMat * bonesTransform * vec4(position, 1.0);
 
     fragmentPos = vec3(model * localTransform * instanceMat * bonesTransform * vec4(position, 1.0));
     fragmentNorm = vec3(model * localTransform * instanceMat * bonesTransform * vec4(normal, 0.0));
 
-    ssaoFragmentNorm = vec3(view * vec4(fragmentNorm, 0.0));
+    ssaoFragmentNorm = vec3(cameraView * vec4(fragmentNorm, 0.0));
 
     /* flip UV */
     textureCoords = vec2(uv.x, uv.y);
@@ -89,8 +106,8 @@ void main()
         TBN = mat3(T, B, N);
 
         /* SSAO */
-        vec3 ssaoT = normalize(vec3(view * vec4(TT, 0.0)));
-        vec3 ssaoN = normalize(vec3(view * vec4(NN, 0.0)));
+        vec3 ssaoT = normalize(vec3(cameraView * vec4(TT, 0.0)));
+        vec3 ssaoN = normalize(vec3(cameraView * vec4(NN, 0.0)));
 
         ssaoT = normalize(ssaoT - dot(ssaoT, ssaoN) * ssaoN);
         vec3 ssaoB = cross(ssaoN, ssaoT);
@@ -12,6 +12,8 @@ struct GBuffer
     sampler2D texture_staticDepth;
 };
 
+#define SHADOW_CASCADES 3
+
 struct DirLight
 {
     vec3 direction;
@@ -20,37 +22,79 @@ struct DirLight
     float coeff;
 
     int isShadow; 
-    sampler2D texture_shadow1; // depth
+    int cascades;
+    sampler2D texture_shadow[SHADOW_CASCADES]; // depth, nearest first
+    mat4 shadowViewProjection[SHADOW_CASCADES];
     
     float esmFactor;
     float bias;
-
-    mat4 shadowView;
-    mat4 shadowProjection;
 };
 
 uniform sampler2D texture_ssao;
 
 in vec2 UV;
 
+layout (std140) uniform Frame
+{
+    mat4 projection;
+    mat4 view;
+    mat4 staticView;
+    vec3 viewPos;
+    float sunIntensity;
+    vec3 sunPos;
+    float sunGradient;
+};
+
 uniform GBuffer gBuffer;
 
 #define MAX_DIR_LIGHTS 1
 uniform DirLight dirLights[MAX_DIR_LIGHTS];
 
-uniform vec3 viewPos;
 
 const float PI = 3.1415926535;
 
-float calcDirShadow(DirLight light, vec4 shadowCoords)
+float getShadowMoment(DirLight light, int cascade, vec2 coords)
+{
+    /* an array of samplers only takes constant indices */
+    if (cascade == 0)
+    {
+        return texture(light.texture_shadow[0], coords).r;
+    }
+    else if (cascade == 1)
+    {
+        return texture(light.texture_shadow[1], coords).r;
+    }
+
+    return texture(light.texture_shadow[2], coords).r;
+}
+
+float calcDirShadow(DirLight light, vec3 fragPos)
 {
-    vec4 projCoords = shadowCoords / shadowCoords.w;
-    projCoords = projCoords * 0.5 + 0.5;
+    /* the nearest cascade the fragment is in, the blur needs a few texels of border */
+    int cascade = -1;
+    vec4 projCoords;
+
+    for (int i = 0; i < light.cascades && cascade < 0; i++)
+    {
+        projCoords = light.shadowViewProjection[i] * vec4(fragPos, 1.0);
+        projCoords = projCoords / projCoords.w;
+        projCoords = projCoords * 0.5 + 0.5;
+
+        if (all(greaterThan(projCoords.xy, vec2(0.01))) && all(lessThan(projCoords.xy, vec2(0.99))))
+        {
+            cascade = i;
+        }
+    }
+
+    if (cascade < 0)
+    {
+        return 1.0;
+    }
 
     float currentDepth = projCoords.z;
     currentDepth += light.bias;
 
-    float moment = texture(light.texture_shadow1, projCoords.xy).r;
+    float moment = getShadowMoment(light, cascade, projCoords.xy);
 
     if (currentDepth < moment)
     {
@@ -161,10 +205,7 @@ vec4 calcDirLights()
 
         if (dirLights[i].isShadow == 1 && staticDepth == 0.0)
         {
-            // calc shadow coords
-            vec4 dirShadowCoords = dirLights[i].shadowProjection * dirLights[i].shadowView * vec4(fragPos, 1.0);
-
-            float shadow = calcDirShadow(dirLights[i], dirShadowCoords);
+            float shadow = calcDirShadow(dirLights[i], fragPos);
             L00 *= shadow;
         }
 
@@ -111,48 +111,119 @@ GLuint Shader::loadShaders(string vertex_path, string fragment_path)
     glDeleteShader(FragmentShaderID);
 
     ID = ProgramID;
+
+    loadLocations();
+
+    /* the blocks are bound to their points once, not per program */
+    bindBlock(FRAME_BLOCK, FRAME_BLOCK_BINDING);
+    bindBlock(BONES_BLOCK, BONES_BLOCK_BINDING);
+
     return ProgramID;
 }
 
+void Shader::bindBlock(const string& name, GLuint binding)
+{
+    GLuint block = glGetUniformBlockIndex(ID, name.c_str());
+
+    if (block != GL_INVALID_INDEX)
+    {
+        glUniformBlockBinding(ID, block, binding);
+    }
+}
+
+void Shader::loadLocations()
+{
+    locations.clear();
+
+    GLint count = 0;
+    GLint maxLength = 0;
+
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    vector < char > buffer(maxLength + 1);
+
+    for (GLint i = 0; i < count; i++)
+    {
+        GLint size = 0;
+        GLenum type = 0;
+
+        glGetActiveUniform(ID, i, buffer.size(), nullptr, &size, &type, buffer.data());
+
+        string name = buffer.data();
+        GLint location = glGetUniformLocation(ID, name.c_str());
+
+        /* members of the uniform blocks have no location */
+        if (location == -1)
+        {
+            continue;
+        }
+
+        locations[name] = location;
+
+        /* arrays come as "name[0]", every element gets its own entry */
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+        {
+            string base = name.substr(0, name.size() - 3);
+
+            locations[base] = location;
+
+            for (GLint j = 1; j < size; j++)
+            {
+                string element = base + "[" + to_string(j) + "]";
+
+                locations[element] = glGetUniformLocation(ID, element.c_str());
+            }
+        }
+    }
+}
+
 void Shader::use() const
 {
     glUseProgram(ID);
 }
         
-void Shader::setMat4(string key, mat4 value)
+GLint Shader::getLocation(const string& key) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(getID(), key.c_str()), 1, GL_FALSE, value_ptr(value));
+    auto it = locations.find(key);
+
+    /* -1 is quietly ignored by glUniform, as it was with glGetUniformLocation */
+    return it != locations.end() ? it->second : -1;
 }
 
-void Shader::setMat3(string key, mat3 value)
+void Shader::setMat4(const string& key, const mat4& value)
 {
-    glUniformMatrix3fv(glGetUniformLocation(getID(), key.c_str()), 1, GL_FALSE, value_ptr(value));
+    glUniformMatrix4fv(getLocation(key), 1, GL_FALSE, value_ptr(value));
 }
 
-void Shader::setVec4(string key, vec4 value)
+void Shader::setMat3(const string& key, const mat3& value)
 {
-    glUniform4f(glGetUniformLocation(getID(), key.c_str()), value.x, value.y, value.z, value.w);
+    glUniformMatrix3fv(getLocation(key), 1, GL_FALSE, value_ptr(value));
 }
 
-void Shader::setVec3(string key, vec3 value)
+void Shader::setVec4(const string& key, const vec4& value)
 {
-    glUniform3f(glGetUniformLocation(getID(), key.c_str()), value.x, value.y, value.z);
+    glUniform4f(getLocation(key), value.x, value.y, value.z, value.w);
 }
 
-void Shader::setVec2(string key, vec2 value)
+void Shader::setVec3(const string& key, const vec3& value)
 {
-    glUniform2f(glGetUniformLocation(getID(), key.c_str()), value.x, value.y);
+    glUniform3f(getLocation(key), value.x, value.y, value.z);
 }
 
-void Shader::setFloat(string key, float value)
+void Shader::setVec2(const string& key, const vec2& value)
 {
-    glUniform1f(glGetUniformLocation(getID(), key.c_str()), value);
-    
+    glUniform2f(getLocation(key), value.x, value.y);
 }
 
-void Shader::setInt(string key, int value)
+void Shader::setFloat(const string& key, float value)
 {
-    glUniform1i(glGetUniformLocation(getID(), key.c_str()), value);
+    glUniform1f(getLocation(key), value);
+}
+
+void Shader::setInt(const string& key, int value)
+{
+    glUniform1i(getLocation(key), value);
 }
         
 GLuint Shader::getID() const
@@ -161,3 +232,48 @@ GLuint Shader::getID() const
 }
 
 Shader::~Shader(){}
+
+template <> void Uniform < mat4 >::set(const mat4& value) const
+{
+    glUniformMatrix4fv(location, 1, GL_FALSE, value_ptr(value));
+}
+
+template <> void Uniform < mat4 >::set(const mat4* values, int count) const
+{
+    glUniformMatrix4fv(location, count, GL_FALSE, value_ptr(values[0]));
+}
+
+template <> void Uniform < mat3 >::set(const mat3& value) const
+{
+    glUniformMatrix3fv(location, 1, GL_FALSE, value_ptr(value));
+}
+
+template <> void Uniform < vec4 >::set(const vec4& value) const
+{
+    glUniform4f(location, value.x, value.y, value.z, value.w);
+}
+
+template <> void Uniform < vec3 >::set(const vec3& value) const
+{
+    glUniform3f(location, value.x, value.y, value.z);
+}
+
+template <> void Uniform < vec3 >::set(const vec3* values, int count) const
+{
+    glUniform3fv(location, count, value_ptr(values[0]));
+}
+
+template <> void Uniform < vec2 >::set(const vec2& value) const
+{
+    glUniform2f(location, value.x, value.y);
+}
+
+template <> void Uniform < float >::set(const float& value) const
+{
+    glUniform1f(location, value);
+}
+
+template <> void Uniform < int >::set(const int& value) const
+{
+    glUniform1i(location, value);
+}
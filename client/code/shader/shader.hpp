@@ -7,6 +7,7 @@
 #include <fstream>
 #include <algorithm>
 #include <sstream>
+#include <map>
 
 #include <cstdlib>
 #include <cstring>
@@ -18,6 +19,14 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+/* the per frame uniform block every program shares */
+#define FRAME_BLOCK "Frame"
+#define FRAME_BLOCK_BINDING 0
+
+/* bone palette of the skinned object being drawn */
+#define BONES_BLOCK "Bones"
+#define BONES_BLOCK_BINDING 1
+
 using namespace std;
 using namespace glm;
 
@@ -26,6 +35,12 @@ class Shader
     private:
         GLuint ID;
 
+        /* every active uniform and array element, filled once after the link */
+        map < string, GLint > locations;
+
+        void loadLocations();
+        void bindBlock(const string& name, GLuint binding);
+
     public:
         
         Shader();
@@ -33,18 +48,50 @@ class Shader
         GLuint loadShaders(string vertex_file_path, string fragment_file_path);
 
         void use() const;
+
+        GLint getLocation(const string& key) const;
         
-        void setMat4(string key, mat4 value);
-        void setMat3(string key, mat3 value);
+        void setMat4(const string& key, const mat4& value);
+        void setMat3(const string& key, const mat3& value);
         
-        void setVec4(string key, vec4 value);
-        void setVec3(string key, vec3 value);
-        void setVec2(string key, vec2 value);
+        void setVec4(const string& key, const vec4& value);
+        void setVec3(const string& key, const vec3& value);
+        void setVec2(const string& key, const vec2& value);
 
-        void setFloat(string key, float value);
-        void setInt(string key, int value);
+        void setFloat(const string& key, float value);
+        void setInt(const string& key, int value);
 
         GLuint getID() const;
 
         ~Shader();
 };
+
+/*
+ * location of one uniform of one program, looked up once and kept by the caller.
+ * the program has to be in use when it's set, just like with the Shader setters
+ */
+template < typename T >
+class Uniform
+{
+    private:
+        GLint location;
+
+    public:
+        Uniform() : location(-1) {}
+        Uniform(const Shader* shader, const string& key) : location(shader->getLocation(key)) {}
+
+        void set(const T& value) const;
+        void set(const T* values, int count) const;
+
+        bool isActive() const { return location != -1; }
+};
+
+template <> void Uniform < mat4 >::set(const mat4& value) const;
+template <> void Uniform < mat4 >::set(const mat4* values, int count) const;
+template <> void Uniform < mat3 >::set(const mat3& value) const;
+template <> void Uniform < vec4 >::set(const vec4& value) const;
+template <> void Uniform < vec3 >::set(const vec3& value) const;
+template <> void Uniform < vec3 >::set(const vec3* values, int count) const;
+template <> void Uniform < vec2 >::set(const vec2& value) const;
+template <> void Uniform < float >::set(const float& value) const;
+template <> void Uniform < int >::set(const int& value) const;
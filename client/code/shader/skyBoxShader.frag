@@ -5,7 +5,17 @@ layout (location = 1) out vec4 brightColor;
 
 in vec3 textureCoords;
 
-uniform float alpha;
+layout (std140) uniform Frame
+{
+    mat4 projection;
+    mat4 view;
+    mat4 staticView;
+    vec3 viewPos;
+    float sunIntensity;
+    vec3 sunPos;
+    float sunGradient;
+};
+
 uniform sampler2D depthTexture;
 uniform samplerCube skybox;
 
@@ -20,16 +30,16 @@ void main()
         discard;
     }
 
-    fragColor = vec4(pow(texture(skybox, textureCoords).rgb, vec3(gamma)), alpha);    
+    fragColor = vec4(pow(texture(skybox, textureCoords).rgb, vec3(gamma)), sunGradient);    
 
     float brightness = dot(fragColor.rgb, vec3(0.2126, 0.7152, 0.0722));
 
     if (brightness > 1.0)
     {
-        brightColor = vec4(fragColor.rgb, alpha);
+        brightColor = vec4(fragColor.rgb, sunGradient);
     }
     else
     {
-        brightColor = vec4(0.0, 0.0, 0.0, alpha);
+        brightColor = vec4(0.0, 0.0, 0.0, sunGradient);
     }
 }
@@ -3,8 +3,16 @@
 layout (location = 0) in vec3 position;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform Frame
+{
+    mat4 projection;
+    mat4 view;
+    mat4 staticView;
+    vec3 viewPos;
+    float sunIntensity;
+    vec3 sunPos;
+    float sunGradient;
+};
 
 out vec3 textureCoords;
 
@@ -12,7 +20,7 @@ void main()
 {
     textureCoords = position;
 
-    vec4 pos = projection * view * model * vec4(position, 1.0);
+    vec4 pos = projection * staticView * model * vec4(position, 1.0);
 
     gl_Position = pos.xyww;
 }
@@ -18,8 +18,18 @@ uniform float radius;
 uniform float bias;
 uniform float power;
 
+layout (std140) uniform Frame
+{
+    mat4 projection;
+    mat4 view;
+    mat4 staticView;
+    vec3 viewPos;
+    float sunIntensity;
+    vec3 sunPos;
+    float sunGradient;
+};
+
 uniform mat4 invProjection;
-uniform mat4 projection;
 
 uniform GBuffer gBuffer;
 
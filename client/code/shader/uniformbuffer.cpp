@@ -0,0 +1,32 @@
+#include "uniformbuffer.hpp"
+
+UniformBuffer::UniformBuffer(GLuint binding, GLsizeiptr size)
+{
+    this->binding = binding;
+    this->size = size;
+
+    glGenBuffers(1, &UBO);
+
+    glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+    glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UniformBuffer::update(const void* data)
+{
+    glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+    /* orphan the old storage, the last frame may still read it */
+    glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UniformBuffer::bind() const
+{
+    glBindBufferBase(GL_UNIFORM_BUFFER, binding, UBO);
+}
+
+UniformBuffer::~UniformBuffer()
+{
+    glDeleteBuffers(1, &UBO);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+using namespace std;
+
+/* std140 block shared by all the programs, filled once and bound to its binding point */
+class UniformBuffer
+{
+    private:
+        GLuint UBO;
+        GLuint binding;
+        GLsizeiptr size;
+
+    public:
+        UniformBuffer(GLuint binding, GLsizeiptr size);
+
+        void update(const void* data);
+        void bind() const;
+
+        ~UniformBuffer();
+};
@@ -11,6 +11,38 @@
 
 #include "raytracer.hpp"
 
+RayFilterCallback::RayFilterCallback(const vector < btRigidBody* >* ignored, bool missStatic) : btCollisionWorld::ClosestRayResultCallback(btVector3(0, 0, 0), btVector3(0, 0, 0))
+{
+    this->ignored = ignored;
+    this->missStatic = missStatic;
+
+    /* static and kinematic bodies are in the static group */
+    if (missStatic)
+    {
+        m_collisionFilterMask = btBroadphaseProxy::AllFilter & ~btBroadphaseProxy::StaticFilter;
+    }
+}
+
+void RayFilterCallback::reset(const btVector3& rayFrom, const btVector3& rayTo)
+{
+    m_rayFromWorld = rayFrom;
+    m_rayToWorld = rayTo;
+    m_closestHitFraction = 1.0;
+    m_collisionObject = nullptr;
+}
+
+bool RayFilterCallback::needsCollision(btBroadphaseProxy* proxy) const
+{
+    if (!btCollisionWorld::ClosestRayResultCallback::needsCollision(proxy))
+    {
+        return false;
+    }
+
+    const btCollisionObject* object = static_cast < const btCollisionObject* >(proxy->m_clientObject);
+
+    return !ignored || find(ignored->begin(), ignored->end(), object) == ignored->end();
+}
+
 RayTracer::RayTracer(btDynamicsWorld* world)
 {
     this->world = world; // pointer to our physics world
@@ -69,7 +101,7 @@ RayResult* RayTracer::rayCast(btVector3 &rayFrom, btVector3 &rayTo, bool missSta
 
     btVector3 rT = rayTo; 
 
-    rT *= 10000; // rayTo is really small 
+    rT *= RAYTRACER_DISTANCE; // rayTo is really small 
 
     btCollisionWorld::ClosestRayResultCallback rayCallback(rayFrom, rT);
 
@@ -99,4 +131,35 @@ RayResult* RayTracer::rayCast(btVector3 &rayFrom, btVector3 &rayTo, bool missSta
     return nullptr;
 }
         
+int RayTracer::rayCast(const vector < RayQuery >& queries, vector < RayResult >& results, const vector < btRigidBody* >& ignored, bool missStatic) const
+{
+    if (!world || results.size() < queries.size())
+    {
+        return 0;
+    }
+
+    RayFilterCallback rayCallback(&ignored, missStatic);
+
+    int hits = 0;
+
+    for (size_t i = 0; i < queries.size(); i++)
+    {
+        rayCallback.reset(queries[i].from, queries[i].to);
+
+        world->rayTest(queries[i].from, queries[i].to, rayCallback); // perform ray test in bullet 
+
+        results[i].body = nullptr;
+
+        if (rayCallback.hasHit())
+        {
+            results[i].body = (btRigidBody*)btRigidBody::upcast(rayCallback.m_collisionObject); // from const to normal
+            results[i].hitPoint = rayCallback.m_hitPointWorld;
+
+            hits += results[i].body ? 1 : 0;
+        }
+    }
+
+    return hits;
+}
+
 RayTracer::~RayTracer() {}
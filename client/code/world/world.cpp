@@ -28,27 +28,12 @@ World::World() : BulletEvents()
 
 void World::collisionEvent(btRigidBody* body0, btRigidBody* body1)
 {
-    collidedBodies.insert({body0, body1}); 
-    
-    if (touchingBodies.find({body0, body1}) == touchingBodies.end() && touchingBodies.find({body1, body0}) == touchingBodies.end())
-    {
-        touchingBodies.insert({body0, body1});
-    }
+    collidedBodies.push_back({body0, body1});
 }
 
 void World::separationEvent(btRigidBody* body0, btRigidBody* body1)
 {
-    separatedBodies.insert({body0, body1}); 
-    
-    if (touchingBodies.find({body0, body1}) != touchingBodies.end())
-    {
-        touchingBodies.erase({body0, body1});
-    }
-    
-    if (touchingBodies.find({body1, body0}) != touchingBodies.end())
-    {
-        touchingBodies.erase({body1, body0});
-    }
+    separatedBodies.push_back({body0, body1});
 }
 
 void World::clearEventsData()
@@ -64,92 +49,77 @@ void World::pollEvents()
 
 bool World::isTouching(btRigidBody* body0, btRigidBody* body1) const
 {
-    if (touchingBodies.find({body0, body1}) == touchingBodies.end() && touchingBodies.find({body1, body0}) == touchingBodies.end()) 
-    {
-        return false;
-    }
-
-    return true;
+    return contacts.isTouching(body0, body1);
 }
 
 bool World::isCollided(btRigidBody* body0, btRigidBody* body1) const
 {
-    if (collidedBodies.find({body0, body1}) == collidedBodies.end() && collidedBodies.find({body1, body0}) == collidedBodies.end()) 
+    for (auto& i: collidedBodies)
     {
-        return false;
+        if ((i.first == body0 && i.second == body1) || (i.first == body1 && i.second == body0))
+        {
+            return true;
+        }
     }
 
-    return true;
+    return false;
 }
 
 bool World::isSeparated(btRigidBody* body0, btRigidBody* body1) const
 {
-    if (separatedBodies.find({body0, body1}) == separatedBodies.end() && separatedBodies.find({body1, body0}) == separatedBodies.end()) 
+    for (auto& i: separatedBodies)
     {
-        return false;
+        if ((i.first == body0 && i.second == body1) || (i.first == body1 && i.second == body0))
+        {
+            return true;
+        }
     }
 
-    return true;
+    return false;
 }
 
-set < btRigidBody* > World::getTouchingWith(btRigidBody* body0) const
+const vector < btRigidBody* >& World::getTouchingWith(btRigidBody* body0) const
 {
-    set < btRigidBody* > res;
-
-    for (auto& i: touchingBodies)
-    {
-        if (i.first == body0)
-        {
-            res.insert(i.second);
-        }
-        else if (i.second == body0)
-        {
-            res.insert(i.first);
-        }
-    }
-
-    /* move constructor */
-    return move(res);
+    /* the adjacency list of the body, no scan over all the pairs */
+    return contacts.getTouchingWith(body0);
 }
 
-set < btRigidBody* > World::getCollidedWith(btRigidBody* body0) const
+vector < btRigidBody* > World::getCollidedWith(btRigidBody* body0) const
 {
-    set < btRigidBody* > res;
+    vector < btRigidBody* > res;
 
     for (auto& i: collidedBodies)
     {
         if (i.first == body0)
         {
-            res.insert(i.second);
+            res.push_back(i.second);
         }
         else if (i.second == body0)
         {
-            res.insert(i.first);
+            res.push_back(i.first);
         }
     }
 
-    /* move constructor */
-    return move(res);
+    return res;
 }
 
-set < btRigidBody* > World::getSeparatedWith(btRigidBody* body0) const
+vector < btRigidBody* > World::getSeparatedWith(btRigidBody* body0) const
 {
-    set < btRigidBody* > res;
+    vector < btRigidBody* > res;
 
     for (auto& i: separatedBodies)
     {
         if (i.first == body0)
         {
-            res.insert(i.second);
+            res.push_back(i.second);
         }
         else if (i.second == body0)
         {
-            res.insert(i.first);
+            res.push_back(i.first);
         }
     }
 
-    /* move constructor */
-    return move(res);
+    return res;
 }
                 
 void World::updateSimulation(float dt, int subSteps, float fixedStep)
@@ -1,4 +1,6 @@
 #include "../global/globaluse.hpp"
+#include "../global/config.hpp"
+#include "../global/telemetry.hpp"
 
 #include "../world/raytracer.hpp"
 #include "../world/bulletevents.hpp"
@@ -15,7 +17,10 @@
 #include "../level/levelloader.hpp"
 #include "../level/level.hpp"
 
+#include "../multiplayer/messagebuffer.hpp"
+#include "../multiplayer/linksimulator.hpp"
 #include "../multiplayer/node.hpp"
+#include "../multiplayer/worldsnapshot.hpp"
 #include "../multiplayer/playerdatacollector.hpp"
 #include "../multiplayer/playerdataupdater.hpp"
 #include "../multiplayer/physicsobjectdatacollector.hpp"
@@ -25,50 +30,375 @@
 #include "../multiplayer/weaponpickerupdater.hpp"
 #include "../multiplayer/weapondroppercollector.hpp"
 #include "../multiplayer/weapondropperupdater.hpp"
+#include "../multiplayer/posehistory.hpp"
 #include "../multiplayer/weaponfireupdater.hpp"
 #include "../multiplayer/playerconnectioncollector.hpp"
 #include "../multiplayer/playerdisconnectioncollector.hpp"
+#include "../multiplayer/interestgrid.hpp"
+#include "../multiplayer/snapshotencoder.hpp"
+#include "../multiplayer/decoderpool.hpp"
+#include "../multiplayer/commandqueue.hpp"
+#include "../multiplayer/matchrecorder.hpp"
+#include "../multiplayer/matchreader.hpp"
 #include "../multiplayer/multiplayer.hpp"
 
 #include "game.hpp"
 
 Game::Game(string levelName)
 {
+    config = new Config();
+    config->loadConfig(global.path("config.xml"));
+
+    recorder = nullptr;
+    reader = nullptr;
+
+    /* the spawn points are the only random part of a match, the log keeps the seed */
+    if (!config->getRecordFile().empty())
+    {
+        MatchHeader header = {levelName, config->getSlots(), config->getTickRate(), config->getSendRate(), random_device()()};
+
+        global.setSeed(header.seed);
+
+        recorder = new MatchRecorder(global.path(config->getRecordFile()), header);
+    }
+
+    init(levelName);
+}
+
+Game::Game(MatchReader* reader)
+{
+    const MatchHeader& header = reader->getHeader();
+
+    config = new Config();
+    config->loadConfig(global.path("config.xml"));
+    config->setReplay(header.slots, header.tickRate, header.sendRate);
+
+    global.setSeed(header.seed);
+
+    recorder = nullptr;
+    this->reader = reader;
+
+    init(header.levelName);
+}
+
+void Game::init(string levelName)
+{
+    telemetry = new Telemetry(config->getSlots(), config->getTelemetryPeriod(), global.path(config->getTelemetryFile()));
+
     physicsWorld = new World();
 
-    level = new Level(physicsWorld);
+    level = new Level(physicsWorld, config->getSlots());
     level->loadLevel(levelName);
         
-    multiplayer = new Multiplayer(level, physicsWorld);
+    multiplayer = new Multiplayer(level, physicsWorld, config, telemetry);
+    multiplayer->setRecorder(recorder);
+
+    tick = 0;
 }
 
 void Game::checkEvents() {}
 
+void Game::simulate()
+{
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    float step = 1.0 / config->getTickRate();
+
+    chrono::steady_clock::time_point phase = telemetry->now();
+
+    /* the respawns go by the server time, a replay runs on the recorded one */
+    if (recorder)
+    {
+        recorder->addClock(tick, global.getTime());
+    }
+
+    physicsWorld->pollEvents();
+    checkEvents();        
+
+    telemetry->addTime("tick.events", phase);
+    phase = telemetry->now();
+
+    /* everything the clients asked for since the last tick */
+    multiplayer->applyCommands();
+
+    telemetry->addTime("tick.commands", phase);
+    phase = telemetry->now();
+
+    /* the players move by their owners' input, never by a transform they send */
+    level->updatePlayers(step);
+
+    telemetry->addTime("tick.players", phase);
+    phase = telemetry->now();
+
+    /* exactly one fixed step, the wall clock is handled by the accumulator */
+    physicsWorld->updateSimulation(step, 1, step);
+
+    telemetry->addTime("tick.physics", phase);
+    phase = telemetry->now();
+
+    level->update();
+
+    telemetry->addTime("tick.level", phase);
+
+    tick++;
+
+    phase = telemetry->now();
+
+    /* poses the shots will be rewound to */
+    multiplayer->record(tick);
+
+    telemetry->addTime("tick.record", phase);
+
+    /* snapshots go out on tick boundaries, the sender thread encodes them */
+    if (tick % max(1, config->getTickRate() / config->getSendRate()) == 0)
+    {
+        phase = telemetry->now();
+
+        multiplayer->connect(tick);
+        multiplayer->publish(tick);
+
+        telemetry->addTime("tick.publish", phase);
+    }
+
+    if (recorder && tick % config->getRecordKeyframe() == 0)
+    {
+        phase = telemetry->now();
+
+        Keyframe keyframe;
+
+        capture(keyframe);
+        recorder->addKeyframe(tick, keyframe);
+
+        telemetry->addTime("tick.keyframe", phase);
+    }
+
+    unsigned int tickTime = chrono::duration_cast < chrono::microseconds >(chrono::steady_clock::now() - start).count();
+
+    telemetry->addTime("tick", tickTime);
+    multiplayer->setTickTime(tickTime);
+}
+
 void Game::gameLoop()
 {
-    thread sender(&Multiplayer::broadcast, multiplayer);
     thread receiver(&Multiplayer::update, multiplayer);
+    thread sender(&Multiplayer::send, multiplayer);
+    thread reporter(&Telemetry::report, telemetry);
+
+    chrono::steady_clock::duration step = chrono::duration_cast < chrono::steady_clock::duration >(chrono::duration < double >(1.0 / config->getTickRate()));
+    chrono::steady_clock::duration accumulator(0);
+    chrono::steady_clock::time_point previous = chrono::steady_clock::now();
         
     while (true)
     {
-        this_thread::sleep_for(chrono::milliseconds(16));
+        chrono::steady_clock::time_point now = chrono::steady_clock::now();
 
-        physicsWorld->pollEvents();
-        checkEvents();        
+        accumulator += now - previous;
+        previous = now;
 
-        if (global.getTime() > 1.0)
+        if (accumulator > step * GAME_MAX_CATCHUP_TICKS)
         {
-            physicsWorld->updateSimulation(1.0, 1);
+            /* the dropped time, a stall worth looking for in the log */
+            telemetry->addTime("tick.dropped", chrono::duration_cast < chrono::microseconds >(accumulator - step * GAME_MAX_CATCHUP_TICKS).count());
+
+            accumulator = step * GAME_MAX_CATCHUP_TICKS;
         }
 
-        level->update();
+        while (accumulator >= step)
+        {
+            simulate();
+
+            accumulator -= step;
+        }
+
+        this_thread::sleep_until(previous + (step - accumulator));
     }
 
     cout << "\n\nKILLING ALL THREADS\n\n";
     terminate();
 
-    sender.join();
     receiver.join();
+    sender.join();
+    reporter.join();
+}
+
+void Game::capture(Keyframe& keyframe) const
+{
+    keyframe.objects.clear();
+    keyframe.soldiers.clear();
+
+    level->forEachPhysicsObject([&keyframe](PhysicsObject* physicsObject)
+    {
+        btRigidBody* body = physicsObject->getRigidBody();
+
+        if (body->isStaticOrKinematicObject())
+        {
+            return;
+        }
+
+        const btTransform& transform = body->getCenterOfMassTransform();
+
+        keyframe.objects.push_back({physicsObject->getNetID(), transform.getOrigin(), transform.getRotation()});
+    });
+
+    vector < Player* > players = level->getPlayers();
+
+    for (Player* player: players)
+    {
+        Soldier* soldier = dynamic_cast < Soldier* >(player);
+
+        if (!soldier || !soldier->isConnected() || !soldier->getPhysicsObject())
+        {
+            continue;
+        }
+
+        keyframe.soldiers.push_back({soldier->getID(), soldier->getHealth(), soldier->getPhysicsObject()->getRigidBody()->getCenterOfMassPosition()});
+    }
+}
+
+/* the count of objects and soldiers that differ, drift is the farthest any of them got */
+int Game::compare(const Keyframe& recorded, const Keyframe& replayed, float& drift) const
+{
+    int differences = 0;
+
+    drift = 0.0;
+
+    map < int, const KeyframeObject* > objects;
+
+    for (const KeyframeObject& object: replayed.objects)
+    {
+        objects[object.netID] = &object;
+    }
+
+    for (const KeyframeObject& object: recorded.objects)
+    {
+        auto it = objects.find(object.netID);
+
+        if (it == objects.end())
+        {
+            differences++;
+            continue;
+        }
+
+        float distance = object.position.distance(it->second->position);
+        float angle = object.rotation.angleShortestPath(it->second->rotation);
+
+        drift = max(drift, distance);
+
+        if (distance > GAME_REPLAY_TOLERANCE || angle > GAME_REPLAY_TOLERANCE)
+        {
+            differences++;
+        }
+    }
+
+    differences += max(0, (int)replayed.objects.size() - (int)recorded.objects.size());
+
+    map < int, const KeyframeSoldier* > soldiers;
+
+    for (const KeyframeSoldier& soldier: replayed.soldiers)
+    {
+        soldiers[soldier.id] = &soldier;
+    }
+
+    for (const KeyframeSoldier& soldier: recorded.soldiers)
+    {
+        auto it = soldiers.find(soldier.id);
+
+        if (it == soldiers.end())
+        {
+            differences++;
+            continue;
+        }
+
+        float distance = soldier.position.distance(it->second->position);
+
+        drift = max(drift, distance);
+
+        if (distance > GAME_REPLAY_TOLERANCE || soldier.health != it->second->health)
+        {
+            differences++;
+        }
+    }
+
+    differences += max(0, (int)replayed.soldiers.size() - (int)recorded.soldiers.size());
+
+    return differences;
+}
+
+/*
+ * runs a recorded match again, no sockets and no waiting: the recorded messages go through
+ * the decoders and the tick like received ones, the sender broadcasts to nobody.
+ * every keyframe is checked against the replayed state, the telemetry report goes to the console
+ */
+void Game::replay()
+{
+    thread sender(&Multiplayer::send, multiplayer);
+
+    const MatchHeader& header = reader->getHeader();
+
+    cout << "Replay level: " << header.levelName << ", " << header.tickRate << " ticks per second" << endl;
+
+    MatchRecord record;
+    Keyframe keyframe;
+
+    unsigned int keyframes = 0;
+    unsigned int diverged = 0;
+    float maxDrift = 0.0;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    while (reader->next(record))
+    {
+        /* a join or a quit happens inside its tick, everything else after it */
+        unsigned int until = record.kind == RECORD_JOIN || record.kind == RECORD_QUIT ? record.tick - 1 : record.tick;
+
+        while (tick < until)
+        {
+            simulate();
+        }
+
+        switch (record.kind)
+        {
+            case RECORD_CLOCK:
+                global.setTime(record.value);
+                break;
+
+            case RECORD_KEYFRAME:
+            {
+                float drift;
+
+                capture(keyframe);
+
+                int differences = compare(record.keyframe, keyframe, drift);
+
+                keyframes++;
+                maxDrift = max(maxDrift, drift);
+
+                /* the first one is where to look */
+                if (differences && !diverged++)
+                {
+                    cout << "Diverged at tick: " << tick << ", " << differences << " differences, drift " << drift << endl;
+                }
+
+                break;
+            }
+
+            default:
+                multiplayer->inject(record);
+                break;
+        }
+    }
+
+    multiplayer->finish();
+    sender.join();
+
+    global.setTime(-1);
+
+    float seconds = max(0.001f, chrono::duration < float >(chrono::steady_clock::now() - start).count());
+
+    cout << "Replayed ticks: " << tick << " in " << seconds << " s (" << tick / seconds << " per second)" << endl;
+    cout << "Keyframes: " << keyframes << ", diverged " << diverged << ", max drift " << maxDrift << endl;
+
+    cout << telemetry->getReport();
 }
 
 Game::~Game()
@@ -77,4 +407,7 @@ Game::~Game()
     delete physicsWorld;
 
     delete multiplayer;
+    delete recorder;
+    delete telemetry;
+    delete config;
 }
@@ -3,22 +3,45 @@
 #include <chrono>
 #include <thread>
 
+/* after a stall the lost time is dropped instead of stepping this many ticks at once */
+#define GAME_MAX_CATCHUP_TICKS 5
+
+/* a replayed keyframe further off than this, in world units or radians, diverged */
+#define GAME_REPLAY_TOLERANCE 0.001
+
 using namespace std;
 
 class Game
 {
     private:
+        Config* config;
+        Telemetry* telemetry;
+
         Level* level;
         World* physicsWorld;
 
         Multiplayer* multiplayer;
 
+        /* one of them or none, a recorded match or a replayed one */
+        MatchRecorder* recorder;
+        MatchReader* reader;
+
+        unsigned int tick;
+
+        void init(string levelName);
+
         void checkEvents(); 
+        void simulate();
+
+        void capture(Keyframe& keyframe) const;
+        int compare(const Keyframe& recorded, const Keyframe& replayed, float& drift) const;
 
     public:
         Game(string level);
+        Game(MatchReader* reader);
         
         void gameLoop();
+        void replay();
 
         ~Game();
 };
@@ -0,0 +1,238 @@
+#include "config.hpp"
+
+Config::Config()
+{
+    slots = 5;
+    backlog = 2;
+    port = 5040;
+
+    decoders = 2;
+
+    tickRate = 60;
+    sendRate = 20;
+
+    interestRadius = 60.0;
+    interestCell = 16.0;
+    interestBudget = 1100;
+
+    loss = 0.0;
+    latency = 0;
+    jitter = 0;
+
+    telemetryPeriod = 10;
+    telemetryFile = "telemetry.log";
+
+    recordFile = "";
+    recordKeyframe = 60;
+}
+
+void Config::loadConfig(string fileName)
+{
+    XMLDocument configDoc;
+
+    /* keep the defaults */
+    if (configDoc.LoadFile(fileName.c_str()) != XML_SUCCESS)
+    {
+        return;
+    }
+
+    XMLNode* root = configDoc.FirstChildElement("Config");
+
+    if (!root)
+    {
+        throw runtime_error("ERROR::Config::loadConfig() failed to load XML");
+    }
+
+    /* server */
+    XMLElement* serverElem = root->FirstChildElement("server");
+
+    if (serverElem)
+    {
+        serverElem->QueryIntAttribute("slots", &slots);
+        serverElem->QueryIntAttribute("backlog", &backlog);
+        serverElem->QueryIntAttribute("port", &port);
+        serverElem->QueryIntAttribute("tickrate", &tickRate);
+        serverElem->QueryIntAttribute("sendrate", &sendRate);
+        serverElem->QueryIntAttribute("decoders", &decoders);
+    }
+
+    if (slots <= 0 || backlog <= 0 || port <= 0 || tickRate <= 0 || sendRate <= 0 || sendRate > tickRate || decoders < 0)
+    {
+        throw runtime_error("ERROR::Config::loadConfig() bad server settings");
+    }
+
+    /* interest */
+    XMLElement* interestElem = root->FirstChildElement("interest");
+
+    if (interestElem)
+    {
+        interestElem->QueryFloatAttribute("radius", &interestRadius);
+        interestElem->QueryFloatAttribute("cell", &interestCell);
+        interestElem->QueryIntAttribute("budget", &interestBudget);
+    }
+
+    if (interestRadius <= 0.0 || interestCell <= 0.0 || interestBudget < 0)
+    {
+        throw runtime_error("ERROR::Config::loadConfig() bad interest settings");
+    }
+
+    /* simulator */
+    XMLElement* simulatorElem = root->FirstChildElement("simulator");
+
+    if (simulatorElem)
+    {
+        simulatorElem->QueryFloatAttribute("loss", &loss);
+        simulatorElem->QueryIntAttribute("latency", &latency);
+        simulatorElem->QueryIntAttribute("jitter", &jitter);
+    }
+
+    if (loss < 0.0 || loss > 1.0 || latency < 0 || jitter < 0)
+    {
+        throw runtime_error("ERROR::Config::loadConfig() bad simulator settings");
+    }
+
+    /* telemetry */
+    XMLElement* telemetryElem = root->FirstChildElement("telemetry");
+
+    if (telemetryElem)
+    {
+        telemetryElem->QueryIntAttribute("period", &telemetryPeriod);
+
+        const char* file = telemetryElem->Attribute("file");
+
+        if (file)
+        {
+            telemetryFile = file;
+        }
+    }
+
+    if (telemetryPeriod < 0 || telemetryFile.empty())
+    {
+        throw runtime_error("ERROR::Config::loadConfig() bad telemetry settings");
+    }
+
+    /* record */
+    XMLElement* recordElem = root->FirstChildElement("record");
+
+    if (recordElem)
+    {
+        recordElem->QueryIntAttribute("keyframe", &recordKeyframe);
+
+        const char* file = recordElem->Attribute("file");
+
+        if (file)
+        {
+            recordFile = file;
+        }
+    }
+
+    if (recordKeyframe <= 0)
+    {
+        throw runtime_error("ERROR::Config::loadConfig() bad record settings");
+    }
+}
+
+/* a replay runs with the settings of the match, on a port nobody knows and records nothing */
+void Config::setReplay(int slots, int tickRate, int sendRate)
+{
+    if (slots <= 0 || tickRate <= 0 || sendRate <= 0 || sendRate > tickRate)
+    {
+        throw runtime_error("ERROR::Config::setReplay() bad match settings");
+    }
+
+    this->slots = slots;
+    this->tickRate = tickRate;
+    this->sendRate = sendRate;
+
+    port = 0;
+    loss = 0.0;
+    latency = 0;
+    jitter = 0;
+
+    /* the timings are what a replay is for */
+    telemetryPeriod = max(1, telemetryPeriod);
+
+    recordFile = "";
+}
+
+int Config::getSlots() const
+{
+    return slots;
+}
+
+int Config::getBacklog() const
+{
+    return backlog;
+}
+
+int Config::getPort() const
+{
+    return port;
+}
+
+int Config::getDecoders() const
+{
+    return decoders;
+}
+
+int Config::getTickRate() const
+{
+    return tickRate;
+}
+
+int Config::getSendRate() const
+{
+    return sendRate;
+}
+
+float Config::getInterestRadius() const
+{
+    return interestRadius;
+}
+
+float Config::getInterestCell() const
+{
+    return interestCell;
+}
+
+int Config::getInterestBudget() const
+{
+    return interestBudget;
+}
+
+float Config::getLoss() const
+{
+    return loss;
+}
+
+int Config::getLatency() const
+{
+    return latency;
+}
+
+int Config::getJitter() const
+{
+    return jitter;
+}
+
+int Config::getTelemetryPeriod() const
+{
+    return telemetryPeriod;
+}
+
+string Config::getTelemetryFile() const
+{
+    return telemetryFile;
+}
+
+string Config::getRecordFile() const
+{
+    return recordFile;
+}
+
+int Config::getRecordKeyframe() const
+{
+    return recordKeyframe;
+}
+
+Config::~Config() {}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+#include <tinyxml2/tinyxml2.h>
+
+using namespace std;
+using namespace tinyxml2;
+
+class Config
+{
+    private:
+        /* server */
+        int slots;
+        int backlog;
+        int port;
+
+        /* threads parsing the client messages, 0 = the receiver does it alone */
+        int decoders;
+
+        /* simulation steps and snapshots per second */
+        int tickRate;
+        int sendRate;
+
+        /* area of interest, world units and bytes per snapshot */
+        float interestRadius;
+        float interestCell;
+        int interestBudget;
+
+        /* link simulator, applied to the outgoing datagrams */
+        float loss;
+        int latency;
+        int jitter;
+
+        /* metrics log, seconds between the reports */
+        int telemetryPeriod;
+        string telemetryFile;
+
+        /* match log, empty file = off, ticks between the state keyframes */
+        string recordFile;
+        int recordKeyframe;
+
+    public:
+        Config();
+
+        void loadConfig(string fileName);
+        void setReplay(int slots, int tickRate, int sendRate);
+
+        int getSlots() const;
+        int getBacklog() const;
+        int getPort() const;
+        int getDecoders() const;
+
+        int getTickRate() const;
+        int getSendRate() const;
+
+        float getInterestRadius() const;
+        float getInterestCell() const;
+        int getInterestBudget() const;
+
+        float getLoss() const;
+        int getLatency() const;
+        int getJitter() const;
+
+        int getTelemetryPeriod() const;
+        string getTelemetryFile() const;
+
+        string getRecordFile() const;
+        int getRecordKeyframe() const;
+
+        ~Config();
+};
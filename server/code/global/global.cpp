@@ -1,10 +1,11 @@
 #include "global.hpp"
 
+mt19937 Global::gen(random_device{}());
+uniform_real_distribution < float > Global::dis(0.0, 1.0);
+atomic < int > Global::fixedTime(-1);
+
 Global::Global() 
 {
-    gen = new mt19937(rd());
-    dis = new uniform_real_distribution < float >(0.0, 1.0);
-    
     start = chrono::system_clock::now();
 }
 
@@ -35,9 +36,15 @@ float Global::cutFloat(float from, int precision) const
     return stof(ss.str());
 }
 
+void Global::setSeed(unsigned int seed)
+{
+    gen.seed(seed);
+    dis.reset();
+}
+
 float Global::getRandomNumber() const
 {
-    return (*dis)(*gen);
+    return dis(gen);
 }
 
 float Global::getUpTime() const
@@ -49,12 +56,25 @@ float Global::getUpTime() const
     return diff.count();
 }
 
+/* -1 goes back to the wall clock */
+void Global::setTime(int time)
+{
+    fixedTime = time;
+}
+
 unsigned int Global::getTime() const
 {
+    int time = fixedTime;
+
+    if (time >= 0)
+    {
+        return time;
+    }
+
     auto now = chrono::system_clock::now();
-    unsigned long long time = chrono::duration_cast < chrono::milliseconds >(now.time_since_epoch()).count();
+    unsigned long long wallTime = chrono::duration_cast < chrono::milliseconds >(now.time_since_epoch()).count();
 
-    return time % 1000000;
+    return wallTime % 1000000;
 }
 
 double Global::toRads(double angle) const
@@ -67,8 +87,4 @@ double Global::toDegs(double rads) const
     return rads * 180.0 / 3.14159265;
 }
 
-Global::~Global() 
-{
-    delete gen;
-    delete dis;
-}
+Global::~Global() {}
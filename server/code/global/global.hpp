@@ -7,6 +7,7 @@
 #include <sstream>
 #include <iomanip>
 #include <random>
+#include <atomic>
 
 //bullet
 #include <bullet/btBulletCollisionCommon.h>
@@ -17,9 +18,10 @@ using namespace std;
 class Global
 {
     private:
-        random_device rd;
-        mt19937* gen;
-        uniform_real_distribution < float >* dis;
+        /* one for all the copies of global, a replay reseeds it and freezes the clock */
+        static mt19937 gen;
+        static uniform_real_distribution < float > dis;
+        static atomic < int > fixedTime;
         
         chrono::system_clock::time_point start;
 
@@ -30,8 +32,10 @@ class Global
         
         float cutFloat(float from, int precision) const;
 
+        void setSeed(unsigned int seed);
         float getRandomNumber() const;
         float getUpTime() const;
+        void setTime(int time);
         unsigned int getTime() const;
 
         double toRads(double angle) const;
@@ -0,0 +1,229 @@
+#include "telemetry.hpp"
+
+Telemetry::Telemetry(int slots, int period, string fileName)
+{
+    traffic.resize(slots, {0, 0, 0, 0, 0, 0});
+
+    this->period = period;
+    this->fileName = fileName;
+
+    periodStart = chrono::steady_clock::now();
+}
+
+int Telemetry::getBucket(unsigned int micros) const
+{
+    int bucket = 0;
+
+    while (micros && bucket < TELEMETRY_BUCKETS - 1)
+    {
+        micros >>= 1;
+        bucket++;
+    }
+
+    return bucket;
+}
+
+unsigned int Telemetry::getPercentile(const Histogram& histogram, float percent) const
+{
+    unsigned long long rank = (unsigned long long)(histogram.count * percent / 100.0);
+    unsigned long long seen = 0;
+
+    /* the upper edge of the bucket, never above what was actually seen */
+    for (int i = 0; i < TELEMETRY_BUCKETS; i++)
+    {
+        seen += histogram.buckets[i];
+
+        if (seen > rank)
+        {
+            return i == TELEMETRY_BUCKETS - 1 ? histogram.max : min(histogram.max, (1u << i) - 1);
+        }
+    }
+
+    return histogram.max;
+}
+
+bool Telemetry::isEnabled() const
+{
+    return period > 0;
+}
+
+chrono::steady_clock::time_point Telemetry::now() const
+{
+    return chrono::steady_clock::now();
+}
+
+void Telemetry::addTime(const string& name, chrono::steady_clock::time_point start)
+{
+    addTime(name, chrono::duration_cast < chrono::microseconds >(chrono::steady_clock::now() - start).count());
+}
+
+void Telemetry::addTime(const string& name, unsigned int micros)
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+
+    unique_lock < mutex > lk(mtx);
+
+    auto it = histograms.find(name);
+
+    if (it == histograms.end())
+    {
+        it = histograms.insert({name, Histogram()}).first;
+    }
+
+    Histogram& histogram = it->second;
+
+    histogram.buckets[getBucket(micros)]++;
+    histogram.count++;
+    histogram.sum += micros;
+    histogram.max = max(histogram.max, micros);
+}
+
+void Telemetry::addIn(int client, size_t bytes)
+{
+    if (!isEnabled() || client < 0 || client >= (int)traffic.size())
+    {
+        return;
+    }
+
+    unique_lock < mutex > lk(mtx);
+
+    traffic[client].bytesIn += bytes;
+    traffic[client].messagesIn++;
+}
+
+void Telemetry::addOut(int client, size_t bytes)
+{
+    if (!isEnabled() || client < 0 || client >= (int)traffic.size())
+    {
+        return;
+    }
+
+    unique_lock < mutex > lk(mtx);
+
+    traffic[client].bytesOut += bytes;
+    traffic[client].messagesOut++;
+}
+
+void Telemetry::setQueue(int client, size_t frames, size_t bytes)
+{
+    if (!isEnabled() || client < 0 || client >= (int)traffic.size())
+    {
+        return;
+    }
+
+    unique_lock < mutex > lk(mtx);
+
+    traffic[client].queueFrames = max(traffic[client].queueFrames, frames);
+    traffic[client].queueBytes = max(traffic[client].queueBytes, bytes);
+}
+
+string Telemetry::getReport()
+{
+    map < string, Histogram > periodHistograms;
+    vector < Traffic > periodTraffic;
+
+    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+    float seconds;
+
+    /* swap out under the lock, format without it */
+    {
+        unique_lock < mutex > lk(mtx);
+
+        periodHistograms.swap(histograms);
+        periodTraffic = traffic;
+
+        for (size_t i = 0; i < traffic.size(); i++)
+        {
+            traffic[i] = {0, 0, 0, 0, 0, 0};
+        }
+
+        seconds = max(0.001f, chrono::duration < float >(end - periodStart).count());
+        periodStart = end;
+    }
+
+    stringstream res;
+
+    char date[32];
+    time_t wall = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", localtime(&wall));
+
+    res << "=== " << date << " | " << fixed << setprecision(1) << seconds << " s ===\n";
+
+    /* phases */
+    res << left << setw(28) << "phase" << right << setw(10) << "count" << setw(10) << "avg us" << setw(10) << "p50 us" << setw(10) << "p90 us" << setw(10) << "p99 us" << setw(10) << "max us" << "\n";
+
+    for (auto& i: periodHistograms)
+    {
+        const Histogram& histogram = i.second;
+
+        res << left << setw(28) << i.first << right << setw(10) << histogram.count;
+        res << setw(10) << (histogram.count ? histogram.sum / histogram.count : 0);
+        res << setw(10) << getPercentile(histogram, 50) << setw(10) << getPercentile(histogram, 90) << setw(10) << getPercentile(histogram, 99);
+        res << setw(10) << histogram.max << "\n";
+    }
+
+    /* raw buckets, "<2^i us:count", empty ones skipped */
+    for (auto& i: periodHistograms)
+    {
+        res << "hist " << i.first;
+
+        for (int j = 0; j < TELEMETRY_BUCKETS; j++)
+        {
+            if (i.second.buckets[j])
+            {
+                res << " <" << (1u << j) << ":" << i.second.buckets[j];
+            }
+        }
+
+        res << "\n";
+    }
+
+    /* clients */
+    res << left << setw(8) << "client" << right << setw(12) << "in B/s" << setw(10) << "in msg/s" << setw(12) << "out B/s" << setw(10) << "out msg/s" << setw(12) << "queue frm" << setw(12) << "queue B" << "\n";
+
+    for (size_t i = 0; i < periodTraffic.size(); i++)
+    {
+        const Traffic& t = periodTraffic[i];
+
+        if (!t.messagesIn && !t.messagesOut)
+        {
+            continue;
+        }
+
+        res << left << setw(8) << i << right;
+        res << setw(12) << t.bytesIn / seconds << setw(10) << t.messagesIn / seconds;
+        res << setw(12) << t.bytesOut / seconds << setw(10) << t.messagesOut / seconds;
+        res << setw(12) << t.queueFrames << setw(12) << t.queueBytes << "\n";
+    }
+
+    return res.str();
+}
+
+void Telemetry::report()
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+
+    while (true)
+    {
+        this_thread::sleep_for(chrono::seconds(period));
+
+        /* the file may be rotated away between the reports */
+        ofstream file(fileName, ios::app);
+
+        if (!file)
+        {
+            cerr << "ERROR::Telemetry::report() can't open " << fileName << endl;
+            continue;
+        }
+
+        file << getReport() << endl;
+    }
+}
+
+Telemetry::~Telemetry() {}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <ctime>
+
+#define TELEMETRY_BUCKETS 24 /* log2 of microseconds, the last one takes everything from 2^22 us */
+
+using namespace std;
+
+/*
+ * server instrumentation, shared by the simulation, the receiver and the node.
+ * phase durations go into log2 histograms by name, the traffic is counted per client,
+ * every period the whole thing is appended to the log file as text and reset
+ */
+class Telemetry
+{
+    private:
+        struct Histogram
+        {
+            unsigned long long buckets[TELEMETRY_BUCKETS];
+            unsigned long long count;
+            unsigned long long sum;
+            unsigned int max;
+        };
+
+        struct Traffic
+        {
+            unsigned long long bytesIn;
+            unsigned long long messagesIn;
+            unsigned long long bytesOut;
+            unsigned long long messagesOut;
+
+            /* the deepest the send queue got */
+            size_t queueFrames;
+            size_t queueBytes;
+        };
+
+        map < string, Histogram > histograms;
+        vector < Traffic > traffic;
+
+        int period;
+        string fileName;
+        chrono::steady_clock::time_point periodStart;
+
+        mutable mutex mtx;
+
+        int getBucket(unsigned int micros) const;
+        unsigned int getPercentile(const Histogram& histogram, float percent) const;
+
+    public:
+        Telemetry(int slots, int period, string fileName);
+
+        bool isEnabled() const;
+
+        chrono::steady_clock::time_point now() const;
+
+        void addTime(const string& name, chrono::steady_clock::time_point start);
+        void addTime(const string& name, unsigned int micros);
+
+        void addIn(int client, size_t bytes);
+        void addOut(int client, size_t bytes);
+        void setQueue(int client, size_t frames, size_t bytes);
+
+        string getReport();
+
+        void report();
+
+        ~Telemetry();
+};
@@ -15,11 +15,15 @@
 #include "levelloader.hpp"
 #include "level.hpp"
 
-Level::Level(World* physicsWorld)
+Level::Level(World* physicsWorld, int slots)
 {
     this->physicsWorld = physicsWorld;
+    this->slots = slots;
 
-    levelLoader = new LevelLoader(physicsWorld);
+    levelLoader = new LevelLoader(physicsWorld, slots);
+    rayTracer = new RayTracer(physicsWorld->getWorld());
+
+    players.reserve(slots);
 
     levelName = "";
 }
@@ -33,8 +37,19 @@ void Level::loadLevel(string level)
 
     /*** GET LOADED DATA ***/
     levelLoader->getSpawner(spawner);
-    levelLoader->getPlayersData(players);
-    levelLoader->getPhysicsObjectsData(physicsObjects);
+
+    map < string, PhysicsObject* > loaded;
+    levelLoader->getPhysicsObjectsData(loaded);
+
+    unique_lock < mutex > lk(mtx);
+
+    /* the soldiers come on join, no reallocation then */
+    physicsObjects.reserve(loaded.size() + slots);
+
+    for (auto& i: loaded)
+    {
+        registerPhysicsObject(i.second, false);
+    }
 }
 
 void Level::updateLevel()
@@ -42,75 +57,184 @@ void Level::updateLevel()
     levelLoader->updateLevel();
 }
         
-void Level::addPhysicsObject(PhysicsObject* physicsObject)
+int Level::registerPhysicsObject(PhysicsObject* physicsObject, bool player)
 {
-    if (physicsObjects.find(physicsObject->getName()) == physicsObjects.end())
+    auto it = handles.find(physicsObject->getName());
+
+    if (it != handles.end())
     {
-        physicsObjects.insert({physicsObject->getName(), physicsObject}); 
+        return it->second;
+    }
+
+    int handle;
+
+    if (!freeHandles.empty())
+    {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+
+        physicsObjects[handle] = physicsObject;
+    }
+    else
+    {
+        handle = physicsObjects.size();
+
+        physicsObjects.push_back(physicsObject);
     }
+
+    handles.insert({physicsObject->getName(), handle});
+    physicsObject->setNetID(handle);
+
+    if (player)
+    {
+        playerHandles.push_back(handle);
+    }
+    else
+    {
+        objectHandles.push_back(handle);
+    }
+
+    return handle;
+}
+
+void Level::unregisterPhysicsObject(int handle)
+{
+    PhysicsObject* physicsObject = physicsObjects[handle];
+
+    handles.erase(physicsObject->getName());
+
+    playerHandles.erase(remove(playerHandles.begin(), playerHandles.end(), handle), playerHandles.end());
+    objectHandles.erase(remove(objectHandles.begin(), objectHandles.end(), handle), objectHandles.end());
+
+    delete physicsObject;
+
+    physicsObjects[handle] = nullptr;
+    freeHandles.push_back(handle);
+}
+        
+int Level::addPhysicsObject(PhysicsObject* physicsObject)
+{
+    unique_lock < mutex > lk(mtx);
+
+    return registerPhysicsObject(physicsObject, false);
 }
 
 PhysicsObject* Level::getPhysicsObject(string name) const
 {
-    if (physicsObjects.find(name) != physicsObjects.end())
+    unique_lock < mutex > lk(mtx);
+
+    auto it = handles.find(name);
+
+    if (it != handles.end())
     {
-        return physicsObjects.find(name)->second;
+        return physicsObjects[it->second];
     }
 
     return nullptr;
 }
 
-void Level::removePhysicsObject(PhysicsObject* physicsObject)
+PhysicsObject* Level::getPhysicsObject(int handle) const
 {
-    if (physicsObjects.find(physicsObject->getName()) != physicsObjects.end())
+    unique_lock < mutex > lk(mtx);
+
+    if (handle < 0 || handle >= (int)physicsObjects.size())
     {
-        auto it = physicsObjects.find(physicsObject->getName());
+        return nullptr;
+    }
 
-        delete it->second;
-        physicsObjects.erase(it);
+    return physicsObjects[handle];
+}
+
+int Level::getHandle(string name) const
+{
+    unique_lock < mutex > lk(mtx);
+
+    auto it = handles.find(name);
+
+    if (it != handles.end())
+    {
+        return it->second;
     }
+
+    return -1;
+}
+
+void Level::removePhysicsObject(PhysicsObject* physicsObject)
+{
+    removePhysicsObject(physicsObject->getName());
 }
         
 void Level::removePhysicsObject(string name)
 {
-    if (physicsObjects.find(name) != physicsObjects.end())
-    {
-        auto it = physicsObjects.find(name);
+    unique_lock < mutex > lk(mtx);
+
+    auto it = handles.find(name);
 
-        delete it->second;
-        physicsObjects.erase(it);
+    if (it != handles.end())
+    {
+        unregisterPhysicsObject(it->second);
     }
 }
         
-void Level::spawn(int client)
+Player* Level::addPlayer(int id)
 {
-    Soldier* soldier = nullptr;
+    if (id < 0 || id >= slots)
+    {
+        throw(runtime_error("ERROR::Level::addPlayer() slot out of range"));
+    }
 
-    for (size_t i = 0; i < players.size(); i++)
+    Player* player = getPlayer(id);
+
+    if (player)
     {
-        if (players[i]->getID() == client)
-        {
-            soldier = dynamic_cast < Soldier* >(players[client]);
+        return player;
+    }
 
-            if (!soldier)
-            {
-                return;
-            }
-            else
-            {
-                break;
-            }
-        }
+    Soldier* soldier = levelLoader->loadSoldier(id);
+    soldier->setRayTracer(rayTracer);
+
+    unique_lock < mutex > lk(mtx);
+
+    if (soldier->getPhysicsObject())
+    {
+        registerPhysicsObject(soldier->getPhysicsObject(), true);
+    }
+
+    players.push_back(soldier);
+
+    return soldier;
+}
+
+void Level::spawn(int client)
+{
+    Soldier* soldier = dynamic_cast < Soldier* >(getPlayer(client));
+
+    if (!soldier)
+    {
+        return;
     }
 
     soldier->getPhysicsObject()->setTransform(spawner->getTransform(soldier->getID()));
     soldier->setHealth(soldier->getMaxHealth());
 }
 
+void Level::updatePlayers(float step)
+{
+    vector < Player* > players = getPlayers();
+
+    /* the queued input commands, before the step moves the bodies */
+    for (size_t i = 0; i < players.size(); i++)
+    {
+        players[i]->update(step);
+    }
+}
+
 void Level::update()
 {
     int respawnTime = 5000;
 
+    vector < Player* > players = getPlayers();
+
     /* respawn */
     for (size_t i = 0; i < players.size(); i++)
     {
@@ -145,9 +269,7 @@ void Level::update()
             continue;
         }
 
-        set < btRigidBody* > touching;
-
-        touching = physicsWorld->getTouchingWith(players[i]->getPhysicsObject()->getRigidBody());
+        const vector < btRigidBody* >& touching = physicsWorld->getTouchingWith(players[i]->getPhysicsObject()->getRigidBody());
 
         for (auto& j: touching)
         {
@@ -169,62 +291,94 @@ void Level::deSpawn(int client)
 
 void Level::clearNoPlayersAndTheirWeaponsOwner(int owner)
 {
-    map < string, PhysicsObject* > tmp = getNoPlayersAndTheirWeaponsPhysicsObjects();
-
-    for (auto& it : tmp)
+    forEachNoPlayersAndTheirWeaponsPhysicsObject([owner](PhysicsObject* physicsObject)
     {
-        if (it.second->getOwnerID() == owner)
+        if (physicsObject->getOwnerID() == owner)
         {
-            it.second->getRigidBody()->forceActivationState(ACTIVE_TAG);
-            it.second->getRigidBody()->applyCentralImpulse(it.second->getRigidBody()->getGravity());
+            physicsObject->getRigidBody()->forceActivationState(ACTIVE_TAG);
+            physicsObject->getRigidBody()->applyCentralImpulse(physicsObject->getRigidBody()->getGravity());
 
-            it.second->setOwnerID(-1);
+            physicsObject->setOwnerID(-1);
         }
-    }
+    });
 }
 
-map < string, PhysicsObject* > Level::getPhysicsObjects() const
+void Level::forEachPhysicsObject(const function < void(PhysicsObject*) >& visit) const
 {
-    return physicsObjects;
+    unique_lock < mutex > lk(mtx);
+
+    for (size_t i = 0; i < physicsObjects.size(); i++)
+    {
+        if (physicsObjects[i])
+        {
+            visit(physicsObjects[i]);
+        }
+    }
 }
 
-map < string, PhysicsObject* > Level::getNoPlayersPhysicsObjects() const
+void Level::forEachNoPlayersPhysicsObject(const function < void(PhysicsObject*) >& visit) const
 {
-    map < string, PhysicsObject* > tmp = physicsObjects;
+    unique_lock < mutex > lk(mtx);
 
-    for (size_t i = 0; i < players.size(); i++)
+    for (size_t i = 0; i < objectHandles.size(); i++)
     {
-        tmp.erase(players[i]->getPhysicsObject()->getName());
+        visit(physicsObjects[objectHandles[i]]);
     }
-
-    return tmp;
 }
 
-map < string, PhysicsObject* > Level::getNoPlayersAndTheirWeaponsPhysicsObjects() const
+void Level::forEachNoPlayersAndTheirWeaponsPhysicsObject(const function < void(PhysicsObject*) >& visit) const
 {
-    map < string, PhysicsObject* > tmp = physicsObjects;
+    unique_lock < mutex > lk(mtx);
 
-    for (size_t i = 0; i < players.size(); i++)
+    for (size_t i = 0; i < objectHandles.size(); i++)
     {
-        tmp.erase(players[i]->getPhysicsObject()->getName());
-
-        Soldier* soldier = dynamic_cast < Soldier* >(players[i]);
+        PhysicsObject* physicsObject = physicsObjects[objectHandles[i]];
 
-        if (soldier)
+        /* picked weapons point to their soldier */
+        if (!physicsObject->getUserPointer())
         {
-            deque < Weapon* > weapons = soldier->getWeapons();
-            for (size_t j = 0; j < weapons.size(); j++)
-            {
-                tmp.erase(weapons[j]->getName());
-            }
+            visit(physicsObject);
         }
     }
+}
 
-    return tmp;
+/* copies for the rare callers, a join */
+vector < PhysicsObject* > Level::getPhysicsObjects() const
+{
+    vector < PhysicsObject* > res;
+
+    forEachPhysicsObject([&res](PhysicsObject* physicsObject) { res.push_back(physicsObject); });
+
+    return res;
+}
+
+vector < PhysicsObject* > Level::getNoPlayersPhysicsObjects() const
+{
+    vector < PhysicsObject* > res;
+
+    forEachNoPlayersPhysicsObject([&res](PhysicsObject* physicsObject) { res.push_back(physicsObject); });
+
+    return res;
+}
+
+vector < PhysicsObject* > Level::getNoPlayersAndTheirWeaponsPhysicsObjects() const
+{
+    vector < PhysicsObject* > res;
+
+    forEachNoPlayersAndTheirWeaponsPhysicsObject([&res](PhysicsObject* physicsObject) { res.push_back(physicsObject); });
+
+    return res;
+}
+
+int Level::getSlots() const
+{
+    return slots;
 }
 
 Player* Level::getPlayer(int id) const
 {
+    unique_lock < mutex > lk(mtx);
+
     for (size_t i = 0; i < players.size(); i++)
     {
         if (players[i]->getID() == id)
@@ -238,11 +392,15 @@ Player* Level::getPlayer(int id) const
 
 vector < Player* > Level::getPlayers() const
 {
+    unique_lock < mutex > lk(mtx);
+
     return players;
 }
 
 vector < Player* > Level::getPlayersExcept(int id) const
 {
+    unique_lock < mutex > lk(mtx);
+
     vector < Player* > tmp = players;
 
     for (size_t i = 0; i < tmp.size(); i++)
@@ -271,10 +429,11 @@ Level::~Level()
 {
     delete levelLoader;
     delete spawner;
+    delete rayTracer;
 
-    for (auto& i : physicsObjects)
+    for (size_t i = 0; i < physicsObjects.size(); i++)
     {
-        delete i.second;
+        delete physicsObjects[i];
     }
 
     for (size_t i = 0; i < players.size(); i++)
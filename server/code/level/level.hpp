@@ -3,9 +3,12 @@
 #include <iostream>
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <mutex>
+#include <functional>
 
 using namespace std;
 
@@ -17,37 +20,64 @@ class Level
         LevelLoader* levelLoader;
 
         Spawner* spawner;
+
+        RayTracer* rayTracer; /* ground tests of the players */
         
         string levelName;
         string levelPath;
 
-        /* all objects in the level */
-        map < string, PhysicsObject* > physicsObjects;
+        int slots;
+
+        /* all objects in the level, a handle is the index, holes are reused */
+        vector < PhysicsObject* > physicsObjects;
+        unordered_map < string, int > handles;
+        vector < int > freeHandles;
+
+        /* categories, kept on add / remove. the carried weapons are told apart by the user pointer set on pick / drop */
+        vector < int > playerHandles;
+        vector < int > objectHandles;
         
+        /* allocated on join */
         vector < Player* > players;
 
+        mutable mutex mtx;
+
+        int registerPhysicsObject(PhysicsObject* physicsObject, bool player);
+        void unregisterPhysicsObject(int handle);
+
     public:
-        Level(World* physicsWorld);
+        Level(World* physicsWorld, int slots);
         
         void loadLevel(string level);
         void updateLevel();
 
-        void addPhysicsObject(PhysicsObject* physicsObject);
+        int addPhysicsObject(PhysicsObject* physicsObject);
         PhysicsObject* getPhysicsObject(string name) const;
+        PhysicsObject* getPhysicsObject(int handle) const;
+        int getHandle(string name) const;
 
         void removePhysicsObject(PhysicsObject* physicsObject);
         void removePhysicsObject(string name);
 
+        Player* addPlayer(int id);
+
         void spawn(int client);
+        void updatePlayers(float step);
         void update();
         void deSpawn(int client);
        
         void clearNoPlayersAndTheirWeaponsOwner(int owner);
 
-        map < string, PhysicsObject* > getPhysicsObjects() const;
-        map < string, PhysicsObject* > getNoPlayersPhysicsObjects() const;
-        map < string, PhysicsObject* > getNoPlayersAndTheirWeaponsPhysicsObjects() const;
+        /* visit under the level lock without a copy, the visitor must not call back into the level */
+        void forEachPhysicsObject(const function < void(PhysicsObject*) >& visit) const;
+        void forEachNoPlayersPhysicsObject(const function < void(PhysicsObject*) >& visit) const;
+        void forEachNoPlayersAndTheirWeaponsPhysicsObject(const function < void(PhysicsObject*) >& visit) const;
+
+        vector < PhysicsObject* > getPhysicsObjects() const;
+        vector < PhysicsObject* > getNoPlayersPhysicsObjects() const;
+        vector < PhysicsObject* > getNoPlayersAndTheirWeaponsPhysicsObjects() const;
         
+        int getSlots() const;
         Player* getPlayer(int id) const;
         vector < Player* > getPlayers() const;
         vector < Player* > getPlayersExcept(int id) const;
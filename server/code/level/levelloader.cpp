@@ -14,9 +14,10 @@
 #include "spawner.hpp"
 #include "levelloader.hpp"
 
-LevelLoader::LevelLoader(World* physicsWorld)
+LevelLoader::LevelLoader(World* physicsWorld, int slots)
 {
     this->physicsWorld = physicsWorld;
+    this->slots = slots;
 }
         
 void LevelLoader::loadPhysicsObject(XMLElement* physicsObjectElem, PhysicsObject*& PO, string name)
@@ -722,7 +723,7 @@ void LevelLoader::loadWeapons()
     } 
 }
 
-void LevelLoader::loadSoldiers()
+void LevelLoader::checkSoldiers()
 {
     XMLDocument soldierDoc;
 
@@ -732,111 +733,139 @@ void LevelLoader::loadSoldiers()
 
     if (!root)
     {
-        throw runtime_error("ERROR::LevelLoader::loadSoldiers() failed to load XML");
+        throw runtime_error("ERROR::LevelLoader::checkSoldiers() failed to load XML");
     }
 
+    if (!root->FirstChildElement("soldier"))
+    {
+        throw runtime_error("ERROR::LevelLoader::checkSoldiers() at least 1 soldier is required");
+    }
+}
+
+Soldier* LevelLoader::loadSoldier(int id)
+{
+    XMLDocument soldierDoc;
+
+    soldierDoc.LoadFile((levelName + "/soldier.xml").c_str());
+
+    XMLNode* root = soldierDoc.FirstChildElement("Soldiers");
+
+    if (!root)
+    {
+        throw runtime_error("ERROR::LevelLoader::loadSoldier() failed to load XML");
+    }
+
+    /* the soldier with this id or the first one as a template */
     XMLElement* soldierElem = root->FirstChildElement("soldier");
+    XMLElement* templateElem = soldierElem;
 
     while (soldierElem)
     {
-        /* id */
-        int id = -1;
-        soldierElem->QueryIntAttribute("id", &id);
+        int soldierID = -1;
+        soldierElem->QueryIntAttribute("id", &soldierID);
 
-        /* speed */
-        XMLElement* speedElem = soldierElem->FirstChildElement("speed");
-        float speed = 1.0;
-
-        if (speedElem)
+        if (soldierID == id)
         {
-            speedElem->QueryFloatAttribute("speed", &speed);
+            break;
         }
-        
-        /* health */
-        XMLElement* healthElem = soldierElem->FirstChildElement("health");
-        int health = 1.0;
 
-        if (healthElem)
-        {
-            healthElem->QueryIntAttribute("health", &health);
-        }
+        soldierElem = soldierElem->NextSiblingElement("soldier");
+    }
 
-        Soldier* soldier = nullptr;
+    bool found = soldierElem;
 
-        bool found = false;
-        for (size_t i = 0; i < players.size(); i++)
-        {
-            if (players[i]->getID() == id)
-            {
-                found = true;
-                soldier = dynamic_cast < Soldier* >(players[i]);
-                break;
-            }
-        }
+    if (!found)
+    {
+        soldierElem = templateElem;
+    }
+
+    if (!soldierElem)
+    {
+        throw runtime_error("ERROR::LevelLoader::loadSoldier() no soldier to load");
+    }
+
+    /* speed */
+    XMLElement* speedElem = soldierElem->FirstChildElement("speed");
+    float speed = 1.0;
 
-        if (!found)
+    if (speedElem)
+    {
+        speedElem->QueryFloatAttribute("speed", &speed);
+    }
+    
+    /* health */
+    XMLElement* healthElem = soldierElem->FirstChildElement("health");
+    int health = 1.0;
+
+    if (healthElem)
+    {
+        healthElem->QueryIntAttribute("health", &health);
+    }
+
+    Soldier* soldier = new Soldier(health, id, speed);
+
+    /* physics object */
+    XMLElement* physicsObjectElem = soldierElem->FirstChildElement("obj");
+
+    if (physicsObjectElem)
+    {
+        string name = "soldier" + to_string(id);
+
+        if (found)
         {
-            soldier = new Soldier(health, id, speed);
-            players.push_back(soldier);
+            const char* tmp = nullptr;
+            physicsObjectElem->QueryStringAttribute("name", &tmp);
+
+            name = tmp;
         }
 
-        /* physics object */
-        XMLElement* physicsObjectElem = soldierElem->FirstChildElement("obj");
+        PhysicsObject* PO = nullptr;
 
-        if (physicsObjectElem)
+        if (physicsObjects.find(name) != physicsObjects.end())
         {
-            const char* name = nullptr;
-            physicsObjectElem->QueryStringAttribute("name", &name);
+            PO = physicsObjects.find(name)->second;
+        }
 
-            /* new */
-            if (physicsObjects.find(name) == physicsObjects.end())
-            {
-                PhysicsObject* PO = nullptr;
+        loadPhysicsObject(physicsObjectElem, PO, name);
 
-                loadPhysicsObject(physicsObjectElem, PO, name);
+        physicsObjects.insert({PO->getName(), PO});
 
-                physicsObjects.insert({PO->getName(), PO});
+        soldier->setPhysicsObject(PO);
+    }
 
-                soldier->setPhysicsObject(PO);
-            }
-            else // update
-            {
-                PhysicsObject* PO = physicsObjects.find(name)->second;
+    /* add weapon, the template's weapons belong to its own soldier */
+    XMLElement* armoryElem = soldierElem->FirstChildElement("armory");
 
-                loadPhysicsObject(physicsObjectElem, PO, name);
-            }
-        }
+    if (found && armoryElem)
+    {
+        XMLElement* weaponElem = armoryElem->FirstChildElement("weapon");
 
-        if (!found)
+        while (weaponElem)
         {
-            /* add weapon */
-            XMLElement* armoryElem = soldierElem->FirstChildElement("armory");
+            const char* name = nullptr;
+            weaponElem->QueryStringAttribute("name", &name);
 
-            if (armoryElem)
-            {
-                XMLElement* weaponElem = armoryElem->FirstChildElement("weapon");
+            Weapon* weapon = nullptr;
 
-                while (weaponElem)
-                {
-                    const char* name = nullptr;
-                    weaponElem->QueryStringAttribute("name", &name);
+            if (physicsObjects.find(name) != physicsObjects.end())
+            {
+                weapon = dynamic_cast < Weapon* >(physicsObjects.find(name)->second);
+            }
 
-                    Weapon* weapon = dynamic_cast < Weapon* >(physicsObjects.find(name)->second);
+            if (!weapon)
+            {
+                delete soldier;
 
-                    if (!weapon)
-                    {
-                        throw runtime_error("ERROR::LevelLoader::loadSoldiers() can't find the weapon");
-                    }
+                throw runtime_error("ERROR::LevelLoader::loadSoldier() can't find the weapon");
+            }
 
-                    soldier->pick(weapon);
+            soldier->pick(weapon);
 
-                    weaponElem = weaponElem->NextSiblingElement();
-                }
-            }
+            weaponElem = weaponElem->NextSiblingElement();
         }
-
-        soldierElem = soldierElem->NextSiblingElement();
     }
+
+    return soldier;
 }
         
 void LevelLoader::loadSpawner()
@@ -852,7 +881,7 @@ void LevelLoader::loadSpawner()
         throw runtime_error("ERROR::LevelLoader::loadSpawner() failed to load XML");
     }
 
-    spawner = new Spawner(players.size());
+    spawner = new Spawner(slots);
 
     XMLElement* posElem = root->FirstChildElement("pos");
 
@@ -877,14 +906,9 @@ void LevelLoader::loadLevel(string name)
     loadPhysicsObjects();
     loadWeapons();
 
-    loadSoldiers();
+    checkSoldiers();
 
     loadSpawner();
-
-    if (players.empty())
-    {
-        throw runtime_error("ERROR::loadLevel() at least 1 player is required");
-    }
 }
 
 void LevelLoader::updateLevel()
@@ -903,9 +927,4 @@ void LevelLoader::getPhysicsObjectsData(map < string, PhysicsObject* > &physicsO
     physicsObjects = this->physicsObjects;
 }
 
-void LevelLoader::getPlayersData(vector < Player* > &players) const
-{
-    players = this->players;
-}
-
 LevelLoader::~LevelLoader() {}
@@ -16,11 +16,11 @@ class LevelLoader
 
         string levelName;
 
+        int slots;
+
         Spawner* spawner;
 
         map < string, PhysicsObject* > physicsObjects;
-        
-        vector < Player* > players;
 
         /* helpers */
         void loadPhysicsObject(XMLElement* physicsObjectElem, PhysicsObject*& PO, string name);
@@ -30,20 +30,21 @@ class LevelLoader
         void loadPhysicsObjects();
         void loadWeapons();
 
-        void loadSoldiers();
+        void checkSoldiers();
 
         void loadSpawner();
 
     public:
-        LevelLoader(World* physicsWorld);
+        LevelLoader(World* physicsWorld, int slots);
 
         void loadLevel(string name);
         void updateLevel();
 
+        Soldier* loadSoldier(int id);
+
         void getSpawner(Spawner*& spawner);
 
         void getPhysicsObjectsData(map < string, PhysicsObject* > &physicsObjects) const;
-        void getPlayersData(vector < Player* > &players) const;
 
         ~LevelLoader();
 };
@@ -1,4 +1,6 @@
 #include "global/globaluse.hpp"
+#include "global/config.hpp"
+#include "global/telemetry.hpp"
 
 #include "world/raytracer.hpp"
 #include "world/bulletevents.hpp"
@@ -15,7 +17,10 @@
 #include "level/levelloader.hpp"
 #include "level/level.hpp"
 
+#include "multiplayer/messagebuffer.hpp"
+#include "multiplayer/linksimulator.hpp"
 #include "multiplayer/node.hpp"
+#include "multiplayer/worldsnapshot.hpp"
 #include "multiplayer/playerdatacollector.hpp"
 #include "multiplayer/playerdataupdater.hpp"
 #include "multiplayer/physicsobjectdatacollector.hpp"
@@ -25,15 +30,36 @@
 #include "multiplayer/weaponpickerupdater.hpp"
 #include "multiplayer/weapondroppercollector.hpp"
 #include "multiplayer/weapondropperupdater.hpp"
+#include "multiplayer/posehistory.hpp"
 #include "multiplayer/weaponfireupdater.hpp"
 #include "multiplayer/playerconnectioncollector.hpp"
 #include "multiplayer/playerdisconnectioncollector.hpp"
+#include "multiplayer/interestgrid.hpp"
+#include "multiplayer/snapshotencoder.hpp"
+#include "multiplayer/decoderpool.hpp"
+#include "multiplayer/commandqueue.hpp"
+#include "multiplayer/matchrecorder.hpp"
+#include "multiplayer/matchreader.hpp"
 #include "multiplayer/multiplayer.hpp"
 
 #include "game/game.hpp"
 
-int main()
+int main(int argc, char* argv[])
 {
+    /* ./server replay <file>, a recorded match as fast as it runs */
+    if (argc == 3 && string(argv[1]) == "replay")
+    {
+        MatchReader* reader = new MatchReader(argv[2]);
+        Game* G = new Game(reader);
+
+        G->replay();
+
+        delete G;
+        delete reader;
+
+        return 0;
+    }
+
     Game* G = new Game("urban");
 
     G->gameLoop();
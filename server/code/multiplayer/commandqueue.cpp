@@ -0,0 +1,54 @@
+#include "../global/globaluse.hpp"
+
+#include "../world/raytracer.hpp"
+#include "../world/bulletevents.hpp"
+#include "../world/world.hpp"
+
+#include "../physics_object/openglmotionstate.hpp"
+#include "../physics_object/physicsobject.hpp"
+#include "../physics_object/weapon.hpp"
+
+#include "../player/player.hpp"
+#include "../player/soldier.hpp"
+
+#include "../level/spawner.hpp"
+#include "../level/levelloader.hpp"
+#include "../level/level.hpp"
+
+#include "playerdataupdater.hpp"
+#include "physicsobjectdataupdater.hpp"
+#include "weaponpickerupdater.hpp"
+#include "weapondropperupdater.hpp"
+#include "posehistory.hpp"
+#include "weaponfireupdater.hpp"
+#include "interestgrid.hpp"
+#include "worldsnapshot.hpp"
+#include "snapshotencoder.hpp"
+#include "commandqueue.hpp"
+
+CommandQueue::CommandQueue() {}
+
+void CommandQueue::push(InboundMessage& command)
+{
+    unique_lock < mutex > lk(mtx);
+
+    pending.push_back(move(command));
+}
+
+void CommandQueue::take(vector < InboundMessage >& commands)
+{
+    commands.clear();
+
+    unique_lock < mutex > lk(mtx);
+
+    pending.swap(commands);
+}
+
+size_t CommandQueue::getSize() const
+{
+    unique_lock < mutex > lk(mtx);
+
+    return pending.size();
+}
+
+CommandQueue::~CommandQueue() {}
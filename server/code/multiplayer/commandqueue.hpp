@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+
+using namespace std;
+
+/* a parsed <Ping> message */
+struct PingData
+{
+    int playerID;
+    string time;
+};
+
+/* a client message after the decoders, only the part of its type is filled */
+struct InboundMessage
+{
+    unsigned char type;
+    bool valid;
+
+    string raw; /* the message as it came, only kept while the match is recorded */
+
+    PlayerData player;
+    PickData pick;
+    DropData drop;
+    FireData fire;
+    ObjData obj;
+    AckData ack;
+    ProtoData proto;
+    PingData ping;
+};
+
+/*
+ * the receiver fills it with decoded messages, the simulation takes the whole
+ * batch at the start of a tick, so the level is only ever changed by the tick.
+ * two vectors swap places, the lock is only held for a push or a swap
+ */
+class CommandQueue
+{
+    private:
+        vector < InboundMessage > pending;
+
+        mutable mutex mtx;
+
+    public:
+        CommandQueue();
+
+        void push(InboundMessage& command);
+        void take(vector < InboundMessage >& commands);
+
+        size_t getSize() const;
+
+        ~CommandQueue();
+};
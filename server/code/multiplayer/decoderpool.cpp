@@ -0,0 +1,123 @@
+#include "decoderpool.hpp"
+
+DecoderPool::DecoderPool(int threads)
+{
+    job = nullptr;
+    count = 0;
+    next = 0;
+
+    generation = 0;
+    finished = 0;
+    running = true;
+
+    for (int i = 0; i < threads; i++)
+    {
+        this->threads.push_back(thread(&DecoderPool::work, this));
+    }
+}
+
+void DecoderPool::drain(const function < void(size_t) >* job, size_t count)
+{
+    while (true)
+    {
+        size_t index = next++;
+
+        if (index >= count)
+        {
+            return;
+        }
+
+        (*job)(index);
+    }
+}
+
+void DecoderPool::work()
+{
+    unsigned int seen = 0;
+
+    while (true)
+    {
+        const function < void(size_t) >* batchJob;
+        size_t batchCount;
+
+        {
+            unique_lock < mutex > lk(mtx);
+
+            cv.wait(lk, [&]{ return !running || generation != seen; });
+
+            if (!running)
+            {
+                return;
+            }
+
+            seen = generation;
+            batchJob = job;
+            batchCount = count;
+        }
+
+        drain(batchJob, batchCount);
+
+        {
+            unique_lock < mutex > lk(mtx);
+
+            finished++;
+        }
+
+        doneCv.notify_one();
+    }
+}
+
+int DecoderPool::getThreads() const
+{
+    return threads.size();
+}
+
+void DecoderPool::run(size_t count, const function < void(size_t) >& job)
+{
+    /* not worth the wake ups */
+    if (threads.empty() || count < 2)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            job(i);
+        }
+
+        return;
+    }
+
+    {
+        unique_lock < mutex > lk(mtx);
+
+        this->job = &job;
+        this->count = count;
+        next = 0;
+
+        finished = 0;
+        generation++;
+    }
+
+    cv.notify_all();
+
+    drain(&job, count);
+
+    /* every worker checks in, so none of them is left holding the old batch */
+    unique_lock < mutex > lk(mtx);
+
+    doneCv.wait(lk, [&]{ return finished == threads.size(); });
+}
+
+DecoderPool::~DecoderPool()
+{
+    {
+        unique_lock < mutex > lk(mtx);
+
+        running = false;
+    }
+
+    cv.notify_all();
+
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        threads[i].join();
+    }
+}
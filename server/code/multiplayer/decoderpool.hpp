@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+using namespace std;
+
+/*
+ * fork-join pool of the receiver thread. run() hands out the indices of a batch
+ * one by one to the workers and to the caller itself and returns when all are done,
+ * so the jobs must only touch their own slot
+ */
+class DecoderPool
+{
+    private:
+        vector < thread > threads;
+
+        const function < void(size_t) >* job;
+        size_t count;
+        atomic < size_t > next;
+
+        unsigned int generation; /* bumped per batch */
+        size_t finished; /* workers done with the current batch */
+        bool running;
+
+        mutex mtx;
+        condition_variable cv;
+        condition_variable doneCv;
+
+        void drain(const function < void(size_t) >* job, size_t count);
+        void work();
+
+    public:
+        DecoderPool(int threads);
+
+        int getThreads() const;
+
+        void run(size_t count, const function < void(size_t) >& job);
+
+        ~DecoderPool();
+};
@@ -0,0 +1,114 @@
+#include "interestgrid.hpp"
+
+InterestGrid::InterestGrid(float radius, float cellSize)
+{
+    this->radius = radius;
+    this->cellSize = cellSize;
+}
+
+long long InterestGrid::getCell(int x, int z) const
+{
+    return ((long long)x << 32) ^ (unsigned int)z;
+}
+
+void InterestGrid::add(string key, btVector3 position)
+{
+    int x = (int)floor(position.x() / cellSize);
+    int z = (int)floor(position.z() / cellSize);
+
+    cells[getCell(x, z)].push_back(key);
+    positions[key] = position;
+}
+
+void InterestGrid::setViewer(int client, btVector3 position)
+{
+    viewers[client] = position;
+}
+
+bool InterestGrid::hasViewer(int client) const
+{
+    return viewers.find(client) != viewers.end();
+}
+
+bool InterestGrid::isRelevant(int client, const string& key) const
+{
+    /* nothing known, nothing filtered */
+    auto viewer = viewers.find(client);
+    auto position = positions.find(key);
+
+    if (viewer == viewers.end() || position == positions.end())
+    {
+        return true;
+    }
+
+    return viewer->second.distance2(position->second) <= radius * radius;
+}
+
+vector < string > InterestGrid::getRelevant(int client) const
+{
+    vector < string > res;
+
+    auto viewer = viewers.find(client);
+
+    if (viewer == viewers.end())
+    {
+        return res;
+    }
+
+    const btVector3& center = viewer->second;
+
+    int minX = (int)floor((center.x() - radius) / cellSize);
+    int maxX = (int)floor((center.x() + radius) / cellSize);
+    int minZ = (int)floor((center.z() - radius) / cellSize);
+    int maxZ = (int)floor((center.z() + radius) / cellSize);
+
+    for (int x = minX; x <= maxX; x++)
+    {
+        for (int z = minZ; z <= maxZ; z++)
+        {
+            auto cell = cells.find(getCell(x, z));
+
+            if (cell == cells.end())
+            {
+                continue;
+            }
+
+            for (size_t i = 0; i < cell->second.size(); i++)
+            {
+                if (center.distance2(positions.at(cell->second[i])) <= radius * radius)
+                {
+                    res.push_back(cell->second[i]);
+                }
+            }
+        }
+    }
+
+    return res;
+}
+
+float InterestGrid::getDistance(int client, const string& key) const
+{
+    auto viewer = viewers.find(client);
+    auto position = positions.find(key);
+
+    if (viewer == viewers.end() || position == positions.end())
+    {
+        return 0.0;
+    }
+
+    return viewer->second.distance(position->second);
+}
+
+float InterestGrid::getRadius() const
+{
+    return radius;
+}
+
+void InterestGrid::clear()
+{
+    cells.clear();
+    positions.clear();
+    viewers.clear();
+}
+
+InterestGrid::~InterestGrid() {}
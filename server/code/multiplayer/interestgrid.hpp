@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+
+#include <bullet/btBulletCollisionCommon.h>
+
+using namespace std;
+
+/*
+ * uniform grid over the ground plane (x, z), rebuilt every broadcast.
+ * a client only hears about the entities within radius of its soldier,
+ * the lookup visits the cells around the viewer, not the whole level
+ */
+class InterestGrid
+{
+    private:
+        float radius;
+        float cellSize;
+
+        unordered_map < long long, vector < string > > cells;
+        map < string, btVector3 > positions;
+        map < int, btVector3 > viewers;
+
+        long long getCell(int x, int z) const;
+
+    public:
+        InterestGrid(float radius, float cellSize);
+
+        void add(string key, btVector3 position);
+        void setViewer(int client, btVector3 position);
+
+        bool hasViewer(int client) const;
+        bool isRelevant(int client, const string& key) const;
+
+        vector < string > getRelevant(int client) const;
+        float getDistance(int client, const string& key) const;
+        float getRadius() const;
+
+        void clear();
+
+        ~InterestGrid();
+};
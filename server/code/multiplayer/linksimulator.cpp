@@ -0,0 +1,68 @@
+#include "linksimulator.hpp"
+
+LinkSimulator::LinkSimulator(float loss, int latency, int jitter) : generator(random_device()())
+{
+    this->loss = loss;
+    this->latency = latency;
+    this->jitter = jitter;
+}
+
+void LinkSimulator::push(int slot, string datagram)
+{
+    if (uniform_real_distribution < float >(0.0, 1.0)(generator) < loss)
+    {
+        return;
+    }
+
+    int delay = latency;
+
+    if (jitter > 0)
+    {
+        delay += uniform_int_distribution < int >(-jitter, jitter)(generator);
+    }
+
+    chrono::steady_clock::time_point due = chrono::steady_clock::now() + chrono::milliseconds(max(0, delay));
+
+    pending.insert({due, {slot, move(datagram)}});
+}
+
+vector < pair < int, string > > LinkSimulator::pop()
+{
+    vector < pair < int, string > > res;
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+
+    while (!pending.empty() && pending.begin()->first <= now)
+    {
+        res.push_back({pending.begin()->second.slot, move(pending.begin()->second.data)});
+        pending.erase(pending.begin());
+    }
+
+    return res;
+}
+
+int LinkSimulator::getWait() const
+{
+    if (pending.empty())
+    {
+        return -1;
+    }
+
+    return max(0L, (long)chrono::duration_cast < chrono::milliseconds >(pending.begin()->first - chrono::steady_clock::now()).count());
+}
+
+void LinkSimulator::clear(int slot)
+{
+    for (auto it = pending.begin(); it != pending.end();)
+    {
+        if (it->second.slot == slot)
+        {
+            it = pending.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+LinkSimulator::~LinkSimulator() {}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <map>
+
+using namespace std;
+
+/*
+ * drops and delays datagrams before they hit the socket, so a loopback
+ * session behaves like a bad link. jitter reorders them as well
+ */
+class LinkSimulator
+{
+    private:
+        struct Datagram
+        {
+            int slot;
+            string data;
+        };
+
+        float loss;
+        int latency;
+        int jitter;
+
+        mt19937 generator;
+        multimap < chrono::steady_clock::time_point, Datagram > pending;
+
+    public:
+        LinkSimulator(float loss, int latency, int jitter);
+
+        void push(int slot, string datagram);
+        vector < pair < int, string > > pop();
+
+        int getWait() const;
+
+        void clear(int slot);
+
+        ~LinkSimulator();
+};
@@ -0,0 +1,194 @@
+#include "matchrecorder.hpp"
+#include "matchreader.hpp"
+
+MatchReader::MatchReader(string fileName)
+{
+    file.open(fileName, ios::binary);
+
+    if (!file)
+    {
+        throw(runtime_error("ERROR::MatchReader::MatchReader() failed to open " + fileName));
+    }
+
+    tick = 0;
+
+    char magic[sizeof(MATCH_MAGIC) - 1];
+
+    file.read(magic, sizeof(magic));
+
+    if (!file || memcmp(magic, MATCH_MAGIC, sizeof(magic)))
+    {
+        throw(runtime_error("ERROR::MatchReader::MatchReader() not a match log"));
+    }
+
+    if (readByte() != MATCH_VERSION)
+    {
+        throw(runtime_error("ERROR::MatchReader::MatchReader() unknown version"));
+    }
+
+    header.slots = readVarint();
+    header.tickRate = readVarint();
+    header.sendRate = readVarint();
+    header.seed = readVarint();
+
+    header.levelName.resize(readVarint());
+    file.read(&header.levelName[0], header.levelName.size());
+
+    if (!file)
+    {
+        throw(runtime_error("ERROR::MatchReader::MatchReader() broken header"));
+    }
+}
+
+unsigned char MatchReader::readByte()
+{
+    int byte = file.get();
+
+    if (byte == EOF)
+    {
+        throw(runtime_error("ERROR::MatchReader::readByte() unexpected end"));
+    }
+
+    return byte;
+}
+
+unsigned int MatchReader::readVarint()
+{
+    unsigned int value = 0;
+
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        unsigned char byte = readByte();
+
+        value |= (unsigned int)(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80))
+        {
+            return value;
+        }
+    }
+
+    throw(runtime_error("ERROR::MatchReader::readVarint() too long"));
+}
+
+int MatchReader::readSignedVarint()
+{
+    unsigned int value = readVarint();
+
+    return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
+float MatchReader::readFloat()
+{
+    char bytes[sizeof(float)];
+    float value;
+
+    file.read(bytes, sizeof(float));
+
+    if (!file)
+    {
+        throw(runtime_error("ERROR::MatchReader::readFloat() unexpected end"));
+    }
+
+    memcpy(&value, bytes, sizeof(float));
+
+    return value;
+}
+
+const MatchHeader& MatchReader::getHeader() const
+{
+    return header;
+}
+
+bool MatchReader::next(MatchRecord& record)
+{
+    if (file.peek() == EOF)
+    {
+        return false;
+    }
+
+    try
+    {
+        record.kind = readByte();
+
+        tick += readVarint();
+        record.tick = tick;
+
+        switch (record.kind)
+        {
+            case RECORD_CLOCK:
+            case RECORD_JOIN:
+            case RECORD_QUIT:
+                record.value = readVarint();
+                break;
+
+            case RECORD_COMMAND:
+            {
+                record.value = readByte();
+
+                record.data.resize(readVarint());
+                file.read(&record.data[0], record.data.size());
+
+                if (!file)
+                {
+                    throw(runtime_error("ERROR::MatchReader::next() unexpected end"));
+                }
+
+                break;
+            }
+
+            case RECORD_KEYFRAME:
+            {
+                record.keyframe.objects.resize(readVarint());
+
+                for (KeyframeObject& object: record.keyframe.objects)
+                {
+                    object.netID = readVarint();
+
+                    for (int i = 0; i < 3; i++)
+                    {
+                        object.position[i] = readFloat();
+                    }
+
+                    float rotation[4];
+
+                    for (int i = 0; i < 4; i++)
+                    {
+                        rotation[i] = readFloat();
+                    }
+
+                    object.rotation = btQuaternion(rotation[0], rotation[1], rotation[2], rotation[3]);
+                }
+
+                record.keyframe.soldiers.resize(readVarint());
+
+                for (KeyframeSoldier& soldier: record.keyframe.soldiers)
+                {
+                    soldier.id = readVarint();
+                    soldier.health = readSignedVarint();
+
+                    for (int i = 0; i < 3; i++)
+                    {
+                        soldier.position[i] = readFloat();
+                    }
+                }
+
+                break;
+            }
+
+            default:
+                throw(runtime_error("ERROR::MatchReader::next() unknown record"));
+        }
+    }
+    catch(exception& ex)
+    {
+        /* the server was killed in the middle of a write, the log ends here */
+        cerr << ex.what() << endl;
+
+        return false;
+    }
+
+    return true;
+}
+
+MatchReader::~MatchReader() {}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/* one record of a match log, only the part of its kind is filled */
+struct MatchRecord
+{
+    unsigned char kind;
+    unsigned int tick;
+
+    unsigned int value; /* clock time, join or quit id, command type */
+    string data; /* command */
+    Keyframe keyframe;
+};
+
+/* reads a match log of MatchRecorder front to back */
+class MatchReader
+{
+    private:
+        ifstream file;
+
+        MatchHeader header;
+        unsigned int tick;
+
+        unsigned char readByte();
+        unsigned int readVarint();
+        int readSignedVarint();
+        float readFloat();
+
+    public:
+        MatchReader(string fileName);
+
+        const MatchHeader& getHeader() const;
+
+        bool next(MatchRecord& record);
+
+        ~MatchReader();
+};
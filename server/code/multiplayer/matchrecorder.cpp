@@ -0,0 +1,218 @@
+#include "matchrecorder.hpp"
+
+MatchRecorder::MatchRecorder(string fileName, const MatchHeader& header)
+{
+    file.open(fileName, ios::binary | ios::trunc);
+
+    if (!file)
+    {
+        throw(runtime_error("ERROR::MatchRecorder::MatchRecorder() failed to open " + fileName));
+    }
+
+    lastTick = 0;
+    running = true;
+
+    string out = MATCH_MAGIC;
+
+    out += char(MATCH_VERSION);
+
+    writeVarint(out, header.slots);
+    writeVarint(out, header.tickRate);
+    writeVarint(out, header.sendRate);
+    writeVarint(out, header.seed);
+
+    writeVarint(out, header.levelName.size());
+    out += header.levelName;
+
+    file.write(out.data(), out.size());
+    file.flush();
+
+    writer = thread(&MatchRecorder::write, this);
+}
+
+void MatchRecorder::writeVarint(string& out, unsigned int value) const
+{
+    while (value >= 0x80)
+    {
+        out += char((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+
+    out += char(value);
+}
+
+void MatchRecorder::writeSignedVarint(string& out, int value) const
+{
+    writeVarint(out, ((unsigned int)value << 1) ^ (unsigned int)(value >> 31));
+}
+
+void MatchRecorder::writeFloat(string& out, float value) const
+{
+    char bytes[sizeof(float)];
+
+    memcpy(bytes, &value, sizeof(float));
+
+    out.append(bytes, sizeof(float));
+}
+
+void MatchRecorder::begin(unsigned char kind, unsigned int tick)
+{
+    buffer += char(kind);
+
+    writeVarint(buffer, tick - lastTick);
+
+    lastTick = tick;
+}
+
+void MatchRecorder::end()
+{
+    if (buffer.size() >= MATCH_FLUSH_SIZE)
+    {
+        flush();
+    }
+}
+
+void MatchRecorder::addClock(unsigned int tick, unsigned int time)
+{
+    begin(RECORD_CLOCK, tick);
+
+    writeVarint(buffer, time);
+
+    end();
+}
+
+void MatchRecorder::addCommand(unsigned int tick, unsigned char type, const string& data)
+{
+    begin(RECORD_COMMAND, tick);
+
+    buffer += char(type);
+
+    writeVarint(buffer, data.size());
+    buffer += data;
+
+    end();
+}
+
+void MatchRecorder::addJoin(unsigned int tick, int id)
+{
+    begin(RECORD_JOIN, tick);
+
+    writeVarint(buffer, id);
+
+    end();
+}
+
+void MatchRecorder::addQuit(unsigned int tick, int id)
+{
+    begin(RECORD_QUIT, tick);
+
+    writeVarint(buffer, id);
+
+    end();
+}
+
+void MatchRecorder::addKeyframe(unsigned int tick, const Keyframe& keyframe)
+{
+    begin(RECORD_KEYFRAME, tick);
+
+    writeVarint(buffer, keyframe.objects.size());
+
+    for (const KeyframeObject& object: keyframe.objects)
+    {
+        writeVarint(buffer, object.netID);
+
+        for (int i = 0; i < 3; i++)
+        {
+            writeFloat(buffer, object.position[i]);
+        }
+
+        for (int i = 0; i < 4; i++)
+        {
+            writeFloat(buffer, object.rotation[i]);
+        }
+    }
+
+    writeVarint(buffer, keyframe.soldiers.size());
+
+    for (const KeyframeSoldier& soldier: keyframe.soldiers)
+    {
+        writeVarint(buffer, soldier.id);
+        writeSignedVarint(buffer, soldier.health);
+
+        for (int i = 0; i < 3; i++)
+        {
+            writeFloat(buffer, soldier.position[i]);
+        }
+    }
+
+    /* a keyframe is a good place to cut, the log is checkable up to here */
+    flush();
+}
+
+void MatchRecorder::flush()
+{
+    if (buffer.empty())
+    {
+        return;
+    }
+
+    {
+        unique_lock < mutex > lk(mtx);
+
+        /* the writer is usually idle, then nothing is copied */
+        if (pending.empty())
+        {
+            pending.swap(buffer);
+        }
+        else
+        {
+            pending += buffer;
+        }
+    }
+
+    buffer.clear();
+
+    cv.notify_one();
+}
+
+void MatchRecorder::write()
+{
+    string out;
+
+    while (true)
+    {
+        {
+            unique_lock < mutex > lk(mtx);
+
+            cv.wait(lk, [&]{ return !running || !pending.empty(); });
+
+            /* stopped and everything written */
+            if (pending.empty())
+            {
+                return;
+            }
+
+            out.swap(pending);
+        }
+
+        file.write(out.data(), out.size());
+        file.flush();
+
+        out.clear();
+    }
+}
+
+MatchRecorder::~MatchRecorder()
+{
+    flush();
+
+    {
+        unique_lock < mutex > lk(mtx);
+
+        running = false;
+    }
+
+    cv.notify_one();
+
+    writer.join();
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <fstream>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <bullet/btBulletCollisionCommon.h>
+
+#define MATCH_MAGIC "HSMATCH"
+#define MATCH_VERSION 1
+#define MATCH_FLUSH_SIZE 65536 /* bytes the simulation piles up before the writer gets them */
+
+using namespace std;
+
+/* every record starts with its kind and the ticks since the record before */
+enum RecordKind
+{
+    RECORD_CLOCK = 0, /* the server time at the start of a tick */
+    RECORD_COMMAND, /* a client message as it came in, applied after the tick */
+    RECORD_JOIN,
+    RECORD_QUIT,
+    RECORD_KEYFRAME, /* the state at the end of the tick, a replay checks against it */
+    RECORD_KINDS
+};
+
+/* what a match log starts with */
+struct MatchHeader
+{
+    string levelName;
+    int slots;
+    int tickRate;
+    int sendRate;
+    unsigned int seed; /* of the spawn points */
+};
+
+struct KeyframeObject
+{
+    int netID;
+    btVector3 position;
+    btQuaternion rotation;
+};
+
+struct KeyframeSoldier
+{
+    int id;
+    int health;
+    btVector3 position;
+};
+
+struct Keyframe
+{
+    vector < KeyframeObject > objects;
+    vector < KeyframeSoldier > soldiers;
+};
+
+/*
+ * appends a match to a binary log: the inputs of the simulation (clock, client commands,
+ * joins and quits) and now and then the state it came to. the simulation only encodes into
+ * a buffer, a writer thread gets it every MATCH_FLUSH_SIZE bytes and every keyframe, so a
+ * killed server loses at most the tail. nothing is ever seeked, the log is read front to back
+ */
+class MatchRecorder
+{
+    private:
+        ofstream file;
+
+        string buffer; /* of the simulation */
+        string pending; /* handed over to the writer */
+
+        unsigned int lastTick;
+
+        bool running;
+        mutex mtx;
+        condition_variable cv;
+        thread writer;
+
+        void writeVarint(string& out, unsigned int value) const;
+        void writeSignedVarint(string& out, int value) const;
+        void writeFloat(string& out, float value) const;
+
+        void begin(unsigned char kind, unsigned int tick);
+        void end();
+
+        void write();
+
+    public:
+        MatchRecorder(string fileName, const MatchHeader& header);
+
+        void addClock(unsigned int tick, unsigned int time);
+        void addCommand(unsigned int tick, unsigned char type, const string& data);
+        void addJoin(unsigned int tick, int id);
+        void addQuit(unsigned int tick, int id);
+        void addKeyframe(unsigned int tick, const Keyframe& keyframe);
+
+        void flush();
+
+        ~MatchRecorder();
+};
@@ -1,3 +1,6 @@
+#include "../global/config.hpp"
+#include "../global/telemetry.hpp"
+
 #include "../world/raytracer.hpp"
 #include "../world/bulletevents.hpp"
 #include "../world/world.hpp"
@@ -13,7 +16,10 @@
 #include "../level/levelloader.hpp"
 #include "../level/level.hpp"
 
+#include "messagebuffer.hpp"
+#include "linksimulator.hpp"
 #include "node.hpp"
+#include "worldsnapshot.hpp"
 #include "playerdatacollector.hpp"
 #include "playerdataupdater.hpp"
 #include "physicsobjectdatacollector.hpp"
@@ -23,343 +29,959 @@
 #include "weaponpickerupdater.hpp"
 #include "weapondroppercollector.hpp"
 #include "weapondropperupdater.hpp"
+#include "posehistory.hpp"
 #include "weaponfireupdater.hpp"
 #include "playerconnectioncollector.hpp"
 #include "playerdisconnectioncollector.hpp"
+#include "interestgrid.hpp"
+#include "snapshotencoder.hpp"
+#include "decoderpool.hpp"
+#include "commandqueue.hpp"
+#include "matchrecorder.hpp"
+#include "matchreader.hpp"
 #include "multiplayer.hpp"
 
-Multiplayer::Multiplayer(Level* level, World* world)
+Multiplayer::Multiplayer(Level* level, World* world, Config* config, Telemetry* telemetry)
 {
-    node = new Node(5, 2, 5040);
-    playerDataCollector = new PlayerDataCollector(5);
+    int slots = config->getSlots();
+
+    node = new Node(slots, config->getBacklog(), config->getPort());
+    node->setTelemetry(telemetry);
+
+    if (config->getLoss() > 0.0 || config->getLatency() > 0 || config->getJitter() > 0)
+    {
+        node->simulateLink(config->getLoss(), config->getLatency(), config->getJitter());
+    }
+
+    playerDataCollector = new PlayerDataCollector(slots);
+    joinPlayerDataCollector = new PlayerDataCollector(slots);
     playerDataUpdater = new PlayerDataUpdater();
-    physicsObjectDataCollector = new PhysicsObjectDataCollector(5);
+    physicsObjectDataCollector = new PhysicsObjectDataCollector(slots);
+    joinPhysicsObjectDataCollector = new PhysicsObjectDataCollector(slots);
     physicsObjectDataUpdater = new PhysicsObjectDataUpdater();
-    weaponDataCollector = new WeaponDataCollector(5);
-    weaponPickerCollector = new WeaponPickerCollector(5);
+    weaponDataCollector = new WeaponDataCollector(slots);
+    weaponPickerCollector = new WeaponPickerCollector(slots);
     weaponPickerUpdater = new WeaponPickerUpdater(world);
-    weaponDropperCollector = new WeaponDropperCollector(5);
+    weaponDropperCollector = new WeaponDropperCollector(slots);
     weaponDropperUpdater = new WeaponDropperUpdater();
     weaponFireUpdater = new WeaponFireUpdater(world);
-    playerConnectionCollector = new PlayerConnectionCollector(5);
-    playerDisconnectionCollector = new PlayerDisconnectionCollector(5);
+    poseHistory = new PoseHistory(slots);
+    playerConnectionCollector = new PlayerConnectionCollector(slots);
+    playerDisconnectionCollector = new PlayerDisconnectionCollector(slots);
+    snapshotEncoder = new SnapshotEncoder(slots); /* pass false to keep every client on XML snapshots */
+    interestGrid = new InterestGrid(config->getInterestRadius(), config->getInterestCell());
+    decoderPool = new DecoderPool(config->getDecoders());
+    commandQueue = new CommandQueue();
+    recorder = nullptr;
+
+    snapshots[0] = new WorldSnapshot();
+    snapshots[1] = new WorldSnapshot();
+    front = 0;
+    back = 1;
+    sending = false;
+    finished = false;
+
+    sessions.resize(slots, 0);
+    sentSessions.resize(slots, 0);
+
+    snapshotEncoder->setInterest(interestGrid, config->getInterestBudget());
+    weaponFireUpdater->setDelay(max(1, config->getTickRate() / config->getSendRate()));
 
     this->level = level;
     this->world = world;
+    this->telemetry = telemetry;
+
+    tick = 0;
+    tickTime = 0;
+
+    decodeJob = [this](size_t i)
+    {
+        decode(messages[i], inbound[i]);
+    };
 }
 
-void Multiplayer::broadcast()
+void Multiplayer::record(unsigned int tick)
 {
-    while (true)
-    {
-        this_thread::sleep_for(chrono::milliseconds(50));
+    poseHistory->record(tick, level->getPlayers());
+
+    this->tick = tick;
+}
 
-        /* new clients */
-        if (node->isNewClients())
+void Multiplayer::setTickTime(unsigned int tickTime)
+{
+    this->tickTime = tickTime;
+}
+
+void Multiplayer::setRecorder(MatchRecorder* recorder)
+{
+    this->recorder = recorder;
+}
+
+/* a recorded message goes the way of a received one, a recorded join or quit waits for connect() */
+void Multiplayer::inject(const MatchRecord& record)
+{
+    switch (record.kind)
+    {
+        case RECORD_COMMAND:
         {
-            vector < int > new_sockets = node->getNewClientSockets();
+            /* checked against its slot when it was recorded */
+            Message message = {(unsigned char)record.value, record.data, -1};
+            InboundMessage command;
+
+            chrono::steady_clock::time_point phase = telemetry->now();
+
+            decode(message, command);
+
+            telemetry->addTime("update.decode", phase);
+
+            if (command.valid)
+            {
+                commandQueue->push(command);
+            }
+
+            break;
+        }
+
+        case RECORD_JOIN:
+            replayJoins.push_back(record.value);
+            break;
+
+        case RECORD_QUIT:
+            replayQuits.push_back(record.value);
+            break;
+    }
+}
+
+void Multiplayer::collectPing(const string& info, PingData& data) const
+{
+    XMLDocument pingDoc;
+
+    pingDoc.Parse(info.c_str());
+
+    /* root */
+    XMLNode* root = pingDoc.FirstChildElement("Ping");
+
+    if (!root)
+    {
+        throw runtime_error("ERROR::Multiplayer::collectPing() failed to load XML");
+    }
+
+    data.playerID = -1;
+    data.time.clear();
+
+    XMLElement* idElem = root->FirstChildElement("id");
+
+    if (idElem)
+    {
+        idElem->QueryIntText(&data.playerID);
+    }
+
+    XMLElement* timeElem = root->FirstChildElement("t");
+
+    if (timeElem && timeElem->GetText())
+    {
+        data.time = timeElem->GetText();
+    }
+}
+
+void Multiplayer::answerPing(const PingData& data)
+{
+    int playerID = data.playerID;
+
+    if (playerID < 0 || playerID >= (int)node->getClientSockets().size() || data.time.empty())
+    {
+        return;
+    }
+
+    /* the sender time goes back untouched, the round trip is measured on its clock */
+    XMLDocument pongDoc;
+
+    XMLNode* pongRoot = pongDoc.NewElement("Pong");
+    pongDoc.InsertFirstChild(pongRoot);
+
+    XMLElement* pongTimeElem = pongDoc.NewElement("t");
+    pongTimeElem->SetText(data.time.c_str());
+
+    pongRoot->InsertEndChild(pongTimeElem);
+
+    XMLElement* tickElem = pongDoc.NewElement("tick");
+    tickElem->SetText((unsigned int)tick);
+
+    pongRoot->InsertEndChild(tickElem);
+
+    XMLElement* tickTimeElem = pongDoc.NewElement("tt");
+    tickTimeElem->SetText((unsigned int)tickTime);
+
+    pongRoot->InsertEndChild(tickTimeElem);
+
+    XMLPrinter pongPrinter;
+    pongDoc.Print(&pongPrinter);
+
+    node->sendMSG(node->getClientSocket(playerID), string(pongPrinter.CStr()), true);
+}
+
+/* the level side of a join, the same for a client and a replayed one */
+void Multiplayer::join(int id)
+{
+    cout << "Join playerID: " << id << endl;
+
+    Player* player = level->addPlayer(id);
+
+    player->getPhysicsObject()->setOwnerID(id);
+    player->setConnected(true);
+    level->spawn(id);
+
+    sessions[id]++;
+
+    if (recorder)
+    {
+        recorder->addJoin(tick, id);
+    }
+}
+
+void Multiplayer::quit(int id)
+{
+    cout << "Quit playerID: " << id << endl;
 
-            /* connect players */
-            for (size_t i = 0; i < new_sockets.size(); i++)
+    /* disconnected */
+    if (level->getPlayer(id))
+    {
+        level->getPlayer(id)->setConnected(false);
+    }
+
+    level->clearNoPlayersAndTheirWeaponsOwner(id);
+    level->deSpawn(id);
+
+    /* the sender forgets what it sent to the slot when it sees the new session */
+    sessions[id]++;
+
+    if (recorder)
+    {
+        recorder->addQuit(tick, id);
+    }
+}
+
+void Multiplayer::connect(unsigned int tick)
+{
+    chrono::steady_clock::time_point phase;
+
+    joinPlayerDataCollector->setTick(tick);
+    joinPhysicsObjectDataCollector->setTick(tick);
+
+    /* replayed, in the order they were recorded: the joins of a tick before its quits */
+    for (size_t i = 0; i < replayJoins.size(); i++)
+    {
+        join(replayJoins[i]);
+    }
+
+    for (size_t i = 0; i < replayQuits.size(); i++)
+    {
+        quit(replayQuits[i]);
+    }
+
+    replayJoins.clear();
+    replayQuits.clear();
+
+    /* new clients */
+    if (node->isNewClients())
+    {
+        phase = telemetry->now();
+
+        vector < int > new_sockets = node->getNewClientSockets();
+
+        /* connect players */
+        for (size_t i = 0; i < new_sockets.size(); i++)
+        {
+            if (new_sockets[i] > 0)
             {
-                if (new_sockets[i] > 0)
+                join(i);
+                
+                string message = "<join>" + to_string(i) + "</join>\n";
+                message += "<slots>" + to_string(level->getSlots()) + "</slots>\n";
+
+                /* offer binary snapshots, the client answers with <Proto> */
+                if (snapshotEncoder->isEnabled())
                 {
-                    cout << "Join playerID: " << i << endl;
-                    level->getPlayer(i)->getPhysicsObject()->setOwnerID(i);
-                    level->getPlayer(i)->setConnected(true);
-                    level->spawn(i);
-                    
-                    string message = "BEG\n<join>" + to_string(i) + "</join>\nEND";
-                    try
-                    {
-                        node->sendMSG(new_sockets[i], message);
-                    }
-                    catch(exception& ex) {}
+                    message += "<snap>" + to_string(SNAPSHOT_VERSION) + "</snap>\n";
+                    message += "<udp>" + to_string(node->getDatagramToken(i)) + "</udp>\n";
                 }
+
+                try
+                {
+                    node->sendMSG(new_sockets[i], message);
+                }
+                catch(exception& ex) {}
             }
-           
-            /* physics objects */
-            physicsObjectDataCollector->collect(level->getNoPlayersAndTheirWeaponsPhysicsObjects());
+        }
+       
+        /* physics objects */
+        joinPhysicsObjectDataCollector->collect(level->getNoPlayersAndTheirWeaponsPhysicsObjects());
 
-            for (size_t i = 0; i < new_sockets.size(); i++)
+        for (size_t i = 0; i < new_sockets.size(); i++)
+        {
+            if (new_sockets[i] > 0)
             {
-                if (new_sockets[i] > 0)
+                string message = joinPhysicsObjectDataCollector->getMergedData(level->getLevelPath() + "/physics_object.xml", i); 
+
+                /* send here */
+                try
                 {
-                    string message = physicsObjectDataCollector->getMergedData(level->getLevelPath() + "/physics_object.xml", i); 
-
-                    /* send here */
-                    try
-                    {
-                        node->sendMSG(new_sockets[i], message);
-                    }
-                    catch(exception& ex) {}
+                    node->sendMSG(new_sockets[i], message);
                 }
+                catch(exception& ex) {}
             }
+        }
 
-            physicsObjectDataCollector->clear();
+        joinPhysicsObjectDataCollector->clear();
 
-            /* weapons */
-            weaponDataCollector->collect(level->getPhysicsObjects());
-                    
-            for (size_t i = 0; i < new_sockets.size(); i++)
+        /* weapons */
+        weaponDataCollector->collect(level->getPhysicsObjects());
+                
+        for (size_t i = 0; i < new_sockets.size(); i++)
+        {
+            if (new_sockets[i] > 0)
             {
-                if (new_sockets[i] > 0)
+                string message = weaponDataCollector->getMergedData(level->getLevelPath() + "/weapon.xml", i);
+
+                /* send here */
+                try
                 {
-                    string message = weaponDataCollector->getMergedData(level->getLevelPath() + "/weapon.xml", i);
-
-                    /* send here */
-                    try
-                    {
-                        node->sendMSG(new_sockets[i], message);
-                    }
-                    catch(exception& ex) {}
+                    node->sendMSG(new_sockets[i], message);
                 }
+                catch(exception& ex) {}
             }
+        }
 
-            weaponDataCollector->clear();
+        weaponDataCollector->clear();
 
-            /* players */
-            for (size_t i = 0; i < new_sockets.size(); i++)
+        /* players */
+        joinPlayerDataCollector->collect(level->getPlayers());
+
+        for (size_t i = 0; i < new_sockets.size(); i++)
+        {
+            if (new_sockets[i] > 0)
             {
-                if (new_sockets[i] > 0)
+                /* init player data */
+                string message = joinPlayerDataCollector->getMergedData(level->getLevelPath() + "/soldier.xml", i, true, true, true);
+
+                try
                 {
-                    /* init player data */
-                    vector < Player* > players = level->getPlayers();
-                    playerDataCollector->collect(players);
-
-                    string message = playerDataCollector->getMergedData(level->getLevelPath() + "/soldier.xml", i, true, true, true);
-
-                    try
-                    {
-                        node->sendMSG(new_sockets[i], message);
-                    }
-                    catch(exception& ex) {}
-                    
-                    playerDataCollector->clear();
+                    node->sendMSG(new_sockets[i], message);
                 }
+                catch(exception& ex) {}
             }
+        }
+
+        joinPlayerDataCollector->clear();
 
-            /* newToClient */
-            for (size_t i = 0; i < new_sockets.size(); i++)
+        /* newToClient */
+        for (size_t i = 0; i < new_sockets.size(); i++)
+        {
+            if (new_sockets[i] > 0)
             {
-                if (new_sockets[i] > 0)
+                node->newToClient(i);    
+            }
+        }
+
+        /* show connected */
+        vector < int > sockets = node->getClientSockets();
+
+        for (size_t i = 0; i < sockets.size(); i++)
+        {
+            if (sockets[i] > 0)
+            {
+                playerConnectionCollector->collect(sockets, i); 
+
+                try
                 {
-                    node->newToClient(i);    
+                    node->sendMSG(sockets[i], playerConnectionCollector->getData(i));
                 }
+                catch(exception& ex) {}
+
+                playerConnectionCollector->clear();
             }
+        }
+
+        telemetry->addTime("tick.join", phase);
+    }
+
+    /* old clients */
+    if (node->isOldClients())
+    {
+        phase = telemetry->now();
+
+        /* hide old clients */
+        vector < int > old_sockets = node->getOldClientSockets();
+        vector < int > sockets = node->getClientSockets();
 
-            /* show connected */
-            vector < int > sockets = node->getClientSockets();
+        playerDisconnectionCollector->collect(old_sockets);  
 
-            for (size_t i = 0; i < sockets.size(); i++)
+        for (size_t i = 0; i < sockets.size(); i++)
+        {
+            try
             {
-                if (sockets[i] > 0)
-                {
-                    playerConnectionCollector->collect(sockets, i); 
+                node->sendMSG(sockets[i], playerDisconnectionCollector->getData(i));
+            }
+            catch(exception& ex) {}
+        }
+
+        playerDisconnectionCollector->clear();
+    
+        for (size_t i = 0; i < old_sockets.size(); i++)
+        {
+            if (old_sockets[i] > 0)
+            {
+                quit(i);
 
-                    try
-                    {
-                        node->sendMSG(sockets[i], playerConnectionCollector->getData(i));
-                    }
-                    catch(exception& ex) {}
+                joinPlayerDataCollector->clearLast(i);
+                joinPhysicsObjectDataCollector->clearLast(i);
+                weaponDataCollector->clearLast(i);
+                playerConnectionCollector->clearAllLast();
+                playerDisconnectionCollector->clearAllLast();
+                snapshotEncoder->clearLast(i);
 
-                    playerConnectionCollector->clear();
-                }
+                /* send here */
+                node->oldToNothing(i);
             }
         }
 
-        /* old clients */
-        if (node->isOldClients())
+        telemetry->addTime("tick.quit", phase);
+    }
+}
+
+void Multiplayer::publish(unsigned int tick)
+{
+    snapshots[back]->capture(tick, level, node->getClientSockets(), sessions);
+
+    {
+        unique_lock < mutex > lk(snapshotMtx);
+
+        /* the sender is still busy, the snapshot stays and the next tick adds to it */
+        if (sending)
         {
-            /* hide old clients */
-            vector < int > old_sockets = node->getOldClientSockets();
-            vector < int > sockets = node->getClientSockets();
+            return;
+        }
 
-            playerDisconnectionCollector->collect(old_sockets);  
+        front = back;
+        back = 1 - back;
+        sending = true;
+    }
+
+    snapshotCv.notify_one();
+}
+
+void Multiplayer::send()
+{
+    while (true)
+    {
+        WorldSnapshot* snapshot;
+
+        {
+            unique_lock < mutex > lk(snapshotMtx);
 
-            for (size_t i = 0; i < sockets.size(); i++)
+            snapshotCv.wait(lk, [&]{ return sending || finished; });
+
+            /* finished and nothing left to send */
+            if (!sending)
             {
-                try
-                {
-                    node->sendMSG(sockets[i], playerDisconnectionCollector->getData(i));
-                }
-                catch(exception& ex) {}
+                return;
             }
 
-            playerDisconnectionCollector->clear();
-        
-            for (size_t i = 0; i < old_sockets.size(); i++)
-            {
-                if (old_sockets[i] > 0)
-                {
-                    cout << "Quit playerID: " << i << endl;
+            snapshot = snapshots[front];
+        }
 
-                    /* disconnected */
-                    level->getPlayer(i)->setConnected(false);
-                    level->clearNoPlayersAndTheirWeaponsOwner(i);
-                    level->deSpawn(i);
+        broadcast(snapshot);
 
-                    playerDataCollector->clearLast(i);
-                    physicsObjectDataCollector->clearLast(i);
-                    weaponDataCollector->clearLast(i);
-                    weaponPickerCollector->clearAllLast();
-                    weaponDropperCollector->clearAllLast();
-                    playerConnectionCollector->clearAllLast();
-                    playerDisconnectionCollector->clearAllLast();
+        /* sent, the simulation may have it back */
+        snapshot->clearEvents();
 
-                    /* send here */
-                    node->oldToNothing(i);
-                }
+        unique_lock < mutex > lk(snapshotMtx);
+
+        sending = false;
+    }
+}
+
+/* lets send() return once the last snapshot is out */
+void Multiplayer::finish()
+{
+    {
+        unique_lock < mutex > lk(snapshotMtx);
+
+        finished = true;
+    }
+
+    snapshotCv.notify_one();
+}
+
+void Multiplayer::broadcast(WorldSnapshot* snapshot)
+{
+    chrono::steady_clock::time_point start = telemetry->now();
+    chrono::steady_clock::time_point phase = start;
+
+    unsigned int tick = snapshot->getTick();
+
+    snapshotEncoder->setTick(tick);
+    playerDataCollector->setTick(tick);
+    physicsObjectDataCollector->setTick(tick);
+
+    const vector < int >& clientSockets = snapshot->getClientSockets();
+    const vector < unsigned int >& sessions = snapshot->getSessions();
+
+    /* a slot changed hands, nothing sent to the one before may suppress a message */
+    bool rejoined = false;
+
+    for (size_t j = 0; j < sessions.size(); j++)
+    {
+        if (sessions[j] != sentSessions[j])
+        {
+            playerDataCollector->clearLast(j);
+            physicsObjectDataCollector->clearLast(j);
+
+            sentSessions[j] = sessions[j];
+            rejoined = true;
+        }
+    }
+
+    if (rejoined)
+    {
+        weaponPickerCollector->clearAllLast();
+        weaponDropperCollector->clearAllLast();
+    }
+
+    /* only the connected slots are visited below */
+    vector < int > clients;
+
+    for (size_t j = 0; j < clientSockets.size(); j++)
+    {
+        if (clientSockets[j] > 0)
+        {
+            clients.push_back(j);
+        }
+    }
+
+    const vector < SoldierState >& soldiers = snapshot->getSoldiers();
+    const vector < ObjectState >& objects = snapshot->getObjects();
+
+    /* area of interest, every soldier is also a viewer */
+    interestGrid->clear();
+
+    for (const SoldierState& soldier: soldiers)
+    {
+        interestGrid->add(to_string(soldier.id), soldier.position);
+        interestGrid->setViewer(soldier.id, soldier.position);
+    }
+
+    for (const ObjectState& object: objects)
+    {
+        interestGrid->add(object.name, object.position);
+    }
+
+    telemetry->addTime("broadcast.interest", phase);
+    phase = telemetry->now();
+
+    /* binary player snapshot */
+    for (const SoldierState& soldier: soldiers)
+    {
+        snapshotEncoder->collect(soldier, snapshot->getEvents(soldier.id).respawn);
+    }
+
+    for (size_t k = 0; k < clients.size(); k++)
+    {
+        int j = clients[k];
+
+        if (snapshotEncoder->isBinary(j))
+        {
+            try
+            {
+                node->sendDatagram(clientSockets[j], snapshotEncoder->getSoldiersData(j), SOLDIERS_CHANNEL);
             }
+            catch(exception& ex) {}
         }
+    }
 
-        vector < Player* > players = level->getPlayers();
+    snapshotEncoder->clear();
+
+    telemetry->addTime("broadcast.soldiers", phase);
+    phase = telemetry->now();
+
+    /* player */
+    for (const SoldierState& soldier: soldiers)
+    {
+        playerDataCollector->collect(soldier);
 
-        /* player */
-        for (size_t i = 0; i < players.size(); i++)
+        /* send position info, the own soldier too, its owner reconciles against it */
+        for (size_t k = 0; k < clients.size(); k++)
         {
-            if (!players[i]->isConnected())
+            int j = clients[k];
+
+            if (snapshotEncoder->isBinary(j))
             {
                 continue;
             }
-            
-            Soldier* soldier = dynamic_cast < Soldier* >(players[i]);
-            bool respawnOld = soldier->isRespawn();
 
-            playerDataCollector->collect(players[i]);
+            if (!interestGrid->isRelevant(j, to_string(soldier.id)))
+            {
+                continue;
+            }
 
-            if (respawnOld == soldier->isRespawn())
+            try
             {
-                /* send position info */
-                vector < int > sockets = node->getClientSockets();
+                node->sendMSG(clientSockets[j], playerDataCollector->getSharedData(j, true, true));
+            }
+            catch(exception& ex) {}
+        }
+
+        playerDataCollector->clear();
+    }
+
+    telemetry->addTime("broadcast.player", phase);
+    phase = telemetry->now();
+
+    /* pickWeapons */
+    for (const SoldierState& soldier: soldiers)
+    {
+        weaponPickerCollector->collect(soldier.ownerID, snapshot->getEvents(soldier.id).picked);
+
+        for (size_t k = 0; k < clients.size(); k++)
+        {
+            int j = clients[k];
 
-                for (size_t j = 0; j < sockets.size(); j++)
+            try
+            {
+                shared_ptr < const string > msg = weaponPickerCollector->getSharedData(j);
+
+                if (msg)
                 {
-                    try
-                    {
-                        /* another player, pos + ... */
-                        if ((int)j != players[i]->getID())
-                        {
-                            string msg = playerDataCollector->getData(j, true, true);
-                            node->sendMSG(sockets[j], msg);
-                        }
-                        else /* this player */
-                        {
-                            if (respawnOld)
-                            {
-                                string msg = playerDataCollector->getData(j, true, true);
-                                node->sendMSG(sockets[j], msg, true);
-                            }
-                            else
-                            {
-                                node->sendMSG(sockets[j], playerDataCollector->getData(j, false, true));
-                            }
-                        }
-                    }
-                    catch(exception& ex) {}
+                    weaponDropperCollector->clearAllLast();
                 }
-                                
-                if (respawnOld)
+
+                node->sendMSG(clientSockets[j], msg);
+            }
+            catch(exception& ex) {}
+        }
+
+        weaponPickerCollector->clear();
+    }
+
+    telemetry->addTime("broadcast.pick", phase);
+    phase = telemetry->now();
+
+    /* dropWeapons */
+    for (const SoldierState& soldier: soldiers)
+    {
+        weaponDropperCollector->collect(soldier.ownerID, snapshot->getEvents(soldier.id).dropped);
+
+        for (size_t k = 0; k < clients.size(); k++)
+        {
+            int j = clients[k];
+
+            try
+            {
+                shared_ptr < const string > msg = weaponDropperCollector->getSharedData(j);
+
+                if (msg)
                 {
-                    soldier->setRespawn(false);
+                    weaponPickerCollector->clearAllLast();
                 }
+
+                node->sendMSG(clientSockets[j], msg);
             }
+            catch(exception& ex) {}
+        }
+
+        weaponDropperCollector->clear();
+    }
+
+    telemetry->addTime("broadcast.drop", phase);
+    phase = telemetry->now();
+
+    /* physicsobject data */
+    /* binary physics object snapshot, unchanged objects cost nothing after the delta */
+    for (const ObjectState& object: objects)
+    {
+        snapshotEncoder->collect(object);
+    }
 
-            playerDataCollector->clear();
+    for (const string& name: snapshot->getIdle())
+    {
+        snapshotEncoder->keep(name);
+    }
+
+    for (size_t k = 0; k < clients.size(); k++)
+    {
+        int j = clients[k];
+
+        if (snapshotEncoder->isBinary(j))
+        {
+            try
+            {
+                node->sendDatagram(clientSockets[j], snapshotEncoder->getObjsData(j), OBJS_CHANNEL);
+            }
+            catch(exception& ex) {}
         }
+    }
+
+    snapshotEncoder->clear();
 
-        /* pickWeapons */
-        for (size_t i = 0; i < players.size(); i++)
+    telemetry->addTime("broadcast.objs", phase);
+    phase = telemetry->now();
+
+    /* physics object */
+    for (const ObjectState& object: objects)
+    {
+        if (!object.moving)
         {
-            weaponPickerCollector->collect(players[i]);
+            continue;
+        }
 
-            vector < int > sockets = node->getClientSockets();
+        physicsObjectDataCollector->collect(object);
 
-            for (size_t j = 0; j < sockets.size(); j++)
+        /* send position info */
+        for (size_t k = 0; k < clients.size(); k++)
+        {
+            int j = clients[k];
+
+            if (j != object.ownerID && !snapshotEncoder->isBinary(j) && interestGrid->isRelevant(j, object.name))
             {
                 try
                 {
-                    string msg = weaponPickerCollector->getData(j);
-
-                    if (msg != "")
-                    {
-                        weaponDropperCollector->clearAllLast();
-                    }
-
-                    node->sendMSG(sockets[j], msg);
+                    node->sendMSG(clientSockets[j], physicsObjectDataCollector->getSharedData(j));
                 }
                 catch(exception& ex) {}
             }
-
-            weaponPickerCollector->clear();
         }
 
-        /* dropWeapons */
-        for (size_t i = 0; i < players.size(); i++)
+        physicsObjectDataCollector->clear();
+    }
+
+    telemetry->addTime("broadcast.objects", phase);
+    telemetry->addTime("broadcast", start);
+}
+
+int Multiplayer::getSender(const InboundMessage& inbound) const
+{
+    switch (inbound.type)
+    {
+        case MESSAGE_PLAYER:
+            return inbound.player.playerID;
+
+        case MESSAGE_OBJ:
+            return inbound.obj.senderID;
+
+        case MESSAGE_PICK:
+            return inbound.pick.playerID;
+
+        case MESSAGE_DROP:
+            return inbound.drop.playerID;
+
+        case MESSAGE_FIRE:
+            return inbound.fire.playerID;
+
+        case MESSAGE_ACK:
+            return inbound.ack.client;
+
+        case MESSAGE_PROTO:
+            return inbound.proto.client;
+
+        case MESSAGE_PING:
+            return inbound.ping.playerID;
+
+        default:
+            return -1;
+    }
+}
+
+void Multiplayer::decode(const Message& message, InboundMessage& inbound) const
+{
+    /* per MessageType */
+    static const char* names[MESSAGE_TYPES] = {"decode.other", "decode.player", "decode.obj", "decode.pick", "decode.drop", "decode.fire", "decode.ack", "decode.proto", "decode.ping"};
+
+    chrono::steady_clock::time_point start = telemetry->now();
+
+    inbound.type = message.type;
+    inbound.valid = true;
+
+    /* a replay feeds the decoders with exactly this */
+    if (recorder)
+    {
+        inbound.raw = message.data;
+    }
+
+    try
+    {
+        switch (message.type)
         {
-            weaponDropperCollector->collect(players[i]);
+            case MESSAGE_PLAYER:
+                playerDataUpdater->collect(message.data, inbound.player);
+                break;
+
+            case MESSAGE_OBJ:
+                physicsObjectDataUpdater->collect(message.data, inbound.obj);
+                break;
+
+            case MESSAGE_PICK:
+                weaponPickerUpdater->collect(message.data, inbound.pick);
+                break;
+
+            case MESSAGE_DROP:
+                weaponDropperUpdater->collect(message.data, inbound.drop);
+                break;
+
+            case MESSAGE_FIRE:
+                weaponFireUpdater->collect(message.data, inbound.fire);
+                break;
+
+            case MESSAGE_ACK:
+                snapshotEncoder->collect(message.data, inbound.ack);
+                break;
+
+            case MESSAGE_PROTO:
+                snapshotEncoder->collect(message.data, inbound.proto);
+                break;
+
+            case MESSAGE_PING:
+                collectPing(message.data, inbound.ping);
+                break;
 
-            vector < int > sockets = node->getClientSockets();
+            default:
+                inbound.valid = false;
+                break;
+        }
+    }
+    catch(exception& ex)
+    {
+        /* a broken message is dropped, the receiver goes on */
+        cerr << ex.what() << endl;
+
+        inbound.valid = false;
+    }
 
-            for (size_t j = 0; j < sockets.size(); j++)
+    /* the ids in the payload are the client's word, only the socket it came through counts */
+    if (inbound.valid && message.slot >= 0 && getSender(inbound) != message.slot)
+    {
+        inbound.valid = false;
+    }
+
+    telemetry->addTime(names[inbound.type], start);
+}
+
+void Multiplayer::apply(InboundMessage& inbound)
+{
+    if (!inbound.valid)
+    {
+        return;
+    }
+
+    switch (inbound.type)
+    {
+        case MESSAGE_PLAYER:
+        {
+            Player* player = level->getPlayer(inbound.player.playerID);
+
+            /* queued, the tick runs them */
+            if (player)
             {
-                try
-                {
-                    string msg = weaponDropperCollector->getData(j);
+                playerDataUpdater->updateData(inbound.player, player);
+            }
 
-                    if (msg != "")
-                    {
-                        weaponPickerCollector->clearAllLast();
-                    }
+            break;
+        }
 
-                    node->sendMSG(sockets[j], msg);
-                }
-                catch(exception& ex) {}
+        case MESSAGE_OBJ:
+        {
+            PhysicsObject* physicsObject = level->getPhysicsObject(inbound.obj.netID);
+
+            if (physicsObject && inbound.obj.senderID == physicsObject->getOwnerID())
+            {
+                physicsObjectDataUpdater->updateData(inbound.obj, physicsObject);
             }
 
-            weaponDropperCollector->clear();
+            break;
         }
 
-        /* physicsobject data */
-        map < string, PhysicsObject* > physicsObjects = level->getNoPlayersAndTheirWeaponsPhysicsObjects();
+        case MESSAGE_PICK:
+        {
+            Player* player = level->getPlayer(inbound.pick.playerID);
+
+            if (player)
+            {
+                weaponPickerUpdater->updateData(inbound.pick, player);
+            }
 
-        /* physics object */
-        for (auto& i: physicsObjects)
+            break;
+        }
+
+        case MESSAGE_DROP:
         {
-            if (i.second->isCollidable() && !i.second->getRigidBody()->isStaticOrKinematicObject() && (i.second->getRigidBody()->isActive() || i.second->getName().find("weapon") != string::npos))
+            Player* player = level->getPlayer(inbound.drop.playerID);
+
+            if (player)
             {
-                physicsObjectDataCollector->collect(i.second);
+                weaponDropperUpdater->updateData(inbound.drop, player);
+            }
 
-                /* send position info */
-                vector < int > sockets = node->getClientSockets();
+            break;
+        }
 
-                for (size_t j = 0; j < sockets.size(); j++)
-                {
-                    if ((int)j != i.second->getOwnerID())
-                    {
-                        try
-                        {
-                            node->sendMSG(sockets[j], physicsObjectDataCollector->getData(j));
-                        }
-                        catch(exception& ex) {}
-                    }
-                }
+        case MESSAGE_FIRE:
+        {
+            Player* player = level->getPlayer(inbound.fire.playerID);
 
-                physicsObjectDataCollector->clear();
+            if (player)
+            {
+                weaponFireUpdater->updateData(inbound.fire, player, level, poseHistory);
             }
+
+            break;
         }
+
+        case MESSAGE_ACK:
+            snapshotEncoder->acknowledge(inbound.ack);
+            break;
+
+        case MESSAGE_PROTO:
+            snapshotEncoder->negotiate(inbound.proto);
+            break;
+
+        case MESSAGE_PING:
+            answerPing(inbound.ping);
+            break;
+    }
+}
+
+void Multiplayer::applyCommands()
+{
+    /* per MessageType */
+    static const char* names[MESSAGE_TYPES] = {"command.other", "command.player", "command.obj", "command.pick", "command.drop", "command.fire", "command.ack", "command.proto", "command.ping"};
+
+    commandQueue->take(commands);
+
+    for (size_t i = 0; i < commands.size(); i++)
+    {
+        chrono::steady_clock::time_point phase = telemetry->now();
+
+        /* stamped with the tick they come after */
+        if (recorder)
+        {
+            recorder->addCommand(tick, commands[i].type, commands[i].raw);
+        }
+
+        apply(commands[i]);
+
+        telemetry->addTime(names[commands[i].type], phase);
     }
 }
 
 void Multiplayer::update()
 {
+    /* per MessageType */
+    static const char* names[MESSAGE_TYPES] = {"update.other", "update.player", "update.obj", "update.pick", "update.drop", "update.fire", "update.ack", "update.proto", "update.ping"};
+
     while (true)
     {
-        vector < string > messages;
-
         while (true)
         {
-            node->checkActivity(300);
+            node->checkActivity();
 
             messages = node->getMessages();
 
@@ -369,63 +991,48 @@ void Multiplayer::update()
             }
         }
 
-        /* player data */
-        for (size_t i = 0; i < messages.size(); i++)
+        chrono::steady_clock::time_point start = telemetry->now();
+
+        if (inbound.size() < messages.size())
         {
-            if (messages[i].find("Player") != string::npos)
-            {
-                playerDataUpdater->collect(messages[i]);
-                Player* player = level->getPlayer(playerDataUpdater->getPlayerID());
+            inbound.resize(messages.size());
+        }
 
-                Soldier* soldier = dynamic_cast < Soldier* >(player);
+        /* the parsing doesn't touch the level, it's spread over the decoders */
+        chrono::steady_clock::time_point phase = telemetry->now();
 
-                if (!soldier->isRespawn())
-                {
-                    playerDataUpdater->updateData(player);
-                }
-
-                playerDataUpdater->clear();
-            }
-            else if (messages[i].find("Pick") != string::npos)
-            {
-                weaponPickerUpdater->collect(messages[i]);
-                Player* player = level->getPlayer(weaponPickerUpdater->getPlayerID());
+        decoderPool->run(messages.size(), decodeJob);
 
-                weaponPickerUpdater->updateData(player);
+        telemetry->addTime("update.decode", phase);
 
-                weaponPickerUpdater->clear();
-            }
-            else if (messages[i].find("Drop") != string::npos)
+        for (size_t i = 0; i < messages.size(); i++)
+        {
+            if (!inbound[i].valid)
             {
-                weaponDropperUpdater->collect(messages[i]);
-                Player* player = level->getPlayer(weaponDropperUpdater->getPlayerID());
-
-                weaponDropperUpdater->updateData(player);
-
-                weaponDropperUpdater->clear();
+                continue;
             }
-            else if (messages[i].find("Fire") != string::npos)
-            {
-                weaponFireUpdater->collect(messages[i]);
-                Player* player = level->getPlayer(weaponFireUpdater->getPlayerID());
 
-                weaponFireUpdater->updateData(player, level->getPhysicsObjects());
+            phase = telemetry->now();
 
-                weaponFireUpdater->clear();
-            }
-            else if (messages[i].find("Obj") != string::npos)
+            switch (inbound[i].type)
             {
-                physicsObjectDataUpdater->collect(messages[i]);
-                PhysicsObject* physicsObject = level->getPhysicsObject(physicsObjectDataUpdater->getName());
-
-                if (physicsObjectDataUpdater->getSenderID() == physicsObject->getOwnerID())
-                {
-                    physicsObjectDataUpdater->updateData(physicsObject);
-                }
-
-                physicsObjectDataUpdater->clear();
+                /* the encoder and the node lock for themselves, no need to wait for a tick */
+                case MESSAGE_ACK:
+                case MESSAGE_PROTO:
+                case MESSAGE_PING:
+                    apply(inbound[i]);
+                    break;
+
+                /* the level and the world are only changed by the simulation */
+                default:
+                    commandQueue->push(inbound[i]);
+                    break;
             }
+
+            telemetry->addTime(names[inbound[i].type], phase);
         }
+
+        telemetry->addTime("update", start);
     }
 }
 
@@ -433,8 +1040,10 @@ Multiplayer::~Multiplayer()
 {
     delete node;
     delete playerDataCollector;
+    delete joinPlayerDataCollector;
     delete playerDataUpdater;
     delete physicsObjectDataCollector;
+    delete joinPhysicsObjectDataCollector;
     delete physicsObjectDataUpdater;
     delete weaponDataCollector;
     delete weaponPickerCollector;
@@ -442,6 +1051,13 @@ Multiplayer::~Multiplayer()
     delete weaponDropperCollector;
     delete weaponDropperUpdater;
     delete weaponFireUpdater;
+    delete poseHistory;
     delete playerConnectionCollector;
     delete playerDisconnectionCollector;
+    delete snapshotEncoder;
+    delete interestGrid;
+    delete decoderPool;
+    delete commandQueue;
+    delete snapshots[0];
+    delete snapshots[1];
 }
@@ -5,18 +5,35 @@
 #include <iostream>
 #include <string>
 #include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 #include <tinyxml2/tinyxml2.h>
 
+/* datagram channels of the binary snapshots */
+#define SOLDIERS_CHANNEL 0
+#define OBJS_CHANNEL 1
+
 using namespace tinyxml2;
 using namespace std;
 
+/*
+ * three threads, each owns its part:
+ *  receiver   - the sockets and the decoding, hands the level changes over in the command queue
+ *  simulation - the only one touching the level and the world, applies the commands at the start
+ *               of a tick, handles the joins and the quits and copies the state into a snapshot
+ *  sender     - encodes and sends the snapshot, never looks at the live objects
+ */
 class Multiplayer
 {
     private:
         Node* node;
         PlayerDataCollector* playerDataCollector;
+        PlayerDataCollector* joinPlayerDataCollector;
         PlayerDataUpdater* playerDataUpdater;
         PhysicsObjectDataCollector* physicsObjectDataCollector;
+        PhysicsObjectDataCollector* joinPhysicsObjectDataCollector;
         PhysicsObjectDataUpdater* physicsObjectDataUpdater;
         WeaponDataCollector* weaponDataCollector;
         WeaponPickerCollector* weaponPickerCollector;
@@ -24,16 +41,72 @@ class Multiplayer
         WeaponDropperCollector* weaponDropperCollector;
         WeaponDropperUpdater* weaponDropperUpdater;
         WeaponFireUpdater* weaponFireUpdater;
+        PoseHistory* poseHistory;
         PlayerConnectionCollector* playerConnectionCollector;
         PlayerDisconnectionCollector* playerDisconnectionCollector;
+        SnapshotEncoder* snapshotEncoder;
+        InterestGrid* interestGrid;
+        DecoderPool* decoderPool;
+        MatchRecorder* recorder;
+
+        /* the batch of the receiver, reused */
+        vector < Message > messages;
+        vector < InboundMessage > inbound;
+        function < void(size_t) > decodeJob;
+
+        /* receiver -> simulation */
+        CommandQueue* commandQueue;
+        vector < InboundMessage > commands;
+
+        /* simulation -> sender, the simulation fills the back one, the sender reads the front one */
+        WorldSnapshot* snapshots[2];
+        int front;
+        int back;
+        bool sending;
+        bool finished;
+        mutex snapshotMtx;
+        condition_variable snapshotCv;
+
+        vector < unsigned int > sessions; /* of the simulation */
+        vector < unsigned int > sentSessions; /* of the sender */
+
+        /* a replay has no sockets, these stand in for the node at the next connect */
+        vector < int > replayJoins;
+        vector < int > replayQuits;
 
         Level* level;
         World* world;
+        Telemetry* telemetry;
+
+        atomic < unsigned int > tick;
+        atomic < unsigned int > tickTime; /* microseconds the last simulated tick took */
+
+        void collectPing(const string& info, PingData& data) const;
+        void answerPing(const PingData& data);
+
+        int getSender(const InboundMessage& inbound) const;
+        void decode(const Message& message, InboundMessage& inbound) const;
+        void apply(InboundMessage& inbound);
+
+        void join(int id);
+        void quit(int id);
+
+        void broadcast(WorldSnapshot* snapshot);
 
     public:
-        Multiplayer(Level* level, World* world);
+        Multiplayer(Level* level, World* world, Config* config, Telemetry* telemetry);
+
+        void record(unsigned int tick);
+        void setTickTime(unsigned int tickTime);
+        void setRecorder(MatchRecorder* recorder);
+
+        void inject(const MatchRecord& record);
+
+        void applyCommands();
+        void connect(unsigned int tick);
+        void publish(unsigned int tick);
 
-        void broadcast();
+        void send();
         void update();
 
         void finish();
@@ -1,3 +1,7 @@
+#include "../global/telemetry.hpp"
+
+#include "messagebuffer.hpp"
+#include "linksimulator.hpp"
 #include "node.hpp"
 
 Node::Node(int max_clients, int max_queue, int port)
@@ -8,7 +12,15 @@ Node::Node(int max_clients, int max_queue, int port)
     old_client_sockets.resize(max_clients);
 
     messages.resize(max_clients);
-    lastMsgs.resize(max_clients, "");
+    messageBuffers.resize(max_clients, nullptr);
+    lastMsgs.resize(max_clients);
+    sendQueues.resize(max_clients, {{}, 0, 0});
+    datagramChannels.resize(max_clients, DatagramChannel());
+    events.resize(max_clients + 2);
+
+    linkSimulator = nullptr;
+    telemetry = nullptr;
+    generator.seed(random_device()());
 
     ready = true;
 
@@ -32,16 +44,84 @@ Node::Node(int max_clients, int max_queue, int port)
     {
         throw(runtime_error("ERROR::Node::Node() listen"));
     }
+
+    setNonBlocking(master_sock);
+
+    /* snapshots, same port as the stream */
+    udp_sock = socket(AF_INET, SOCK_DGRAM, 0);
+
+    if (udp_sock < 0)
+    {
+        throw(runtime_error("ERROR::Node::Node() udp_socket"));
+    }
+
+    if (bind(udp_sock, (struct sockaddr*) &addr, sizeof(addr)) < 0)
+    {
+        throw(runtime_error("ERROR::Node::Node() bind udp"));
+    }
+
+    setNonBlocking(udp_sock);
+
+    epoll_fd = epoll_create1(0);
+
+    if (epoll_fd < 0)
+    {
+        throw(runtime_error("ERROR::Node::Node() epoll_create1"));
+    }
+
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLET;
+    event.data.fd = master_sock;
+
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, master_sock, &event) < 0)
+    {
+        throw(runtime_error("ERROR::Node::Node() epoll_ctl"));
+    }
+
+    event.data.fd = udp_sock;
+
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, udp_sock, &event) < 0)
+    {
+        throw(runtime_error("ERROR::Node::Node() epoll_ctl udp"));
+    }
+}
+
+void Node::setNonBlocking(int sock)
+{
+    int flags = fcntl(sock, F_GETFL, 0);
+
+    if (flags < 0 || fcntl(sock, F_SETFL, flags | O_NONBLOCK) < 0)
+    {
+        throw(runtime_error("ERROR::Node::setNonBlocking() fcntl"));
+    }
+}
+
+int Node::getSlot(int sock) const
+{
+    auto it = socketSlots.find(sock);
+
+    if (it == socketSlots.end())
+    {
+        return -1;
+    }
+
+    return it->second;
 }
 
 void Node::checkNewConnections()
 {
-    if (FD_ISSET(master_sock, &readfds))
+    /* edge triggered, take everything that is pending */
+    while (true)
     {
         int client_socket = accept(master_sock, NULL, NULL);
 
         if (client_socket < 0)
         {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ECONNABORTED)
+            {
+                return;
+            }
+
             throw(runtime_error("ERROR::Node::checkNewConnections() accept"));
         }
 
@@ -64,232 +144,523 @@ void Node::checkNewConnections()
             }
         }
         
-        if (newSock && emptyInd >= 0)
+        if (!newSock)
         {
-            new_client_sockets[emptyInd] = client_socket;
+            continue;
         }
-    }
-}
 
-void Node::constructFineMessage(char* buffer, int size, int index, int curMsg, int begOffset)
-{
-	/* BEG */
-	if (!buffer || size <= 0)
-	{
-        messages[index].clear();
+        /* no room */
+        if (emptyInd < 0)
+        {
+            close(client_socket);
+            continue;
+        }
 
-        return;
-    }
+        struct epoll_event event;
+        event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        event.data.fd = client_socket;
 
-    if (begOffset >= size)
-    {
-        return;
+        setNonBlocking(client_socket);
+
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client_socket, &event) < 0)
+        {
+            close(client_socket);
+            continue;
+        }
+
+        unique_lock < mutex > lk(sendMtx);
+
+        if (!messageBuffers[emptyInd])
+        {
+            messageBuffers[emptyInd] = new MessageBuffer();
+        }
+
+        messageBuffers[emptyInd]->clear();
+        sendQueues[emptyInd] = {{}, 0, 0};
+        lastMsgs[emptyInd] = nullptr;
+        messages[emptyInd].clear();
+
+        /* the client proves with it that the datagrams come from him, never 0 */
+        datagramChannels[emptyInd] = DatagramChannel();
+        datagramChannels[emptyInd].token = uniform_int_distribution < unsigned int >(1, 0xFFFFFFFF)(generator);
+
+        new_client_sockets[emptyInd] = client_socket;
+        socketSlots[client_socket] = emptyInd;
     }
+}
 
-    string tmp(buffer, size);
+void Node::checkConnection(int index, int size)
+{
+    int inputsd = client_sockets[index] ? client_sockets[index] : new_client_sockets[index];
+    MessageBuffer* messageBuffer = messageBuffers[index];
 
-    if ((int)messages[index].size() <= curMsg)
+    /* edge triggered, read until the socket is drained */
+    while (true)
     {
-        messages[index].push_back({"", false});
+        int bytes_read = recv(inputsd, messageBuffer->getWritable(size), size, MSG_DONTWAIT);
 
-        size_t beg = tmp.find("BEG", begOffset);
-        if (beg != string::npos)
+        /* disconnected */
+        if (bytes_read == 0)
+        {
+            disconnect(index);
+            return;
+        }
+        else if (bytes_read < 0)
         {
-            size_t end = tmp.find("END", beg + 3);
-            if (end != string::npos)
+            if (errno == EINTR)
             {
-                messages[index][curMsg].first = tmp.substr(beg + 3, end - beg - 3);		
-                messages[index][curMsg].second = true;
-
-                constructFineMessage(buffer, size, index, curMsg + 1, end + 3);
-                return;
+                continue;
             }
-            else
-            {
-                messages[index][curMsg].first = tmp.substr(beg + 3);
-                messages[index][curMsg].second = false;
 
-                return;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
             }
-        }	
-    }
-    else
-    {
-        size_t end = tmp.find("END", begOffset);
-        if (end != string::npos)
-        {
-            messages[index][curMsg].first += tmp.substr(begOffset, end);
-            messages[index][curMsg].second = true;
 
-            constructFineMessage(buffer, size, index, curMsg + 1, end + 3);
+            disconnect(index);
             return;
         }
-        else
+
+        messageBuffer->commit(bytes_read);
+
+        /* complete frames */
+        const char* frame = nullptr;
+        size_t frameSize = 0;
+        unsigned char frameType = MESSAGE_NONE;
+
+        try
         {
-            messages[index][curMsg].first += tmp;
-            messages[index][curMsg].second = false;
+            while (messageBuffer->nextFrame(frame, frameSize, frameType))
+            {
+                messages[index].push_back({frameType, string(frame, frameSize), index});
 
+                if (telemetry)
+                {
+                    telemetry->addIn(index, frameSize + FRAME_HEADER_SIZE);
+                }
+            }
+        }
+        catch(exception& ex)
+        {
+            /* not our protocol */
+            disconnect(index);
             return;
         }
     }
-
-    return;
-    /* END */
 }
 
-void Node::checkConnections(int size)
+void Node::flush(int index)
 {
-    for (int i = 0; i < max_clients; i++)
+    int sock = client_sockets[index] ? client_sockets[index] : new_client_sockets[index];
+    SendQueue& queue = sendQueues[index];
+
+    while (sock > 0 && !queue.frames.empty())
     {
-        int inputsd = client_sockets[i];
+        struct iovec iov[NODE_SEND_BATCH * 2];
+        int count = 0;
 
-        if (FD_ISSET(inputsd, &readfds))
+        /* header and payload of each frame, skipping what is already out */
+        for (size_t i = 0; i < queue.frames.size() && count < NODE_SEND_BATCH * 2; i++)
         {
-            char* buffer = new char[size + 1];
-            int bytes_read = 1;
+            Frame& frame = queue.frames[i];
+            size_t offset = i ? 0 : queue.offset;
 
-            int last = 0;
-            while (last < int(messages[i].size()) && messages[i][last].second)
+            if (offset < FRAME_HEADER_SIZE)
             {
-                last++;
+                iov[count].iov_base = frame.header + offset;
+                iov[count].iov_len = FRAME_HEADER_SIZE - offset;
+                count++;
+
+                offset = FRAME_HEADER_SIZE;
             }
 
-            while (messages[i].empty() || (!messages[i].empty() && !messages[i][last].second))
-            {	
-                memset(buffer, 0, size + 1);
+            iov[count].iov_base = (void*)(frame.payload->data() + offset - FRAME_HEADER_SIZE);
+            iov[count].iov_len = frame.payload->size() + FRAME_HEADER_SIZE - offset;
+            count++;
+        }
 
-                bytes_read = recv(inputsd, buffer, size, MSG_DONTWAIT);
-               
-                /* disconnected */
-                if (bytes_read == 0)
-                {
-                    break;
-                }
-                else if (bytes_read < 0)
-                {
-                    break;
-                }
+        struct msghdr header;
+        memset(&header, 0, sizeof(header));
+        header.msg_iov = iov;
+        header.msg_iovlen = count;
 
-                constructFineMessage(buffer, bytes_read, i, last, 0);
+        int bytes_sent = sendmsg(sock, &header, MSG_NOSIGNAL | MSG_DONTWAIT);
+
+        if (bytes_sent < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
             }
-            
-            for (size_t j = last; j < messages[i].size(); j++)
+
+            /* the rest goes on EPOLLOUT */
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
             {
-                if (messages[i][j].second)
-                {
-                    /* END fix */
-                    if (!messages[i][j].first.empty())
-                    {
-                        int s = messages[i][j].first.size() - 1;
-                        while (s >= 0 && messages[i][j].first[s] != '>')
-                        {
-                            messages[i][j].first[s] = ' ';
-                            s--;
-                        }
-                    }
-                }
+                return;
             }
 
-            delete[] buffer;
+            queue = {{}, 0, 0};
+
+            throw(runtime_error("ERROR::Node::flush() send"));
+        }
+
+        queue.size -= bytes_sent;
+
+        /* release the frames that are out */
+        while (bytes_sent > 0)
+        {
+            size_t left = queue.frames.front().payload->size() + FRAME_HEADER_SIZE - queue.offset;
 
-            /* client has disconnected */
-            if (bytes_read == 0)
+            if ((size_t)bytes_sent < left)
             {
-                old_client_sockets[i] = client_sockets[i];
-                client_sockets[i] = 0;
-                new_client_sockets[i] = 0;
+                queue.offset += bytes_sent;
+                break;
+            }
+
+            bytes_sent -= left;
+            queue.offset = 0;
+            queue.frames.pop_front();
+        }
+    }
+}
 
-                messages[i].clear();
+void Node::disconnect(int index)
+{
+    int sock = client_sockets[index] ? client_sockets[index] : new_client_sockets[index];
+
+    unique_lock < mutex > lk(sendMtx);
+
+    old_client_sockets[index] = sock;
+    client_sockets[index] = 0;
+    new_client_sockets[index] = 0;
+
+    messages[index].clear();
+
+    sendQueues[index] = {{}, 0, 0};
+    lastMsgs[index] = nullptr;
+
+    datagramChannels[index] = DatagramChannel();
+
+    if (linkSimulator)
+    {
+        linkSimulator->clear(index);
+    }
+
+    socketSlots.erase(sock);
+
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, sock, NULL);
+    close(sock);
+}
+
+void Node::checkDatagrams()
+{
+    char buffer[NODE_DATAGRAM_SIZE];
+
+    /* edge triggered, read until the socket is drained */
+    while (true)
+    {
+        struct sockaddr_in from;
+        socklen_t len = sizeof(from);
+
+        int bytes_read = recvfrom(udp_sock, buffer, sizeof(buffer), MSG_DONTWAIT, (struct sockaddr*) &from, &len);
 
-                close(inputsd);
+        if (bytes_read < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
             }
+
+            return;
+        }
+
+        /* only the hello is expected from the clients */
+        if (bytes_read != NODE_DATAGRAM_HEADER_SIZE + 8 || (unsigned char)buffer[0] != NODE_DATAGRAM_HELLO)
+        {
+            continue;
+        }
+
+        unsigned int slot = 0;
+        unsigned int token = 0;
+
+        for (int i = 0; i < 4; i++)
+        {
+            slot |= (unsigned int)(unsigned char)buffer[NODE_DATAGRAM_HEADER_SIZE + i] << (i * 8);
+            token |= (unsigned int)(unsigned char)buffer[NODE_DATAGRAM_HEADER_SIZE + 4 + i] << (i * 8);
         }
+
+        unique_lock < mutex > lk(sendMtx);
+
+        if (slot >= (unsigned int)max_clients || (!client_sockets[slot] && !new_client_sockets[slot]) || datagramChannels[slot].token != token)
+        {
+            continue;
+        }
+
+        datagramChannels[slot].bound = true;
+        datagramChannels[slot].addr = from;
+
+        /* the client says hello until this one gets through */
+        string datagram(NODE_DATAGRAM_HEADER_SIZE, 0);
+        datagram[0] = char(NODE_DATAGRAM_HELLO);
+
+        transmit(slot, datagram);
     }
 }
 
-void Node::checkActivity(int size, float timeoutSec)
+void Node::transmit(int index, string datagram)
 {
-    FD_ZERO(&readfds);
-    FD_SET(master_sock, &readfds);
+    if (telemetry)
+    {
+        telemetry->addOut(index, datagram.size());
+    }
 
-    int max_sd = master_sock;
+    if (linkSimulator)
+    {
+        linkSimulator->push(index, move(datagram));
+        flushDatagrams();
 
-    for (int i = 0; i < max_clients; i++)
+        return;
+    }
+
+    const DatagramChannel& channel = datagramChannels[index];
+
+    /* unreliable anyway, a full socket buffer just loses it */
+    sendto(udp_sock, datagram.data(), datagram.size(), MSG_DONTWAIT, (const struct sockaddr*) &channel.addr, sizeof(channel.addr));
+}
+
+void Node::flushDatagrams()
+{
+    if (!linkSimulator)
     {
-        int sd = client_sockets[i];
+        return;
+    }
 
-        if (sd > 0)
+    vector < pair < int, string > > due = linkSimulator->pop();
+
+    for (size_t i = 0; i < due.size(); i++)
+    {
+        const DatagramChannel& channel = datagramChannels[due[i].first];
+
+        if (channel.bound)
         {
-            FD_SET(sd, &readfds);
+            sendto(udp_sock, due[i].second.data(), due[i].second.size(), MSG_DONTWAIT, (const struct sockaddr*) &channel.addr, sizeof(channel.addr));
         }
+    }
+}
 
-        if (sd > max_sd)
+void Node::checkActivity(int size, float timeoutSec)
+{
+    int timeout = timeoutSec * 1000;
+
+    /* wake up for the delayed datagrams */
+    {
+        unique_lock < mutex > lk(sendMtx);
+
+        if (linkSimulator && linkSimulator->getWait() >= 0)
         {
-            max_sd = sd;
+            timeout = min(timeout, linkSimulator->getWait());
         }
     }
 
-    timeout.tv_sec = timeoutSec;
-    timeout.tv_usec = 0;
+    /* edge triggered, the queued frames won't wake us up again */
+    {
+        unique_lock < mutex > lck(mtx);
+
+        for (size_t i = 0; i < messages.size() && timeout; i++)
+        {
+            if (!messages[i].empty())
+            {
+                timeout = 0;
+            }
+        }
+    }
 
-    int activity = select(max_sd + 1, &readfds, NULL, NULL, &timeout);
+    int activity = epoll_wait(epoll_fd, events.data(), events.size(), timeout);
 
     if (activity < 0 && errno != EINTR)
     {
-        throw(runtime_error("ERROR::Node::checkActivity() select"));
+        throw(runtime_error("ERROR::Node::checkActivity() epoll_wait"));
     }
     
     unique_lock < mutex > lck(mtx);
     ready = false;
 
-    if (activity)
+    for (int i = 0; i < activity; i++)
+    {
+        int sd = events[i].data.fd;
+
+        if (sd == master_sock)
+        {
+            checkNewConnections();
+            continue;
+        }
+
+        if (sd == udp_sock)
+        {
+            checkDatagrams();
+            continue;
+        }
+
+        int index = getSlot(sd);
+
+        if (index < 0)
+        {
+            continue;
+        }
+
+        /* hang ups end up as a zero read */
+        if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+        {
+            checkConnection(index, size);
+        }
+
+        if ((events[i].events & EPOLLOUT) && getSlot(sd) == index)
+        {
+            unique_lock < mutex > lk(sendMtx);
+
+            try
+            {
+                flush(index);
+            }
+            catch(exception& ex) {}
+        }
+    }
+
     {
-        checkNewConnections();
-        checkConnections(size);
+        unique_lock < mutex > lk(sendMtx);
+
+        flushDatagrams();
     }
 
     ready = true;
     cv.notify_all();
 }
 
-void Node::sendMSG(int to, string msg, bool force)
+void Node::sendMSG(int to, string msg, bool force, bool droppable)
 {
-    if (msg == "" || to <= 0)
+    if (msg == "")
     {
         return;
     }
 
+    sendMSG(to, make_shared < const string >(move(msg)), force, droppable);
+}
+
+void Node::sendMSG(int to, shared_ptr < const string > msg, bool force, bool droppable)
+{
+    if (!msg || msg->empty() || to <= 0)
+    {
+        return;
+    }
+
+    unique_lock < mutex > lk(sendMtx);
+
+    int index = getSlot(to);
+
+    if (index < 0)
+    {
+        throw(runtime_error("ERROR::Node::sendMSG() unknown socket"));
+    }
+
     /* check the same message */
-    if (!force)
+    if (!force && lastMsgs[index] && (lastMsgs[index] == msg || *lastMsgs[index] == *msg))
     {
-        for (size_t i = 0; i < client_sockets.size(); i++)
-        {
-            if (client_sockets[i] == to || new_client_sockets[i] == to)
-            {
-                if (lastMsgs[i] == msg)
-                {
-                    return;
-                }
+        return;
+    }
 
-                break;
-            }
-        }
+    SendQueue& queue = sendQueues[index];
+
+    size_t frameSize = msg->size() + FRAME_HEADER_SIZE;
+
+    /* slow client, the next snapshot will cover this one */
+    if (droppable && queue.size + frameSize > NODE_SEND_DROP_THRESHOLD)
+    {
+        return;
+    }
+
+    /* the client can't keep up at all, the receiver thread will clean it up */
+    if (queue.size + frameSize > NODE_SEND_QUEUE_SIZE)
+    {
+        queue = {{}, 0, 0};
+        shutdown(to, SHUT_RDWR);
+
+        throw(runtime_error("ERROR::Node::sendMSG() send queue overflow"));
     }
 
-    if (send(to, msg.data(), msg.size(), MSG_NOSIGNAL) < 0)
+    /* the payload is shared with the other clients, only the reference is queued */
+    Frame frame;
+    MessageBuffer::writeHeader(frame.header, msg->size());
+    frame.payload = msg;
+
+    queue.frames.push_back(frame);
+    queue.size += frameSize;
+
+    if (telemetry)
     {
-        throw(runtime_error("ERROR::Node::sendMSG() send"));
+        telemetry->addOut(index, frameSize);
+        telemetry->setQueue(index, queue.frames.size(), queue.size);
     }
 
     /* save the message */
-    for (size_t i = 0; i < client_sockets.size(); i++)
+    lastMsgs[index] = msg;
+
+    flush(index);
+}
+
+void Node::sendDatagram(int to, string msg, unsigned char channel)
+{
+    if (msg == "" || to <= 0)
     {
-        if (client_sockets[i] == to || new_client_sockets[i] == to)
-        {
-            lastMsgs[i] = msg;
-            break;
-        }
+        return;
+    }
+
+    unique_lock < mutex > lk(sendMtx);
+
+    int index = getSlot(to);
+
+    if (index < 0)
+    {
+        throw(runtime_error("ERROR::Node::sendDatagram() unknown socket"));
+    }
+
+    DatagramChannel& datagramChannel = datagramChannels[index];
+
+    /* no hello yet or too big for one packet, the stream takes it */
+    if (!datagramChannel.bound || channel >= NODE_DATAGRAM_CHANNELS || msg.size() + NODE_DATAGRAM_HEADER_SIZE > NODE_DATAGRAM_SIZE)
+    {
+        lk.unlock();
+        sendMSG(to, move(msg), false, true);
+
+        return;
+    }
+
+    /* the client drops anything older than what it has seen on the channel */
+    unsigned int seq = ++datagramChannel.seqs[channel];
+
+    string datagram(NODE_DATAGRAM_HEADER_SIZE, 0);
+    datagram[0] = char(channel);
+
+    for (int i = 0; i < 4; i++)
+    {
+        datagram[1 + i] = char((seq >> (i * 8)) & 0xFF);
     }
+
+    datagram += msg;
+
+    transmit(index, move(datagram));
+}
+
+void Node::setTelemetry(Telemetry* telemetry)
+{
+    this->telemetry = telemetry;
+}
+
+void Node::simulateLink(float loss, int latency, int jitter)
+{
+    unique_lock < mutex > lk(sendMtx);
+
+    delete linkSimulator;
+    linkSimulator = new LinkSimulator(loss, latency, jitter);
 }
 
 vector < int > Node::getClientSockets() const
@@ -371,7 +742,19 @@ int Node::getClientSocket(size_t index) const
     return client_sockets[index];
 }
 
-vector < string > Node::getMessages() const
+unsigned int Node::getDatagramToken(size_t index) const
+{
+    if (!(index >= 0 && index < datagramChannels.size()))
+    {
+        throw(runtime_error("ERROR::Node::getDatagramToken() out of range"));
+    }
+
+    unique_lock < mutex > lk(sendMtx);
+
+    return datagramChannels[index].token;
+}
+
+vector < Message > Node::getMessages() const
 {
     unique_lock < mutex > lck(mtx);
 
@@ -380,22 +763,28 @@ vector < string > Node::getMessages() const
         cv.wait(lck);
     }
 
-    vector < string > res;
+    vector < Message > res;
 
-    for (size_t i = 0; i < messages.size(); i++)
+    /* everything queued, round robin over the clients, so a flooding client can't push the others back */
+    bool left = true;
+
+    while (left)
     {
-        if (!messages[i].empty() && messages[i][0].second)
-        {
-            res.push_back(messages[i][0].first);
-            messages[i].pop_front();
-        }
-        else
+        left = false;
+
+        for (size_t i = 0; i < messages.size(); i++)
         {
-            res.push_back("");
+            if (!messages[i].empty())
+            {
+                res.push_back(move(messages[i].front()));
+                messages[i].pop_front();
+
+                left |= !messages[i].empty();
+            }
         }
     }
 
-    return move(res);
+    return res;
 }
 
 void Node::newToClient(int index)
@@ -409,4 +798,23 @@ void Node::oldToNothing(int index)
     old_client_sockets[index] = 0; 
 }
 
-Node::~Node() {}
+Node::~Node()
+{
+    for (int i = 0; i < max_clients; i++)
+    {
+        int sock = client_sockets[i] ? client_sockets[i] : new_client_sockets[i];
+
+        if (sock > 0)
+        {
+            close(sock);
+        }
+
+        delete messageBuffers[i];
+    }
+
+    delete linkSimulator;
+
+    close(epoll_fd);
+    close(udp_sock);
+    close(master_sock);
+}
@@ -2,51 +2,128 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
 
 #include <cstring>
+#include <random>
 #include <string>
 #include <iostream>
 #include <vector>
 #include <deque>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <condition_variable>
 
+/* per client outbound queue, bytes */
+#define NODE_SEND_QUEUE_SIZE (1 << 20)
+/* droppable messages are skipped once the backlog is above this */
+#define NODE_SEND_DROP_THRESHOLD (1 << 16)
+/* frames per sendmsg() */
+#define NODE_SEND_BATCH 16
+
+/* u8 channel + u32 sequence (little endian) before every datagram payload */
+#define NODE_DATAGRAM_HEADER_SIZE 5
+/* bigger payloads would fragment, they go over the stream instead */
+#define NODE_DATAGRAM_SIZE 1200
+#define NODE_DATAGRAM_CHANNELS 4
+/* channel byte of the handshake, the client sends u32 slot + u32 token after the header */
+#define NODE_DATAGRAM_HELLO 0xFF
+
 using namespace std;
 
+/* a received frame, the type comes from the frame header */
+struct Message
+{
+    unsigned char type;
+    string data;
+    int slot; /* the client it came through, -1 for a replayed one */
+};
+
 class Node
 {
     private:
+        /* shared, immutable payload behind its own length header */
+        struct Frame
+        {
+            char header[FRAME_HEADER_SIZE];
+            shared_ptr < const string > payload;
+        };
+
+        /* frames waiting for the socket */
+        struct SendQueue
+        {
+            deque < Frame > frames;
+            size_t offset;
+            size_t size;
+        };
+
+        /* unreliable state channel of a slot, bound by the client hello */
+        struct DatagramChannel
+        {
+            bool bound;
+            struct sockaddr_in addr;
+            unsigned int token;
+            unsigned int seqs[NODE_DATAGRAM_CHANNELS];
+        };
+
         int master_sock;
+        int udp_sock;
+        int epoll_fd;
         struct sockaddr_in addr;
-        struct timeval timeout;
 
         int max_clients;
         vector < int > client_sockets;
         vector < int > new_client_sockets;
         vector < int > old_client_sockets;
+        map < int, int > socketSlots;
+
+        vector < struct epoll_event > events;
+        vector < MessageBuffer* > messageBuffers; /* allocated on the first connect of a slot */
 
-        fd_set readfds;
+		mutable vector < deque < Message > > messages;
+        vector < shared_ptr < const string > > lastMsgs; 
+        vector < SendQueue > sendQueues;
 
-		mutable vector < deque < pair < string, bool > > > messages;
-        vector < string > lastMsgs; 
+        vector < DatagramChannel > datagramChannels;
+        LinkSimulator* linkSimulator;
+        Telemetry* telemetry;
+        mt19937 generator;
         
         bool ready;
         mutable mutex mtx;
         mutable condition_variable cv;
+        mutable mutex sendMtx;
 		
-        void constructFineMessage(char* buffer, int size, int index, int curMsg, int begOffset);
- 
+        void setNonBlocking(int sock);
+        int getSlot(int sock) const;
+
         void checkNewConnections();
-        void checkConnections(int size);
+        void checkConnection(int index, int size);
+
+        void flush(int index);
+        void disconnect(int index);
+
+        void checkDatagrams();
+        void transmit(int index, string datagram);
+        void flushDatagrams();
 
     public:
         Node(int max_clients, int max_queue, int port);
 
         void checkActivity(int size = 2048, float timeoutSec = 1);
-        void sendMSG(int to, string msg, bool force = false);
+        void sendMSG(int to, string msg, bool force = false, bool droppable = false);
+        void sendMSG(int to, shared_ptr < const string > msg, bool force = false, bool droppable = false);
+        void sendDatagram(int to, string msg, unsigned char channel = 0);
+
+        void simulateLink(float loss, int latency, int jitter);
+        void setTelemetry(Telemetry* telemetry);
 
         bool isNewClients() const;
         bool isOldClients() const;
@@ -55,7 +132,8 @@ class Node
         vector < int > getNewClientSockets() const;
         vector < int > getOldClientSockets() const;
         int getClientSocket(size_t index) const;
-        vector < string > getMessages() const;
+        unsigned int getDatagramToken(size_t index) const;
+        vector < Message > getMessages() const;
 
         void newToClient(int index);
         void oldToNothing(int index);
@@ -6,12 +6,28 @@
 
 #include "../physics_object/openglmotionstate.hpp"
 #include "../physics_object/physicsobject.hpp"
+#include "../physics_object/weapon.hpp"
 
+#include "../player/player.hpp"
+#include "../player/soldier.hpp"
+
+#include "../level/spawner.hpp"
+#include "../level/levelloader.hpp"
+#include "../level/level.hpp"
+
+#include "worldsnapshot.hpp"
 #include "physicsobjectdatacollector.hpp"
         
 PhysicsObjectDataCollector::PhysicsObjectDataCollector(int clients) 
 {
     last.resize(clients, "");
+
+    tick = 0;
+}
+
+void PhysicsObjectDataCollector::setTick(unsigned int tick)
+{
+    this->tick = tick;
 }
 
 void PhysicsObjectDataCollector::collect(PhysicsObject* physicsObject)
@@ -19,89 +35,110 @@ void PhysicsObjectDataCollector::collect(PhysicsObject* physicsObject)
     if (physicsObject)
     {
         pos.insert({physicsObject->getName(), physicsObject->getTransform()});
+        netIDs.insert({physicsObject->getName(), physicsObject->getNetID()});
     }
 }
 
-void PhysicsObjectDataCollector::collect(map < string, PhysicsObject* > physicsObjects)
+void PhysicsObjectDataCollector::collect(const ObjectState& object)
+{
+    btScalar* model = new btScalar[16];
+    memcpy(model, object.model, sizeof(btScalar) * 16);
+
+    pos.insert({object.name, model});
+    netIDs.insert({object.name, object.netID});
+}
+
+void PhysicsObjectDataCollector::collect(const vector < PhysicsObject* >& physicsObjects)
 {
-    for (auto& i: physicsObjects)
+    for (size_t i = 0; i < physicsObjects.size(); i++)
     {
-        pos.insert({i.first, i.second->getTransform()});
+        collect(physicsObjects[i]);
     }
 }
 
-string PhysicsObjectDataCollector::getData(int client, bool raw) const
+string PhysicsObjectDataCollector::getData(int client) const
 {
-    XMLDocument physicsObjectDataCollectorDoc;
+    shared_ptr < const string > res = getSharedData(client);
 
-    /* root */
-    XMLNode* root = physicsObjectDataCollectorDoc.NewElement("Objs");
-    physicsObjectDataCollectorDoc.InsertFirstChild(root);
-    
-    for (auto& i: pos)
+    return res ? *res : "";
+}
+
+shared_ptr < const string > PhysicsObjectDataCollector::getSharedData(int client) const
+{
+    /* the document is the same for every client */
+    if (printed.empty())
     {
-        /* obj */
-        XMLElement* objElem = physicsObjectDataCollectorDoc.NewElement("obj");
+        XMLDocument physicsObjectDataCollectorDoc;
 
-        /* name */
-        objElem->SetAttribute("name", i.first.data());
+        /* root */
+        XMLNode* root = physicsObjectDataCollectorDoc.NewElement("Objs");
+        physicsObjectDataCollectorDoc.InsertFirstChild(root);
+        
+        for (auto& i: pos)
+        {
+            /* obj */
+            XMLElement* objElem = physicsObjectDataCollectorDoc.NewElement("obj");
 
-        /* model */
-        XMLElement* modelElem = physicsObjectDataCollectorDoc.NewElement("mdl");
+            /* id */
+            objElem->SetAttribute("id", netIDs.at(i.first));
 
-        for (int j = 0; j < 16; j++)
-        {
-            string str;
-            str = char('a' + j);
+            /* model */
+            XMLElement* modelElem = physicsObjectDataCollectorDoc.NewElement("mdl");
 
-            modelElem->SetAttribute(str.data(), global.cutFloat(i.second[j], 4));
+            for (int j = 0; j < 16; j++)
+            {
+                string str;
+                str = char('a' + j);
+
+                modelElem->SetAttribute(str.data(), global.cutFloat(i.second[j], 4));
+            }
+
+            objElem->InsertEndChild(modelElem);
+
+            root->InsertEndChild(objElem);
         }
 
-        objElem->InsertEndChild(modelElem);
+        /* printer */
+        XMLPrinter physicsObjectDataCollectorPrinter;
+        physicsObjectDataCollectorDoc.Print(&physicsObjectDataCollectorPrinter);
 
-        root->InsertEndChild(objElem);
+        printed = physicsObjectDataCollectorPrinter.CStr();
     }
-
-    /* printer */
-    XMLPrinter physicsObjectDataCollectorPrinter;
-    physicsObjectDataCollectorDoc.Print(&physicsObjectDataCollectorPrinter);
     
-    string res = physicsObjectDataCollectorPrinter.CStr();
-    
-    if (res == last[client])
+    if (printed == last[client])
     {
-        return "";
+        return nullptr;
     }
     else
     {
-        last[client] = res;
+        last[client] = printed;
     }
-    
-    /* timestamp */
-    XMLElement* timeElem = physicsObjectDataCollectorDoc.NewElement("time");
-    timeElem->SetAttribute("time", global.getTime());
-    physicsObjectDataCollectorDoc.InsertFirstChild(timeElem);
-    
-    physicsObjectDataCollectorPrinter.ClearBuffer();
-    physicsObjectDataCollectorDoc.Print(&physicsObjectDataCollectorPrinter);
-
-    res = "";
 
-    if (!raw)
-    {
-        res += "BEG\n";
-        res += physicsObjectDataCollectorPrinter.CStr();
-        res += "END";
-    }
-    else
+    /* built once, every client gets the same buffer */
+    if (!message)
     {
-        res += physicsObjectDataCollectorPrinter.CStr();
+        /* timestamp */
+        XMLDocument timeDoc;
+        XMLElement* timeElem = timeDoc.NewElement("time");
+        timeElem->SetAttribute("time", global.getTime());
+        timeElem->SetAttribute("tick", tick);
+        timeDoc.InsertFirstChild(timeElem);
+
+        XMLPrinter timePrinter;
+        timeDoc.Print(&timePrinter);
+
+        string res = "";
+
+        res += timePrinter.CStr();
+        res += printed;
+
+        message = make_shared < const string >(move(res));
     }
 
-    return res;
+    return message;
 }
         
-string PhysicsObjectDataCollector::getMergedData(string fileName, int client, bool raw) const
+string PhysicsObjectDataCollector::getMergedData(string fileName, int client) const
 {
     XMLDocument physicsObjectDataCollectorDoc;
 
@@ -121,6 +158,21 @@ string PhysicsObjectDataCollector::getMergedData(string fileName, int client, bo
         const char* name = nullptr;
         objElem->QueryStringAttribute("name", &name);
 
+        /* network ids of every instance, sent once so the steady messages can refer to them */
+        int quantity = 1;
+        objElem->QueryIntAttribute("quantity", &quantity);
+
+        string ids = "";
+
+        for (int j = 0; j < quantity; j++)
+        {
+            auto idIt = netIDs.find(quantity > 1 ? name + to_string(j) : name);
+
+            ids += (j ? " " : "") + to_string(idIt != netIDs.end() ? idIt->second : -1);
+        }
+
+        objElem->SetAttribute("ids", ids.data());
+
         XMLElement* positionElem = objElem->FirstChildElement("pos");
         
         if (positionElem)
@@ -175,6 +227,7 @@ string PhysicsObjectDataCollector::getMergedData(string fileName, int client, bo
     /* timestamp */
     XMLElement* timeElem = physicsObjectDataCollectorDoc.NewElement("time");
     timeElem->SetAttribute("time", global.getTime());
+    timeElem->SetAttribute("tick", tick);
     physicsObjectDataCollectorDoc.InsertFirstChild(timeElem);
     
     physicsObjectDataCollectorPrinter.ClearBuffer();
@@ -182,16 +235,7 @@ string PhysicsObjectDataCollector::getMergedData(string fileName, int client, bo
 
     res = "";
 
-    if (!raw)
-    {
-        res += "BEG\n";
-        res += physicsObjectDataCollectorPrinter.CStr();
-        res += "END";
-    }
-    else
-    {
-        res += physicsObjectDataCollectorPrinter.CStr();
-    }
+    res += physicsObjectDataCollectorPrinter.CStr();
 
     return res;
 }
@@ -204,6 +248,9 @@ void PhysicsObjectDataCollector::clear()
     }
 
     pos.clear();
+    netIDs.clear();
+    printed = "";
+    message = nullptr;
 }
 
 void PhysicsObjectDataCollector::clearLast(int client)
@@ -3,6 +3,7 @@
 #include <stdexcept>
 #include <vector>
 #include <map>
+#include <memory>
 #include <string>
 
 #include <tinyxml2/tinyxml2.h>
@@ -14,17 +15,28 @@ class PhysicsObjectDataCollector
 {
     private:
         mutable map < string, btScalar* > pos;
+        map < string, int > netIDs;
+
+        /* printed once per collect, shared by all the clients */
+        mutable string printed;
+        mutable shared_ptr < const string > message;
 
         mutable vector < string > last;
 
+        unsigned int tick;
+
     public:
         PhysicsObjectDataCollector(int clients);
 
+        void setTick(unsigned int tick);
+
         void collect(PhysicsObject* physicsObject);
-        void collect(map < string, PhysicsObject* > physicsObjects);
+        void collect(const ObjectState& object);
+        void collect(const vector < PhysicsObject* >& physicsObjects);
 
-        string getData(int client, bool raw = false) const;
-        string getMergedData(string fileName, int client, bool raw = false) const;
+        string getData(int client) const;
+        shared_ptr < const string > getSharedData(int client) const;
+        string getMergedData(string fileName, int client) const;
 
         void clear();
         void clearLast(int client);
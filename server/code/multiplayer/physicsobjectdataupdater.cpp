@@ -9,37 +9,31 @@
 
 #include "physicsobjectdataupdater.hpp"
 
-PhysicsObjectDataUpdater::PhysicsObjectDataUpdater()
-{
-    name = "";
-    senderID = -1;
-
-    model = new btScalar[16];
-    memset(model, 0, sizeof(btScalar) * 16);
-}
+PhysicsObjectDataUpdater::PhysicsObjectDataUpdater() {}
 
-void PhysicsObjectDataUpdater::collect(string info)
+void PhysicsObjectDataUpdater::collect(const string& info, ObjData& data) const
 {
     XMLDocument physicsObjectDataUpdaterDoc;
     
-    physicsObjectDataUpdaterDoc.Parse(info.data());
+    physicsObjectDataUpdaterDoc.Parse(info.data(), info.size());
 
     /* root */
     XMLNode* root = physicsObjectDataUpdaterDoc.FirstChildElement("Obj");
 
     if (!root)
     {
-        physicsObjectDataUpdaterDoc.PrintError();
-        cout << info << endl << endl;
         throw runtime_error("ERROR::PhysicsObjectDataUpdater::collect() failed to load XML");
     }
 
-    /* name */
-    XMLElement* nameElem = root->FirstChildElement("name");
+    data.netID = -1;
+    data.senderID = -1;
+
+    /* netID */
+    XMLElement* netIDElem = root->FirstChildElement("obj");
     
-    if (nameElem)
+    if (netIDElem)
     {
-        name = nameElem->GetText();
+        netIDElem->QueryIntText(&data.netID);
     }
     
     /* senderID */
@@ -47,48 +41,28 @@ void PhysicsObjectDataUpdater::collect(string info)
     
     if (senderIDElem)
     {
-        senderIDElem->QueryIntText(&senderID);
+        senderIDElem->QueryIntText(&data.senderID);
     }
 
     /* model */
     XMLElement* modelElem = root->FirstChildElement("mdl");
 
-    if (modelElem)
+    for (int i = 0; i < 16; i++)
     {
-        for (int i = 0; i < 16; i++)
+        data.model[i] = 0;
+
+        if (modelElem)
         {
-            string str;
-            str = char('a' + i);
+            char name[2] = {char('a' + i), 0};
 
-            modelElem->QueryFloatAttribute(str.data(), &model[i]);
+            modelElem->QueryFloatAttribute(name, &data.model[i]);
         }
     }
 }
 
-void PhysicsObjectDataUpdater::updateData(PhysicsObject* physicsObject)
-{
-    physicsObject->setTransform(model);
-}
-
-string PhysicsObjectDataUpdater::getName() const
+void PhysicsObjectDataUpdater::updateData(ObjData& data, PhysicsObject* physicsObject)
 {
-    return name;
+    physicsObject->setTransform(data.model);
 }
-        
-int PhysicsObjectDataUpdater::getSenderID() const
-{
-    return senderID;
-}
-
-void PhysicsObjectDataUpdater::clear()
-{
-    name = "";
-    senderID = -1;
 
-    memset(model, 0, sizeof(btScalar) * 16);
-}
-
-PhysicsObjectDataUpdater::~PhysicsObjectDataUpdater() 
-{
-    delete[] model;
-}
+PhysicsObjectDataUpdater::~PhysicsObjectDataUpdater() {}
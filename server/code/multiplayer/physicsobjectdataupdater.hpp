@@ -9,25 +9,23 @@
 using namespace std;
 using namespace tinyxml2;
 
-class PhysicsObjectDataUpdater
+/* a parsed <Obj> message */
+struct ObjData
 {
-    private:
-        string name;
-        int senderID;
+    int netID;
+    int senderID;
+
+    btScalar model[16];
+};
 
-        btScalar* model;
-    
+class PhysicsObjectDataUpdater
+{
     public:
         PhysicsObjectDataUpdater();
 
-        void collect(string info);
-
-        void updateData(PhysicsObject* physicsObject);
-
-        string getName() const;
-        int getSenderID() const;
+        void collect(const string& info, ObjData& data) const;
 
-        void clear();
+        void updateData(ObjData& data, PhysicsObject* physicsObject);
 
         ~PhysicsObjectDataUpdater();
 };
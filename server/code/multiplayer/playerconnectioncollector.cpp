@@ -75,9 +75,7 @@ string PlayerConnectionCollector::getData(int client) const
 
     res = "";
 
-    res += "BEG\n";
     res += playerConnectionCollectorPrinter.CStr();
-    res += "END";
 
     return res;
 }
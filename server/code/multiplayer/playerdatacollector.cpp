@@ -11,42 +11,42 @@
 #include "../player/player.hpp"
 #include "../player/soldier.hpp"
 
+#include "../level/spawner.hpp"
+#include "../level/levelloader.hpp"
+#include "../level/level.hpp"
+
+#include "worldsnapshot.hpp"
 #include "playerdatacollector.hpp"
         
 PlayerDataCollector::PlayerDataCollector(int clients)
 {
     last.resize(clients, "");
+
+    tick = 0;
 }
 
-void PlayerDataCollector::collect(Player* player)
+void PlayerDataCollector::setTick(unsigned int tick)
 {
-    if (player->getPhysicsObject())
-    {
-        playerIDs.push_back(player->getID());
-        names.push_back(player->getPhysicsObject()->getName());
-        models.insert({player->getID(), player->getPhysicsObject()->getTransform()});
-        moveDirections.insert({player->getID(), player->getMoveDirection()});
-
-        Soldier* soldier = dynamic_cast < Soldier* >(player);
+    this->tick = tick;
+}
 
-        if (soldier)
-        {
-            deque < Weapon* > weapons = soldier->getWeapons();
-            vector < string > tmp;
+void PlayerDataCollector::collect(const SoldierState& soldier)
+{
+    btScalar* model = new btScalar[16];
+    memcpy(model, soldier.model, sizeof(btScalar) * 16);
 
-            for (size_t i = 0; i < weapons.size(); i++)
-            {
-                tmp.push_back(weapons[i]->getName());
-            }
+    playerIDs.push_back(soldier.id);
+    names.insert({soldier.id, soldier.name});
+    models.insert({soldier.id, model});
+    moveDirections.insert({soldier.id, soldier.moveDirection});
 
-            if (!tmp.empty())
-            {
-                pickedWeapons.insert({soldier->getID(), tmp});
-            }
-        
-            healths.insert({soldier->getID(), soldier->getHealth()});
-        }
+    if (!soldier.weapons.empty())
+    {
+        pickedWeapons.insert({soldier.id, soldier.weapons});
     }
+
+    healths.insert({soldier.id, soldier.health});
+    inputSeqs.insert({soldier.id, soldier.inputSeq});
 }
 
 void PlayerDataCollector::collect(vector < Player* > players)
@@ -56,20 +56,21 @@ void PlayerDataCollector::collect(vector < Player* > players)
         if (players[i]->getPhysicsObject())
         {
             playerIDs.push_back(players[i]->getID());
-            names.push_back(players[i]->getPhysicsObject()->getName());
+            names.insert({players[i]->getID(), players[i]->getPhysicsObject()->getName()});
             models.insert({players[i]->getID(), players[i]->getPhysicsObject()->getTransform()});
             moveDirections.insert({players[i]->getID(), players[i]->getMoveDirection()});
+            inputSeqs.insert({players[i]->getID(), players[i]->getInputSeq()});
 
             Soldier* soldier = dynamic_cast < Soldier* >(players[i]);
 
             if (soldier)
             {
                 deque < Weapon* > weapons = soldier->getWeapons();
-                vector < string > tmp;
+                vector < int > tmp;
 
                 for (size_t j = 0; j < weapons.size(); j++)
                 {
-                    tmp.push_back(weapons[j]->getName());
+                    tmp.push_back(weapons[j]->getNetID());
                 }
 
                 if (!tmp.empty())
@@ -83,124 +84,159 @@ void PlayerDataCollector::collect(vector < Player* > players)
     }
 }
 
-string PlayerDataCollector::getData(int client, bool position, bool health, bool weapons, bool raw) const
+XMLElement* PlayerDataCollector::getSoldierElement(XMLDocument& doc, int playerID, bool position, bool health, bool weapons) const
 {
-    if (playerIDs.empty())
+    XMLElement* soldierElem = doc.NewElement("soldier");
+
+    /* playerID */
+    soldierElem->SetAttribute("id", playerID);
+   
+    if (health)
     {
-        return "";
-    }
+        XMLElement* healthElem = doc.NewElement("health");
+        healthElem->SetAttribute("health", healths[playerID]);
 
-    XMLDocument playerDataCollectorDoc;
-    
-    /* root */
-    XMLNode* root = playerDataCollectorDoc.NewElement("Soldiers");
-    playerDataCollectorDoc.InsertFirstChild(root);
+        soldierElem->InsertEndChild(healthElem);
+    }
 
-    for (size_t i = 0; i < playerIDs.size(); i++)
+    if (position)
     {
-        XMLElement* soldierElem = playerDataCollectorDoc.NewElement("soldier");
-
-        /* playerID */
-        soldierElem->SetAttribute("id", playerIDs[i]);
-       
-        if (health)
-        {
-            XMLElement* healthElem = playerDataCollectorDoc.NewElement("health");
-            healthElem->SetAttribute("health", healths[playerIDs[i]]);
+        /* the owner reconciles its prediction against it */
+        soldierElem->SetAttribute("inp", inputSeqs[playerID]);
 
-            soldierElem->InsertEndChild(healthElem);
-        }
+        /* moveDirection */
+        XMLElement* moveDirectionElem = doc.NewElement("dir");
+        moveDirectionElem->SetAttribute("x", global.cutFloat(moveDirections[playerID].x(), 4));
+        moveDirectionElem->SetAttribute("y", global.cutFloat(moveDirections[playerID].y(), 4));
+        moveDirectionElem->SetAttribute("z", global.cutFloat(moveDirections[playerID].z(), 4));
 
-        if (position)
-        {
-            /* moveDirection */
-            XMLElement* moveDirectionElem = playerDataCollectorDoc.NewElement("dir");
-            moveDirectionElem->SetAttribute("x", global.cutFloat(moveDirections[playerIDs[i]].x(), 4));
-            moveDirectionElem->SetAttribute("y", global.cutFloat(moveDirections[playerIDs[i]].y(), 4));
-            moveDirectionElem->SetAttribute("z", global.cutFloat(moveDirections[playerIDs[i]].z(), 4));
+        soldierElem->InsertEndChild(moveDirectionElem);
 
-            soldierElem->InsertEndChild(moveDirectionElem);
+        /* obj */
+        XMLElement* objElem = doc.NewElement("obj");
 
-            /* obj */
-            XMLElement* objElem = playerDataCollectorDoc.NewElement("obj");
+        objElem->SetAttribute("name", names[playerID].c_str());
 
-            objElem->SetAttribute("name", names[playerIDs[i]].c_str());
+        /* model */
+        XMLElement* modelElem = doc.NewElement("mdl");
 
-            /* model */
-            XMLElement* modelElem = playerDataCollectorDoc.NewElement("mdl");
+        for (int j = 0; j < 16; j++)
+        {
+            string str;
+            str = char('a' + j);
 
-            for (int j = 0; j < 16; j++)
-            {
-                string str;
-                str = char('a' + j);
+            modelElem->SetAttribute(str.data(), global.cutFloat(models[playerID][j], 4));
+        }
 
-                modelElem->SetAttribute(str.data(), global.cutFloat(models[playerIDs[i]][j], 4));
-            }
+        objElem->InsertEndChild(modelElem);
 
-            objElem->InsertEndChild(modelElem);
+        soldierElem->InsertEndChild(objElem);
+    }
 
-            soldierElem->InsertEndChild(objElem);
-        }
+    /* weapons */
+    if (weapons && !pickedWeapons.empty())
+    {
+        XMLElement* armoryElem = doc.NewElement("armory");
 
-        /* weapons */
-        if (weapons && !pickedWeapons.empty())
+        for (size_t j = 0; j < pickedWeapons[playerID].size(); j++)
         {
-            XMLElement* armoryElem = playerDataCollectorDoc.NewElement("armory");
+            XMLElement* weaponElem = doc.NewElement("weapon");
+            weaponElem->SetText(pickedWeapons[playerID][j]);
 
-            for (size_t j = 0; j < pickedWeapons[playerIDs[i]].size(); j++)
-            {
-                XMLElement* weaponElem = playerDataCollectorDoc.NewElement("weapon");
-                weaponElem->SetText(pickedWeapons[playerIDs[i]][j].data());
-
-                armoryElem->InsertEndChild(weaponElem);
-            }
-
-            soldierElem->InsertEndChild(armoryElem);
+            armoryElem->InsertEndChild(weaponElem);
         }
 
-        root->InsertEndChild(soldierElem);
+        soldierElem->InsertEndChild(armoryElem);
     }
 
-    /* printer */
-    XMLPrinter playerDataCollectorPrinter;
-    playerDataCollectorDoc.Print(&playerDataCollectorPrinter);
+    return soldierElem;
+}
 
-    string res = playerDataCollectorPrinter.CStr();
+const string& PlayerDataCollector::getPrinted(bool position, bool health, bool weapons) const
+{
+    int variant = position | health << 1 | weapons << 2;
 
-    if (res == last[client])
+    /* the document is the same for every client */
+    if (printed.find(variant) == printed.end())
     {
-        return "";
-    }
-    else
-    {
-        last[client] = res;
+        XMLDocument playerDataCollectorDoc;
+        
+        /* root */
+        XMLNode* root = playerDataCollectorDoc.NewElement("Soldiers");
+        playerDataCollectorDoc.InsertFirstChild(root);
+
+        for (size_t i = 0; i < playerIDs.size(); i++)
+        {
+            root->InsertEndChild(getSoldierElement(playerDataCollectorDoc, playerIDs[i], position, health, weapons));
+        }
+
+        /* printer */
+        XMLPrinter playerDataCollectorPrinter;
+        playerDataCollectorDoc.Print(&playerDataCollectorPrinter);
+
+        printed[variant] = playerDataCollectorPrinter.CStr();
     }
 
+    return printed[variant];
+}
+
+string PlayerDataCollector::finishData(const string& data) const
+{
     /* timestamp */
-    XMLElement* timeElem = playerDataCollectorDoc.NewElement("time");
+    XMLDocument timeDoc;
+    XMLElement* timeElem = timeDoc.NewElement("time");
     timeElem->SetAttribute("time", global.getTime());
-    playerDataCollectorDoc.InsertFirstChild(timeElem);
+    timeElem->SetAttribute("tick", tick);
+    timeDoc.InsertFirstChild(timeElem);
 
-    playerDataCollectorPrinter.ClearBuffer();
-    playerDataCollectorDoc.Print(&playerDataCollectorPrinter);
+    XMLPrinter timePrinter;
+    timeDoc.Print(&timePrinter);
+
+    string res = "";
+
+    res += timePrinter.CStr();
+    res += data;
+
+    return res; 
+}
+
+string PlayerDataCollector::getData(int client, bool position, bool health, bool weapons) const
+{
+    shared_ptr < const string > res = getSharedData(client, position, health, weapons);
+
+    return res ? *res : "";
+}
+
+shared_ptr < const string > PlayerDataCollector::getSharedData(int client, bool position, bool health, bool weapons) const
+{
+    if (playerIDs.empty())
+    {
+        return nullptr;
+    }
 
-    res = "";
+    const string& data = getPrinted(position, health, weapons);
 
-    if (!raw)
+    if (data == last[client])
     {
-        res += "BEG\n";
-        res += playerDataCollectorPrinter.CStr();
-        res += "END";
+        return nullptr;
     }
     else
     {
-        res += playerDataCollectorPrinter.CStr();
+        last[client] = data;
     }
 
-    return res; 
+    int variant = position | health << 1 | weapons << 2;
+
+    /* built once, every client gets the same buffer */
+    if (messages.find(variant) == messages.end())
+    {
+        messages[variant] = make_shared < const string >(finishData(data));
+    }
+
+    return messages[variant];
 }
 
-string PlayerDataCollector::getMergedData(string fileName, int client, bool position, bool health, bool weapons, bool raw) const
+string PlayerDataCollector::getMergedData(string fileName, int client, bool position, bool health, bool weapons) const
 {
     if (playerIDs.empty())
     {
@@ -219,12 +255,15 @@ string PlayerDataCollector::getMergedData(string fileName, int client, bool posi
     }
 
     XMLElement* soldierElem = root->FirstChildElement("soldier");
+    vector < int > merged;
 
     while (soldierElem)
     {
         int id = 0;
         soldierElem->QueryIntAttribute("id", &id);
 
+        merged.push_back(id);
+
         if (find(playerIDs.begin(), playerIDs.end(), id) == playerIDs.end())
         {
             XMLElement* tmp = soldierElem;
@@ -325,7 +364,7 @@ string PlayerDataCollector::getMergedData(string fileName, int client, bool posi
             for (size_t j = 0; j < pickedWeapons[id].size(); j++)
             {
                 XMLElement* weaponElem = playerDataCollectorDoc.NewElement("weapon");
-                weaponElem->SetText(pickedWeapons[id][j].data());
+                weaponElem->SetText(pickedWeapons[id][j]);
 
                 armoryElem->InsertEndChild(weaponElem);
             }
@@ -336,6 +375,15 @@ string PlayerDataCollector::getMergedData(string fileName, int client, bool posi
         soldierElem = soldierElem->NextSiblingElement();
     }
 
+    /* players the file has no soldier for */
+    for (size_t i = 0; i < playerIDs.size(); i++)
+    {
+        if (find(merged.begin(), merged.end(), playerIDs[i]) == merged.end())
+        {
+            root->InsertEndChild(getSoldierElement(playerDataCollectorDoc, playerIDs[i], position, health, weapons));
+        }
+    }
+
     /* printer */
     XMLPrinter playerDataCollectorPrinter;
     playerDataCollectorDoc.Print(&playerDataCollectorPrinter);
@@ -351,36 +399,19 @@ string PlayerDataCollector::getMergedData(string fileName, int client, bool posi
         last[client] = res;
     }
 
-    /* timestamp */
-    XMLElement* timeElem = playerDataCollectorDoc.NewElement("time");
-    timeElem->SetAttribute("time", global.getTime());
-    playerDataCollectorDoc.InsertFirstChild(timeElem);
-
-    playerDataCollectorPrinter.ClearBuffer();
-    playerDataCollectorDoc.Print(&playerDataCollectorPrinter);
-
-    res = "";
-
-    if (!raw)
-    {
-        res += "BEG\n";
-        res += playerDataCollectorPrinter.CStr();
-        res += "END";
-    }
-    else
-    {
-        res += playerDataCollectorPrinter.CStr();
-    }
-
-    return res; 
+    return finishData(res);
 }
 
 void PlayerDataCollector::clear()
 {
     playerIDs.clear();
+    names.clear();
+    printed.clear();
+    messages.clear();
     moveDirections.clear();
     pickedWeapons.clear();
     healths.clear();
+    inputSeqs.clear();
 
     for (auto& i: models)
     {   
@@ -4,6 +4,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
 
 #include <tinyxml2/tinyxml2.h>
 
@@ -15,22 +16,36 @@ class PlayerDataCollector
     private:
         vector < int > playerIDs;
 
-        vector < string > names;
+        mutable map < int, string > names;
         mutable map < int, btScalar* > models;
         mutable map < int, btVector3 > moveDirections;
-        mutable map < int, vector < string > > pickedWeapons;
+        mutable map < int, vector < int > > pickedWeapons;
         mutable map < int, int > healths;
+        mutable map < int, unsigned int > inputSeqs;
+
+        /* printed once per collect, shared by all the clients */
+        mutable map < int, string > printed;
+        mutable map < int, shared_ptr < const string > > messages;
 
         mutable vector < string > last;
 
+        unsigned int tick;
+
+        XMLElement* getSoldierElement(XMLDocument& doc, int playerID, bool position, bool health, bool weapons) const;
+        const string& getPrinted(bool position, bool health, bool weapons) const;
+        string finishData(const string& data) const;
+
     public:
         PlayerDataCollector(int clients);
 
-        void collect(Player* player);
+        void setTick(unsigned int tick);
+
+        void collect(const SoldierState& soldier);
         void collect(vector < Player* > players);
 
-        string getData(int client, bool position = true, bool health = false, bool weapons = false, bool raw = false) const;
-        string getMergedData(string fileName, int client, bool posotion = true, bool health = false, bool weapons = false, bool raw = false) const;
+        string getData(int client, bool position = true, bool health = false, bool weapons = false) const;
+        shared_ptr < const string > getSharedData(int client, bool position = true, bool health = false, bool weapons = false) const;
+        string getMergedData(string fileName, int client, bool posotion = true, bool health = false, bool weapons = false) const;
 
         void clear();
         void clearLast(int client);
@@ -9,15 +9,9 @@
 
 #include "playerdataupdater.hpp"
         
-PlayerDataUpdater::PlayerDataUpdater()
-{
-    playerID = 0;
-    model = new btScalar[16];
-    memset(model, 0, sizeof(btScalar) * 16);
-    moveDirection = btVector3(0, 0, 0);
-}
+PlayerDataUpdater::PlayerDataUpdater() {}
 
-void PlayerDataUpdater::collect(string info)
+void PlayerDataUpdater::collect(const string& info, PlayerData& data) const
 {
     XMLDocument playerDataUpdaterDoc;
     
@@ -28,64 +22,76 @@ void PlayerDataUpdater::collect(string info)
 
     if (!root)
     {
-        playerDataUpdaterDoc.PrintError();
-        cout << info << endl << endl;
         throw runtime_error("ERROR::PlayerDataUpdater::collect() failed to load XML");
     }
 
+    data.playerID = 0;
+    data.inputs.clear();
+
     /* playerID */
     XMLElement* playerIDElem = root->FirstChildElement("id");
     
     if (playerIDElem)
     {
-        playerIDElem->QueryIntText(&playerID);
+        playerIDElem->QueryIntText(&data.playerID);
     }
 
-    /* model */
-    XMLElement* modelElem = root->FirstChildElement("mdl");
+    /* input commands */
+    XMLElement* inputElem = root->FirstChildElement("in");
 
-    for (int i = 0; i < 16; i++)
+    while (inputElem)
     {
-        string str;
-        str = char('a' + i);
+        InputCommand input;
 
-        modelElem->QueryFloatAttribute(str.data(), &model[i]);
-    }
-    
-    /* moveDirection */
-    XMLElement* moveDirectionElem = root->FirstChildElement("dir");
-    
-    if (moveDirectionElem)
-    {
-        float x, y, z;
+        float x = 0, z = 0;
+        float qx = 0, qy = 0, qz = 0, qw = 1;
 
-        moveDirectionElem->QueryFloatAttribute("x", &x);
-        moveDirectionElem->QueryFloatAttribute("y", &y);
-        moveDirectionElem->QueryFloatAttribute("z", &z);
+        input.seq = 0;
+        input.jump = false;
+        input.time = 0.0;
 
-        moveDirection = btVector3(x, y, z);
-    }
-}
+        inputElem->QueryUnsignedAttribute("s", &input.seq);
+        inputElem->QueryFloatAttribute("x", &x);
+        inputElem->QueryFloatAttribute("z", &z);
+        inputElem->QueryBoolAttribute("j", &input.jump);
+        inputElem->QueryFloatAttribute("t", &input.time);
 
-void PlayerDataUpdater::updateData(Player* player)
-{
-    player->getPhysicsObject()->setTransform(model);
+        inputElem->QueryFloatAttribute("qx", &qx);
+        inputElem->QueryFloatAttribute("qy", &qy);
+        inputElem->QueryFloatAttribute("qz", &qz);
+        inputElem->QueryFloatAttribute("qw", &qw);
 
-    player->setMoveDirection(moveDirection);
-}
+        /* nothing the client says can be faster than walking */
+        input.moveDirection = btVector3(x, 0, z);
 
-int PlayerDataUpdater::getPlayerID() const
-{
-    return playerID;
-}
-        
-void PlayerDataUpdater::clear()
-{
-    playerID = 0;
-    memset(model, 0, sizeof(btScalar) * 16);
+        if (input.moveDirection.length2() > 1.0)
+        {
+            input.moveDirection.normalize();
+        }
+
+        input.time = max(float(PLAYER_INPUT_MIN_TIME), min(input.time, float(PLAYER_INPUT_MAX_TIME)));
+
+        input.rotation = btQuaternion(qx, qy, qz, qw);
+
+        if (input.rotation.length2() < 0.5)
+        {
+            input.rotation = btQuaternion(0, 0, 0, 1);
+        }
+
+        input.rotation.normalize();
+
+        data.inputs.push_back(input);
+
+        inputElem = inputElem->NextSiblingElement("in");
+    }
 }
 
-PlayerDataUpdater::~PlayerDataUpdater() 
+void PlayerDataUpdater::updateData(PlayerData& data, Player* player)
 {
-    delete[] model;
+    for (size_t i = 0; i < data.inputs.size(); i++)
+    {
+        player->pushInput(data.inputs[i]);
+    }
 }
+
+PlayerDataUpdater::~PlayerDataUpdater() {}
@@ -9,24 +9,23 @@
 using namespace std;
 using namespace tinyxml2;
 
-class PlayerDataUpdater
+/* a parsed <Player> message, the input commands of a few client frames */
+struct PlayerData
 {
-    private:
-        int playerID;
+    int playerID;
 
-        btScalar* model;
-        btVector3 moveDirection;
-        
+    vector < InputCommand > inputs;
+};
+
+/* collect() only parses and may run on any thread, updateData() touches the level */
+class PlayerDataUpdater
+{
     public:
         PlayerDataUpdater();
 
-        void collect(string info);
-
-        void updateData(Player* player);
-
-        int getPlayerID() const;
+        void collect(const string& info, PlayerData& data) const;
 
-        void clear();
+        void updateData(PlayerData& data, Player* player);
         
         ~PlayerDataUpdater();
 };
@@ -74,9 +74,7 @@ string PlayerDisconnectionCollector::getData(int client) const
 
     res = "";
 
-    res += "BEG\n";
     res += playerDisconnectionCollectorPrinter.CStr();
-    res += "END";
 
     return res;
 }
@@ -0,0 +1,269 @@
+#include "../global/globaluse.hpp"
+
+#include "../world/raytracer.hpp"
+#include "../world/bulletevents.hpp"
+#include "../world/world.hpp"
+
+#include "../physics_object/openglmotionstate.hpp"
+#include "../physics_object/physicsobject.hpp"
+#include "../physics_object/weapon.hpp"
+
+#include "../player/player.hpp"
+#include "../player/soldier.hpp"
+
+#include "posehistory.hpp"
+
+PoseHistory::PoseHistory(int slots)
+{
+    frames.resize(POSE_HISTORY_DEPTH);
+
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        frames[i].tick = 0;
+        frames[i].poses.reserve(slots);
+    }
+
+    latest = 0;
+}
+
+const PoseHistory::Frame* PoseHistory::getFrame(unsigned int tick) const
+{
+    /* no rewinding into the future or past the history */
+    if (tick > latest || tick == 0)
+    {
+        tick = latest;
+    }
+    else if (latest - tick >= POSE_HISTORY_DEPTH)
+    {
+        tick = latest - POSE_HISTORY_DEPTH + 1;
+    }
+
+    const Frame& frame = frames[tick % POSE_HISTORY_DEPTH];
+
+    if (frame.tick != tick)
+    {
+        return nullptr;
+    }
+
+    return &frame;
+}
+
+btScalar PoseHistory::raySphere(const btVector3& from, const btVector3& dir, const btVector3& center, btScalar radius) const
+{
+    btVector3 oc = from - center;
+
+    btScalar b = oc.dot(dir);
+    btScalar c = oc.dot(oc) - radius * radius;
+    btScalar h = b * b - c;
+
+    if (h < 0)
+    {
+        return -1;
+    }
+
+    return -b - sqrt(h);
+}
+
+btScalar PoseHistory::rayCapsule(const btVector3& from, const btVector3& dir, const Pose& pose) const
+{
+    btVector3 axis = pose.transform.getBasis().getColumn(pose.upAxis) * pose.halfHeight;
+
+    btVector3 a = pose.transform.getOrigin() - axis;
+    btVector3 b = pose.transform.getOrigin() + axis;
+
+    btVector3 ba = b - a;
+    btVector3 oa = from - a;
+
+    btScalar baba = ba.dot(ba);
+    btScalar bard = ba.dot(dir);
+    btScalar baoa = ba.dot(oa);
+    btScalar rdoa = dir.dot(oa);
+    btScalar oaoa = oa.dot(oa);
+
+    /* cylinder body */
+    btScalar k2 = baba - bard * bard;
+
+    if (baba > SIMD_EPSILON && k2 > SIMD_EPSILON)
+    {
+        btScalar k1 = baba * rdoa - baoa * bard;
+        btScalar k0 = baba * oaoa - baoa * baoa - pose.radius * pose.radius * baba;
+        btScalar h = k1 * k1 - k2 * k0;
+
+        if (h < 0)
+        {
+            return -1;
+        }
+
+        btScalar t = (-k1 - sqrt(h)) / k2;
+        btScalar y = baoa + t * bard;
+
+        if (y > 0 && y < baba)
+        {
+            return t;
+        }
+
+        /* one of the caps */
+        return raySphere(from, dir, y <= 0 ? a : b, pose.radius);
+    }
+
+    /* degenerate capsule or a ray along the axis, the closest cap decides */
+    btScalar ta = raySphere(from, dir, a, pose.radius);
+    btScalar tb = raySphere(from, dir, b, pose.radius);
+
+    if (ta < 0 || (tb >= 0 && tb < ta))
+    {
+        return tb;
+    }
+
+    return ta;
+}
+
+void PoseHistory::record(unsigned int tick, const vector < Player* >& players)
+{
+    unique_lock < mutex > lk(mtx);
+
+    Frame& frame = frames[tick % POSE_HISTORY_DEPTH];
+
+    frame.tick = tick;
+    frame.poses.clear();
+
+    for (size_t i = 0; i < players.size(); i++)
+    {
+        if (!players[i]->isConnected() || !players[i]->getPhysicsObject() || !players[i]->getPhysicsObject()->getRigidBody())
+        {
+            continue;
+        }
+
+        /* the dead lie there without collisions, a shot goes through them */
+        Soldier* soldier = dynamic_cast < Soldier* >(players[i]);
+
+        if (soldier && soldier->getHealth() <= 0)
+        {
+            continue;
+        }
+
+        btRigidBody* body = players[i]->getPhysicsObject()->getRigidBody();
+
+        Pose pose;
+
+        pose.playerID = players[i]->getID();
+        pose.body = body;
+        pose.transform = body->getWorldTransform();
+
+        btCollisionShape* shape = body->getCollisionShape();
+        btCapsuleShape* capsule = dynamic_cast < btCapsuleShape* >(shape);
+        btCompoundShape* compound = dynamic_cast < btCompoundShape* >(shape);
+
+        /* soldiers are a compound, the capsule child is the body and the head sits on its cap */
+        for (int j = 0; compound && !capsule && j < compound->getNumChildShapes(); j++)
+        {
+            capsule = dynamic_cast < btCapsuleShape* >(compound->getChildShape(j));
+
+            if (capsule)
+            {
+                pose.transform = pose.transform * compound->getChildTransform(j);
+            }
+        }
+
+        if (capsule)
+        {
+            pose.radius = capsule->getRadius();
+            pose.halfHeight = capsule->getHalfHeight();
+            pose.upAxis = capsule->getUpAxis();
+        }
+        else
+        {
+            /* anything else is approximated by its bounding sphere */
+            btVector3 center;
+
+            shape->getBoundingSphere(center, pose.radius);
+            pose.halfHeight = 0;
+            pose.upAxis = 1;
+        }
+
+        frame.poses.push_back(pose);
+    }
+
+    latest = tick;
+}
+
+unsigned int PoseHistory::getLatestTick() const
+{
+    unique_lock < mutex > lk(mtx);
+
+    return latest;
+}
+
+bool PoseHistory::rayTest(unsigned int tick, btRigidBody* me, btVector3 rayFrom, btVector3 rayTo, PoseHit& hit) const
+{
+    unique_lock < mutex > lk(mtx);
+
+    const Frame* frame = getFrame(tick);
+
+    btScalar length = rayFrom.distance(rayTo);
+
+    if (!frame || length < SIMD_EPSILON)
+    {
+        return false;
+    }
+
+    btVector3 dir = (rayTo - rayFrom) / length;
+
+    hit.playerID = -1;
+    hit.distance = length;
+
+    for (size_t i = 0; i < frame->poses.size(); i++)
+    {
+        const Pose& pose = frame->poses[i];
+
+        if (pose.body == me)
+        {
+            continue;
+        }
+
+        /* broadphase, the sphere around the whole capsule */
+        btScalar bound = raySphere(rayFrom, dir, pose.transform.getOrigin(), pose.radius + pose.halfHeight);
+
+        if (bound < 0 && rayFrom.distance(pose.transform.getOrigin()) > pose.radius + pose.halfHeight)
+        {
+            continue;
+        }
+
+        if (bound > hit.distance)
+        {
+            continue;
+        }
+
+        btScalar distance = rayCapsule(rayFrom, dir, pose);
+
+        if (distance >= 0 && distance < hit.distance)
+        {
+            hit.playerID = pose.playerID;
+            hit.distance = distance;
+        }
+    }
+
+    if (hit.playerID < 0)
+    {
+        return false;
+    }
+
+    hit.hitPoint = rayFrom + dir * hit.distance;
+
+    return true;
+}
+
+void PoseHistory::clear()
+{
+    unique_lock < mutex > lk(mtx);
+
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        frames[i].tick = 0;
+        frames[i].poses.clear();
+    }
+
+    latest = 0;
+}
+
+PoseHistory::~PoseHistory() {}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <mutex>
+
+#include <bullet/btBulletCollisionCommon.h>
+#include <bullet/btBulletDynamicsCommon.h>
+
+#define POSE_HISTORY_DEPTH 64 /* ticks, about a second at the default tickrate */
+
+using namespace std;
+
+struct PoseHit
+{
+    int playerID;
+    btScalar distance;
+    btVector3 hitPoint;
+};
+
+/*
+ * ring buffer of the soldier hit capsules, one frame per tick.
+ * a shot is tested against the poses of the tick the shooter was looking at,
+ * a bounding sphere rejects the soldiers the ray can't reach before the exact capsule test
+ */
+class PoseHistory
+{
+    private:
+        struct Pose
+        {
+            int playerID;
+            btRigidBody* body;
+            btTransform transform;
+
+            btScalar radius;
+            btScalar halfHeight;
+            int upAxis;
+        };
+
+        struct Frame
+        {
+            unsigned int tick;
+            vector < Pose > poses;
+        };
+
+        vector < Frame > frames;
+        unsigned int latest;
+
+        mutable mutex mtx;
+
+        const Frame* getFrame(unsigned int tick) const;
+
+        btScalar raySphere(const btVector3& from, const btVector3& dir, const btVector3& center, btScalar radius) const;
+        btScalar rayCapsule(const btVector3& from, const btVector3& dir, const Pose& pose) const;
+
+    public:
+        PoseHistory(int slots);
+
+        void record(unsigned int tick, const vector < Player* >& players);
+
+        unsigned int getLatestTick() const;
+
+        bool rayTest(unsigned int tick, btRigidBody* me, btVector3 rayFrom, btVector3 rayTo, PoseHit& hit) const;
+
+        void clear();
+
+        ~PoseHistory();
+};
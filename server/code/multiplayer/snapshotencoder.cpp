@@ -0,0 +1,653 @@
+#include "../global/globaluse.hpp"
+
+#include "../world/raytracer.hpp"
+#include "../world/bulletevents.hpp"
+#include "../world/world.hpp"
+
+#include "../physics_object/openglmotionstate.hpp"
+#include "../physics_object/physicsobject.hpp"
+#include "../physics_object/weapon.hpp"
+
+#include "../player/player.hpp"
+#include "../player/soldier.hpp"
+
+#include "../level/spawner.hpp"
+#include "../level/levelloader.hpp"
+#include "../level/level.hpp"
+
+#include "interestgrid.hpp"
+#include "worldsnapshot.hpp"
+#include "snapshotencoder.hpp"
+
+SnapshotEncoder::SnapshotEncoder(int clients, bool enabled)
+{
+    this->enabled = enabled;
+    this->tick = 0;
+
+    interestGrid = nullptr;
+    budget = 0;
+
+    versions.resize(clients, 0);
+    soldierChannels.resize(clients, {0, 0, {}});
+    objChannels.resize(clients, {0, 0, {}});
+}
+
+SnapshotEncoder::Entity SnapshotEncoder::quantize(const btScalar* model) const
+{
+    Entity entity;
+    memset(&entity, 0, sizeof(Entity));
+
+    btTransform transform;
+    transform.setFromOpenGLMatrix(model);
+
+    btVector3 origin = transform.getOrigin();
+
+    for (int i = 0; i < 3; i++)
+    {
+        entity.position[i] = (int)lround(origin[i] * SNAPSHOT_POSITION_SCALE);
+    }
+
+    entity.rotation = packRotation(transform.getRotation());
+
+    return entity;
+}
+
+unsigned int SnapshotEncoder::packRotation(btQuaternion rotation) const
+{
+    rotation.normalize();
+
+    btScalar q[4] = {rotation.x(), rotation.y(), rotation.z(), rotation.w()};
+
+    int largest = 0;
+
+    for (int i = 1; i < 4; i++)
+    {
+        if (fabs(q[i]) > fabs(q[largest]))
+        {
+            largest = i;
+        }
+    }
+
+    /* q and -q are the same rotation, keep the dropped component positive */
+    btScalar sign = q[largest] < 0 ? -1.0 : 1.0;
+
+    unsigned int res = largest;
+
+    for (int i = 0; i < 4; i++)
+    {
+        if (i == largest)
+        {
+            continue;
+        }
+
+        btScalar value = q[i] * sign * M_SQRT2;
+        value = max(btScalar(-1.0), min(btScalar(1.0), value));
+
+        res = (res << 10) | (unsigned int)lround((value + 1.0) * 0.5 * 1023.0);
+    }
+
+    return res;
+}
+
+void SnapshotEncoder::writeVarint(string& out, unsigned int value) const
+{
+    while (value >= 0x80)
+    {
+        out += char((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+
+    out += char(value);
+}
+
+void SnapshotEncoder::writeSignedVarint(string& out, int value) const
+{
+    writeVarint(out, ((unsigned int)value << 1) ^ (unsigned int)(value >> 31));
+}
+
+void SnapshotEncoder::collect(const string& info, ProtoData& data) const
+{
+    XMLDocument negotiateDoc;
+
+    negotiateDoc.Parse(info.c_str());
+
+    /* root */
+    XMLNode* root = negotiateDoc.FirstChildElement("Proto");
+
+    if (!root)
+    {
+        throw runtime_error("ERROR::SnapshotEncoder::collect() failed to load Proto XML");
+    }
+
+    data.client = -1;
+    data.version = 0;
+
+    XMLElement* idElem = root->FirstChildElement("id");
+
+    if (idElem)
+    {
+        idElem->QueryIntText(&data.client);
+    }
+
+    XMLElement* snapElem = root->FirstChildElement("snap");
+
+    if (snapElem)
+    {
+        snapElem->QueryIntText(&data.version);
+    }
+}
+
+void SnapshotEncoder::negotiate(const ProtoData& data)
+{
+    int client = data.client;
+
+    if (client < 0 || client >= (int)versions.size())
+    {
+        return;
+    }
+
+    unique_lock < mutex > lk(mtx);
+
+    versions[client] = (enabled && data.version == SNAPSHOT_VERSION) ? data.version : 0;
+
+    soldierChannels[client] = {0, 0, {}};
+    objChannels[client] = {0, 0, {}};
+}
+
+void SnapshotEncoder::collect(const string& info, AckData& data) const
+{
+    XMLDocument acknowledgeDoc;
+
+    acknowledgeDoc.Parse(info.c_str());
+
+    /* root */
+    XMLNode* root = acknowledgeDoc.FirstChildElement("Ack");
+
+    if (!root)
+    {
+        throw runtime_error("ERROR::SnapshotEncoder::collect() failed to load Ack XML");
+    }
+
+    data.client = -1;
+    data.soldiersSeq = 0;
+    data.objsSeq = 0;
+
+    XMLElement* idElem = root->FirstChildElement("id");
+
+    if (idElem)
+    {
+        idElem->QueryIntText(&data.client);
+    }
+
+    XMLElement* soldiersElem = root->FirstChildElement("soldiers");
+
+    if (soldiersElem)
+    {
+        soldiersElem->QueryUnsignedText(&data.soldiersSeq);
+    }
+
+    XMLElement* objsElem = root->FirstChildElement("objs");
+
+    if (objsElem)
+    {
+        objsElem->QueryUnsignedText(&data.objsSeq);
+    }
+}
+
+void SnapshotEncoder::acknowledge(const AckData& data)
+{
+    int client = data.client;
+
+    if (client < 0 || client >= (int)versions.size())
+    {
+        return;
+    }
+
+    unique_lock < mutex > lk(mtx);
+
+    Channel* channels[2] = {&soldierChannels[client], &objChannels[client]};
+    unsigned int seqs[2] = {data.soldiersSeq, data.objsSeq};
+
+    for (int i = 0; i < 2; i++)
+    {
+        if (seqs[i] <= channels[i]->acked || seqs[i] > channels[i]->seq)
+        {
+            continue;
+        }
+
+        channels[i]->acked = seqs[i];
+
+        /* nothing older than the acked snapshot can be a baseline anymore */
+        while (!channels[i]->history.empty() && channels[i]->history.front().seq < seqs[i])
+        {
+            channels[i]->history.pop_front();
+        }
+    }
+}
+
+bool SnapshotEncoder::isEnabled() const
+{
+    return enabled;
+}
+
+bool SnapshotEncoder::isBinary(int client) const
+{
+    unique_lock < mutex > lk(mtx);
+
+    return client >= 0 && client < (int)versions.size() && versions[client] > 0;
+}
+
+void SnapshotEncoder::setInterest(InterestGrid* interestGrid, int budget)
+{
+    this->interestGrid = interestGrid;
+    this->budget = budget;
+}
+
+void SnapshotEncoder::setTick(unsigned int tick)
+{
+    this->tick = tick;
+}
+
+void SnapshotEncoder::collect(const SoldierState& soldier, bool respawn)
+{
+    Entity entity = quantize(soldier.model);
+
+    for (int i = 0; i < 3; i++)
+    {
+        btScalar value = max(btScalar(-1.0), min(btScalar(1.0), soldier.moveDirection[i]));
+        entity.direction[i] = (signed char)lround(value * 127.0);
+    }
+
+    entity.id = soldier.id;
+    entity.ownerID = soldier.id;
+    entity.mask = POSITION | ROTATION | DIRECTION | HEALTH | INPUT;
+
+    entity.health = soldier.health;
+    entity.input = soldier.inputSeq;
+    entity.force = respawn;
+
+    soldiers[to_string(entity.id)] = entity;
+}
+
+void SnapshotEncoder::collect(const ObjectState& object)
+{
+    Entity entity = quantize(object.model);
+
+    entity.id = object.netID;
+    entity.ownerID = object.ownerID;
+    entity.mask = POSITION | ROTATION;
+
+    objs[object.name] = entity;
+}
+
+void SnapshotEncoder::keep(const string& name)
+{
+    kept.insert(name);
+}
+
+float SnapshotEncoder::getPriority(const Entity& entity, const Entity& prev, unsigned char flags, int client, const string& key) const
+{
+    /* respawns and the own soldier can't wait */
+    if (entity.force || entity.ownerID == client)
+    {
+        return SNAPSHOT_PRIORITY_MAX;
+    }
+
+    float change = 0.0;
+
+    if (flags & POSITION)
+    {
+        if (prev.mask & POSITION)
+        {
+            float distance = 0.0;
+
+            for (int i = 0; i < 3; i++)
+            {
+                float delta = (entity.position[i] - prev.position[i]) / SNAPSHOT_POSITION_SCALE;
+                distance += delta * delta;
+            }
+
+            change += sqrt(distance);
+        }
+        else
+        {
+            change += 1.0;
+        }
+    }
+
+    if (flags & (ROTATION | DIRECTION))
+    {
+        change += 0.1;
+    }
+
+    if (flags & HEALTH)
+    {
+        change += 1.0;
+    }
+
+    float closeness = 1.0;
+
+    if (interestGrid)
+    {
+        closeness = max(0.1f, 1.0f - interestGrid->getDistance(client, key) / interestGrid->getRadius());
+    }
+
+    return (1.0 + change) * closeness;
+}
+
+void SnapshotEncoder::writeEntity(string& out, const Entity& entity, const Entity& prev, unsigned char flags) const
+{
+    /* player id or level net id */
+    writeVarint(out, entity.id);
+
+    out += char(flags);
+
+    if (flags & POSITION)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            writeSignedVarint(out, entity.position[j] - ((prev.mask & POSITION) ? prev.position[j] : 0));
+        }
+    }
+
+    if (flags & ROTATION)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            out += char((entity.rotation >> (j * 8)) & 0xFF);
+        }
+    }
+
+    if (flags & DIRECTION)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            out += char(entity.direction[j]);
+        }
+    }
+
+    if (flags & HEALTH)
+    {
+        writeSignedVarint(out, entity.health);
+    }
+
+    if (flags & INPUT)
+    {
+        writeVarint(out, entity.input);
+    }
+}
+
+string SnapshotEncoder::getData(Channel& channel, char kind, const map < string, Entity >& entities, int client)
+{
+    unique_lock < mutex > lk(mtx);
+
+    /* baseline */
+    const State* base = nullptr;
+
+    for (size_t i = 0; i < channel.history.size(); i++)
+    {
+        if (channel.history[i].seq == channel.acked)
+        {
+            base = &channel.history[i];
+            break;
+        }
+    }
+
+    State next;
+    next.seq = channel.seq + 1;
+
+    if (base)
+    {
+        next.entities = base->entities;
+    }
+
+    /* candidates, everything while the client has no soldier to look from */
+    vector < const pair < const string, Entity >* > candidates;
+    set < string > relevantKeys;
+
+    bool interest = interestGrid && interestGrid->hasViewer(client);
+
+    if (interest)
+    {
+        vector < string > relevant = interestGrid->getRelevant(client);
+
+        for (size_t i = 0; i < relevant.size(); i++)
+        {
+            auto it = entities.find(relevant[i]);
+
+            if (it != entities.end())
+            {
+                candidates.push_back(&*it);
+                relevantKeys.insert(it->first);
+            }
+        }
+    }
+    else
+    {
+        for (auto& i: entities)
+        {
+            candidates.push_back(&i);
+        }
+    }
+
+    vector < Pending > pending;
+
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+        const string& key = candidates[i]->first;
+        Entity entity = candidates[i]->second;
+
+        if (entity.ownerID == client)
+        {
+            /* the owner simulates it himself */
+            if (kind == 'O')
+            {
+                continue;
+            }
+
+            /* the owner predicts its soldier, it only needs where the server has it and how far that is in its input */
+            if (!entity.force)
+            {
+                entity.mask &= ~(ROTATION | DIRECTION);
+            }
+        }
+        else
+        {
+            entity.mask &= ~INPUT;
+        }
+
+        Entity prev;
+        memset(&prev, 0, sizeof(Entity));
+
+        auto prevIt = next.entities.find(key);
+
+        if (prevIt != next.entities.end())
+        {
+            prev = prevIt->second;
+        }
+
+        unsigned char flags = 0;
+
+        if ((entity.mask & POSITION) && (entity.force || !(prev.mask & POSITION) || memcmp(entity.position, prev.position, sizeof(entity.position))))
+        {
+            flags |= POSITION;
+        }
+
+        if ((entity.mask & ROTATION) && (entity.force || !(prev.mask & ROTATION) || entity.rotation != prev.rotation))
+        {
+            flags |= ROTATION;
+        }
+
+        if ((entity.mask & DIRECTION) && (!(prev.mask & DIRECTION) || memcmp(entity.direction, prev.direction, sizeof(entity.direction))))
+        {
+            flags |= DIRECTION;
+        }
+
+        if ((entity.mask & HEALTH) && (!(prev.mask & HEALTH) || entity.health != prev.health))
+        {
+            flags |= HEALTH;
+        }
+
+        if ((entity.mask & INPUT) && (!(prev.mask & INPUT) || entity.input != prev.input))
+        {
+            flags |= INPUT;
+        }
+
+        if (!flags)
+        {
+            continue;
+        }
+
+        pending.push_back({&key, entity, prev, flags, channel.priorities[key] + getPriority(entity, prev, flags, client, key)});
+    }
+
+    /* most important first, whatever doesn't fit waits with a higher priority */
+    stable_sort(pending.begin(), pending.end(), [](const Pending& a, const Pending& b) { return a.priority > b.priority; });
+
+    string body;
+    unsigned int count = 0;
+
+    /*
+     * gone from the server or out of the interest, they go out until a snapshot without them is acked.
+     * a hidden one leaves the baseline too, so it comes back whole
+     */
+    for (auto it = next.entities.begin(); it != next.entities.end();)
+    {
+        auto entity = entities.find(it->first);
+        unsigned char flags = REMOVED;
+
+        if (entity != entities.end())
+        {
+            if (!interest || relevantKeys.count(it->first) || entity->second.ownerID == client)
+            {
+                it++;
+                continue;
+            }
+
+            flags = HIDDEN;
+        }
+        else if (kind == 'O' && kept.count(it->first))
+        {
+            it++;
+            continue;
+        }
+
+        writeVarint(body, it->second.id);
+        body += char(flags);
+
+        channel.priorities.erase(it->first);
+        it = next.entities.erase(it);
+        count++;
+    }
+
+    for (size_t i = 0; i < pending.size(); i++)
+    {
+        const Pending& entry = pending[i];
+
+        string data;
+        writeEntity(data, entry.entity, entry.prev, entry.flags);
+
+        if (budget > 0 && count && body.size() + data.size() > (size_t)budget)
+        {
+            channel.priorities[*entry.key] = entry.priority;
+            continue;
+        }
+
+        body += data;
+        channel.priorities.erase(*entry.key);
+
+        Entity& merged = next.entities[*entry.key];
+        merged.id = entry.entity.id;
+
+        if (entry.flags & POSITION)
+        {
+            memcpy(merged.position, entry.entity.position, sizeof(merged.position));
+        }
+
+        if (entry.flags & ROTATION)
+        {
+            merged.rotation = entry.entity.rotation;
+        }
+
+        if (entry.flags & DIRECTION)
+        {
+            memcpy(merged.direction, entry.entity.direction, sizeof(merged.direction));
+        }
+
+        if (entry.flags & HEALTH)
+        {
+            merged.health = entry.entity.health;
+        }
+
+        if (entry.flags & INPUT)
+        {
+            merged.input = entry.entity.input;
+        }
+
+        merged.mask = entry.prev.mask | entry.flags;
+        count++;
+    }
+
+    if (!count)
+    {
+        return "";
+    }
+
+    /* header */
+    string res = "#";
+
+    res += char(SNAPSHOT_VERSION);
+    res += kind;
+    writeVarint(res, next.seq);
+    writeVarint(res, base ? base->seq : 0);
+    writeVarint(res, global.getTime());
+    writeVarint(res, tick);
+    writeVarint(res, count);
+    res += body;
+
+    channel.seq = next.seq;
+    channel.history.push_back(move(next));
+
+    if (channel.history.size() > SNAPSHOT_HISTORY)
+    {
+        channel.history.pop_front();
+    }
+
+    return res;
+}
+
+string SnapshotEncoder::getSoldiersData(int client)
+{
+    return getData(soldierChannels[client], 'S', soldiers, client);
+}
+
+string SnapshotEncoder::getObjsData(int client)
+{
+    return getData(objChannels[client], 'O', objs, client);
+}
+
+void SnapshotEncoder::clear()
+{
+    soldiers.clear();
+    objs.clear();
+    kept.clear();
+}
+
+void SnapshotEncoder::clearLast(int client)
+{
+    unique_lock < mutex > lk(mtx);
+
+    versions[client] = 0;
+    soldierChannels[client] = {0, 0, {}};
+    objChannels[client] = {0, 0, {}};
+}
+
+void SnapshotEncoder::clearAllLast()
+{
+    for (size_t i = 0; i < versions.size(); i++)
+    {
+        clearLast(i);
+    }
+}
+
+SnapshotEncoder::~SnapshotEncoder() {}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <mutex>
+
+#include <tinyxml2/tinyxml2.h>
+
+#define SNAPSHOT_VERSION 5
+#define SNAPSHOT_HISTORY 32
+#define SNAPSHOT_POSITION_SCALE 512.0
+#define SNAPSHOT_PRIORITY_MAX 1e9
+
+using namespace std;
+using namespace tinyxml2;
+
+/* a parsed <Proto> message */
+struct ProtoData
+{
+    int client;
+    int version;
+};
+
+/* a parsed <Ack> message */
+struct AckData
+{
+    int client;
+    unsigned int soldiersSeq;
+    unsigned int objsSeq;
+};
+
+/*
+ * binary snapshot wire format (little endian, varints are LEB128, signed ones zigzag):
+ *
+ *  '#' marker, u8 version, u8 kind ('S' soldiers / 'O' objs), varint seq, varint baseSeq (0 = full),
+ *  varint time, varint tick, varint count, then count entries:
+ *
+ *  soldier: varint id, u8 flags, [pos], [rot], [dir], [health], [input]
+ *  obj:     varint net id (sent once at join), u8 flags, [pos], [rot]
+ *  removed: varint id, u8 flags = REMOVED, for an entity of the baseline the server doesn't have anymore
+ *  hidden:  varint id, u8 flags = HIDDEN, for an entity of the baseline out of the client's interest
+ *
+ *  pos    - 3 signed varints, quantized by SNAPSHOT_POSITION_SCALE, delta against the base entity
+ *  rot    - u32, smallest three quaternion (2 bit index + 3 x 10 bit)
+ *  dir    - 3 x s8, move direction * 127
+ *  health - signed varint
+ *  input  - varint, the last input command of the owner the server applied, only to the owner
+ */
+class SnapshotEncoder
+{
+    private:
+        enum Flags
+        {
+            POSITION = 1,
+            ROTATION = 2,
+            DIRECTION = 4,
+            HEALTH = 8,
+            INPUT = 16,
+            REMOVED = 32,
+            HIDDEN = 64
+        };
+
+        struct Entity
+        {
+            int id;
+            int ownerID;
+            bool force;
+            unsigned char mask;
+
+            int position[3];
+            unsigned int rotation;
+            signed char direction[3];
+            int health;
+            unsigned int input;
+        };
+
+        struct State
+        {
+            unsigned int seq;
+            map < string, Entity > entities;
+        };
+
+        struct Channel
+        {
+            unsigned int seq;
+            unsigned int acked;
+            deque < State > history;
+            map < string, float > priorities; /* grows while an entity is left out for the budget */
+        };
+
+        struct Pending
+        {
+            const string* key;
+            Entity entity;
+            Entity prev;
+            unsigned char flags;
+            float priority;
+        };
+
+        bool enabled;
+        unsigned int tick;
+
+        InterestGrid* interestGrid;
+        int budget; /* bytes of one snapshot body, 0 = unlimited */
+
+        vector < int > versions;
+        vector < Channel > soldierChannels;
+        vector < Channel > objChannels;
+
+        map < string, Entity > soldiers;
+        map < string, Entity > objs;
+        set < string > kept; /* objs that exist but aren't sent, never REMOVED */
+
+        mutable mutex mtx;
+
+        Entity quantize(const btScalar* model) const;
+        unsigned int packRotation(btQuaternion rotation) const;
+
+        void writeVarint(string& out, unsigned int value) const;
+        void writeSignedVarint(string& out, int value) const;
+
+        float getPriority(const Entity& entity, const Entity& prev, unsigned char flags, int client, const string& key) const;
+        void writeEntity(string& out, const Entity& entity, const Entity& prev, unsigned char flags) const;
+
+        string getData(Channel& channel, char kind, const map < string, Entity >& entities, int client);
+
+    public:
+        SnapshotEncoder(int clients, bool enabled = true);
+
+        void collect(const string& info, ProtoData& data) const;
+        void collect(const string& info, AckData& data) const;
+
+        void negotiate(const ProtoData& data);
+        void acknowledge(const AckData& data);
+
+        bool isEnabled() const;
+        bool isBinary(int client) const;
+
+        void setInterest(InterestGrid* interestGrid, int budget);
+        void setTick(unsigned int tick);
+
+        void collect(const SoldierState& soldier, bool respawn);
+        void collect(const ObjectState& object);
+        void keep(const string& name);
+
+        string getSoldiersData(int client);
+        string getObjsData(int client);
+
+        void clear();
+        void clearLast(int client);
+        void clearAllLast();
+
+        ~SnapshotEncoder();
+};
@@ -15,25 +15,28 @@ WeaponDataCollector::WeaponDataCollector(int clients)
     last.resize(clients, "");
 }
 
-void WeaponDataCollector::collect(map < string, PhysicsObject* > weapons)
+void WeaponDataCollector::collect(const vector < PhysicsObject* >& weapons)
 {
-    for (auto& i: weapons)
+    for (size_t i = 0; i < weapons.size(); i++)
     {
-        Weapon* weapon = dynamic_cast < Weapon* >(i.second);
+        Weapon* weapon = dynamic_cast < Weapon* >(weapons[i]);
 
         if (weapon)
         {        
-            pos.insert({i.first, weapon->getTransform()});
-            storages.insert({i.first, weapon->getStorageBullets()});
-            sizes.insert({i.first, weapon->getMagazineSize()});
-            magazines.insert({i.first, weapon->getMagazineBullets()});
-            speeds.insert({i.first, weapon->getShotSpeed()});
-            powers.insert({i.first, weapon->getShotPower()});
+            string name = weapon->getName();
+
+            pos.insert({name, weapon->getTransform()});
+            netIDs.insert({name, weapon->getNetID()});
+            storages.insert({name, weapon->getStorageBullets()});
+            sizes.insert({name, weapon->getMagazineSize()});
+            magazines.insert({name, weapon->getMagazineBullets()});
+            speeds.insert({name, weapon->getShotSpeed()});
+            powers.insert({name, weapon->getShotPower()});
         }
     }
 }
 
-string WeaponDataCollector::getMergedData(string fileName, int client, bool raw) const
+string WeaponDataCollector::getMergedData(string fileName, int client) const
 {
     XMLDocument weaponDataCollectorDoc;
 
@@ -53,6 +56,21 @@ string WeaponDataCollector::getMergedData(string fileName, int client, bool raw)
         const char* name = nullptr;
         weaponElem->QueryStringAttribute("name", &name);
 
+        /* network ids of every instance, sent once so the steady messages can refer to them */
+        int quantity = 1;
+        weaponElem->QueryIntAttribute("quantity", &quantity);
+
+        string ids = "";
+
+        for (int j = 0; j < quantity; j++)
+        {
+            auto idIt = netIDs.find(quantity > 1 ? name + to_string(j) : name);
+
+            ids += (j ? " " : "") + to_string(idIt != netIDs.end() ? idIt->second : -1);
+        }
+
+        weaponElem->SetAttribute("ids", ids.data());
+
         XMLElement* positionElem = weaponElem->FirstChildElement("pos");
         
         if (positionElem)
@@ -154,16 +172,7 @@ string WeaponDataCollector::getMergedData(string fileName, int client, bool raw)
 
     res = "";
 
-    if (!raw)
-    {
-        res += "BEG\n";
-        res += weaponDataCollectorPrinter.CStr();
-        res += "END";
-    }
-    else
-    {
-        res += weaponDataCollectorPrinter.CStr();
-    }
+    res += weaponDataCollectorPrinter.CStr();
 
     return res;
 }
@@ -176,6 +185,7 @@ void WeaponDataCollector::clear()
     }
 
     pos.clear();
+    netIDs.clear();
     storages.clear();
     sizes.clear();
     magazines.clear();
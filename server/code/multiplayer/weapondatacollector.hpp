@@ -14,6 +14,7 @@ class WeaponDataCollector
 {
     private:
         mutable map < string, btScalar* > pos;
+        map < string, int > netIDs;
         mutable map < string, int > storages;
         mutable map < string, int > sizes;
         mutable map < string, int > magazines;
@@ -25,9 +26,9 @@ class WeaponDataCollector
     public:
         WeaponDataCollector(int clients);
 
-        void collect(map < string, PhysicsObject* > physicsObjects);
+        void collect(const vector < PhysicsObject* >& physicsObjects);
 
-        string getMergedData(string fileName, int client, bool raw = false) const;
+        string getMergedData(string fileName, int client) const;
 
         void clear(); 
         void clearLast(int client);
@@ -11,6 +11,11 @@
 #include "../player/player.hpp"
 #include "../player/soldier.hpp"
 
+#include "../level/spawner.hpp"
+#include "../level/levelloader.hpp"
+#include "../level/level.hpp"
+
+#include "worldsnapshot.hpp"
 #include "weapondroppercollector.hpp"
 
 WeaponDropperCollector::WeaponDropperCollector(int clients)
@@ -19,94 +24,99 @@ WeaponDropperCollector::WeaponDropperCollector(int clients)
     last.resize(clients, "");
 }
 
-void WeaponDropperCollector::collect(Player* player)
+void WeaponDropperCollector::collect(int playerID, const vector < int >& netIDs)
 {
-    Soldier* soldier = dynamic_cast < Soldier* >(player);
-
-    if (!soldier)
-    {
-        throw(runtime_error("ERROR::WeaponDropperCollector::collect() player is not a soldier"));
-    }
-
-    playerID = soldier->getPhysicsObject()->getOwnerID();
-
-    deque < Weapon* > old_weapons = soldier->getOldWeapons();
+    this->playerID = playerID;
+    this->netIDs.insert(this->netIDs.end(), netIDs.begin(), netIDs.end());
+}
 
-    for (size_t i = 0; i < old_weapons.size(); i++)
-    {
-        names.push_back(old_weapons[i]->getName());
-    }
+string WeaponDropperCollector::getData(int client) const
+{
+    shared_ptr < const string > res = getSharedData(client);
 
-    soldier->oldToNothing();
+    return res ? *res : "";
 }
 
-string WeaponDropperCollector::getData(int client) const
+shared_ptr < const string > WeaponDropperCollector::getSharedData(int client) const
 {   
-    if (names.empty())
+    if (netIDs.empty())
     {
-        return "";
+        return nullptr;
     }
 
-    XMLDocument weaponDropperCollectorDoc;
+    /* the document is the same for every client */
+    if (printed.empty())
+    {
+        XMLDocument weaponDropperCollectorDoc;
 
-    /* root */
-    XMLNode* root = weaponDropperCollectorDoc.NewElement("Drop");
-    weaponDropperCollectorDoc.InsertFirstChild(root);
-    
-    /* playerID */
-    XMLElement* playerIDElem = weaponDropperCollectorDoc.NewElement("id");
-    playerIDElem->SetText(playerID);
+        /* root */
+        XMLNode* root = weaponDropperCollectorDoc.NewElement("Drop");
+        weaponDropperCollectorDoc.InsertFirstChild(root);
+        
+        /* playerID */
+        XMLElement* playerIDElem = weaponDropperCollectorDoc.NewElement("id");
+        playerIDElem->SetText(playerID);
 
-    root->InsertEndChild(playerIDElem);
+        root->InsertEndChild(playerIDElem);
 
-    /* weapons */
-    XMLElement* weaponsElem = weaponDropperCollectorDoc.NewElement("wpns");
+        /* weapons */
+        XMLElement* weaponsElem = weaponDropperCollectorDoc.NewElement("wpns");
 
-    for (size_t i = 0; i < names.size(); i++)
-    {
-        XMLElement* nameElem = weaponDropperCollectorDoc.NewElement("name");
-        nameElem->SetText(names[i].data());
+        for (size_t i = 0; i < netIDs.size(); i++)
+        {
+            XMLElement* weaponElem = weaponDropperCollectorDoc.NewElement("wpn");
+            weaponElem->SetText(netIDs[i]);
 
-        weaponsElem->InsertEndChild(nameElem);
-    }
+            weaponsElem->InsertEndChild(weaponElem);
+        }
 
-    root->InsertEndChild(weaponsElem);
+        root->InsertEndChild(weaponsElem);
 
-    /* printer */
-    XMLPrinter weaponDropperCollectorPrinter;
-    weaponDropperCollectorDoc.Print(&weaponDropperCollectorPrinter);
+        /* printer */
+        XMLPrinter weaponDropperCollectorPrinter;
+        weaponDropperCollectorDoc.Print(&weaponDropperCollectorPrinter);
 
-    string res = weaponDropperCollectorPrinter.CStr();
+        printed = weaponDropperCollectorPrinter.CStr();
+    }
 
-    if (res == last[client])
+    if (printed == last[client])
     {
-        return "";
+        return nullptr;
     }
     else
     {
-        last[client] = res;
+        last[client] = printed;
     }
     
-    /* timestamp */
-    XMLElement* timeElem = weaponDropperCollectorDoc.NewElement("time");
-    timeElem->SetAttribute("time", global.getTime());
-    weaponDropperCollectorDoc.InsertFirstChild(timeElem);
-    
-    weaponDropperCollectorPrinter.ClearBuffer();
-    weaponDropperCollectorDoc.Print(&weaponDropperCollectorPrinter);
+    /* built once, every client gets the same buffer */
+    if (!message)
+    {
+        /* timestamp */
+        XMLDocument timeDoc;
+        XMLElement* timeElem = timeDoc.NewElement("time");
+        timeElem->SetAttribute("time", global.getTime());
+        timeDoc.InsertFirstChild(timeElem);
+
+        XMLPrinter timePrinter;
+        timeDoc.Print(&timePrinter);
 
-    res = "";
+        string res = "";
 
-    res += "BEG\n";
-    res += weaponDropperCollectorPrinter.CStr();
-    res += "END";
+        res += timePrinter.CStr();
+        res += printed;
 
-    return res;
+        message = make_shared < const string >(move(res));
+    }
+
+    return message;
 }
 
 void WeaponDropperCollector::clear()
 {
-    names.clear();
+    netIDs.clear();
+
+    printed = "";
+    message = nullptr;
 }
 
 void WeaponDropperCollector::clearLast(int client)
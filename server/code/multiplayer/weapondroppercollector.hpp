@@ -4,6 +4,7 @@
 #include <vector>
 #include <deque>
 #include <map>
+#include <memory>
 #include <string>
 
 #include <tinyxml2/tinyxml2.h>
@@ -16,16 +17,21 @@ class WeaponDropperCollector
     private:
         int playerID;
 
-        vector < string > names;
+        vector < int > netIDs;
+
+        /* printed once per collect, shared by all the clients */
+        mutable string printed;
+        mutable shared_ptr < const string > message;
 
         mutable vector < string > last;
 
     public:
         WeaponDropperCollector(int clients);
 
-        void collect(Player* player);
+        void collect(int playerID, const vector < int >& netIDs);
 
         string getData(int client) const;
+        shared_ptr < const string > getSharedData(int client) const;
 
         void clear();
         void clearLast(int client);
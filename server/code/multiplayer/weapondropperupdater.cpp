@@ -13,14 +13,9 @@
 
 #include "weapondropperupdater.hpp"
 
-WeaponDropperUpdater::WeaponDropperUpdater()
-{
-    playerID = 0;
-    model = new btScalar[16];
-    memset(model, 0, sizeof(btScalar) * 16);
-}
+WeaponDropperUpdater::WeaponDropperUpdater() {}
 
-void WeaponDropperUpdater::collect(string info)
+void WeaponDropperUpdater::collect(const string& info, DropData& data) const
 {
     XMLDocument weaponDropperUpdaterDoc;
     
@@ -31,32 +26,37 @@ void WeaponDropperUpdater::collect(string info)
 
     if (!root)
     {
-        weaponDropperUpdaterDoc.PrintError();
-        cout << info << endl << endl;
         throw runtime_error("ERROR::WeaponDropperUpdater::collect() failed to load XML");
     }
 
+    data.playerID = 0;
+
     /* playerID */
     XMLElement* playerIDElem = root->FirstChildElement("id");
     
     if (playerIDElem)
     {
-        playerIDElem->QueryIntText(&playerID);
+        playerIDElem->QueryIntText(&data.playerID);
     }
 
     /* model */
     XMLElement* modelElem = root->FirstChildElement("mdl");
 
+    if (!modelElem)
+    {
+        throw runtime_error("ERROR::WeaponDropperUpdater::collect() no model");
+    }
+
     for (int i = 0; i < 16; i++)
     {
-        string str;
-        str = char('a' + i);
+        char name[2] = {char('a' + i), 0};
 
-        modelElem->QueryFloatAttribute(str.data(), &model[i]);
+        data.model[i] = 0;
+        modelElem->QueryFloatAttribute(name, &data.model[i]);
     }
 }
 
-void WeaponDropperUpdater::updateData(Player* player)
+void WeaponDropperUpdater::updateData(DropData& data, Player* player)
 {
     Soldier* soldier = dynamic_cast < Soldier* >(player);
 
@@ -65,21 +65,7 @@ void WeaponDropperUpdater::updateData(Player* player)
         throw(runtime_error("ERROR::WeaponDropperUPdater::updatedata() player is not a soldier"));
     }
 
-    soldier->drop(model);
-}
-
-int WeaponDropperUpdater::getPlayerID() const
-{
-    return playerID;
+    soldier->drop(data.model);
 }
 
-void WeaponDropperUpdater::clear()
-{
-    playerID = 0;
-    memset(model, 0, sizeof(btScalar) * 16);
-}
-
-WeaponDropperUpdater::~WeaponDropperUpdater()
-{
-    delete[] model;
-}
+WeaponDropperUpdater::~WeaponDropperUpdater() {}
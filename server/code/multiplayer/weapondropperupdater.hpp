@@ -10,23 +10,22 @@
 using namespace std;
 using namespace tinyxml2;
 
-class WeaponDropperUpdater
+/* a parsed <Drop> message */
+struct DropData
 {
-    private:
-        int playerID;
+    int playerID;
 
-        btScalar* model;
+    btScalar model[16];
+};
 
+class WeaponDropperUpdater
+{
     public:
         WeaponDropperUpdater();
 
-        void collect(string info);
-
-        void updateData(Player* player);
-
-        int getPlayerID() const;
+        void collect(const string& info, DropData& data) const;
 
-        void clear();
+        void updateData(DropData& data, Player* player);
 
         ~WeaponDropperUpdater();
 };
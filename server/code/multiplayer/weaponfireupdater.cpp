@@ -11,16 +11,21 @@
 #include "../player/player.hpp"
 #include "../player/soldier.hpp"
 
+#include "../level/spawner.hpp"
+#include "../level/levelloader.hpp"
+#include "../level/level.hpp"
+
+#include "posehistory.hpp"
 #include "weaponfireupdater.hpp"
 
 WeaponFireUpdater::WeaponFireUpdater(World* world)
 {
-    playerID = 0;
+    delay = 0;
     this->world = world;
     rayTracer = new RayTracer(world->getWorld());
 }
 
-void WeaponFireUpdater::collect(string info)
+void WeaponFireUpdater::collect(const string& info, FireData& data) const
 {
     XMLDocument weaponFireUpdaterDoc;
     
@@ -31,25 +36,43 @@ void WeaponFireUpdater::collect(string info)
 
     if (!root)
     {
-        weaponFireUpdaterDoc.PrintError();
-        cout << info << endl << endl;
         throw runtime_error("ERROR::WeaponFireUpdater::collect() failed to load XML");
     }
 
+    data.playerID = 0;
+    data.tick = 0;
+
+    data.fireInfo.clear();
+    data.reloadInfo.clear();
+
     /* playerID */
     XMLElement* playerIDElem = root->FirstChildElement("id");
     
     if (playerIDElem)
     {
-        playerIDElem->QueryIntText(&playerID);
+        playerIDElem->QueryIntText(&data.playerID);
+    }
+
+    /* the server tick the shooter was looking at */
+    XMLElement* tickElem = root->FirstChildElement("tick");
+
+    if (tickElem)
+    {
+        tickElem->QueryUnsignedText(&data.tick);
     }
 
     XMLElement* weaponElem = root->FirstChildElement("wpn");
     
     while (weaponElem)
     {
-        XMLElement* nameElem = weaponElem->FirstChildElement("name");
-        const char* name = nameElem->GetText();
+        int netID = -1;
+
+        XMLElement* netIDElem = weaponElem->FirstChildElement("id");
+
+        if (netIDElem)
+        {
+            netIDElem->QueryIntText(&netID);
+        }
 
         vector < pair < btVector3, btVector3 > > bullets;
         
@@ -59,9 +82,9 @@ void WeaponFireUpdater::collect(string info)
         {
             const char* reload = reloadElem->GetText();
             
-            if (!strcmp(reload, "1"))
+            if (reload && !strcmp(reload, "1"))
             {
-                reloadInfo.insert({name, true});
+                data.reloadInfo.insert({netID, true});
             }
         }
 
@@ -69,7 +92,7 @@ void WeaponFireUpdater::collect(string info)
 
         while (bulletElem)
         {
-            btVector3 from, to;
+            btVector3 from(0, 0, 0), to(0, 0, 0);
 
             /* pickFrom */
             XMLElement* fromElem = bulletElem->FirstChildElement("frm");
@@ -106,38 +129,56 @@ void WeaponFireUpdater::collect(string info)
 
         if (!bullets.empty())
         {
-            fireInfo.insert({name, bullets});
+            data.fireInfo.insert({netID, bullets});
         }
 
         weaponElem = weaponElem->NextSiblingElement();
     }
 }
 
-void WeaponFireUpdater::updateData(Player* player, map < string, PhysicsObject* > physicsObjects)
+void WeaponFireUpdater::setDelay(unsigned int delay)
 {
-    for (auto &i : fireInfo)
-    {
-        auto it = physicsObjects.find(i.first);
+    this->delay = delay;
+}
 
-        if (it == physicsObjects.end())
+void WeaponFireUpdater::updateData(FireData& data, Player* player, Level* level, PoseHistory* poseHistory)
+{
+    btRigidBody* me = player->getPhysicsObject()->getRigidBody();
+
+    /* soldiers are hit in the past, only the rest of the world blocks the shot now */
+    soldiers.clear();
+    vector < Player* > players = level->getPlayers();
+
+    for (size_t i = 0; i < players.size(); i++)
+    {
+        if (players[i]->getPhysicsObject())
         {
-            continue;
+            soldiers.push_back(players[i]->getPhysicsObject()->getRigidBody());
         }
+    }
 
-        Weapon* WE = dynamic_cast < Weapon* >(it->second);
+    /* the client renders the others one snapshot behind the tick it got */
+    unsigned int rewind = data.tick > delay ? data.tick - delay : data.tick;
+
+    queries.clear();
+    powers.clear();
+
+    for (auto &i : data.fireInfo)
+    {
+        Weapon* WE = dynamic_cast < Weapon* >(level->getPhysicsObject(i.first));
 
         if (!WE)
         {
             continue;
         }
 
-        auto jt = reloadInfo.find(i.first);
+        auto jt = data.reloadInfo.find(i.first);
 
-        if (jt != reloadInfo.end())
+        if (jt != data.reloadInfo.end())
         {
             WE->reload();
 
-            reloadInfo.erase(i.first);
+            data.reloadInfo.erase(jt);
         }
 
         for (auto &j : i.second)
@@ -148,40 +189,43 @@ void WeaponFireUpdater::updateData(Player* player, map < string, PhysicsObject*
                 break;
             }
 
-            unique_ptr < RayResult > result(rayTracer->rayCast(player->getPhysicsObject()->getRigidBody(), j.first, j.second, false));
-
-            if (!result.get())
-            {
-                continue;
-            }
+            queries.push_back({j.first, j.first + j.second.normalized() * RAYTRACER_DISTANCE});
+            powers.push_back(WE->getShotPower());
+        }
+    }
 
-            PhysicsObject* PO = static_cast < PhysicsObject* >(result->body->getUserPointer());
-            
-            //cout << PO->getName() << endl;
+    /* all the bullets of the message in one pass */
+    if (results.size() < queries.size())
+    {
+        results.resize(queries.size());
+    }
 
-            if (!PO->getUserPointer())
-            {
-                continue;
-            }
+    rayTracer->rayCast(queries, results, soldiers, false);
 
-            Soldier* soldier = static_cast < Soldier* >(PO->getUserPointer());
+    for (size_t i = 0; i < queries.size(); i++)
+    {
+        btVector3 rayTo = results[i].body ? results[i].hitPoint : queries[i].to;
 
-            int dmg = WE->getShotPower();
+        PoseHit hit;
 
-            soldier->damage(dmg);
+        if (!poseHistory->rayTest(rewind, me, queries[i].from, rayTo, hit))
+        {
+            continue;
         }
-    }
-    
-    for (auto &i : reloadInfo)
-    {
-        auto it = physicsObjects.find(i.first);
 
-        if (it == physicsObjects.end())
+        Soldier* soldier = dynamic_cast < Soldier* >(level->getPlayer(hit.playerID));
+
+        if (!soldier)
         {
             continue;
         }
 
-        Weapon* WE = dynamic_cast < Weapon* >(it->second);
+        soldier->damage(powers[i]);
+    }
+    
+    for (auto &i : data.reloadInfo)
+    {
+        Weapon* WE = dynamic_cast < Weapon* >(level->getPhysicsObject(i.first));
 
         if (!WE)
         {
@@ -192,19 +236,6 @@ void WeaponFireUpdater::updateData(Player* player, map < string, PhysicsObject*
     }
 }
 
-int WeaponFireUpdater::getPlayerID() const
-{
-    return playerID;
-}
-
-void WeaponFireUpdater::clear()
-{
-    playerID = 0;
-
-    fireInfo.clear();
-    reloadInfo.clear();
-}
-
 WeaponFireUpdater::~WeaponFireUpdater()
 {
     delete rayTracer;
@@ -10,27 +10,38 @@
 using namespace std;
 using namespace tinyxml2;
 
+/* a parsed <Fire> message */
+struct FireData
+{
+    int playerID;
+    unsigned int tick; /* the server tick the shooter was looking at */
+
+    map < int, vector < pair < btVector3, btVector3 > > > fireInfo;
+    map < int, bool > reloadInfo;
+};
+
 class WeaponFireUpdater
 {
     private:
         World* world;
         RayTracer* rayTracer;
 
-        int playerID;
-       
-        map < string, vector < pair < btVector3, btVector3 > > > fireInfo;
-        map < string, bool > reloadInfo;
+        unsigned int delay;
+
+        /* kept between the messages so a shot doesn't allocate */
+        vector < btRigidBody* > soldiers;
+        vector < RayQuery > queries;
+        vector < RayResult > results;
+        vector < int > powers;
 
     public:
         WeaponFireUpdater(World* world);
 
-        void collect(string info);
-
-        void updateData(Player* player, map < string, PhysicsObject* > physicsObjects);
+        void collect(const string& info, FireData& data) const;
 
-        int getPlayerID() const;
+        void setDelay(unsigned int delay);
 
-        void clear();
+        void updateData(FireData& data, Player* player, Level* level, PoseHistory* poseHistory);
 
         ~WeaponFireUpdater();
 };
@@ -11,6 +11,11 @@
 #include "../player/player.hpp"
 #include "../player/soldier.hpp"
 
+#include "../level/spawner.hpp"
+#include "../level/levelloader.hpp"
+#include "../level/level.hpp"
+
+#include "worldsnapshot.hpp"
 #include "weaponpickercollector.hpp"
 
 WeaponPickerCollector::WeaponPickerCollector(int clients)
@@ -19,94 +24,99 @@ WeaponPickerCollector::WeaponPickerCollector(int clients)
     last.resize(clients, "");
 }
 
-void WeaponPickerCollector::collect(Player* player)
+void WeaponPickerCollector::collect(int playerID, const vector < int >& netIDs)
 {
-    Soldier* soldier = dynamic_cast < Soldier* >(player);
-
-    if (!soldier)
-    {
-        throw(runtime_error("ERROR::WeaponPickerCollector::collect() player is not a soldier"));
-    }
-
-    playerID = soldier->getPhysicsObject()->getOwnerID();
-
-    deque < Weapon* > new_weapons = soldier->getNewWeapons();
+    this->playerID = playerID;
+    this->netIDs.insert(this->netIDs.end(), netIDs.begin(), netIDs.end());
+}
 
-    for (int i = (int)new_weapons.size() - 1; i >= 0; i--)
-    {
-        names.push_back(new_weapons[i]->getName());
-    }
+string WeaponPickerCollector::getData(int client) const
+{
+    shared_ptr < const string > res = getSharedData(client);
 
-    soldier->newToWeapons();
+    return res ? *res : "";
 }
 
-string WeaponPickerCollector::getData(int client) const
+shared_ptr < const string > WeaponPickerCollector::getSharedData(int client) const
 {   
-    if (names.empty())
+    if (netIDs.empty())
     {
-        return "";
+        return nullptr;
     }
 
-    XMLDocument weaponPickerCollectorDoc;
+    /* the document is the same for every client */
+    if (printed.empty())
+    {
+        XMLDocument weaponPickerCollectorDoc;
 
-    /* root */
-    XMLNode* root = weaponPickerCollectorDoc.NewElement("Pick");
-    weaponPickerCollectorDoc.InsertFirstChild(root);
-    
-    /* playerID */
-    XMLElement* playerIDElem = weaponPickerCollectorDoc.NewElement("id");
-    playerIDElem->SetText(playerID);
+        /* root */
+        XMLNode* root = weaponPickerCollectorDoc.NewElement("Pick");
+        weaponPickerCollectorDoc.InsertFirstChild(root);
+        
+        /* playerID */
+        XMLElement* playerIDElem = weaponPickerCollectorDoc.NewElement("id");
+        playerIDElem->SetText(playerID);
 
-    root->InsertEndChild(playerIDElem);
+        root->InsertEndChild(playerIDElem);
 
-    /* weapons */
-    XMLElement* weaponsElem = weaponPickerCollectorDoc.NewElement("wpns");
+        /* weapons */
+        XMLElement* weaponsElem = weaponPickerCollectorDoc.NewElement("wpns");
 
-    for (size_t i = 0; i < names.size(); i++)
-    {
-        XMLElement* nameElem = weaponPickerCollectorDoc.NewElement("name");
-        nameElem->SetText(names[i].data());
+        for (size_t i = 0; i < netIDs.size(); i++)
+        {
+            XMLElement* weaponElem = weaponPickerCollectorDoc.NewElement("wpn");
+            weaponElem->SetText(netIDs[i]);
 
-        weaponsElem->InsertEndChild(nameElem);
-    }
+            weaponsElem->InsertEndChild(weaponElem);
+        }
 
-    root->InsertEndChild(weaponsElem);
+        root->InsertEndChild(weaponsElem);
 
-    /* printer */
-    XMLPrinter weaponPickerCollectorPrinter;
-    weaponPickerCollectorDoc.Print(&weaponPickerCollectorPrinter);
+        /* printer */
+        XMLPrinter weaponPickerCollectorPrinter;
+        weaponPickerCollectorDoc.Print(&weaponPickerCollectorPrinter);
 
-    string res = weaponPickerCollectorPrinter.CStr();
+        printed = weaponPickerCollectorPrinter.CStr();
+    }
 
-    if (res == last[client])
+    if (printed == last[client])
     {
-        return "";
+        return nullptr;
     }
     else
     {
-        last[client] = res;
+        last[client] = printed;
     }
-
-    /* timestamp */
-    XMLElement* timeElem = weaponPickerCollectorDoc.NewElement("time");
-    timeElem->SetAttribute("time", global.getTime());
-    weaponPickerCollectorDoc.InsertFirstChild(timeElem);
     
-    weaponPickerCollectorPrinter.ClearBuffer();
-    weaponPickerCollectorDoc.Print(&weaponPickerCollectorPrinter);
+    /* built once, every client gets the same buffer */
+    if (!message)
+    {
+        /* timestamp */
+        XMLDocument timeDoc;
+        XMLElement* timeElem = timeDoc.NewElement("time");
+        timeElem->SetAttribute("time", global.getTime());
+        timeDoc.InsertFirstChild(timeElem);
+
+        XMLPrinter timePrinter;
+        timeDoc.Print(&timePrinter);
 
-    res = "";
+        string res = "";
 
-    res += "BEG\n";
-    res += weaponPickerCollectorPrinter.CStr();
-    res += "END";
+        res += timePrinter.CStr();
+        res += printed;
 
-    return res;
+        message = make_shared < const string >(move(res));
+    }
+
+    return message;
 }
 
 void WeaponPickerCollector::clear()
 {
-    names.clear();
+    netIDs.clear();
+
+    printed = "";
+    message = nullptr;
 }
 
 void WeaponPickerCollector::clearLast(int client)
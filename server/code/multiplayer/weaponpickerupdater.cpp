@@ -15,16 +15,11 @@
 
 WeaponPickerUpdater::WeaponPickerUpdater(World* world)
 {
-    playerID = 0;
     this->world = world;
     rayTracer = new RayTracer(world->getWorld());
-
-    pickFrom = pickTo = btVector3(0, 0, 0);
-
-    weapon = nullptr;
 }
 
-void WeaponPickerUpdater::collect(string info)
+void WeaponPickerUpdater::collect(const string& info, PickData& data) const
 {
     XMLDocument weaponPickerUpdaterDoc;
     
@@ -35,17 +30,18 @@ void WeaponPickerUpdater::collect(string info)
 
     if (!root)
     {
-        weaponPickerUpdaterDoc.PrintError();
-        cout << info << endl << endl;
         throw runtime_error("ERROR::WeaponPickerUpdater::collect() failed to load XML");
     }
 
+    data.playerID = 0;
+    data.pickFrom = data.pickTo = btVector3(0, 0, 0);
+
     /* playerID */
     XMLElement* playerIDElem = root->FirstChildElement("id");
     
     if (playerIDElem)
     {
-        playerIDElem->QueryIntText(&playerID);
+        playerIDElem->QueryIntText(&data.playerID);
     }
 
     /* pickFrom */
@@ -53,13 +49,13 @@ void WeaponPickerUpdater::collect(string info)
     
     if (fromElem)
     {
-        float x, y, z;
+        float x = 0, y = 0, z = 0;
 
         fromElem->QueryFloatAttribute("x", &x);
         fromElem->QueryFloatAttribute("y", &y);
         fromElem->QueryFloatAttribute("z", &z);
 
-        pickFrom = btVector3(x, y, z);
+        data.pickFrom = btVector3(x, y, z);
     }
     
     /* pickTo */
@@ -67,27 +63,27 @@ void WeaponPickerUpdater::collect(string info)
     
     if (toElem)
     {
-        float x, y, z;
+        float x = 0, y = 0, z = 0;
 
         toElem->QueryFloatAttribute("x", &x);
         toElem->QueryFloatAttribute("y", &y);
         toElem->QueryFloatAttribute("z", &z);
 
-        pickTo = btVector3(x, y, z);
+        data.pickTo = btVector3(x, y, z);
     }
 }
 
-void WeaponPickerUpdater::updateData(Player* player)
+void WeaponPickerUpdater::updateData(PickData& data, Player* player)
 {
     /* rayTracer */
-    unique_ptr < RayResult > result(rayTracer->rayCast(player->getPhysicsObject()->getRigidBody(), pickFrom, pickTo, false));
+    unique_ptr < RayResult > result(rayTracer->rayCast(player->getPhysicsObject()->getRigidBody(), data.pickFrom, data.pickTo, false));
 
     if (!result.get())
     {
         return;
     }
 
-    float dist = (pickFrom - result->hitPoint).length();
+    float dist = (data.pickFrom - result->hitPoint).length();
 
     int optimalDistance = 20;
 
@@ -96,7 +92,7 @@ void WeaponPickerUpdater::updateData(Player* player)
         return;
     }
 
-    weapon = dynamic_cast < Weapon* >(static_cast < PhysicsObject* >(result->body->getUserPointer()));
+    Weapon* weapon = dynamic_cast < Weapon* >(static_cast < PhysicsObject* >(result->body->getUserPointer()));
 
     Soldier* soldier = dynamic_cast < Soldier* >(player);
 
@@ -114,19 +110,6 @@ void WeaponPickerUpdater::updateData(Player* player)
     }
 }
 
-int WeaponPickerUpdater::getPlayerID() const
-{
-    return playerID;
-}
-
-void WeaponPickerUpdater::clear()
-{
-    playerID = 0;
-    pickFrom = pickTo = btVector3(0, 0, 0);
-
-    weapon = nullptr;
-}
-
 WeaponPickerUpdater::~WeaponPickerUpdater()
 {
     delete rayTracer;
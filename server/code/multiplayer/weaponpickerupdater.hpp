@@ -10,28 +10,27 @@
 using namespace std;
 using namespace tinyxml2;
 
+/* a parsed <Pick> message */
+struct PickData
+{
+    int playerID;
+
+    btVector3 pickFrom;
+    btVector3 pickTo;
+};
+
 class WeaponPickerUpdater
 {
     private:
         World* world;
         RayTracer* rayTracer;
 
-        int playerID;
-        btVector3 pickFrom;
-        btVector3 pickTo;
-        
-        Weapon* weapon;
-
     public:
         WeaponPickerUpdater(World* world);
 
-        void collect(string info);
-
-        void updateData(Player* player);
-
-        int getPlayerID() const;
+        void collect(const string& info, PickData& data) const;
 
-        void clear();
+        void updateData(PickData& data, Player* player);
 
         ~WeaponPickerUpdater();
 };
@@ -0,0 +1,173 @@
+#include "../global/globaluse.hpp"
+
+#include "../world/raytracer.hpp"
+#include "../world/bulletevents.hpp"
+#include "../world/world.hpp"
+
+#include "../physics_object/openglmotionstate.hpp"
+#include "../physics_object/physicsobject.hpp"
+#include "../physics_object/weapon.hpp"
+
+#include "../player/player.hpp"
+#include "../player/soldier.hpp"
+
+#include "../level/spawner.hpp"
+#include "../level/levelloader.hpp"
+#include "../level/level.hpp"
+
+#include "worldsnapshot.hpp"
+
+WorldSnapshot::WorldSnapshot()
+{
+    tick = 0;
+}
+
+void WorldSnapshot::capture(unsigned int tick, Level* level, const vector < int >& clientSockets, const vector < unsigned int >& sessions)
+{
+    this->tick = tick;
+    this->clientSockets = clientSockets;
+    this->sessions = sessions;
+
+    /* soldiers */
+    soldiers.clear();
+
+    vector < Player* > players = level->getPlayers();
+
+    for (size_t i = 0; i < players.size(); i++)
+    {
+        Soldier* soldier = dynamic_cast < Soldier* >(players[i]);
+
+        if (!soldier || !soldier->isConnected() || !soldier->getPhysicsObject())
+        {
+            continue;
+        }
+
+        PhysicsObject* physicsObject = soldier->getPhysicsObject();
+
+        SoldierState state;
+
+        state.id = soldier->getID();
+        state.ownerID = physicsObject->getOwnerID();
+        state.name = physicsObject->getName();
+
+        btScalar* model = physicsObject->getTransform();
+        memcpy(state.model, model, sizeof(state.model));
+        delete[] model;
+
+        state.position = physicsObject->getRigidBody()->getCenterOfMassPosition();
+        state.moveDirection = soldier->getMoveDirection();
+        state.health = soldier->getHealth();
+        state.inputSeq = soldier->getInputSeq();
+
+        deque < Weapon* > weapons = soldier->getWeapons();
+
+        for (size_t j = 0; j < weapons.size(); j++)
+        {
+            state.weapons.push_back(weapons[j]->getNetID());
+        }
+
+        soldiers.push_back(state);
+
+        /* the events are taken out of the soldier, so every one goes out exactly once */
+        SoldierEvents& soldierEvents = events[state.id];
+
+        if (soldier->isRespawn())
+        {
+            soldierEvents.respawn = true;
+            soldier->setRespawn(false);
+        }
+
+        deque < Weapon* > newWeapons = soldier->getNewWeapons();
+
+        for (int j = (int)newWeapons.size() - 1; j >= 0; j--)
+        {
+            soldierEvents.picked.push_back(newWeapons[j]->getNetID());
+        }
+
+        soldier->newToWeapons();
+
+        deque < Weapon* > oldWeapons = soldier->getOldWeapons();
+
+        for (size_t j = 0; j < oldWeapons.size(); j++)
+        {
+            soldierEvents.dropped.push_back(oldWeapons[j]->getNetID());
+        }
+
+        soldier->oldToNothing();
+    }
+
+    /* objects */
+    objects.clear();
+    idle.clear();
+
+    level->forEachNoPlayersPhysicsObject([this](PhysicsObject* physicsObject)
+    {
+        /* picked weapons point to their soldier */
+        if (physicsObject->getUserPointer() || !physicsObject->isCollidable() || physicsObject->getRigidBody()->isStaticOrKinematicObject())
+        {
+            idle.push_back(physicsObject->getName());
+            return;
+        }
+
+        ObjectState state;
+
+        state.name = physicsObject->getName();
+        state.netID = physicsObject->getNetID();
+        state.ownerID = physicsObject->getOwnerID();
+
+        btScalar* model = physicsObject->getTransform();
+        memcpy(state.model, model, sizeof(state.model));
+        delete[] model;
+
+        state.position = physicsObject->getRigidBody()->getCenterOfMassPosition();
+        state.moving = physicsObject->getRigidBody()->isActive() || state.name.find("weapon") != string::npos;
+
+        objects.push_back(state);
+    });
+}
+
+unsigned int WorldSnapshot::getTick() const
+{
+    return tick;
+}
+
+const vector < int >& WorldSnapshot::getClientSockets() const
+{
+    return clientSockets;
+}
+
+const vector < unsigned int >& WorldSnapshot::getSessions() const
+{
+    return sessions;
+}
+
+const vector < SoldierState >& WorldSnapshot::getSoldiers() const
+{
+    return soldiers;
+}
+
+const vector < ObjectState >& WorldSnapshot::getObjects() const
+{
+    return objects;
+}
+
+const vector < string >& WorldSnapshot::getIdle() const
+{
+    return idle;
+}
+
+const SoldierEvents& WorldSnapshot::getEvents(int id) const
+{
+    static const SoldierEvents none = {false, {}, {}};
+
+    auto it = events.find(id);
+
+    return it == events.end() ? none : it->second;
+}
+
+void WorldSnapshot::clearEvents()
+{
+    events.clear();
+}
+
+WorldSnapshot::~WorldSnapshot() {}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+
+#include <bullet/btBulletCollisionCommon.h>
+
+using namespace std;
+
+/* what the broadcast needs of a connected soldier */
+struct SoldierState
+{
+    int id;
+    int ownerID;
+    string name;
+
+    btScalar model[16];
+    btVector3 position;
+    btVector3 moveDirection;
+
+    int health;
+    vector < int > weapons; /* net ids, the one in hands first */
+
+    unsigned int inputSeq; /* the last input command of the owner the tick applied */
+};
+
+/* a dynamic object that isn't a soldier or carried by one */
+struct ObjectState
+{
+    string name;
+    int netID;
+    int ownerID;
+
+    btScalar model[16];
+    btVector3 position;
+
+    bool moving; /* an active body or a weapon, the XML clients only get these */
+};
+
+/* what happened to a soldier since the last snapshot that went out */
+struct SoldierEvents
+{
+    bool respawn;
+    vector < int > picked; /* net ids, the latest pick first */
+    vector < int > dropped;
+};
+
+/*
+ * the state of the level at the end of a tick, copied out of the live objects by the
+ * simulation so the broadcast never touches them. the simulation fills one, the sender
+ * reads the other without locks, they swap when the sender is done.
+ * the events pile up until a snapshot is taken, the state is always the latest
+ */
+class WorldSnapshot
+{
+    private:
+        unsigned int tick;
+
+        vector < int > clientSockets;
+        vector < unsigned int > sessions; /* per slot, bumped on every join and quit */
+
+        vector < SoldierState > soldiers;
+        vector < ObjectState > objects;
+        vector < string > idle; /* names of the objects that exist but aren't sent, carried weapons and static bodies */
+        map < int, SoldierEvents > events;
+
+    public:
+        WorldSnapshot();
+
+        void capture(unsigned int tick, Level* level, const vector < int >& clientSockets, const vector < unsigned int >& sessions);
+
+        unsigned int getTick() const;
+
+        const vector < int >& getClientSockets() const;
+        const vector < unsigned int >& getSessions() const;
+
+        const vector < SoldierState >& getSoldiers() const;
+        const vector < ObjectState >& getObjects() const;
+        const vector < string >& getIdle() const;
+        const SoldierEvents& getEvents(int id) const;
+
+        void clearEvents();
+
+        ~WorldSnapshot();
+};
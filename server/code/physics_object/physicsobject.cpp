@@ -152,7 +152,8 @@ void PhysicsObject::updateBody(btCollisionShape* shape, float mass, btVector3 po
     body->setMassProps(mass, localInertia); 
     
     physicsWorld->getWorld()->removeRigidBody(body);
-    physicsWorld->getWorld()->addRigidBody(body, group, btBroadphaseProxy::AllFilter);
+    /* static bodies in their own group, rays can leave them out in the broadphase */
+    physicsWorld->getWorld()->addRigidBody(body, mass || group != btBroadphaseProxy::DefaultFilter ? group : btBroadphaseProxy::StaticFilter, btBroadphaseProxy::AllFilter);
     
     body->forceActivationState(ACTIVE_TAG);
 }        
@@ -185,6 +186,7 @@ PhysicsObject::PhysicsObject(string name, World* physicsWorld)
     globalNames.insert(name);
     this->name = name;
     ownerID = -1;
+    netID = -1;
 
     ready = true;
 }
@@ -218,6 +220,7 @@ PhysicsObject::PhysicsObject(string name, World* physicsWorld, btCollisionShape*
     globalNames.insert(name);
     this->name = name;
     ownerID = -1;
+    netID = -1;
     
     ready = true;
 }
@@ -251,6 +254,7 @@ PhysicsObject::PhysicsObject(string name, World* physicsWorld, ConvexHullShape*
     globalNames.insert(name);
     this->name = name;
     ownerID = -1;
+    netID = -1;
     
     ready = true;
 }
@@ -286,6 +290,7 @@ PhysicsObject::PhysicsObject(string name, World* physicsWorld, CompoundShape* sh
     globalNames.insert(name);
     this->name = name;
     ownerID = -1;
+    netID = -1;
     
     ready = true;
 }
@@ -307,6 +312,11 @@ void PhysicsObject::setOwnerID(int ownerID)
     this->ownerID = ownerID;
 }
 
+void PhysicsObject::setNetID(int netID)
+{
+    this->netID = netID;
+}
+
 void PhysicsObject::setShape(btCollisionShape* shape)
 {
     delete this->phShape;
@@ -487,6 +497,11 @@ int PhysicsObject::getOwnerID() const
     return ownerID;
 }
 
+int PhysicsObject::getNetID() const
+{
+    return netID;
+}
+
 float PhysicsObject::getMass() const
 {
     return mass;
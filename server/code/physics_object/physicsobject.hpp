@@ -61,6 +61,7 @@ class PhysicsObject
         string name;
 
         int ownerID;
+        int netID; /* level handle, the name is sent only once at join */
 
         World* physicsWorld;
 
@@ -92,6 +93,7 @@ class PhysicsObject
 
         void setName(string name);
         void setOwnerID(int ownerID);
+        void setNetID(int netID);
         void setShape(btCollisionShape* shape);
         void setShape(ConvexHullShape* shape);
         void setShape(CompoundShape* shape);
@@ -109,6 +111,7 @@ class PhysicsObject
 
         string getName() const;
         int getOwnerID() const;
+        int getNetID() const;
         float getMass() const;
         btCollisionShape* getShape() const;
         ConvexHullShape* getConvexHullShape() const;
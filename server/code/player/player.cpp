@@ -25,6 +25,10 @@ Player::Player(int id, float speed)
     moveDirection = btVector3(0, 0, 0);
     this->connected = false;
 
+    rayTracer = nullptr;
+    inputSeq = 0;
+    inputTime = 0.0;
+
     ready = true;
 }
         
@@ -42,6 +46,11 @@ Player::Player(int id, PhysicsObject* physicsObject, float speed)
 
     this->physicsObject = physicsObject;
     physicsObject->setUserPointer(this);
+
+    moveDirection = btVector3(0, 0, 0);
+    rayTracer = nullptr;
+    inputSeq = 0;
+    inputTime = 0.0;
     
     setConnected(false);
     
@@ -52,6 +61,9 @@ void Player::setConnected(bool connected)
 {
     this->connected = connected;
 
+    /* a new session counts from the start */
+    resetInputs();
+
     if (connected)
     {
         if (physicsObject)
@@ -88,12 +100,284 @@ void Player::removePhysicsObject()
     physicsObject = nullptr;
 }
 
+void Player::setRayTracer(RayTracer* rayTracer)
+{
+    this->rayTracer = rayTracer;
+}
+
 void Player::setMoveDirection(btVector3 moveDirection)
 {
     this->moveDirection = moveDirection;
 }
 
-void Player::update() {}
+bool Player::isGroundStanding()
+{
+    btVector3 Min;
+    btVector3 Max;
+
+    btRigidBody* body = physicsObject->getRigidBody();
+
+    body->getAabb(Min, Max);
+
+    btVector3 center = body->getCenterOfMassPosition();
+
+    float playerBottomDist = center.y() - Min.y();
+
+    Min.setY(center.y());
+    Max.setY(center.y());
+
+    float radius = (Max - Min).length() / (2 * sqrt(2));
+
+    float rayStep = 0.1;
+    float whenFloor = 0.1;
+
+    /* the same rays as the client, or the prediction misses */
+    btVector3 down = btVector3(0, -(playerBottomDist + whenFloor), 0);
+
+    groundQueries.clear();
+
+    for (float i = Min.x(); i < Max.x(); i += rayStep)
+    {
+        for (float j = Min.z(); j < Max.z(); j += rayStep)
+        {
+            btVector3 from = center;
+            from.setX(i);
+            from.setZ(j);
+
+            /* cutting extra bounding box */
+            if ((center - from).length() > radius)
+            {
+                continue;
+            }
+
+            groundQueries.push_back({from, from + down});
+        }
+    }
+
+    if (groundResults.size() < groundQueries.size())
+    {
+        groundResults.resize(groundQueries.size());
+    }
+
+    groundIgnored.assign(1, body);
+
+    return rayTracer->rayCast(groundQueries, groundResults, groundIgnored, false) > 0;
+}
+
+bool Player::isJumpAllowed()
+{
+    btVector3 Min;
+    btVector3 Max;
+
+    btRigidBody* body = physicsObject->getRigidBody();
+
+    body->getAabb(Min, Max);
+
+    btVector3 center = body->getCenterOfMassPosition();
+
+    float playerBottomDist = center.y() - Min.y();
+    float whenFloor = 0.1;
+
+    groundQueries.assign(1, {center, center - btVector3(0, playerBottomDist + whenFloor, 0)});
+
+    if (groundResults.empty())
+    {
+        groundResults.resize(1);
+    }
+
+    groundIgnored.assign(1, body);
+
+    return rayTracer->rayCast(groundQueries, groundResults, groundIgnored, false) > 0;
+}
+
+void Player::jump()
+{
+    if (!isJumpAllowed())
+    {
+        return;
+    }
+
+    float power = 70;
+    float loss = 0.5;
+
+    btRigidBody* body = physicsObject->getRigidBody();
+
+    body->setActivationState(ACTIVE_TAG);
+
+    /* redusing the speed */
+    btVector3 velocity = body->getLinearVelocity();
+    velocity = btVector3(velocity.x() * loss, velocity.y(), velocity.z() * loss);
+    body->setLinearVelocity(velocity);
+
+    body->applyCentralImpulse(btVector3(0, 1, 0) * power);
+}
+
+void Player::moveGround(float scale)
+{
+    float speedFactor = 20;
+    float friction = 1.36;
+
+    btRigidBody* body = physicsObject->getRigidBody();
+
+    /* push the body */
+    body->applyCentralImpulse(btVector3(moveDirection.x(), 0, moveDirection.z()) * speed * speedFactor * scale);
+
+    btVector3 velocity = body->getLinearVelocity();
+
+    /* disable sliding effect */
+    if (velocity.length() < 0.05)
+    {
+        body->setActivationState(WANTS_DEACTIVATION);
+    }
+
+    /* friction, a whole tick of it per step of command time */
+    float slowdown = pow(1.0 / friction, scale);
+
+    velocity = btVector3(velocity.x() * slowdown, velocity.y(), velocity.z() * slowdown);
+
+    body->setLinearVelocity(velocity);
+}
+
+void Player::moveAir(float scale)
+{
+    btRigidBody* body = physicsObject->getRigidBody();
+
+    btVector3 velocity = body->getLinearVelocity();
+    btVector3 XZVelocity = velocity;
+    XZVelocity.setY(0.0);
+
+    float speedFactor = XZVelocity.length() / 2.5 + 2.5;
+
+    /* push the body */
+    body->applyCentralImpulse(btVector3(moveDirection.x(), 0, moveDirection.z()) * speed * speedFactor * scale);
+
+    velocity = body->getLinearVelocity();
+
+    /* enable sliding effect */
+    if (abs(velocity.y()) < 0.05)
+    {
+        body->forceActivationState(ACTIVE_TAG);
+    }
+}
+
+void Player::speedHackControl()
+{
+    float maxSpeed = 4.8;
+
+    btRigidBody* body = physicsObject->getRigidBody();
+
+    btVector3 velocity = body->getLinearVelocity();
+    btVector3 XZVelocity = velocity;
+    XZVelocity.setY(0.0);
+
+    if (XZVelocity.length() > maxSpeed)
+    {
+        btVector3 XZNormVel = XZVelocity;
+        XZNormVel.normalize();
+
+        velocity -= (XZVelocity.length() - maxSpeed) * XZNormVel; 
+
+        body->setLinearVelocity(velocity);
+    }
+}
+
+void Player::move(const InputCommand& input, float scale)
+{
+    moveDirection = input.moveDirection;
+
+    /* the facing is the client's, it doesn't change where the body goes */
+    btTransform transform = physicsObject->getRigidBody()->getWorldTransform();
+
+    if (transform.getRotation() != input.rotation)
+    {
+        transform.setRotation(input.rotation);
+        physicsObject->setTransform(transform);
+    }
+
+    if (input.jump)
+    {
+        jump();
+    }
+
+    if (isGroundStanding())
+    {
+        moveGround(scale);
+    }
+    else
+    {
+        moveAir(scale);
+    }
+
+    speedHackControl();
+}
+
+void Player::pushInput(const InputCommand& input)
+{
+    /* resent or out of order */
+    if (input.seq <= inputSeq || (!inputs.empty() && input.seq <= inputs.back().seq))
+    {
+        return;
+    }
+
+    /* too far behind, the oldest are skipped and the owner gets corrected */
+    if (inputs.size() >= PLAYER_INPUT_QUEUE)
+    {
+        inputSeq = inputs.front().seq;
+        inputs.pop_front();
+    }
+
+    inputs.push_back(input);
+}
+
+void Player::resetInputs()
+{
+    inputs.clear();
+    inputSeq = 0;
+    inputTime = 0.0;
+}
+
+void Player::clearInputs()
+{
+    if (!inputs.empty())
+    {
+        inputSeq = inputs.back().seq;
+    }
+
+    inputs.clear();
+    inputTime = 0.0;
+}
+
+void Player::update(float step)
+{
+    if (!(connected && physicsObject && rayTracer) || physicsObject->isStatic())
+    {
+        /* nothing to move, the commands are still acknowledged */
+        clearInputs();
+        return;
+    }
+
+    /* the commands only get the time the ticks had, a faster client can't run faster */
+    inputTime = min(inputTime + step, float(PLAYER_INPUT_BACKLOG));
+
+    bool jumped = false;
+
+    while (!inputs.empty() && inputs.front().time <= inputTime)
+    {
+        InputCommand& input = inputs.front();
+
+        inputTime -= input.time;
+
+        /* one jump a tick, the body is still on the ground for the rest of the commands */
+        input.jump = input.jump && !jumped;
+        jumped |= input.jump;
+
+        /* the pushes were made for a whole tick */
+        move(input, input.time / step);
+
+        inputSeq = inputs.front().seq;
+        inputs.pop_front();
+    }
+}
 
 bool Player::isConnected() const
 {
@@ -110,6 +394,11 @@ btVector3 Player::getMoveDirection() const
     return moveDirection;
 }
 
+unsigned int Player::getInputSeq() const
+{
+    return inputSeq;
+}
+
 float Player::getSpeed() const
 {
     return speed;
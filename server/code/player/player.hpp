@@ -8,13 +8,29 @@
 #include <memory>
 #include <mutex>
 #include <condition_variable>
+#include <deque>
 
 //bullet
 #include <bullet/btBulletCollisionCommon.h>
 #include <bullet/btBulletDynamicsCommon.h>
 
+#define PLAYER_INPUT_QUEUE 128 /* commands waiting for the ticks, the oldest go first */
+#define PLAYER_INPUT_MAX_TIME 0.1 /* seconds, a longer client frame is cut down to it */
+#define PLAYER_INPUT_MIN_TIME 0.004 /* seconds, a shorter client frame is stretched to it */
+#define PLAYER_INPUT_BACKLOG 0.25 /* seconds of ticks the commands may catch up on */
+
 using namespace std;
 
+/* one client frame of the owner, the tick applies them in seq order */
+struct InputCommand
+{
+    unsigned int seq;
+    btVector3 moveDirection;
+    bool jump;
+    float time; /* seconds the client ran it for */
+    btQuaternion rotation; /* facing only, it doesn't move anything */
+};
+
 class Player
 {
     protected:
@@ -29,6 +45,28 @@ class Player
 
         btVector3 moveDirection;
 
+        RayTracer* rayTracer;
+
+        /* ground test buffers, refilled every command */
+        vector < RayQuery > groundQueries;
+        vector < RayResult > groundResults;
+        vector < btRigidBody* > groundIgnored;
+
+        deque < InputCommand > inputs;
+        unsigned int inputSeq; /* the last one applied, goes back to the owner */
+        float inputTime; /* tick time the queued commands may still use */
+
+        bool isGroundStanding();
+        bool isJumpAllowed();
+        void jump();
+
+        void moveGround(float scale);
+        void moveAir(float scale);
+        void speedHackControl();
+
+        void move(const InputCommand& input, float scale);
+        void resetInputs();
+
         mutable mutex mtx;
         mutable condition_variable cv;
         mutable bool ready;
@@ -40,14 +78,19 @@ class Player
         virtual void setConnected(bool connected);
         void setPhysicsObject(PhysicsObject* player);
         void removePhysicsObject();
+        void setRayTracer(RayTracer* rayTracer);
 
         void setMoveDirection(btVector3 moveDirection);
-        
-        virtual void update();
+
+        void pushInput(const InputCommand& input);
+        void clearInputs();
+
+        virtual void update(float step);
 
         bool isConnected() const;
         PhysicsObject* getPhysicsObject() const;
         btVector3 getMoveDirection() const;
+        unsigned int getInputSeq() const;
         float getSpeed() const;
         int getID() const;
 
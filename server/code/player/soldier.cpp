@@ -39,6 +39,9 @@ void Soldier::setConnected(bool connected)
 {
     this->connected = connected;
 
+    /* a new session counts from the start */
+    resetInputs();
+
     if (connected)
     {
         if (physicsObject)
@@ -9,12 +9,14 @@
 #include <bullet/btBulletCollisionCommon.h>
 #include <bullet/btBulletDynamicsCommon.h>
 
+#include "contactcache.hpp"
+
 using namespace std;
 
 class BulletEvents
 {
     protected:
-        set < pair < const btRigidBody*, const btRigidBody* > > m_PairsLastUpdate;
+        ContactCache contacts;
 
         void checkForCollisionEvents(btCollisionDispatcher *m_Dispatcher);
 
@@ -0,0 +1,250 @@
+#include "contactcache.hpp"
+
+const vector < btRigidBody* > ContactCache::none;
+
+ContactCache::ContactCache(size_t capacity)
+{
+    size_t size = 1;
+
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+
+    table.resize(size, {nullptr, nullptr, 0});
+    count = 0;
+
+    frame = 0;
+}
+
+size_t ContactCache::getSlot(const btRigidBody* body0, const btRigidBody* body1) const
+{
+    unsigned long long key = (unsigned long long)(size_t)body0 * 0x9E3779B97F4A7C15ULL ^ (unsigned long long)(size_t)body1;
+
+    key ^= key >> 29;
+    key *= 0xBF58476D1CE4E5B9ULL;
+    key ^= key >> 32;
+
+    return key & (table.size() - 1);
+}
+
+size_t ContactCache::find(const btRigidBody* body0, const btRigidBody* body1) const
+{
+    size_t mask = table.size() - 1;
+
+    for (size_t i = getSlot(body0, body1); table[i].body0; i = (i + 1) & mask)
+    {
+        if (table[i].body0 == body0 && table[i].body1 == body1)
+        {
+            return i;
+        }
+    }
+
+    return table.size();
+}
+
+void ContactCache::insert(btRigidBody* body0, btRigidBody* body1)
+{
+    if ((count + 1) * 2 > table.size())
+    {
+        grow();
+    }
+
+    size_t mask = table.size() - 1;
+    size_t i = getSlot(body0, body1);
+
+    while (table[i].body0)
+    {
+        i = (i + 1) & mask;
+    }
+
+    table[i] = {body0, body1, frame};
+    count++;
+}
+
+void ContactCache::erase(size_t index)
+{
+    size_t mask = table.size() - 1;
+    size_t hole = index;
+
+    /* backward shift, the probe chains stay unbroken without tombstones */
+    for (size_t i = (hole + 1) & mask; table[i].body0; i = (i + 1) & mask)
+    {
+        size_t home = getSlot(table[i].body0, table[i].body1);
+
+        bool stays = hole <= i ? (home > hole && home <= i) : (home > hole || home <= i);
+
+        if (!stays)
+        {
+            table[hole] = table[i];
+            hole = i;
+        }
+    }
+
+    table[hole].body0 = nullptr;
+    count--;
+}
+
+void ContactCache::grow()
+{
+    vector < Entry > old;
+    old.swap(table);
+
+    table.resize(old.size() * 2, {nullptr, nullptr, 0});
+
+    size_t mask = table.size() - 1;
+
+    for (size_t j = 0; j < old.size(); j++)
+    {
+        if (!old[j].body0)
+        {
+            continue;
+        }
+
+        size_t i = getSlot(old[j].body0, old[j].body1);
+
+        while (table[i].body0)
+        {
+            i = (i + 1) & mask;
+        }
+
+        table[i] = old[j];
+    }
+}
+
+void ContactCache::link(btRigidBody* body0, btRigidBody* body1)
+{
+    adjacency[body0].push_back(body1);
+    adjacency[body1].push_back(body0);
+}
+
+void ContactCache::unlink(btRigidBody* body0, btRigidBody* body1)
+{
+    pair < btRigidBody*, btRigidBody* > bodies[2] = {{body0, body1}, {body1, body0}};
+
+    for (int k = 0; k < 2; k++)
+    {
+        auto it = adjacency.find(bodies[k].first);
+
+        if (it == adjacency.end())
+        {
+            continue;
+        }
+
+        vector < btRigidBody* >& list = it->second;
+
+        for (size_t i = 0; i < list.size(); i++)
+        {
+            if (list[i] == bodies[k].second)
+            {
+                list[i] = list.back();
+                list.pop_back();
+                break;
+            }
+        }
+    }
+}
+
+void ContactCache::begin()
+{
+    frame++;
+
+    current.clear();
+}
+
+bool ContactCache::touch(btRigidBody* body0, btRigidBody* body1)
+{
+    if (body0 > body1)
+    {
+        swap(body0, body1);
+    }
+
+    size_t i = find(body0, body1);
+
+    if (i != table.size())
+    {
+        /* several manifolds of the same pair */
+        if (table[i].frame != frame)
+        {
+            table[i].frame = frame;
+            current.push_back({body0, body1});
+        }
+
+        return false;
+    }
+
+    insert(body0, body1);
+    link(body0, body1);
+
+    current.push_back({body0, body1});
+
+    return true;
+}
+
+const vector < pair < btRigidBody*, btRigidBody* > >& ContactCache::end()
+{
+    separated.clear();
+
+    /* touched last frame, not stamped this one */
+    for (size_t j = 0; j < previous.size(); j++)
+    {
+        size_t i = find(previous[j].first, previous[j].second);
+
+        if (i == table.size() || table[i].frame == frame)
+        {
+            continue;
+        }
+
+        erase(i);
+        unlink(previous[j].first, previous[j].second);
+
+        separated.push_back(previous[j]);
+    }
+
+    previous.swap(current);
+
+    return separated;
+}
+
+bool ContactCache::isTouching(const btRigidBody* body0, const btRigidBody* body1) const
+{
+    if (body0 > body1)
+    {
+        swap(body0, body1);
+    }
+
+    return find(body0, body1) != table.size();
+}
+
+const vector < btRigidBody* >& ContactCache::getTouchingWith(const btRigidBody* body) const
+{
+    auto it = adjacency.find(body);
+
+    if (it == adjacency.end())
+    {
+        return none;
+    }
+
+    return it->second;
+}
+
+void ContactCache::clear()
+{
+    for (size_t i = 0; i < table.size(); i++)
+    {
+        table[i].body0 = nullptr;
+    }
+
+    count = 0;
+
+    for (auto& i: adjacency)
+    {
+        i.second.clear();
+    }
+
+    current.clear();
+    previous.clear();
+    separated.clear();
+}
+
+ContactCache::~ContactCache() {}
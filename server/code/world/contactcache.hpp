@@ -0,0 +1,66 @@
+#pragma once
+
+//native
+#include <vector>
+#include <unordered_map>
+#include <utility>
+
+//bullet
+#include <bullet/btBulletCollisionCommon.h>
+#include <bullet/btBulletDynamicsCommon.h>
+
+#define CONTACT_CACHE_CAPACITY 256 /* pair table slots, a power of two, doubles when half full */
+
+using namespace std;
+
+/*
+ * bodies in contact, kept between the ticks.
+ * pairs live in an open addressing table stamped with the last frame they touched,
+ * every body has the list of its touching ones, the frame buffers are swapped and reused
+ */
+class ContactCache
+{
+    private:
+        struct Entry
+        {
+            btRigidBody* body0; /* nullptr - empty slot */
+            btRigidBody* body1;
+            unsigned int frame;
+        };
+
+        vector < Entry > table;
+        size_t count;
+
+        unordered_map < const btRigidBody*, vector < btRigidBody* > > adjacency;
+        static const vector < btRigidBody* > none;
+
+        vector < pair < btRigidBody*, btRigidBody* > > current;
+        vector < pair < btRigidBody*, btRigidBody* > > previous;
+        vector < pair < btRigidBody*, btRigidBody* > > separated;
+
+        unsigned int frame;
+
+        size_t getSlot(const btRigidBody* body0, const btRigidBody* body1) const;
+        size_t find(const btRigidBody* body0, const btRigidBody* body1) const;
+
+        void insert(btRigidBody* body0, btRigidBody* body1);
+        void erase(size_t index);
+        void grow();
+
+        void link(btRigidBody* body0, btRigidBody* body1);
+        void unlink(btRigidBody* body0, btRigidBody* body1);
+
+    public:
+        ContactCache(size_t capacity = CONTACT_CACHE_CAPACITY);
+
+        void begin();
+        bool touch(btRigidBody* body0, btRigidBody* body1);
+        const vector < pair < btRigidBody*, btRigidBody* > >& end();
+
+        bool isTouching(const btRigidBody* body0, const btRigidBody* body1) const;
+        const vector < btRigidBody* >& getTouchingWith(const btRigidBody* body) const;
+
+        void clear();
+
+        ~ContactCache();
+};
@@ -1,5 +1,43 @@
 #include "raytracer.hpp"
 
+RayFilterCallback::RayFilterCallback(const vector < btRigidBody* >* ignored, bool missStatic, bool missKinematic) : btCollisionWorld::ClosestRayResultCallback(btVector3(0, 0, 0), btVector3(0, 0, 0))
+{
+    this->ignored = ignored;
+    this->missStatic = missStatic;
+    this->missKinematic = missKinematic;
+
+    /* static bodies are added in their own group, the broadphase drops them before the flags are checked */
+    if (missStatic && missKinematic)
+    {
+        m_collisionFilterMask = btBroadphaseProxy::AllFilter & ~btBroadphaseProxy::StaticFilter;
+    }
+}
+
+void RayFilterCallback::reset(const btVector3& rayFrom, const btVector3& rayTo)
+{
+    m_rayFromWorld = rayFrom;
+    m_rayToWorld = rayTo;
+    m_closestHitFraction = 1.0;
+    m_collisionObject = nullptr;
+}
+
+bool RayFilterCallback::needsCollision(btBroadphaseProxy* proxy) const
+{
+    if (!btCollisionWorld::ClosestRayResultCallback::needsCollision(proxy))
+    {
+        return false;
+    }
+
+    const btCollisionObject* object = static_cast < const btCollisionObject* >(proxy->m_clientObject);
+
+    if ((object->isStaticObject() && missStatic) || (object->isKinematicObject() && missKinematic))
+    {
+        return false;
+    }
+
+    return !ignored || find(ignored->begin(), ignored->end(), object) == ignored->end();
+}
+
 RayTracer::RayTracer(btDynamicsWorld* world)
 {
     this->world = world; // pointer to the physics world
@@ -7,41 +45,46 @@ RayTracer::RayTracer(btDynamicsWorld* world)
 
 RayResult* RayTracer::rayCast(btRigidBody* me, btVector3 rayFrom, btVector3 rayTo, bool missStatic, bool missKinematic) const
 {
-    if (!world)
+    vector < RayQuery > queries = {{rayFrom, rayTo * RAYTRACER_DISTANCE}}; // rayTo is really small 
+    vector < RayResult > results(1);
+
+    if (!rayCast(queries, results, {me}, missStatic, missKinematic))
     {
         return nullptr;
     }
 
-    btVector3 rT = rayTo; 
+    return new RayResult(results[0]);
+}
 
-    rT *= 10000; // rayTo is really small 
+int RayTracer::rayCast(const vector < RayQuery >& queries, vector < RayResult >& results, const vector < btRigidBody* >& ignored, bool missStatic, bool missKinematic) const
+{
+    if (!world || results.size() < queries.size())
+    {
+        return 0;
+    }
 
-    btCollisionWorld::ClosestRayResultCallback rayCallback(rayFrom, rT);
+    RayFilterCallback rayCallback(&ignored, missStatic, missKinematic);
 
-    world->rayTest(rayFrom, rT, rayCallback); // perform ray test in bullet 
-   
-    if (rayCallback.hasHit())
+    int hits = 0;
+
+    for (size_t i = 0; i < queries.size(); i++)
     {
-        btRigidBody *body = (btRigidBody*)btRigidBody::upcast(rayCallback.m_collisionObject); // from const to normal
+        rayCallback.reset(queries[i].from, queries[i].to);
 
-        if (!body)
-        {
-            return nullptr;
-        }
+        world->rayTest(queries[i].from, queries[i].to, rayCallback); // perform ray test in bullet 
 
-        if ((body == me) || (body->isStaticObject() && missStatic) || (body->isKinematicObject() && missKinematic))
-        {
-            return rayCast(me, rayCallback.m_hitPointWorld, rayTo, missStatic, missKinematic); 
-        }
+        results[i].body = nullptr;
 
-        RayResult* result = new RayResult();
-        result->body = body; // set hit body
-        result->hitPoint = rayCallback.m_hitPointWorld; // set hit point
+        if (rayCallback.hasHit())
+        {
+            results[i].body = (btRigidBody*)btRigidBody::upcast(rayCallback.m_collisionObject); // from const to normal
+            results[i].hitPoint = rayCallback.m_hitPointWorld;
 
-        return result;
+            hits += results[i].body ? 1 : 0;
+        }
     }
 
-    return nullptr;
+    return hits;
 }
         
 RayTracer::~RayTracer() {}
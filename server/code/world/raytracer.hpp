@@ -1,5 +1,8 @@
 #pragma once
 
+#include <vector>
+#include <algorithm>
+
 //bullet
 #include <bullet/btBulletCollisionCommon.h>
 #include <bullet/btBulletDynamicsCommon.h>
@@ -7,14 +10,37 @@
 //openGL
 #include <glm/glm.hpp>
 
+using namespace std;
 using namespace glm;
 
+#define RAYTRACER_DISTANCE 10000.0
+
 struct RayResult
 {
-    btRigidBody* body;
+    btRigidBody* body; /* nullptr on a miss */
     btVector3 hitPoint;
 };
 
+struct RayQuery
+{
+    btVector3 from;
+    btVector3 to;
+};
+
+/* closest hit, the bodies we look through are filtered out instead of casting again from the hit point */
+struct RayFilterCallback : public btCollisionWorld::ClosestRayResultCallback
+{
+    const vector < btRigidBody* >* ignored;
+    bool missStatic;
+    bool missKinematic;
+
+    RayFilterCallback(const vector < btRigidBody* >* ignored, bool missStatic, bool missKinematic);
+
+    void reset(const btVector3& rayFrom, const btVector3& rayTo);
+
+    virtual bool needsCollision(btBroadphaseProxy* proxy) const;
+};
+
 class RayTracer
 {
     private:
@@ -25,5 +51,8 @@ class RayTracer
 
         RayResult* rayCast(btRigidBody* me, btVector3 rayFrom, btVector3 rayTo, bool missStatic = true, bool missKinematic = true) const;
 
+        /* every ray of a tick at once, results has to hold queries.size() entries and is reused by the caller */
+        int rayCast(const vector < RayQuery >& queries, vector < RayResult >& results, const vector < btRigidBody* >& ignored, bool missStatic = true, bool missKinematic = true) const;
+
         ~RayTracer();
 };
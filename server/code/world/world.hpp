@@ -19,9 +19,9 @@ class World : public BulletEvents
         btConstraintSolver* solver;
         btDynamicsWorld* world;
 
-        set < pair < btRigidBody*, btRigidBody* > > touchingBodies;
-        set < pair < btRigidBody*, btRigidBody* > > collidedBodies;
-        set < pair < btRigidBody*, btRigidBody* > > separatedBodies;
+        /* touching pairs live in the contact cache, these two are refilled every step */
+        vector < pair < btRigidBody*, btRigidBody* > > collidedBodies;
+        vector < pair < btRigidBody*, btRigidBody* > > separatedBodies;
 
         void collisionEvent(btRigidBody* body0, btRigidBody* body1) override;
         void separationEvent(btRigidBody* body0, btRigidBody* body1) override;
@@ -36,9 +36,9 @@ class World : public BulletEvents
         bool isCollided(btRigidBody* body0, btRigidBody* body1) const;
         bool isSeparated(btRigidBody* body0, btRigidBody* body1) const;
 
-        set < btRigidBody* > getTouchingWith(btRigidBody* body0) const;
-        set < btRigidBody* > getCollidedWith(btRigidBody* body0) const;
-        set < btRigidBody* > getSeparatedWith(btRigidBody* body0) const;
+        const vector < btRigidBody* >& getTouchingWith(btRigidBody* body0) const;
+        vector < btRigidBody* > getCollidedWith(btRigidBody* body0) const;
+        vector < btRigidBody* > getSeparatedWith(btRigidBody* body0) const;
 
         void updateSimulation(float dt, int step = 1, float fixedStep = 1.0 / 60.0);
        